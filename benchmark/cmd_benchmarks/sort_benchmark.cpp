@@ -0,0 +1,114 @@
+/*
+ *  Copyright © 2026 WinuxCmd
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights, to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to whom the Software
+ *  is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *  - File: sort_benchmark.cpp
+ *  - CopyrightYear: 2026
+ */
+#include <benchmark/benchmark.h>
+
+import std;
+import container;
+
+// 10M short lines, the shape of a large sort input. Built once and shared
+// by every thread count so that only the sort is timed.
+static const std::vector<std::string_view>& sort_input() {
+    static StringArena arena;
+    static const std::vector<std::string_view> lines = [] {
+        constexpr size_t kLines = 10'000'000;
+        std::mt19937_64 rng(42);
+        std::vector<std::string_view> out;
+        out.reserve(kLines);
+        char buf[32];
+        for (size_t i = 0; i < kLines; ++i) {
+            auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), rng() % 100'000'000);
+            out.push_back(arena.store(std::string_view(buf, end - buf)));
+        }
+        return out;
+    }();
+    return lines;
+}
+
+// parallel_stable_sort is what sort --parallel=N runs on each chunk
+static void BM_ParallelStableSort(benchmark::State& state) {
+    const auto& input = sort_input();
+    const auto threads = static_cast<size_t>(state.range(0));
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::vector<std::string_view> lines = input;
+        state.ResumeTiming();
+        parallel_stable_sort(lines.begin(), lines.end(), std::less<>{}, threads);
+        benchmark::DoNotOptimize(lines.data());
+    }
+    state.SetItemsProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_ParallelStableSort)
+    ->RangeMultiplier(2)
+    ->Range(1, 32)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// 1M paths sharing long prefixes, where byte-wise radix sorting pays off
+static const std::vector<std::string_view>& path_input() {
+    static StringArena arena;
+    static const std::vector<std::string_view> paths = [] {
+        constexpr size_t kPaths = 1'000'000;
+        std::mt19937_64 rng(7);
+        std::vector<std::string_view> out;
+        out.reserve(kPaths);
+        for (size_t i = 0; i < kPaths; ++i) {
+            const std::string path = std::format(
+                "/var/log/service/2026-{:02}-{:02}/worker-{:03}/part-{:06}.log",
+                rng() % 12 + 1, rng() % 28 + 1, rng() % 100, rng() % 1'000'000);
+            out.push_back(arena.store(path));
+        }
+        return out;
+    }();
+    return paths;
+}
+
+static void BM_PathsStdSort(benchmark::State& state) {
+    const auto& input = path_input();
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::vector<std::string_view> lines = input;
+        state.ResumeTiming();
+        std::sort(lines.begin(), lines.end());
+        benchmark::DoNotOptimize(lines.data());
+    }
+    state.SetItemsProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_PathsStdSort)->Unit(benchmark::kMillisecond);
+
+static void BM_PathsMultikeyQuicksort(benchmark::State& state) {
+    const auto& input = path_input();
+    auto byte_at = [](std::string_view s, size_t depth) {
+        return depth < s.size() ? static_cast<int>(static_cast<unsigned char>(s[depth])) : -1;
+    };
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::vector<std::string_view> lines = input;
+        state.ResumeTiming();
+        multikey_quicksort(lines.begin(), lines.end(), byte_at, [](auto, auto) {});
+        benchmark::DoNotOptimize(lines.data());
+    }
+    state.SetItemsProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_PathsMultikeyQuicksort)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,44 @@
+# Generate the compile-time command table
+# Scans command sources for REGISTER_COMMAND(id, "name", ...) and writes an
+# X-macro list consumed by src/core/command_table.cpp:
+#
+#     WINUX_COMMAND(id, "name")
+#
+# The output is only rewritten when its content changes so that reconfiguring
+# does not force a rebuild of the table translation unit.
+
+function(generate_command_table OUTPUT_FILE)
+    set(TABLE_CONTENT "// Auto-generated by cmake/GenerateCommandTable.cmake. Do not edit.\n")
+    set(COMMAND_IDS "")
+
+    foreach(SOURCE_FILE ${ARGN})
+        file(READ "${SOURCE_FILE}" SOURCE_TEXT)
+        string(REGEX MATCH
+                "REGISTER_COMMAND\\([ \t\r\n]*([A-Za-z_][A-Za-z0-9_]*)[ \t\r\n]*,[^\"]*\"([^\"]*)\""
+                COMMAND_MATCH "${SOURCE_TEXT}")
+        if(NOT COMMAND_MATCH)
+            message(WARNING "No REGISTER_COMMAND found in ${SOURCE_FILE}")
+            continue()
+        endif()
+
+        set(COMMAND_ID "${CMAKE_MATCH_1}")
+        set(COMMAND_NAME "${CMAKE_MATCH_2}")
+        if(COMMAND_ID IN_LIST COMMAND_IDS)
+            message(FATAL_ERROR "Duplicate command identifier '${COMMAND_ID}' in ${SOURCE_FILE}")
+        endif()
+        list(APPEND COMMAND_IDS "${COMMAND_ID}")
+
+        string(APPEND TABLE_CONTENT "WINUX_COMMAND(${COMMAND_ID}, \"${COMMAND_NAME}\")\n")
+    endforeach()
+
+    set(TEMP_FILE "${OUTPUT_FILE}.tmp")
+    file(WRITE "${TEMP_FILE}" "${TABLE_CONTENT}")
+    configure_file("${TEMP_FILE}" "${OUTPUT_FILE}" COPYONLY)
+    file(REMOVE "${TEMP_FILE}")
+
+    # Re-run configuration when a command's registration changes
+    set_property(DIRECTORY APPEND PROPERTY CMAKE_CONFIGURE_DEPENDS ${ARGN})
+
+    list(LENGTH COMMAND_IDS COMMAND_COUNT)
+    message(STATUS "Command table: ${COMMAND_COUNT} commands -> ${OUTPUT_FILE}")
+endfunction()
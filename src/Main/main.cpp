@@ -30,6 +30,7 @@ import core;
 import utils;
 import readline;
 import native_completion;
+import serve;
 import version;
 
 namespace {
@@ -173,6 +174,12 @@ static int printHelp() noexcept {
 
   safePrintLn(L"");
   safePrintLn(L"Use 'winuxcmd <command> --help' for command-specific help.");
+  safePrintLn(
+      L"Use 'winuxcmd --serve' to keep a warm server; set WINUXCMD_SERVER=1 "
+      L"to route commands to it.");
+  safePrintLn(
+      L"Use 'winuxcmd --pipeline \"a | b\"' to run a pipeline of builtins "
+      L"in-process.");
   return 1;
 }
 
@@ -285,6 +292,9 @@ static int runNativeFallback(const std::string &line) noexcept {
   PROCESS_INFORMATION pi{};
   si.cb = sizeof(si);
 
+  // The child shares our stdout; emit anything still buffered first.
+  flushOutput();
+
   // CreateProcessW requires a mutable command buffer.
   std::vector<wchar_t> mutable_cmd(cmdline.begin(), cmdline.end());
   mutable_cmd.push_back(L'\0');
@@ -327,6 +337,85 @@ static bool hasShellMeta(std::string_view line) {
          line.find('&') != std::string_view::npos;
 }
 
+// Split a REPL line into whitespace-separated tokens with basic quoting.
+// Quoted tokens get a \x01 prefix so commands skip wildcard expansion.
+static std::vector<std::string> tokenizeReplLine(std::string_view line) {
+  std::vector<std::string> tokens;
+  std::string tok;
+  bool in_single_quote = false;
+  bool in_double_quote = false;
+  bool was_quoted = false;
+  auto finish_token = [&] {
+    if (tok.empty()) return;
+    if (was_quoted) {
+      tokens.push_back("\x01" + tok);
+    } else {
+      tokens.push_back(std::move(tok));
+    }
+    tok.clear();
+    was_quoted = false;
+  };
+
+  for (char c : line) {
+    if (c == '\'' && !in_double_quote) {
+      in_single_quote = !in_single_quote;
+      was_quoted = true;
+    } else if (c == '"' && !in_single_quote) {
+      in_double_quote = !in_double_quote;
+      was_quoted = true;
+    } else if (std::isspace(static_cast<unsigned char>(c)) &&
+               !in_single_quote && !in_double_quote) {
+      finish_token();
+    } else {
+      tok += c;
+    }
+  }
+  finish_token();
+  return tokens;
+}
+
+// Split `a | b | c` into stages when every stage is a builtin that can run
+// in-process. Lines with redirections, `||`, `&` or non-builtin stages are
+// left to the native shell.
+static std::optional<std::vector<core::stage_pipeline::Stage>>
+splitBuiltinPipeline(std::string_view line) {
+  std::vector<std::string_view> parts;
+  bool in_single_quote = false;
+  bool in_double_quote = false;
+  size_t start = 0;
+  for (size_t i = 0; i < line.size(); ++i) {
+    const char c = line[i];
+    if (c == '\'' && !in_double_quote) {
+      in_single_quote = !in_single_quote;
+    } else if (c == '"' && !in_single_quote) {
+      in_double_quote = !in_double_quote;
+    } else if (!in_single_quote && !in_double_quote) {
+      if (c == '<' || c == '>' || c == '&') return std::nullopt;
+      if (c == '|') {
+        if (i + 1 < line.size() && line[i + 1] == '|') return std::nullopt;
+        parts.push_back(line.substr(start, i - start));
+        start = i + 1;
+      }
+    }
+  }
+  if (parts.empty()) return std::nullopt;
+  parts.push_back(line.substr(start));
+
+  std::vector<core::stage_pipeline::Stage> stages;
+  stages.reserve(parts.size());
+  for (auto part : parts) {
+    auto argv = tokenizeReplLine(part);
+    if (argv.empty()) return std::nullopt;
+    if (!CommandRegistry::hasCommand(argv.front())) {
+      argv.front() = toLowerAscii(argv.front());
+    }
+    stages.push_back({std::move(argv)});
+  }
+
+  if (!core::stage_pipeline::runnable(stages)) return std::nullopt;
+  return stages;
+}
+
 static std::optional<std::string> rewriteSudoBuiltinLine(
     const std::string &line) {
   std::istringstream iss(line);
@@ -515,6 +604,12 @@ static void runReplMode() noexcept {
       resolved_line = *rewritten;
     }
 
+    // Pipelines made only of builtins run in-process on threads.
+    if (auto stages = splitBuiltinPipeline(resolved_line); stages) {
+      core::stage_pipeline::run(*stages);
+      continue;
+    }
+
     // REPL does not implement a full shell parser.
     // Route shell-style compound commands to native-shell fallback.
     if (hasShellMeta(resolved_line)) {
@@ -524,42 +619,7 @@ static void runReplMode() noexcept {
 
     // Tokenise with basic quoting support
     // Quoted arguments get a \x01 prefix to protect wildcards from expansion
-    std::vector<std::string> tokens;
-    {
-      std::string tok;
-      bool in_single_quote = false;
-      bool in_double_quote = false;
-      bool was_quoted = false;
-      for (size_t i = 0; i < resolved_line.size(); ++i) {
-        char c = resolved_line[i];
-        if (c == '\'' && !in_double_quote) {
-          in_single_quote = !in_single_quote;
-          was_quoted = true;
-        } else if (c == '"' && !in_single_quote) {
-          in_double_quote = !in_double_quote;
-          was_quoted = true;
-        } else if (std::isspace(static_cast<unsigned char>(c)) && !in_single_quote && !in_double_quote) {
-          if (!tok.empty()) {
-            if (was_quoted) {
-              tokens.push_back("\x01" + tok);
-            } else {
-              tokens.push_back(std::move(tok));
-            }
-            tok.clear();
-            was_quoted = false;
-          }
-        } else {
-          tok += c;
-        }
-      }
-      if (!tok.empty()) {
-        if (was_quoted) {
-          tokens.push_back("\x01" + tok);
-        } else {
-          tokens.push_back(std::move(tok));
-        }
-      }
-    }
+    std::vector<std::string> tokens = tokenizeReplLine(resolved_line);
     if (tokens.empty()) continue;
 
     // REPL built-ins: keep cwd changes in current winuxcmd process.
@@ -608,6 +668,55 @@ static void runReplMode() noexcept {
   safePrintLn(L"\nGoodbye!");
 }
 
+// tail -f/-F/--follow waits for more data until it is interrupted, which
+// only the local console can do reliably.
+static bool followsInput(std::string_view command,
+                         std::span<std::string_view> args) {
+  if (command != "tail") return false;
+  for (auto arg : args) {
+    if (arg == "--") break;
+    if (arg.starts_with("--follow")) return true;
+    if (arg.size() < 2 || arg[0] != '-' || arg[1] == '-') continue;
+    for (char c : arg.substr(1)) {
+      if (c == 'f' || c == 'F') return true;
+      if (c == 'c' || c == 'n' || c == 's') break;  // The rest is a value
+    }
+  }
+  return false;
+}
+
+// Command and arguments of an invocation that is a plain builtin dispatch
+// and can therefore be forwarded to a --serve process. Commands that use
+// the real standard handles, start children or change the environment
+// would act on the server's console and state, and interactive or
+// follow-mode commands would outlive their client's interest in them, so
+// all of these run locally.
+static std::optional<
+    std::pair<std::string_view, std::span<std::string_view>>>
+serverDispatchTarget(std::string_view self_name,
+                     std::vector<std::string_view> &args) {
+  namespace sp = core::stage_pipeline;
+  if (self_name != "winuxcmd") {
+    if (!CommandRegistry::hasCommand(self_name)) return std::nullopt;
+    if (sp::needs_os_handles(self_name)) return std::nullopt;
+    if (followsInput(self_name, args)) return std::nullopt;
+    return std::pair{self_name, std::span<std::string_view>(args)};
+  }
+
+  if (args.empty() || !CommandRegistry::hasCommand(args[0])) {
+    return std::nullopt;
+  }
+  if (sp::needs_os_handles(args[0])) return std::nullopt;
+  std::span<std::string_view> cmd_args(args.data() + 1, args.size() - 1);
+  if (followsInput(args[0], cmd_args)) return std::nullopt;
+  // `winuxcmd <cmd> --version` reports the winuxcmd version locally.
+  if (std::ranges::find(cmd_args, std::string_view("--version")) !=
+      cmd_args.end()) {
+    return std::nullopt;
+  }
+  return std::pair{args[0], cmd_args};
+}
+
 /**
  * @brief Main function for WinuxCmd
  * @param argc Number of command-line arguments
@@ -618,9 +727,6 @@ int main(int argc, char *argv[]) noexcept {
   if (argc < 1) {
     return printHelp();
   }
-  // Automatically set console or pipe output.
-  setupConsoleForUnicode();
-  detectReplFallbackShell();
   // Get the executable name (stem only)
   std::string self_name = path::get_executable_name(argv[0]);
 
@@ -631,7 +737,37 @@ int main(int argc, char *argv[]) noexcept {
     args.emplace_back(argv[i]);
   }
 
+  // Warm server mode: winuxcmd --serve [PIPE] [--trace]
+  if (self_name == "winuxcmd" && !args.empty() && args[0] == "--serve") {
+    setupConsoleForUnicode();
+    bool trace = false;
+    std::wstring pipe_name = defaultServerPipeName();
+    for (size_t i = 1; i < args.size(); ++i) {
+      if (args[i] == "--trace") {
+        trace = true;
+      } else {
+        pipe_name = utf8_to_wstring(std::string(args[i]));
+      }
+    }
+    return runServer(pipe_name, trace);
+  }
+
+  // Plain command invocations go to a warm server first when one is
+  // configured (WINUXCMD_SERVER), before any local startup work.
+  if (auto target = serverDispatchTarget(self_name, args)) {
+    if (auto exit_code = forwardToServer(target->first, target->second)) {
+      return *exit_code;
+    }
+  }
+
+  // Automatically set console or pipe output.
+  setupConsoleForUnicode();
+
   if (self_name == "winuxcmd") {
+    // The fallback shell only matters for the REPL, completions and
+    // non-builtin commands; linked tools (ls.exe) skip the process scan.
+    detectReplFallbackShell();
+
     // Mode 1: winuxcmd <command> [args...] (e.g., winuxcmd ls -la)
     if (args.empty()) {
       // Enter interactive REPL when running on a real console, otherwise help.
@@ -683,6 +819,18 @@ int main(int argc, char *argv[]) noexcept {
       return 0;
     }
 
+    // One REPL pipeline line without the REPL:
+    // winuxcmd --pipeline "ls | grep x | sort"
+    if (args[0] == "--pipeline" && args.size() == 2) {
+      auto stages = splitBuiltinPipeline(args[1]);
+      if (!stages) {
+        safeErrorPrintLn(
+            "winuxcmd: --pipeline: not a pipeline of in-process builtins");
+        return 2;
+      }
+      return core::stage_pipeline::run(*stages);
+    }
+
     // Check for top-level help flags/alias
     if (args.size() == 1 && (args[0] == "--help" || args[0] == "-h")) {
       return printHelp();
@@ -0,0 +1,511 @@
+/*
+ *  Copyright © 2026 [caomengxuan666]
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *  - File: serve.cppm
+ *  - Username: Administrator
+ *  - CopyrightYear: 2026
+ */
+module;
+#include "pch/pch.h"
+export module serve;
+import std;
+import core;
+import utils;
+
+// ──────────────────────────────────────────────────────────────────────────────
+// Warm server mode
+//
+// `winuxcmd --serve` keeps one process listening on a named pipe. When
+// WINUXCMD_SERVER is set, every `ls.exe` / `winuxcmd grep ...` first tries to
+// hand its command line, working directory, environment and standard handles
+// to that process and only returns the exit code, skipping process startup
+// work. Each request runs on its own thread with its own command context and
+// standard handles; see ProcessStateGate for how cwd/environment are shared.
+// ──────────────────────────────────────────────────────────────────────────────
+
+namespace {
+constexpr std::uint32_t kRequestMagic = 0x31435857;  // "WXC1"
+constexpr std::uint32_t kMaxRequestSize = 64u << 20;
+constexpr DWORD kPipeBufferSize = 64 * 1024;
+
+struct Request {
+  std::array<std::uint64_t, 3> std_handles{};  // client's stdin/stdout/stderr
+  std::wstring cwd;
+  std::wstring environment;  // Double-NUL terminated environment block
+  std::vector<std::string> argv;  // argv[0] is the command name
+};
+
+bool writeAll(HANDLE pipe, const void *data, size_t size) {
+  const auto *p = static_cast<const char *>(data);
+  while (size > 0) {
+    DWORD written = 0;
+    const DWORD chunk = static_cast<DWORD>(std::min<size_t>(size, 1u << 30));
+    if (!WriteFile(pipe, p, chunk, &written, nullptr) || written == 0)
+      return false;
+    p += written;
+    size -= written;
+  }
+  return true;
+}
+
+bool readAll(HANDLE pipe, void *data, size_t size) {
+  auto *p = static_cast<char *>(data);
+  while (size > 0) {
+    DWORD got = 0;
+    const DWORD chunk = static_cast<DWORD>(std::min<size_t>(size, 1u << 30));
+    if (!ReadFile(pipe, p, chunk, &got, nullptr) || got == 0) return false;
+    p += got;
+    size -= got;
+  }
+  return true;
+}
+
+// ---- Encoding: u32 total size, then little-endian fields -------------------
+
+void putU32(std::string &out, std::uint32_t v) {
+  out.append(reinterpret_cast<const char *>(&v), sizeof(v));
+}
+
+void putU64(std::string &out, std::uint64_t v) {
+  out.append(reinterpret_cast<const char *>(&v), sizeof(v));
+}
+
+void putBytes(std::string &out, const void *data, size_t size) {
+  putU32(out, static_cast<std::uint32_t>(size));
+  out.append(static_cast<const char *>(data), size);
+}
+
+std::string encodeRequest(const Request &request) {
+  std::string out(sizeof(std::uint32_t), '\0');  // Size, patched below
+  putU32(out, kRequestMagic);
+  for (auto h : request.std_handles) putU64(out, h);
+  putBytes(out, request.cwd.data(), request.cwd.size() * sizeof(wchar_t));
+  putBytes(out, request.environment.data(),
+           request.environment.size() * sizeof(wchar_t));
+  putU32(out, static_cast<std::uint32_t>(request.argv.size()));
+  for (const auto &arg : request.argv) putBytes(out, arg.data(), arg.size());
+
+  const auto size = static_cast<std::uint32_t>(out.size() - sizeof(size));
+  std::memcpy(out.data(), &size, sizeof(size));
+  return out;
+}
+
+class RequestParser {
+ public:
+  explicit RequestParser(std::string_view data) : data_(data) {}
+
+  bool u32(std::uint32_t &v) { return raw(&v, sizeof(v)); }
+  bool u64(std::uint64_t &v) { return raw(&v, sizeof(v)); }
+
+  bool bytes(std::string_view &v) {
+    std::uint32_t size = 0;
+    if (!u32(size) || size > data_.size()) return false;
+    v = data_.substr(0, size);
+    data_.remove_prefix(size);
+    return true;
+  }
+
+  bool wide(std::wstring &v) {
+    std::string_view raw_bytes;
+    if (!bytes(raw_bytes) || raw_bytes.size() % sizeof(wchar_t) != 0)
+      return false;
+    v.resize(raw_bytes.size() / sizeof(wchar_t));
+    std::memcpy(v.data(), raw_bytes.data(), raw_bytes.size());
+    return true;
+  }
+
+ private:
+  bool raw(void *dest, size_t size) {
+    if (data_.size() < size) return false;
+    std::memcpy(dest, data_.data(), size);
+    data_.remove_prefix(size);
+    return true;
+  }
+
+  std::string_view data_;
+};
+
+std::optional<Request> readRequest(HANDLE pipe) {
+  std::uint32_t size = 0;
+  if (!readAll(pipe, &size, sizeof(size)) || size > kMaxRequestSize)
+    return std::nullopt;
+  std::string data(size, '\0');
+  if (!readAll(pipe, data.data(), data.size())) return std::nullopt;
+
+  RequestParser parser(data);
+  Request request;
+  std::uint32_t magic = 0;
+  std::uint32_t argc = 0;
+  if (!parser.u32(magic) || magic != kRequestMagic) return std::nullopt;
+  for (auto &h : request.std_handles) {
+    if (!parser.u64(h)) return std::nullopt;
+  }
+  if (!parser.wide(request.cwd) || !parser.wide(request.environment) ||
+      !parser.u32(argc) || argc == 0) {
+    return std::nullopt;
+  }
+  request.argv.reserve(std::min<std::uint32_t>(argc, 1024));
+  for (std::uint32_t i = 0; i < argc; ++i) {
+    std::string_view arg;
+    if (!parser.bytes(arg)) return std::nullopt;
+    request.argv.emplace_back(arg);
+  }
+  return request;
+}
+
+// ---- Server side -----------------------------------------------------------
+
+// Working directory and environment belong to the process, not a thread.
+// Requests are admitted strictly in arrival order, each taking a ticket.
+// Consecutive requests that agree on cwd/environment run concurrently; one
+// that needs a different state waits for the running ones to finish and
+// then switches the process over. A newcomer that matches the current state
+// still queues behind an earlier waiting request, so a steady stream of
+// same-cwd requests cannot starve a different one.
+//
+// With tracing on, every step is logged to the server's own standard
+// output ("ticket N queued: CMD", "admitted", "released"), in gate order.
+class ProcessStateGate {
+ public:
+  explicit ProcessStateGate(bool trace) : trace_(trace) {}
+
+  /// @return The request's ticket, to be passed to leave()
+  std::uint64_t enter(const Request &request) {
+    std::unique_lock lock(mutex_);
+    const std::uint64_t ticket = next_ticket_++;
+    log(ticket, "queued: " + request.argv.front());
+    changed_.wait(lock, [&] {
+      return ticket == serving_ && (active_ == 0 || matches(request));
+    });
+    if (!matches(request)) {
+      applyEnvironment(request.environment);
+      SetCurrentDirectoryW(request.cwd.c_str());
+      cwd_ = request.cwd;
+      environment_ = request.environment;
+    }
+    ++active_;
+    ++serving_;
+    log(ticket, "admitted");
+    changed_.notify_all();
+    return ticket;
+  }
+
+  void leave(std::uint64_t ticket) {
+    std::lock_guard lock(mutex_);
+    log(ticket, "released");
+    if (--active_ == 0) changed_.notify_all();
+  }
+
+ private:
+  bool matches(const Request &request) const {
+    return initialized() && request.cwd == cwd_ &&
+           request.environment == environment_;
+  }
+
+  bool initialized() const { return !cwd_.empty(); }
+
+  // Request threads have the client's handles bound, so write to the
+  // process's own standard output directly.
+  void log(std::uint64_t ticket, const std::string &what) const {
+    if (!trace_) return;
+    const std::string line =
+        "winuxcmd: ticket " + std::to_string(ticket) + " " + what + "\n";
+    DWORD written = 0;
+    WriteFile(GetStdHandle(STD_OUTPUT_HANDLE), line.data(),
+              static_cast<DWORD>(line.size()), &written, nullptr);
+  }
+
+  // Replace the process environment with the client's block. _wputenv_s
+  // keeps the C runtime's copy (getenv) in sync with the Win32 one.
+  static void applyEnvironment(const std::wstring &block) {
+    std::vector<std::wstring> names;
+    if (wchar_t *env = GetEnvironmentStringsW()) {
+      for (const wchar_t *p = env; *p; p += std::wcslen(p) + 1) {
+        std::wstring_view entry(p);
+        if (entry.front() == L'=') continue;  // Per-drive cwd entries
+        names.emplace_back(entry.substr(0, entry.find(L'=')));
+      }
+      FreeEnvironmentStringsW(env);
+    }
+    for (const auto &name : names) _wputenv_s(name.c_str(), L"");
+
+    for (const wchar_t *p = block.c_str(); *p; p += std::wcslen(p) + 1) {
+      std::wstring_view entry(p);
+      if (entry.front() == L'=') continue;
+      const size_t eq = entry.find(L'=');
+      if (eq == std::wstring_view::npos) continue;
+      std::wstring name(entry.substr(0, eq));
+      std::wstring value(entry.substr(eq + 1));
+      _wputenv_s(name.c_str(), value.c_str());
+    }
+  }
+
+  const bool trace_;
+  std::mutex mutex_;
+  std::condition_variable changed_;
+  size_t active_ = 0;
+  std::uint64_t next_ticket_ = 0;  // Handed to the next request to arrive
+  std::uint64_t serving_ = 0;      // Ticket allowed to enter next
+  std::wstring cwd_;
+  std::wstring environment_;
+};
+
+// The client's standard handles duplicated into this process
+class ClientHandles {
+ public:
+  ClientHandles(HANDLE pipe, const std::array<std::uint64_t, 3> &values) {
+    ULONG pid = 0;
+    if (!GetNamedPipeClientProcessId(pipe, &pid)) return;
+    HANDLE process = OpenProcess(PROCESS_DUP_HANDLE, FALSE, pid);
+    if (process == nullptr) return;
+    for (size_t i = 0; i < values.size(); ++i) {
+      auto source = reinterpret_cast<HANDLE>(
+          static_cast<std::uintptr_t>(values[i]));
+      if (source == nullptr || source == INVALID_HANDLE_VALUE) continue;
+      DuplicateHandle(process, source, GetCurrentProcess(), &handles_[i], 0,
+                      FALSE, DUPLICATE_SAME_ACCESS);
+    }
+    CloseHandle(process);
+  }
+
+  ~ClientHandles() {
+    for (HANDLE h : handles_) {
+      if (h != INVALID_HANDLE_VALUE) CloseHandle(h);
+    }
+  }
+
+  ClientHandles(const ClientHandles &) = delete;
+  ClientHandles &operator=(const ClientHandles &) = delete;
+
+  HANDLE in() const { return handles_[0]; }
+  HANDLE out() const { return handles_[1]; }
+  HANDLE err() const { return handles_[2]; }
+
+ private:
+  std::array<HANDLE, 3> handles_{INVALID_HANDLE_VALUE, INVALID_HANDLE_VALUE,
+                                 INVALID_HANDLE_VALUE};
+};
+
+void enableVirtualTerminal(HANDLE h) {
+  DWORD mode = 0;
+  if (h != INVALID_HANDLE_VALUE && GetConsoleMode(h, &mode)) {
+    SetConsoleMode(h, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+  }
+}
+
+// Ends a request early when its client process goes away (killed, or
+// Ctrl+C): the command's stop event is signalled, blocking I/O on the
+// command thread is cancelled, and the gate ticket is released at once so
+// a command that ignores both cannot hold up every later request.
+class ClientWatch {
+ public:
+  ClientWatch(HANDLE pipe, ProcessStateGate &gate, std::uint64_t ticket)
+      : gate_(gate), ticket_(ticket) {
+    stop_ = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    done_ = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    ULONG pid = 0;
+    if (GetNamedPipeClientProcessId(pipe, &pid)) {
+      client_ = OpenProcess(SYNCHRONIZE, FALSE, pid);
+    }
+    DuplicateHandle(GetCurrentProcess(), GetCurrentThread(),
+                    GetCurrentProcess(), &command_thread_, 0, FALSE,
+                    DUPLICATE_SAME_ACCESS);
+    if (client_ != nullptr && stop_ != nullptr && done_ != nullptr) {
+      watcher_ = std::thread([this] { watch(); });
+    }
+    bind_thread_stop_event(stop_);
+  }
+
+  ~ClientWatch() {
+    bind_thread_stop_event(nullptr);
+    if (done_ != nullptr) SetEvent(done_);
+    if (watcher_.joinable()) watcher_.join();
+    release();
+    for (HANDLE h : {stop_, done_, client_, command_thread_}) {
+      if (h != nullptr) CloseHandle(h);
+    }
+  }
+
+  ClientWatch(const ClientWatch &) = delete;
+  ClientWatch &operator=(const ClientWatch &) = delete;
+
+ private:
+  void watch() {
+    const HANDLE waits[] = {done_, client_};
+    if (WaitForMultipleObjects(2, waits, FALSE, INFINITE) !=
+        WAIT_OBJECT_0 + 1) {
+      return;
+    }
+    SetEvent(stop_);
+    if (command_thread_ != nullptr) CancelSynchronousIo(command_thread_);
+    release();
+  }
+
+  void release() {
+    if (!released_.exchange(true)) gate_.leave(ticket_);
+  }
+
+  ProcessStateGate &gate_;
+  const std::uint64_t ticket_;
+  HANDLE stop_ = nullptr;
+  HANDLE done_ = nullptr;
+  HANDLE client_ = nullptr;
+  HANDLE command_thread_ = nullptr;
+  std::atomic<bool> released_{false};
+  std::thread watcher_;
+};
+
+void serveClient(HANDLE pipe, ProcessStateGate &gate) {
+  std::int32_t exit_code = 1;
+  if (auto request = readRequest(pipe)) {
+    ClientHandles handles(pipe, request->std_handles);
+    enableVirtualTerminal(handles.out());
+    bind_thread_std_handles(handles.in(), handles.out(), handles.err());
+
+    const std::uint64_t ticket = gate.enter(*request);
+    {
+      ClientWatch watch(pipe, gate, ticket);
+      std::vector<std::string_view> args(request->argv.begin() + 1,
+                                         request->argv.end());
+      exit_code = CommandRegistry::dispatch(request->argv.front(), args);
+    }
+
+    bind_thread_std_handles(nullptr, nullptr, nullptr);
+  }
+
+  writeAll(pipe, &exit_code, sizeof(exit_code));
+  FlushFileBuffers(pipe);
+  DisconnectNamedPipe(pipe);
+  CloseHandle(pipe);
+}
+}  // namespace
+
+/// Pipe used when WINUXCMD_SERVER=1 or `--serve` is given no name: one per
+/// logon session.
+export std::wstring defaultServerPipeName() {
+  DWORD session = 0;
+  ProcessIdToSessionId(GetCurrentProcessId(), &session);
+  return L"\\\\.\\pipe\\winuxcmd-serve-" + std::to_wstring(session);
+}
+
+/**
+ * @brief Serve command requests on a named pipe until the process is killed.
+ * @param trace Log each request's passage through the state gate to
+ *        standard output
+ * @return Non-zero when the pipe cannot be created (e.g. already served)
+ */
+export int runServer(const std::wstring &pipe_name, bool trace = false) {
+  static ProcessStateGate gate(trace);
+  DWORD first_instance = FILE_FLAG_FIRST_PIPE_INSTANCE;
+
+  safePrintLn(L"winuxcmd: serving on " + pipe_name);
+  flushOutput();
+
+  while (true) {
+    HANDLE pipe = CreateNamedPipeW(
+        pipe_name.c_str(), PIPE_ACCESS_DUPLEX | first_instance,
+        PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT |
+            PIPE_REJECT_REMOTE_CLIENTS,
+        PIPE_UNLIMITED_INSTANCES, kPipeBufferSize, kPipeBufferSize, 0, nullptr);
+    if (pipe == INVALID_HANDLE_VALUE) {
+      safeErrorPrintLn(L"winuxcmd: cannot create pipe " + pipe_name +
+                       (GetLastError() == ERROR_ACCESS_DENIED
+                            ? L" (already being served?)"
+                            : L""));
+      return 1;
+    }
+    first_instance = 0;
+
+    if (!ConnectNamedPipe(pipe, nullptr) &&
+        GetLastError() != ERROR_PIPE_CONNECTED) {
+      CloseHandle(pipe);
+      continue;
+    }
+    std::thread([pipe] { serveClient(pipe, gate); }).detach();
+  }
+}
+
+/**
+ * @brief Run a command through the warm server named by WINUXCMD_SERVER.
+ * @return The command's exit code, or nullopt when no server is configured
+ *         or reachable and the command should run locally
+ */
+export std::optional<int> forwardToServer(std::string_view command,
+                                          std::span<std::string_view> args) {
+  wchar_t value[256];
+  constexpr DWORD kValueSize = static_cast<DWORD>(std::size(value));
+  const DWORD len = GetEnvironmentVariableW(L"WINUXCMD_SERVER", value,
+                                            kValueSize);
+  if (len == 0 || len >= kValueSize) return std::nullopt;
+  const std::wstring_view setting(value, len);
+  const std::wstring pipe_name = setting == L"1" ? defaultServerPipeName()
+                                                 : std::wstring(setting);
+
+  HANDLE pipe = CreateFileW(pipe_name.c_str(), GENERIC_READ | GENERIC_WRITE,
+                            0, nullptr, OPEN_EXISTING, 0, nullptr);
+  if (pipe == INVALID_HANDLE_VALUE && GetLastError() == ERROR_PIPE_BUSY &&
+      WaitNamedPipeW(pipe_name.c_str(), 1000)) {
+    pipe = CreateFileW(pipe_name.c_str(), GENERIC_READ | GENERIC_WRITE, 0,
+                       nullptr, OPEN_EXISTING, 0, nullptr);
+  }
+  if (pipe == INVALID_HANDLE_VALUE) return std::nullopt;
+
+  Request request;
+  const DWORD std_ids[] = {STD_INPUT_HANDLE, STD_OUTPUT_HANDLE,
+                           STD_ERROR_HANDLE};
+  for (size_t i = 0; i < request.std_handles.size(); ++i) {
+    request.std_handles[i] = static_cast<std::uint64_t>(
+        reinterpret_cast<std::uintptr_t>(GetStdHandle(std_ids[i])));
+  }
+
+  request.cwd.resize(GetCurrentDirectoryW(0, nullptr));
+  request.cwd.resize(GetCurrentDirectoryW(
+      static_cast<DWORD>(request.cwd.size()), request.cwd.data()));
+
+  if (wchar_t *env = GetEnvironmentStringsW()) {
+    const wchar_t *end = env;
+    while (*end) end += std::wcslen(end) + 1;
+    request.environment.assign(env, end + 1);
+    FreeEnvironmentStringsW(env);
+  } else {
+    request.environment.assign(1, L'\0');
+  }
+
+  request.argv.reserve(args.size() + 1);
+  request.argv.emplace_back(command);
+  for (auto arg : args) request.argv.emplace_back(arg);
+
+  const std::string message = encodeRequest(request);
+  if (!writeAll(pipe, message.data(), message.size())) {
+    // Nothing ran yet; fall back to running locally.
+    CloseHandle(pipe);
+    return std::nullopt;
+  }
+
+  std::int32_t exit_code = 0;
+  const bool answered = readAll(pipe, &exit_code, sizeof(exit_code));
+  CloseHandle(pipe);
+  if (!answered) {
+    safeErrorPrintLn(L"winuxcmd: lost connection to server " + pipe_name);
+    return 1;
+  }
+  return exit_code;
+}
@@ -229,7 +229,7 @@ REGISTER_COMMAND(base32, "base32",
   // Read input
   std::string input;
   if (ctx.positionals.empty() || ctx.positionals[0] == "-") {
-    input.assign(std::istreambuf_iterator<char>(std::cin),
+    input.assign(std::istreambuf_iterator<char>(stdin_stream()),
                  std::istreambuf_iterator<char>());
   } else {
     std::wstring wfile = utf8_to_wstring(std::string(ctx.positionals[0]));
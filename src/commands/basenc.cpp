@@ -303,7 +303,7 @@ REGISTER_COMMAND(basenc, "basenc",
   // Read input
   std::string input;
   if (ctx.positionals.empty() || ctx.positionals[0] == "-") {
-    input.assign(std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>());
+    input.assign(std::istreambuf_iterator<char>(stdin_stream()), std::istreambuf_iterator<char>());
   } else {
     std::wstring wfile = utf8_to_wstring(std::string(ctx.positionals[0]));
     HANDLE hFile = CreateFileW(wfile.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
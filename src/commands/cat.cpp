@@ -35,6 +35,10 @@
 #include "pch/pch.h"
 //include other header after pch.h
 #include "core/command_macros.h"
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define WINUX_CAT_SSE2 1
+#endif
 import std;
 import core;
 import utils;
@@ -92,10 +96,42 @@ auto constexpr CAT_OPTIONS =
 namespace cat_pipeline {
 namespace cp = core::pipeline;
 
+// Plain copies move data in blocks of this size
+constexpr size_t kCopyBlock = 1024 * 1024;
+
+struct FormatOptions {
+  bool number = false;
+  bool number_nonblank = false;
+  bool squeeze_blank = false;
+  bool show_ends = false;
+  bool show_tabs = false;
+  bool show_nonprinting = false;
+
+  [[nodiscard]] auto plain() const -> bool {
+    return !number && !number_nonblank && !squeeze_blank && !show_ends &&
+           !show_tabs && !show_nonprinting;
+  }
+};
+
+auto build_format_options(const BoundCommandContext<CAT_OPTIONS> &ctx)
+    -> FormatOptions {
+  const bool all = ctx.get<"--show-all">(false);
+  const bool e = ctx.get<"-e">(false);
+  const bool t = ctx.get<"-t">(false);
+  FormatOptions opts;
+  opts.number = ctx.get<"--number">(false);
+  opts.number_nonblank = ctx.get<"--number-nonblank">(false);
+  opts.squeeze_blank = ctx.get<"--squeeze-blank">(false);
+  opts.show_ends = ctx.get<"--show-ends">(false) || all || e;
+  opts.show_tabs = ctx.get<"--show-tabs">(false) || all || t;
+  opts.show_nonprinting = ctx.get<"--show-nonprinting">(false) || all || e || t;
+  return opts;
+}
+
 // ----------------------------------------------
 // 1. Validate arguments - OPTIMIZED: pass by reference
 // ----------------------------------------------
-auto validate_arguments(const CommandContext<CAT_OPTIONS.size()> &ctx,
+auto validate_arguments(const BoundCommandContext<CAT_OPTIONS> &ctx,
                         SmallVector<std::string, 64> &out_files)
     -> cp::Result<void> {
   for (auto arg : ctx.positionals) {
@@ -124,213 +160,286 @@ auto validate_arguments(const CommandContext<CAT_OPTIONS.size()> &ctx,
   return {};
 }
 
-}  // namespace cat_pipeline
-
-REGISTER_COMMAND(cat, "cat",
-                 "concatenate files and print on the standard output",
-                 "Concatenate FILE(s) to standard output.\n"
-                 "With no FILE, or when FILE is -, read standard input.\n"
-                 "\nExamples:\n"
-                 "  cat f g  Output f's contents, then g's contents.\n"
-                 "  cat      Copy standard input to standard output.",
-                 "  cat file.txt              Display contents of file.txt\n"
-                 "  cat -n file.txt           Number all output lines\n"
-                 "  cat file1.txt file2.txt   Concatenate multiple files\n"
-                 "  cat                       Read from standard input",
-                 "tac(1), head(1), tail(1), more(1), less(1)", "caomengxuan666",
-                 "Copyright © 2026 WinuxCmd", CAT_OPTIONS) {
-  using namespace cat_pipeline;
-  using namespace core::pipeline;
-
-  const bool fast_passthrough =
-      !ctx.get<bool>("--show-all", false) &&
-      !ctx.get<bool>("--number-nonblank", false) &&
-      !ctx.get<bool>("-b", false) &&
-      !ctx.get<bool>("--show-ends", false) &&
-      !ctx.get<bool>("-E", false) &&
-      !ctx.get<bool>("--number", false) &&
-      !ctx.get<bool>("-n", false) &&
-      !ctx.get<bool>("--squeeze-blank", false) &&
-      !ctx.get<bool>("-s", false) &&
-      !ctx.get<bool>("--show-tabs", false) &&
-      !ctx.get<bool>("-T", false) &&
-      !ctx.get<bool>("--show-nonprinting", false) &&
-      !ctx.get<bool>("-v", false) &&
-      !ctx.get<bool>("-e", false) &&
-      !ctx.get<bool>("-t", false);
+auto open_input(std::string_view path) -> HANDLE {
+  return CreateFileW(utf8_to_wstring(std::string(path)).c_str(), GENERIC_READ,
+                     FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                     nullptr, OPEN_EXISTING,
+                     FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                     nullptr);
+}
 
-  // ----------------------------------------------
-  // Empty line check (unchanged)
-  // ----------------------------------------------
-  auto is_empty_line = [](const std::string &line) -> bool {
-    return line.empty() ||
-           (line.size() == 1 && isspace(static_cast<unsigned char>(line[0])));
-  };
+/// Standard input that can be read with ReadFile, rather than through a
+/// pipeline channel or the console's line editing.
+auto stdin_read_handle() -> HANDLE {
+  if (thread_stdin_channel() != nullptr) return nullptr;
+  HANDLE handle = thread_stdin_handle();
+  if (handle == nullptr || handle == INVALID_HANDLE_VALUE ||
+      GetFileType(handle) == FILE_TYPE_CHAR) {
+    return nullptr;
+  }
+  return handle;
+}
 
-  // ----------------------------------------------
-  // Process character - FULLY OPTIMIZED, NO wstring!
-  // ----------------------------------------------
-  auto process_character = [&](unsigned char c,
-                               const CommandContext<CAT_OPTIONS.size()> &ctx) {
-    bool show_nonprinting = ctx.get<bool>("--show-nonprinting", false) ||
-                            ctx.get<bool>("--show-all", false) ||
-                            ctx.get<bool>("-e", false) ||
-                            ctx.get<bool>("-t", false);
-    bool show_ends = ctx.get<bool>("--show-ends", false) ||
-                     ctx.get<bool>("--show-all", false) ||
-                     ctx.get<bool>("-e", false);
-    bool show_tabs = ctx.get<bool>("--show-tabs", false) ||
-                     ctx.get<bool>("--show-all", false) ||
-                     ctx.get<bool>("-t", false);
-
-    if (show_nonprinting) {
-      if (c < 0x20) {
-        // Control characters
-        if (c == '\n') {
-          safePrint("\n");
-        } else if (c == '\t') {
-          if (show_tabs)
-            safePrint("^I");
-          else
-            safePrint("\t");
-        } else if (c == '\f') {
-          safePrint("^L");
-        } else {
-          // ^A, ^B, ..., ^Z - NO wstring!
-          safePrint('^');
-          safePrint(static_cast<char>(c + 0x40));
+/**
+ * @brief Copy INPUT to standard output unchanged.
+ *
+ * Double buffered: a reader thread fills one 1 MiB block while the calling
+ * thread writes the other, so a file-to-file copy keeps both disks busy.
+ * Blocks this large bypass the stdout buffer and go to WriteFile directly.
+ * Only the calling thread writes, as standard output is bound per thread.
+ *
+ * @return false when reading failed
+ */
+auto copy_handle(HANDLE input) -> bool {
+  std::array<std::vector<char>, 2> blocks{std::vector<char>(kCopyBlock),
+                                          std::vector<char>(kCopyBlock)};
+  std::array<DWORD, 2> lengths{};
+  std::counting_semaphore<2> free_blocks(2);
+  std::counting_semaphore<2> full_blocks(0);
+  std::atomic<bool> stop{false};
+  bool read_failed = false;
+
+  std::jthread reader([&] {
+    for (size_t i = 0;; i ^= 1) {
+      free_blocks.acquire();
+      if (stop.load()) return;
+      DWORD got = 0;
+      if (!ReadFile(input, blocks[i].data(), static_cast<DWORD>(kCopyBlock),
+                    &got, nullptr)) {
+        const DWORD err = GetLastError();
+        if (err != ERROR_BROKEN_PIPE && err != ERROR_OPERATION_ABORTED) {
+          read_failed = true;
         }
-      } else if (c == 0x7F) {
-        // DEL
-        safePrint("^?");
-      } else if (c >= 0x80) {
-        // M-x notation - NO wstring!
-        safePrint('M');
-        safePrint('-');
-        safePrint(static_cast<char>(c - 0x80));
-      } else {
-        // Printable ASCII
-        safePrint(static_cast<char>(c));
+        got = 0;
       }
-    } else if (show_tabs && c == '\t') {
-      safePrint("^I");
-    } else {
-      // Normal output
-      safePrint(static_cast<char>(c));
+      lengths[i] = got;
+      full_blocks.release();
+      if (got == 0) return;
     }
-  };
+  });
 
-  // ----------------------------------------------
-  // Process line - OPTIMIZED: snprintf instead of wostringstream
-  // ----------------------------------------------
-  auto process_line = [&](std::string &line,
-                          const CommandContext<CAT_OPTIONS.size()> &ctx,
-                          size_t &line_num) {
-    // Remove Windows line endings
-    if (!line.empty() && line.back() == '\r') {
-      line.pop_back();
+  for (size_t i = 0;; i ^= 1) {
+    full_blocks.acquire();
+    if (lengths[i] == 0) break;
+    safePrint(std::string_view(blocks[i].data(), lengths[i]));
+    if (is_stdout_pipe_closed()) {
+      // Nobody reads the output any more; unblock a reader waiting on a pipe.
+      stop.store(true);
+      free_blocks.release();
+      CancelSynchronousIo(reader.native_handle());
+      break;
     }
+    free_blocks.release();
+  }
+  reader.join();
+  return !read_failed;
+}
 
-    bool empty = is_empty_line(line);
+/// Plain copy of a stream that has no handle to read from.
+auto copy_stream(std::istream &in) -> void {
+  std::vector<char> buffer(kCopyBlock);
+  while (in.good() && !is_stdout_pipe_closed()) {
+    in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    auto got = in.gcount();
+    if (got <= 0) break;
+    safePrint(std::string_view(buffer.data(), static_cast<size_t>(got)));
+  }
+}
 
-    bool number_lines = ctx.get<bool>("--number", false);
-    bool number_nonblank = ctx.get<bool>("--number-nonblank", false);
-    bool show_ends = ctx.get<bool>("--show-ends", false) ||
-                     ctx.get<bool>("--show-all", false) ||
-                     ctx.get<bool>("-e", false);
+/**
+ * Offset of the first byte at or after FROM that -v or -T has to render
+ * differently, or LINE.size(). With -v those are controls and bytes from
+ * DEL up; 16 bytes are classified at once.
+ */
+auto find_special(std::string_view line, size_t from,
+                  const FormatOptions &opts) -> size_t {
+  if (!opts.show_nonprinting) {
+    const size_t tab = line.find('\t', from);
+    return tab == std::string_view::npos ? line.size() : tab;
+  }
+  const auto *data = reinterpret_cast<const unsigned char *>(line.data());
+  size_t i = from;
+#ifdef WINUX_CAT_SSE2
+  const __m128i below_space = _mm_set1_epi8(0x1F);
+  const __m128i del = _mm_set1_epi8(0x7F);
+  for (; i + 16 <= line.size(); i += 16) {
+    const __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+    const __m128i control =
+        _mm_cmpeq_epi8(_mm_min_epu8(chunk, below_space), chunk);
+    const __m128i high = _mm_cmpeq_epi8(_mm_max_epu8(chunk, del), chunk);
+    const auto mask = static_cast<unsigned>(
+        _mm_movemask_epi8(_mm_or_si128(control, high)));
+    if (mask != 0) return i + static_cast<size_t>(std::countr_zero(mask));
+  }
+#endif
+  for (; i < line.size(); ++i) {
+    if (data[i] < 0x20 || data[i] >= 0x7F) return i;
+  }
+  return line.size();
+}
 
-    // OPTIMIZED: snprintf instead of wostringstream
-    if (number_lines && !number_nonblank) {
-      char buf[32];
-      int len = snprintf(buf, sizeof(buf), "%6zu ", line_num++);
-      safePrint(std::string_view(buf, len));
-    } else if (number_nonblank && !empty) {
-      char buf[32];
-      int len = snprintf(buf, sizeof(buf), "%6zu ", line_num++);
-      safePrint(std::string_view(buf, len));
-    }
+auto render_special(unsigned char c, const FormatOptions &opts,
+                    std::string &out) -> void {
+  if (c == '\t') {
+    out += opts.show_tabs ? "^I" : "\t";
+  } else if (c < 0x20) {
+    out += '^';
+    out += static_cast<char>(c + 0x40);
+  } else if (c == 0x7F) {
+    out += "^?";
+  } else {
+    out += "M-";
+    out += static_cast<char>(c - 0x80);
+  }
+}
 
-    // Output content
-    for (char ch : line) {
-      process_character(static_cast<unsigned char>(ch), ctx);
-    }
+auto is_empty_line(std::string_view line) -> bool {
+  return line.empty() ||
+         (line.size() == 1 && std::isspace(static_cast<unsigned char>(line[0])));
+}
 
-    if (show_ends) safePrint("$");
-    safePrint("\n");
-  };
+/**
+ * @brief Applies -n/-b/-s/-E/-T/-v to the lines of one input.
+ *
+ * Lines come from a LineReader as views into its blocks; runs of bytes
+ * that need no rendering are copied as whole slices into the output block.
+ */
+class Formatter {
+ public:
+  Formatter(const FormatOptions &opts, size_t &line_num)
+      : opts_(opts), line_num_(line_num) {
+    out_.reserve(kOutputFlush + 256);
+  }
+  ~Formatter() { flush(); }
 
-  // ----------------------------------------------
-  // Process stream (unchanged)
-  // ----------------------------------------------
-  auto process_stream = [&](std::istream &stream,
-                            const CommandContext<CAT_OPTIONS.size()> &ctx,
-                            size_t &line_num) {
-    if (fast_passthrough) {
-      std::array<char, 8192> buffer{};
-      while (stream.good()) {
-        stream.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
-        auto got = stream.gcount();
-        if (got <= 0) break;
-        safePrint(std::string_view(buffer.data(), static_cast<size_t>(got)));
+  void format(LineReader &reader) {
+    std::string_view line;
+    bool last_line_empty = false;
+    while (reader.next(line)) {
+      const bool empty = is_empty_line(line);
+      if (opts_.squeeze_blank && empty && last_line_empty) continue;
+      last_line_empty = empty;
+      write_line(line, empty);
+      if (out_.size() >= kOutputFlush) {
+        flush();
+        // Downstream (for example `head`) may close the pipe early.
         if (is_stdout_pipe_closed()) break;
       }
-      return;
     }
+  }
 
-    std::string line;
-    bool last_line_empty = false;
-    bool squeeze_blank = ctx.get<bool>("--squeeze-blank", false);
+  void flush() {
+    if (out_.empty()) return;
+    safePrint(out_);
+    out_.clear();
+  }
 
-    while (std::getline(stream, line)) {
-      bool empty = is_empty_line(line);
+ private:
+  static constexpr size_t kOutputFlush = 64 * 1024;
 
-      if (squeeze_blank && empty && last_line_empty) {
-        continue;
-      }
+  const FormatOptions &opts_;
+  size_t &line_num_;
+  std::string out_;
 
-      last_line_empty = empty;
-      process_line(line, ctx, line_num);
+  void write_line(std::string_view line, bool empty) {
+    if ((opts_.number && !opts_.number_nonblank) ||
+        (opts_.number_nonblank && !empty)) {
+      char buf[32];
+      int len = snprintf(buf, sizeof(buf), "%6zu ", line_num_++);
+      out_.append(buf, static_cast<size_t>(len));
+    }
 
-      // Downstream (for example `head`) may close the pipe early.
-      // Stop reading immediately instead of scanning the rest of huge inputs.
-      if (is_stdout_pipe_closed()) {
-        break;
+    if (!opts_.show_tabs && !opts_.show_nonprinting) {
+      out_.append(line);
+    } else {
+      size_t pos = 0;
+      while (pos < line.size()) {
+        const size_t special = find_special(line, pos, opts_);
+        out_.append(line.substr(pos, special - pos));
+        if (special == line.size()) break;
+        render_special(static_cast<unsigned char>(line[special]), opts_, out_);
+        pos = special + 1;
       }
     }
+
+    if (opts_.show_ends) out_ += '$';
+    out_ += '\n';
+  }
+};
+
+}  // namespace cat_pipeline
+
+REGISTER_COMMAND(cat, "cat",
+                 "concatenate files and print on the standard output",
+                 "Concatenate FILE(s) to standard output.\n"
+                 "With no FILE, or when FILE is -, read standard input.\n"
+                 "\nExamples:\n"
+                 "  cat f g  Output f's contents, then g's contents.\n"
+                 "  cat      Copy standard input to standard output.",
+                 "  cat file.txt              Display contents of file.txt\n"
+                 "  cat -n file.txt           Number all output lines\n"
+                 "  cat file1.txt file2.txt   Concatenate multiple files\n"
+                 "  cat                       Read from standard input",
+                 "tac(1), head(1), tail(1), more(1), less(1)", "caomengxuan666",
+                 "Copyright © 2026 WinuxCmd", CAT_OPTIONS) {
+  using namespace cat_pipeline;
+  using namespace core::pipeline;
+
+  const FormatOptions opts = build_format_options(ctx);
+
+  auto report_missing = [](std::string_view path) {
+    safeErrorPrint("cat: '");
+    safeErrorPrint(path);
+    safeErrorPrint("': No such file or directory");
+    safeErrorPrint("\n");
+  };
+  auto report_read_error = [](std::string_view path) {
+    safeErrorPrint("cat: error reading '");
+    safeErrorPrint(path);
+    safeErrorPrint("'");
+    safeErrorPrint("\n");
   };
 
-  // ----------------------------------------------
-  // Process file - OPTIMIZED: NO wstring error messages!
-  // ----------------------------------------------
-  auto process_file = [&](std::string_view path,
-                          const CommandContext<CAT_OPTIONS.size()> &ctx,
-                          size_t &line_num) -> bool {
+  auto copy_file = [&](std::string_view path) -> bool {
     if (path == "-") {
-      process_stream(std::cin, ctx, line_num);
-      return true;
+      if (HANDLE handle = stdin_read_handle()) return copy_handle(handle);
+      copy_stream(stdin_stream());
+      return !stdin_stream().bad();
     }
-
-    std::ifstream file(std::string(path), std::ios::binary);
-
-    if (!file.is_open()) {
-      // OPTIMIZED: No wstring concatenation!
-      safeErrorPrint("cat: '");
-      safeErrorPrint(path);
-      safeErrorPrint("': No such file or directory");
-      safeErrorPrint("\n");
+    HANDLE handle = open_input(path);
+    if (handle == INVALID_HANDLE_VALUE) {
+      report_missing(path);
       return false;
     }
+    const bool ok = copy_handle(handle);
+    CloseHandle(handle);
+    if (!ok) report_read_error(path);
+    return ok;
+  };
 
-    process_stream(file, ctx, line_num);
+  auto format_file = [&](std::string_view path, size_t &line_num) -> bool {
+    LineReaderOptions reader_options;
+    reader_options.strip_cr = true;  // Windows line endings
+    reader_options.decode_text = false;
+    std::ifstream file;
+    std::optional<LineReader> reader;
+    if (path == "-") {
+      reader.emplace(LineReader::for_stdin(reader_options));
+    } else {
+      file.open(std::string(path), std::ios::binary);
+      if (!file.is_open()) {
+        report_missing(path);
+        return false;
+      }
+      reader.emplace(file, reader_options);
+    }
 
-    if (file.bad()) {
-      safeErrorPrint("cat: error reading '");
-      safeErrorPrint(path);
-      safeErrorPrint("'");
-      safeErrorPrint("\n");
+    Formatter(opts, line_num).format(*reader);
+    if (reader->failed()) {
+      report_read_error(path);
       return false;
     }
-
     return true;
   };
 
@@ -349,9 +458,9 @@ REGISTER_COMMAND(cat, "cat",
     if (is_stdout_pipe_closed()) {
       break;
     }
-    if (!process_file(file, ctx, line_num)) {
-      exit_code = 1;
-    }
+    const bool ok =
+        opts.plain() ? copy_file(file) : format_file(file, line_num);
+    if (!ok) exit_code = 1;
   }
 
   return exit_code;
@@ -117,61 +117,44 @@ auto build_config(const CommandContext<CMP_OPTIONS.size()>& ctx)
   return cfg;
 }
 
+auto open_input(const std::string& file, const Config& cfg)
+    -> std::optional<MappedFile> {
+  auto input = file == "-" ? MappedFile::from_stdin(AccessHint::Sequential)
+                           : MappedFile::open(file, AccessHint::Sequential);
+  if (!input) {
+    if (!cfg.quiet) {
+      auto err = std::string("cmp: ") + file + ": No such file";
+      cp::Result<int> result = std::unexpected(std::string_view(err));
+      cp::report_error(result, L"cmp");
+    }
+    return std::nullopt;
+  }
+  return std::move(*input);
+}
+
+auto without_bom(const std::string& file, std::string_view data)
+    -> std::string_view {
+  // Skip UTF-8 BOM if present at the beginning
+  if (file != "-" && data.size() >= 3 &&
+      static_cast<unsigned char>(data[0]) == 0xEF &&
+      static_cast<unsigned char>(data[1]) == 0xBB &&
+      static_cast<unsigned char>(data[2]) == 0xBF) {
+    data.remove_prefix(3);
+  }
+  return data;
+}
+
 auto run(const Config& cfg) -> int {
   const std::string& file1 = cfg.files[0];
   const std::string& file2 = cfg.files[1];
 
-  // Read file 1
-  std::vector<char> data1;
-  if (file1 == "-") {
-    data1.assign(std::istreambuf_iterator<char>(std::cin),
-                std::istreambuf_iterator<char>());
-  } else {
-    std::ifstream f1(file1, std::ios::binary);
-    if (!f1) {
-      if (!cfg.quiet) {
-        auto err = std::string("cmp: ") + file1 + ": No such file";
-        cp::Result<int> result = std::unexpected(std::string_view(err));
-        cp::report_error(result, L"cmp");
-      }
-      return 2;
-    }
-    data1.assign(std::istreambuf_iterator<char>(f1),
-                std::istreambuf_iterator<char>());
-    // Skip UTF-8 BOM if present at the beginning
-    if (data1.size() >= 3 &&
-        static_cast<unsigned char>(data1[0]) == 0xEF &&
-        static_cast<unsigned char>(data1[1]) == 0xBB &&
-        static_cast<unsigned char>(data1[2]) == 0xBF) {
-      data1.assign(data1.begin() + 3, data1.end());
-    }
-  }
+  auto file_a = open_input(file1, cfg);
+  if (!file_a) return 2;
+  auto file_b = open_input(file2, cfg);
+  if (!file_b) return 2;
 
-  // Read file 2
-  std::vector<char> data2;
-  if (file2 == "-") {
-    data2.assign(std::istreambuf_iterator<char>(std::cin),
-                std::istreambuf_iterator<char>());
-  } else {
-    std::ifstream f2(file2, std::ios::binary);
-    if (!f2) {
-      if (!cfg.quiet) {
-        auto err = std::string("cmp: ") + file2 + ": No such file";
-        cp::Result<int> result = std::unexpected(std::string_view(err));
-        cp::report_error(result, L"cmp");
-      }
-      return 2;
-    }
-    data2.assign(std::istreambuf_iterator<char>(f2),
-                std::istreambuf_iterator<char>());
-    // Skip UTF-8 BOM if present at the beginning
-    if (data2.size() >= 3 &&
-        static_cast<unsigned char>(data2[0]) == 0xEF &&
-        static_cast<unsigned char>(data2[1]) == 0xBB &&
-        static_cast<unsigned char>(data2[2]) == 0xBF) {
-      data2.assign(data2.begin() + 3, data2.end());
-    }
-  }
+  const std::string_view data1 = without_bom(file1, file_a->view());
+  const std::string_view data2 = without_bom(file2, file_b->view());
 
   // Skip initial bytes
   size_t start_pos = cfg.skip_bytes;
@@ -180,45 +163,47 @@ auto run(const Config& cfg) -> int {
   }
 
   // Compare up to max_bytes
-  size_t bytes_to_compare = std::min(cfg.max_bytes, std::min(data1.size(), data2.size()) - start_pos);
-
-  for (size_t i = 0; i < bytes_to_compare; ++i) {
-    size_t pos = start_pos + i;
-    if (pos >= data1.size() || pos >= data2.size()) {
-      break;
-    }
+  const size_t common = std::min(data1.size(), data2.size());
+  const size_t bytes_to_compare =
+      start_pos < common ? std::min(cfg.max_bytes, common - start_pos) : 0;
 
-    unsigned char c1 = static_cast<unsigned char>(data1[pos]);
-    unsigned char c2 = static_cast<unsigned char>(data2[pos]);
+  // std::mismatch over the mapped bytes finds the first difference without
+  // a per-byte bounds check.
+  const auto [diff1, diff2] =
+      std::mismatch(data1.begin() + start_pos,
+                    data1.begin() + start_pos + bytes_to_compare,
+                    data2.begin() + start_pos);
+  if (diff1 != data1.begin() + start_pos + bytes_to_compare) {
+    const size_t pos = static_cast<size_t>(diff1 - data1.begin());
+    unsigned char c1 = static_cast<unsigned char>(*diff1);
+    unsigned char c2 = static_cast<unsigned char>(*diff2);
 
-    if (c1 != c2) {
-      // Files differ
-      if (cfg.quiet) {
-        return 1;
-      }
-
-      if (cfg.verbose) {
-        safePrint(file1);
-        safePrint(" ");
-        safePrint(file2);
-        safePrint(" differ: byte ");
-        safePrintLn(std::to_string(pos + 1));
-      }
+    // Files differ
+    if (cfg.quiet) {
+      return 1;
+    }
 
-      if (cfg.print_bytes) {
-        char buf[64];
-        snprintf(buf, sizeof(buf), "%zu %3o %3o", pos + 1, c1, c2);
-        safePrintLn(buf);
-      } else {
-        safePrint(file1);
-        safePrint(" ");
-        safePrint(file2);
-        safePrint(" differ: byte ");
-        safePrintLn(std::to_string(pos + 1));
-      }
+    if (cfg.verbose) {
+      safePrint(file1);
+      safePrint(" ");
+      safePrint(file2);
+      safePrint(" differ: byte ");
+      safePrintLn(std::to_string(pos + 1));
+    }
 
-      return 1;
+    if (cfg.print_bytes) {
+      char buf[64];
+      snprintf(buf, sizeof(buf), "%zu %3o %3o", pos + 1, c1, c2);
+      safePrintLn(buf);
+    } else {
+      safePrint(file1);
+      safePrint(" ");
+      safePrint(file2);
+      safePrint(" differ: byte ");
+      safePrintLn(std::to_string(pos + 1));
     }
+
+    return 1;
   }
 
   // Check if one file is longer
@@ -127,11 +127,11 @@ auto read_input(const std::string& filename) -> cp::Result<std::string> {
   if (filename == "-" || filename.empty()) {
     // Read from stdin
     std::string line;
-    while (std::getline(std::cin, line)) {
+    while (std::getline(stdin_stream(), line)) {
       content += line;
       content += '\n';
     }
-    if (std::cin.bad() && !std::cin.eof()) {
+    if (stdin_stream().bad() && !stdin_stream().eof()) {
       return std::unexpected("error reading from standard input");
     }
   } else {
@@ -244,7 +244,7 @@ auto copy_file(const std::string& srcPath, const std::string& destPath,
       safeErrorPrint(destPath);
       safeErrorPrint("'? (y/n) ");
       char response;
-      std::cin.get(response);
+      stdin_stream().get(response);
       if (response != 'y' && response != 'Y') {
         return true;
       }
@@ -200,7 +200,7 @@ auto build_config(const CommandContext<CPIO_OPTIONS.size()>& ctx) -> cp::Result<
 auto run(const Config& cfg) -> int {
   // Read input (file list or archive)
   std::string input;
-  input.assign(std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>());
+  input.assign(std::istreambuf_iterator<char>(stdin_stream()), std::istreambuf_iterator<char>());
   
   if (cfg.create) {
     // Create archive
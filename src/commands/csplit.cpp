@@ -138,7 +138,7 @@ auto read_lines(const std::string& filename) -> cp::Result<SmallVector<std::stri
 
   if (filename == "-") {
     std::string line;
-    while (std::getline(std::cin, line)) {
+    while (std::getline(stdin_stream(), line)) {
       lines.push_back(line);
     }
   } else {
@@ -167,24 +167,30 @@ auto read_lines(const std::string& filename) -> cp::Result<SmallVector<std::stri
   return lines;
 }
 
-auto match_pattern(const std::string& line, const std::string& pattern) -> bool {
+// Compiles the BRE of a "/REGEX/[OFFSET]" pattern; other patterns yield none.
+auto compile_split_regex(const std::string& pattern)
+    -> cp::Result<std::optional<Regex>> {
+  if (pattern.empty() || pattern[0] != '/') return std::optional<Regex>{};
+  size_t close = pattern.rfind('/');
+  if (close == 0) return std::unexpected("missing closing '/' in pattern");
+  auto re = Regex::compile(std::string_view(pattern).substr(1, close - 1));
+  if (!re) return std::unexpected(re.error());
+  return std::optional<Regex>(std::move(*re));
+}
+
+auto match_pattern(const std::string& line, const std::string& pattern,
+                   const std::optional<Regex>& regex) -> bool {
   // Simple pattern matching (supports exact match and wildcards)
   if (pattern.empty()) return false;
+  if (regex) return regex->search(line);
   
   // Check if pattern is a number (line number)
   try {
     int line_num = std::stoi(pattern);
     return false;  // Line number matching not implemented
   } catch (...) {
-    // String pattern
-    if (pattern[0] == '/') {
-      // Regex pattern (not fully implemented)
-      std::string search_pattern = pattern.substr(1, pattern.size() - 1);
-      return line.find(search_pattern) != std::string::npos;
-    } else {
-      // Exact match
-      return line == pattern;
-    }
+    // String pattern: exact match
+    return line == pattern;
   }
 }
 
@@ -206,9 +212,14 @@ auto run(const Config& cfg) -> int {
   for (size_t i = 0; i < cfg.patterns.size(); ++i) {
     const auto& pattern = cfg.patterns[i];
     bool pattern_found = false;
-    
+    auto regex = compile_split_regex(pattern);
+    if (!regex) {
+      cp::report_error(regex, L"csplit");
+      return 1;
+    }
+
     for (size_t line_idx = current_start; line_idx < lines.size(); ++line_idx) {
-      if (match_pattern(lines[line_idx], pattern)) {
+      if (match_pattern(lines[line_idx], pattern, *regex)) {
         // Found pattern, split here
         file_ranges.back().push_back(line_idx);
         file_ranges.push_back({});
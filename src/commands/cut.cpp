@@ -107,31 +107,17 @@ auto is_selected(int index, const std::vector<Range>& ranges) -> bool {
   return false;
 }
 
-auto split_records(std::string_view content, char record_delim)
-    -> std::vector<std::string> {
-  std::vector<std::string> out;
-  size_t start = 0;
-  for (size_t i = 0; i < content.size(); ++i) {
-    if (content[i] == record_delim) {
-      out.emplace_back(content.substr(start, i - start));
-      start = i + 1;
-    }
-  }
-  if (start < content.size()) out.emplace_back(content.substr(start));
-  return out;
-}
-
-auto read_source(std::string_view path) -> cp::Result<std::string> {
-  if (path == "-") {
-    return std::string(std::istreambuf_iterator<char>(std::cin),
-                       std::istreambuf_iterator<char>());
-  }
-  std::ifstream in(std::string(path), std::ios::binary);
-  if (!in.is_open()) {
+auto open_reader(std::string_view path, std::ifstream& file, char delimiter)
+    -> cp::Result<LineReader> {
+  LineReaderOptions options;
+  options.delimiter = delimiter;
+  if (path == "-") return LineReader::for_stdin(options);
+
+  file.open(std::string(path), std::ios::binary);
+  if (!file.is_open()) {
     return std::unexpected("cannot open '" + std::string(path) + "'");
   }
-  return std::string(std::istreambuf_iterator<char>(in),
-                     std::istreambuf_iterator<char>());
+  return LineReader(file, options);
 }
 
 auto is_unsupported_used(const CommandContext<CUT_OPTIONS.size()>& ctx)
@@ -209,30 +195,20 @@ auto cut_line(std::string_view line, const Config& cfg) -> std::string {
   return out;
 }
 
-  auto run_file(const std::string& path, const Config& cfg) -> int {
-  auto content = read_source(path);
-  if (!content) {
-    cp::report_error(content, L"cut");
+auto run_file(const std::string& path, const Config& cfg) -> int {
+  const char record_delim = cfg.zero_terminated ? '\0' : '\n';
+  std::ifstream file;
+  auto reader = open_reader(path, file, record_delim);
+  if (!reader) {
+    cp::report_error(reader, L"cut");
     return 1;
   }
 
-  char record_delim = cfg.zero_terminated ? '\0' : '\n';
-
-  std::vector<std::string> records;
-  size_t start = 0;
-  for (size_t i = 0; i < content->size(); ++i) {
-    if ((*content)[i] == record_delim) {
-      records.push_back(content->substr(start, i - start));
-      start = i + 1;
-    }
-  }
-  if (start < content->size()) {
-    records.push_back(content->substr(start));
-  }
-
-  for (const auto& rec : records) {
+  std::string_view rec;
+  while (reader->next(rec)) {
     auto out = cut_line(rec, cfg);
-    if (out.empty() && cfg.only_delimited && rec.find(cfg.delimiter) == std::string::npos) {
+    if (out.empty() && cfg.only_delimited &&
+        rec.find(cfg.delimiter) == std::string_view::npos) {
       continue;
     }
     safePrint(out);
@@ -241,6 +217,7 @@ auto cut_line(std::string_view line, const Config& cfg) -> std::string {
     } else {
       safePrint("\n");
     }
+    if (is_stdout_pipe_closed()) break;
   }
   return 0;
 }
@@ -13,6 +13,38 @@ auto constexpr DD_OPTIONS = std::array{OPTION("if", "", "input file", STRING_TYP
                                                 OPTION("bs", "", "block size", STRING_TYPE),
                                                 OPTION("count", "", "copy N blocks", STRING_TYPE)};
 
+namespace {
+
+// ReadFile/WriteFile take a DWORD length, so block sizes of 4 GiB and more
+// are transferred in pieces instead of being truncated by a cast.
+constexpr size_t kMaxIoChunk = 1U << 30;
+
+auto read_block(HANDLE handle, char* buffer, size_t size) -> size_t {
+  size_t total = 0;
+  while (total < size) {
+    DWORD got = 0;
+    const DWORD want = static_cast<DWORD>(std::min(size - total, kMaxIoChunk));
+    if (!ReadFile(handle, buffer + total, want, &got, nullptr) || got == 0) break;
+    total += got;
+    // Like dd, a short read from a pipe ends the block.
+    if (got < want) break;
+  }
+  return total;
+}
+
+auto write_block(HANDLE handle, const char* buffer, size_t size) -> size_t {
+  size_t total = 0;
+  while (total < size) {
+    DWORD written = 0;
+    const DWORD want = static_cast<DWORD>(std::min(size - total, kMaxIoChunk));
+    if (!WriteFile(handle, buffer + total, want, &written, nullptr) || written == 0) break;
+    total += written;
+  }
+  return total;
+}
+
+}  // namespace
+
 REGISTER_COMMAND(
     dd,
     /* name */
@@ -89,13 +121,12 @@ REGISTER_COMMAND(
   }
   
   std::vector<char> buffer(block_size);
-  DWORD bytesRead;
   size_t blocks_copied = 0;
   size_t bytes_copied = 0;
   
-  while (ReadFile(hIn, buffer.data(), static_cast<DWORD>(block_size), &bytesRead, nullptr) && bytesRead > 0) {
-    DWORD bytesWritten;
-    WriteFile(hOut, buffer.data(), bytesRead, &bytesWritten, nullptr);
+  size_t bytesRead = 0;
+  while ((bytesRead = read_block(hIn, buffer.data(), block_size)) > 0) {
+    const size_t bytesWritten = write_block(hOut, buffer.data(), bytesRead);
     blocks_copied++;
     bytes_copied += bytesWritten;
     
@@ -116,7 +116,7 @@ DOS2UNIX_OPTIONS) {
     // Read from stdin, write to stdout
     std::string line;
     bool first = true;
-    while (std::getline(std::cin, line)) {
+    while (std::getline(stdin_stream(), line)) {
       // Remove trailing \r if present
       if (!line.empty() && line.back() == '\r') {
         line.pop_back();
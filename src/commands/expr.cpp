@@ -108,6 +108,24 @@ auto evaluate_expr(std::span<const std::string_view> args) -> std::expected<long
   }
 }
 
+// STRING : REGEX - the BRE is anchored at the start of STRING. Yields \1
+// when the pattern has a group, otherwise the number of bytes matched.
+auto evaluate_match(std::string_view str, std::string_view pattern)
+    -> std::expected<std::string, std::string> {
+  RegexOptions opts;
+  opts.captures = true;
+  auto re = Regex::compile(pattern, opts);
+  if (!re) return std::unexpected("expr: " + std::string(re.error()));
+
+  std::vector<RegexMatch> groups;
+  bool hit = re->find(str, 0, groups) && groups[0].begin == 0;
+  if (re->group_count() > 0) {
+    if (!hit || !groups[1].matched()) return std::string();
+    return std::string(str.substr(groups[1].begin, groups[1].size()));
+  }
+  return std::to_string(hit ? groups[0].size() : 0);
+}
+
 }  // namespace
 
 REGISTER_COMMAND(
@@ -126,19 +144,35 @@ REGISTER_COMMAND(
     "  *, /, %   Multiplication, division, modulus\n"
     "  <, <=, =, !=, >=, >  Comparison\n"
     "  &, |      Logical AND, OR\n"
+    "  STRING : REGEX, match STRING REGEX\n"
+    "            Anchored BRE match: \\1 if REGEX has a group, else the\n"
+    "            length of the match\n"
     "\n"
     "Note: This is a basic implementation supporting simple two-operand expressions.",
 "  expr 2 + 3\n"
     "  expr 5 \\* 10\n"
     "  expr 10 / 2\n"
     "  expr 5 % 3\n"
-    "  expr 2 \\\< 5",
+    "  expr 2 \\\< 5\n"
+    "  expr abc123 : '[a-z]*'",
 
     /* see also */
     "test(1), let(1)",
 "WinuxCmd",
 "Copyright © 2026 WinuxCmd",
 EXPR_OPTIONS) {
+  const auto& args = ctx.positionals;
+  if (args.size() == 3 && (args[1] == ":" || args[0] == "match")) {
+    auto matched = args[1] == ":" ? evaluate_match(args[0], args[2])
+                                  : evaluate_match(args[1], args[2]);
+    if (!matched) {
+      safeErrorPrintLn(matched.error());
+      return 2;
+    }
+    safePrintLn(*matched);
+    return matched->empty() || *matched == "0" ? 1 : 0;
+  }
+
   auto result = evaluate_expr(ctx.positionals);
   if (!result) {
     safeErrorPrintLn(result.error());
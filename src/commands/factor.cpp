@@ -100,7 +100,7 @@ FACTOR_OPTIONS) {
   if (ctx.positionals.empty()) {
     // Read from stdin
     std::string line;
-    while (std::getline(std::cin, line)) {
+    while (std::getline(stdin_stream(), line)) {
       try {
         numbers.push_back(std::stoll(line));
       } catch (...) {
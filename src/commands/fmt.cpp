@@ -134,7 +134,7 @@ auto read_input(const std::string& filename) -> cp::Result<std::string> {
   if (filename == "-") {
     // Read from stdin line by line (like cat and fold)
     std::string line;
-    while (std::getline(std::cin, line)) {
+    while (std::getline(stdin_stream(), line)) {
       content += line + "\n";
     }
   } else {
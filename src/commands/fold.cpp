@@ -169,7 +169,7 @@ auto run(const Config& cfg) -> int {
     if (file == "-") {
       // Read from stdin
       std::string line;
-      while (std::getline(std::cin, line)) {
+      while (std::getline(stdin_stream(), line)) {
         line += "\n";  // Preserve line ending
         auto folded = fold_line(line, cfg.width, cfg.count_bytes, cfg.break_at_spaces);
         safePrint(folded);
@@ -130,10 +130,11 @@ auto constexpr GREP_OPTIONS = std::array{
     OPTION("-q", "--quiet", "suppress all normal output"),
     OPTION("", "--silent", "suppress all normal output"),
     OPTION("", "--binary-files",
-           "assume that binary files are TYPE [NOT SUPPORT]", STRING_TYPE),
-    OPTION("-a", "--text", "equivalent to --binary-files=text [NOT SUPPORT]"),
-    OPTION("-I", "",
-           "equivalent to --binary-files=without-match [NOT SUPPORT]"),
+           "assume that binary files are TYPE; TYPE is 'binary', 'text', or "
+           "'without-match'",
+           STRING_TYPE),
+    OPTION("-a", "--text", "equivalent to --binary-files=text"),
+    OPTION("-I", "", "equivalent to --binary-files=without-match"),
     OPTION("-d", "--directories",
            "how to handle directories: read, recurse, skip", STRING_TYPE),
     OPTION("-D", "--devices",
@@ -170,13 +171,21 @@ auto constexpr GREP_OPTIONS = std::array{
     OPTION("", "--colour",
            "highlight matching strings; WHEN can be 'always', 'never', or 'auto'",
            STRING_TYPE),
-    OPTION("-U", "--binary", "do not strip CR at EOL")};
+    OPTION("-U", "--binary", "do not strip CR at EOL"),
+    OPTION("-j", "--threads",
+           "search files with NUM threads for -r (default: one per CPU)",
+           INT_TYPE),
+    OPTION("", "--unordered",
+           "with -r, print files as they finish instead of in walk order")};
 
 namespace grep_pipeline {
 namespace cp = core::pipeline;
 
 enum class PatternMode { BasicRegex, ExtendedRegex, Fixed };
 
+// --binary-files: what to do with input that contains NUL bytes
+enum class BinaryFiles { Binary, Text, WithoutMatch };
+
 struct MatchPiece {
   size_t begin = 0;
   size_t end = 0;
@@ -184,8 +193,15 @@ struct MatchPiece {
 
 struct Pattern {
   std::string raw;
-  std::string lowered;
-  std::optional<std::regex> regex;
+  std::optional<Regex> regex;
+};
+
+// Output of one input, buffered when files are searched in parallel
+struct FileResult {
+  std::string out;
+  std::string err;
+  bool any_selected = false;
+  bool error = false;
 };
 
 struct Config {
@@ -197,6 +213,7 @@ struct Config {
   bool no_messages = false;
   bool invert_match = false;
   int max_count = -1;
+  bool line_buffered = false;
   bool byte_offset = false;
   bool line_number = false;
   bool with_filename = false;
@@ -211,6 +228,8 @@ struct Config {
   bool null_after_filename = false;
   bool recursive = false;
   SmallVector<Pattern, 32> patterns;
+  // -F: every pattern compiled into one automaton
+  std::optional<LiteralSet> literals;
   SmallVector<std::string, 64> files;
   bool has_error = false;
   int before_context = 0;
@@ -221,17 +240,15 @@ struct Config {
   std::string group_separator = "--";
   bool no_group_separator = false;
   bool initial_tab = false;
+  BinaryFiles binary_files = BinaryFiles::Binary;
+  // Set per input: the current input was sniffed as binary
+  bool binary_input = false;
+  int threads = 0;  // -j; 0 means one per CPU
+  bool unordered = false;
+  // Set on a worker's copy: output is buffered here instead of printed
+  FileResult* capture = nullptr;
 };
 
-auto to_lower_ascii(std::string_view s) -> std::string {
-  std::string out;
-  out.reserve(s.size());
-  for (unsigned char c : s) {
-    out.push_back(static_cast<char>(std::tolower(c)));
-  }
-  return out;
-}
-
 auto split_lines(std::string_view s) -> std::vector<std::string> {
   std::vector<std::string> parts;
   parts.reserve(s.size() / 40);  // Reserve for ~40 chars per line
@@ -248,23 +265,6 @@ auto split_lines(std::string_view s) -> std::vector<std::string> {
   return parts;
 }
 
-auto split_records(std::string_view s, char delim)
-    -> std::vector<std::pair<size_t, size_t>> {
-  std::vector<std::pair<size_t, size_t>> out;
-  out.reserve(s.size() / 40);  // Reserve for ~40 chars per record
-  size_t start = 0;
-  for (size_t i = 0; i < s.size(); ++i) {
-    if (s[i] == delim) {
-      out.emplace_back(start, i + 1);
-      start = i + 1;
-    }
-  }
-  if (start < s.size()) {
-    out.emplace_back(start, s.size());
-  }
-  return out;
-}
-
 auto is_word_char(unsigned char c) -> bool {
   return std::isalnum(c) || c == '_';
 }
@@ -281,17 +281,16 @@ auto compile_pattern(PatternMode mode, bool ignore_case, std::string_view raw)
     -> cp::Result<Pattern> {
   Pattern p;
   p.raw = std::string(raw);
-  p.lowered = to_lower_ascii(raw);
 
   if (mode == PatternMode::Fixed) return p;
 
-  try {
-    auto flags = std::regex::ECMAScript;
-    if (ignore_case) flags |= std::regex::icase;
-    p.regex.emplace(p.raw, flags);
-  } catch (const std::regex_error&) {
-    return std::unexpected("invalid regular expression: " + std::string(raw));
-  }
+  RegexOptions opts;
+  opts.syntax = mode == PatternMode::ExtendedRegex ? RegexSyntax::Extended
+                                                   : RegexSyntax::Basic;
+  opts.icase = ignore_case;
+  auto re = Regex::compile(p.raw, opts);
+  if (!re) return std::unexpected(re.error());
+  p.regex.emplace(std::move(*re));
 
   return p;
 }
@@ -308,27 +307,22 @@ auto load_patterns_from_file(const std::string& path)
   return split_lines(buf);
 }
 
-auto is_unsupported_used(const CommandContext<GREP_OPTIONS.size()>& ctx)
+auto is_unsupported_used(const BoundCommandContext<GREP_OPTIONS>& ctx)
     -> std::optional<std::string> {
-  if (ctx.get<bool>("--perl-regexp", false) || ctx.get<bool>("-P", false))
+  if (ctx.get<"--perl-regexp">(false) || ctx.get<"-P">(false))
     return "--perl-regexp is [NOT SUPPORT]";
-  if (!ctx.get<std::string>("--binary-files", "").empty() ||
-      ctx.get<bool>("--text", false) || ctx.get<bool>("-a", false) ||
-      ctx.get<bool>("-I", false))
-    return "binary file mode options are [NOT SUPPORT]";
-  if (!ctx.get<std::string>("--devices", "").empty() ||
-      !ctx.get<std::string>("-D", "").empty())
+  if (!ctx.get<"--devices", std::string>("").empty() ||
+      !ctx.get<"-D", std::string>("").empty())
     return "--devices is [NOT SUPPORT]";
-  if (ctx.get<bool>("--dereference-recursive", false) ||
-      ctx.get<bool>("-R", false))
+  if (ctx.get<"--dereference-recursive">(false) || ctx.get<"-R">(false))
     return "--dereference-recursive is [NOT SUPPORT]";
-  if (!ctx.get<std::string>("--exclude-from", "").empty() ||
-      !ctx.get<std::string>("--exclude-dir", "").empty())
+  if (!ctx.get<"--exclude-from", std::string>("").empty() ||
+      !ctx.get<"--exclude-dir", std::string>("").empty())
     return "exclude-from/exclude-dir options are [NOT SUPPORT]";
   return std::nullopt;
 }
 
-auto build_config(const CommandContext<GREP_OPTIONS.size()>& ctx)
+auto build_config(const BoundCommandContext<GREP_OPTIONS>& ctx)
     -> cp::Result<Config> {
   Config cfg;
 
@@ -337,88 +331,91 @@ auto build_config(const CommandContext<GREP_OPTIONS.size()>& ctx)
   }
 
   cfg.mode = PatternMode::BasicRegex;
-  if (ctx.get<bool>("--fixed-strings", false) || ctx.get<bool>("-F", false))
+  if (ctx.get<"--fixed-strings">(false) || ctx.get<"-F">(false))
     cfg.mode = PatternMode::Fixed;
-  if (ctx.get<bool>("--extended-regexp", false) || ctx.get<bool>("-E", false))
+  if (ctx.get<"--extended-regexp">(false) || ctx.get<"-E">(false))
     cfg.mode = PatternMode::ExtendedRegex;
-  if (ctx.get<bool>("--basic-regexp", false) || ctx.get<bool>("-G", false))
+  if (ctx.get<"--basic-regexp">(false) || ctx.get<"-G">(false))
     cfg.mode = PatternMode::BasicRegex;
 
-  cfg.ignore_case =
-      ctx.get<bool>("--ignore-case", false) || ctx.get<bool>("-i", false);
-  if (ctx.get<bool>("--no-ignore-case", false)) cfg.ignore_case = false;
-
-  cfg.word_regexp =
-      ctx.get<bool>("--word-regexp", false) || ctx.get<bool>("-w", false);
-  cfg.line_regexp =
-      ctx.get<bool>("--line-regexp", false) || ctx.get<bool>("-x", false);
-  cfg.null_data =
-      ctx.get<bool>("--null-data", false) || ctx.get<bool>("-z", false);
-  cfg.no_messages =
-      ctx.get<bool>("--no-messages", false) || ctx.get<bool>("-s", false);
-  cfg.invert_match =
-      ctx.get<bool>("--invert-match", false) || ctx.get<bool>("-v", false);
-  cfg.max_count = ctx.get<int>("--max-count", -1);
-  if (cfg.max_count < 0) cfg.max_count = ctx.get<int>("-m", -1);
-  cfg.byte_offset =
-      ctx.get<bool>("--byte-offset", false) || ctx.get<bool>("-b", false);
-  cfg.line_number =
-      ctx.get<bool>("--line-number", false) || ctx.get<bool>("-n", false);
-  cfg.with_filename =
-      ctx.get<bool>("--with-filename", false) || ctx.get<bool>("-H", false);
-  cfg.no_filename =
-      ctx.get<bool>("--no-filename", false) || ctx.get<bool>("-h", false);
-  cfg.label = ctx.get<std::string>("--label", "");
-  cfg.only_matching =
-      ctx.get<bool>("--only-matching", false) || ctx.get<bool>("-o", false);
-  cfg.quiet = ctx.get<bool>("--quiet", false) ||
-              ctx.get<bool>("--silent", false) || ctx.get<bool>("-q", false);
-  cfg.files_without_match = ctx.get<bool>("--files-without-match", false) ||
-                            ctx.get<bool>("-L", false);
-  cfg.files_with_matches = ctx.get<bool>("--files-with-matches", false) ||
-                           ctx.get<bool>("-l", false);
-  cfg.count_only =
-      ctx.get<bool>("--count", false) || ctx.get<bool>("-c", false);
-  cfg.null_after_filename =
-      ctx.get<bool>("--null", false) || ctx.get<bool>("-Z", false);
-
-  cfg.recursive =
-      ctx.get<bool>("--recursive", false) || ctx.get<bool>("-r", false);
-  cfg.directories = ctx.get<std::string>("--directories", "");
-  if (cfg.directories.empty()) cfg.directories = ctx.get<std::string>("-d", "");
+  cfg.ignore_case = ctx.get<"--ignore-case">(false) || ctx.get<"-i">(false);
+  if (ctx.get<"--no-ignore-case">(false)) cfg.ignore_case = false;
+
+  cfg.word_regexp = ctx.get<"--word-regexp">(false) || ctx.get<"-w">(false);
+  cfg.line_regexp = ctx.get<"--line-regexp">(false) || ctx.get<"-x">(false);
+  cfg.null_data = ctx.get<"--null-data">(false) || ctx.get<"-z">(false);
+  cfg.no_messages = ctx.get<"--no-messages">(false) || ctx.get<"-s">(false);
+  cfg.invert_match = ctx.get<"--invert-match">(false) || ctx.get<"-v">(false);
+  cfg.max_count = ctx.get<"--max-count">(-1);
+  if (cfg.max_count < 0) cfg.max_count = ctx.get<"-m">(-1);
+  cfg.line_buffered = ctx.get<"--line-buffered">(false);
+  cfg.byte_offset = ctx.get<"--byte-offset">(false) || ctx.get<"-b">(false);
+  cfg.line_number = ctx.get<"--line-number">(false) || ctx.get<"-n">(false);
+  cfg.with_filename = ctx.get<"--with-filename">(false) || ctx.get<"-H">(false);
+  cfg.no_filename = ctx.get<"--no-filename">(false) || ctx.get<"-h">(false);
+  cfg.label = ctx.get<"--label", std::string>("");
+  cfg.only_matching = ctx.get<"--only-matching">(false) || ctx.get<"-o">(false);
+  cfg.quiet = ctx.get<"--quiet">(false) ||
+              ctx.get<"--silent">(false) || ctx.get<"-q">(false);
+  cfg.files_without_match = ctx.get<"--files-without-match">(false) ||
+                            ctx.get<"-L">(false);
+  cfg.files_with_matches = ctx.get<"--files-with-matches">(false) ||
+                           ctx.get<"-l">(false);
+  cfg.count_only = ctx.get<"--count">(false) || ctx.get<"-c">(false);
+  cfg.null_after_filename = ctx.get<"--null">(false) || ctx.get<"-Z">(false);
+
+  cfg.recursive = ctx.get<"--recursive">(false) || ctx.get<"-r">(false);
+  cfg.directories = ctx.get<"--directories", std::string>("");
+  if (cfg.directories.empty()) cfg.directories = ctx.get<"-d", std::string>("");
   if (cfg.directories.empty())
     cfg.directories = cfg.recursive ? "recurse" : "read";
 
-  cfg.before_context = ctx.get<int>("-B", 0);
-  cfg.after_context = ctx.get<int>("-A", 0);
-  int context = ctx.get<int>("-C", 0);
+  cfg.before_context = ctx.get<"-B">(0);
+  cfg.after_context = ctx.get<"-A">(0);
+  int context = ctx.get<"-C">(0);
   if (context > 0) {
     cfg.before_context = context;
     cfg.after_context = context;
   }
 
-  std::string color_opt = ctx.get<std::string>("--color", "");
-  if (color_opt.empty()) color_opt = ctx.get<std::string>("--colour", "");
+  std::string color_opt = ctx.get<"--color", std::string>("");
+  if (color_opt.empty()) color_opt = ctx.get<"--colour", std::string>("");
   cfg.color = (color_opt == "always" || color_opt == "auto");
 
-  cfg.include = ctx.get<std::string>("--include", "");
-  cfg.exclude = ctx.get<std::string>("--exclude", "");
+  cfg.include = ctx.get<"--include", std::string>("");
+  cfg.exclude = ctx.get<"--exclude", std::string>("");
+
+  cfg.group_separator = ctx.get<"--group-separator", std::string>("--");
+  cfg.no_group_separator = ctx.get<"--no-group-separator">(false);
+  cfg.initial_tab = ctx.get<"--initial-tab">(false) || ctx.get<"-T">(false);
+  std::string binary_files = ctx.get<"--binary-files", std::string>("");
+  if (binary_files.empty() || binary_files == "binary") {
+    cfg.binary_files = BinaryFiles::Binary;
+  } else if (binary_files == "text") {
+    cfg.binary_files = BinaryFiles::Text;
+  } else if (binary_files == "without-match") {
+    cfg.binary_files = BinaryFiles::WithoutMatch;
+  } else {
+    return std::unexpected("invalid argument for --binary-files");
+  }
+  if (ctx.get<"--text">(false) || ctx.get<"-a">(false))
+    cfg.binary_files = BinaryFiles::Text;
+  if (ctx.get<"-I">(false)) cfg.binary_files = BinaryFiles::WithoutMatch;
 
-  cfg.group_separator = ctx.get<std::string>("--group-separator", "--");
-  cfg.no_group_separator = ctx.get<bool>("--no-group-separator", false);
-  cfg.initial_tab =
-      ctx.get<bool>("--initial-tab", false) || ctx.get<bool>("-T", false);
+  cfg.threads = ctx.get<"--threads">(0);
+  if (cfg.threads <= 0) cfg.threads = ctx.get<"-j">(0);
+  cfg.unordered = ctx.get<"--unordered">(false);
 
   SmallVector<std::string, 32> raw_patterns;
-  std::string p_e = ctx.get<std::string>("--regexp", "");
-  if (p_e.empty()) p_e = ctx.get<std::string>("-e", "");
+  std::string p_e = ctx.get<"--regexp", std::string>("");
+  if (p_e.empty()) p_e = ctx.get<"-e", std::string>("");
   if (!p_e.empty()) {
     auto from_e = split_lines(p_e);
     for (const auto& p : from_e) raw_patterns.push_back(p);
   }
 
-  std::string p_file = ctx.get<std::string>("--file", "");
-  if (p_file.empty()) p_file = ctx.get<std::string>("-f", "");
+  std::string p_file = ctx.get<"--file", std::string>("");
+  if (p_file.empty()) p_file = ctx.get<"-f", std::string>("");
   if (!p_file.empty()) {
     auto file_patterns = load_patterns_from_file(p_file);
     if (!file_patterns) return std::unexpected(file_patterns.error());
@@ -446,6 +443,12 @@ auto build_config(const CommandContext<GREP_OPTIONS.size()>& ctx)
     if (!c) return std::unexpected(c.error());
     cfg.patterns.push_back(*c);
   }
+  if (cfg.mode == PatternMode::Fixed) {
+    std::vector<std::string> literals;
+    literals.reserve(cfg.patterns.size());
+    for (const auto& p : cfg.patterns) literals.push_back(p.raw);
+    cfg.literals.emplace(LiteralSet::compile(literals, cfg.ignore_case));
+  }
 
   for (const auto& p : positionals) cfg.files.push_back(std::string(p));
   if (cfg.files.empty()) {
@@ -471,62 +474,56 @@ auto record_name_for_output(std::string_view input_name, const Config& cfg)
 auto collect_matches_in_line(std::string_view line, const Config& cfg)
     -> std::vector<MatchPiece> {
   std::vector<MatchPiece> out;
-  std::string lowered_line;
-
-  for (const auto& p : cfg.patterns) {
-    if (cfg.mode == PatternMode::Fixed) {
-      if (cfg.line_regexp) {
-        bool eq = cfg.ignore_case ? (to_lower_ascii(line) == p.lowered)
-                                  : (line == p.raw);
-        if (eq) out.push_back(MatchPiece{0, line.size()});
-        continue;
-      }
 
-      size_t cursor = 0;
-      while (true) {
-        size_t pos = std::string_view::npos;
-        size_t len = 0;
-        if (cfg.ignore_case) {
-          if (lowered_line.empty() && !line.empty()) {
-            lowered_line = to_lower_ascii(line);
-          }
-          pos = lowered_line.find(p.lowered, cursor);
-          len = p.lowered.size();
-        } else {
-          pos = line.find(p.raw, cursor);
-          len = p.raw.size();
-        }
-
-        if (pos == std::string_view::npos) break;
-        MatchPiece m{pos, pos + len};
-        if (!cfg.word_regexp || word_boundary_ok(line, m.begin, m.end)) {
-          out.push_back(m);
+  if (cfg.literals) {
+    const auto& literals = *cfg.literals;
+    if (cfg.line_regexp) {
+      if (literals.full_match(line)) out.push_back(MatchPiece{0, line.size()});
+      return out;
+    }
+    size_t cursor = 0;
+    while (auto found = literals.find(line, cursor)) {
+      MatchPiece m{found->begin, found->end};
+      if (cfg.word_regexp && !word_boundary_ok(line, m.begin, m.end)) {
+        // A shorter pattern starting here may still be a whole word
+        m.end = m.begin;
+        literals.for_each_match_at(line, m.begin, [&](size_t end) {
+          if (word_boundary_ok(line, m.begin, end)) m.end = end;
+        });
+        if (m.end == m.begin) {
+          cursor = m.begin + 1;
+          continue;
         }
-        cursor = m.begin + 1;
       }
-      continue;
+      out.push_back(m);
+      cursor = m.end > m.begin ? m.end : m.begin + 1;
     }
+    return out;
+  }
 
+  for (const auto& p : cfg.patterns) {
     if (!p.regex.has_value()) continue;
 
     if (cfg.line_regexp) {
-      if (std::regex_match(line.begin(), line.end(), *p.regex)) {
+      if (p.regex->full_match(line)) {
         out.push_back(MatchPiece{0, line.size()});
       }
       continue;
     }
 
-    std::string line_copy(line);
-    for (auto it =
-             std::sregex_iterator(line_copy.begin(), line_copy.end(), *p.regex);
-         it != std::sregex_iterator(); ++it) {
-      auto pos = static_cast<size_t>(it->position());
-      auto len = static_cast<size_t>(it->length());
-      if (len == 0) continue;
-      MatchPiece m{pos, pos + len};
+    size_t cursor = 0;
+    while (cursor <= line.size()) {
+      auto found = p.regex->find(line, cursor);
+      if (!found) break;
+      if (found->size() == 0) {
+        cursor = found->begin + 1;
+        continue;
+      }
+      MatchPiece m{found->begin, found->end};
       if (!cfg.word_regexp || word_boundary_ok(line, m.begin, m.end)) {
         out.push_back(m);
       }
+      cursor = m.end;
     }
   }
 
@@ -543,6 +540,99 @@ auto collect_matches_in_line(std::string_view line, const Config& cfg)
   return out;
 }
 
+// Is LINE selected (before -v)? Unlike collect_matches_in_line() this stops
+// at the first match and allocates nothing, and an empty match counts.
+auto line_matches(std::string_view line, const Config& cfg) -> bool {
+  if (cfg.word_regexp && !cfg.line_regexp) {
+    return !collect_matches_in_line(line, cfg).empty();
+  }
+  if (cfg.literals) {
+    return cfg.line_regexp ? cfg.literals->full_match(line)
+                           : cfg.literals->search(line);
+  }
+  for (const auto& p : cfg.patterns) {
+    if (!p.regex.has_value()) continue;
+    if (cfg.line_regexp ? p.regex->full_match(line) : p.regex->search(line))
+      return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Finds lines that may match without splitting the input into lines.
+ *
+ * Fixed strings run the literal set over the whole buffer. A regex is
+ * located through the literal every match of it contains (its prefix or
+ * suffix); if some pattern has none, every line is a candidate.
+ */
+class CandidateFinder {
+ public:
+  explicit CandidateFinder(const Config& cfg) : cfg_(cfg) {
+    if (cfg.literals) return;
+    for (const auto& p : cfg.patterns) {
+      if (!p.regex.has_value()) continue;
+      std::string_view prefix = p.regex->literal_prefix();
+      std::string_view suffix = p.regex->literal_suffix();
+      std::string_view needle = prefix.size() >= suffix.size() ? prefix : suffix;
+      if (needle.empty()) {
+        every_line_ = true;
+        needles_.clear();
+        return;
+      }
+      needles_.push_back(Needle{needle});
+    }
+  }
+
+  // Offset of a byte in the first candidate line at or after FROM (a line
+  // start), or npos when the rest of DATA cannot match.
+  auto next(std::string_view data, size_t from) -> size_t {
+    if (every_line_) return from;
+    if (cfg_.literals) {
+      auto found = cfg_.literals->find(data, from);
+      return found ? found->begin : std::string_view::npos;
+    }
+    size_t best = std::string_view::npos;
+    for (auto& n : needles_) {
+      // Each needle's next occurrence is cached until the scan passes it
+      if (!n.exhausted && (!n.valid || n.at < from)) {
+        n.at = data.find(n.text, from);
+        n.valid = true;
+        n.exhausted = n.at == std::string_view::npos;
+      }
+      if (!n.exhausted) best = std::min(best, n.at);
+    }
+    return best;
+  }
+
+ private:
+  struct Needle {
+    std::string_view text;
+    size_t at = 0;
+    bool valid = false;
+    bool exhausted = false;
+  };
+
+  const Config& cfg_;
+  std::vector<Needle> needles_;
+  bool every_line_ = false;
+};
+
+auto emit(const Config& cfg, std::string_view text) -> void {
+  if (cfg.capture != nullptr) {
+    cfg.capture->out.append(text);
+  } else {
+    safePrint(text);
+  }
+}
+
+auto emit_error(const Config& cfg, std::string_view text) -> void {
+  if (cfg.capture != nullptr) {
+    cfg.capture->err.append(text);
+  } else {
+    safeErrorPrint(text);
+  }
+}
+
 auto append_prefix(std::string& out, const Config& cfg, bool show_filename,
                    std::string_view display_name, size_t line_no, size_t offset)
     -> void {
@@ -596,20 +686,14 @@ auto append_line_with_color(std::string& out, std::string_view line, const std::
   }
 }
 
-auto process_selected_record(std::string_view line, bool had_delim,
-                             std::string_view display_name, bool show_filename,
-                             size_t line_no, size_t offset, Config& cfg,
-                             size_t& selected_count) -> bool {
-  auto matches = collect_matches_in_line(line, cfg);
-  bool is_match = !matches.empty();
-  bool selected = cfg.invert_match ? !is_match : is_match;
-  if (!selected) return false;
-
-  ++selected_count;
-  if (cfg.quiet) return true;
-
+auto print_selected_record(std::string_view line, bool had_delim,
+                           const std::vector<MatchPiece>& matches,
+                           std::string_view display_name, bool show_filename,
+                           size_t line_no, size_t offset, const Config& cfg)
+    -> void {
+  if (cfg.quiet) return;
   if (cfg.files_with_matches || cfg.files_without_match || cfg.count_only)
-    return true;
+    return;
 
   const char delim = cfg.null_data ? '\0' : '\n';
   std::string output_buf;
@@ -629,7 +713,7 @@ auto process_selected_record(std::string_view line, bool had_delim,
         output_buf.append(line.substr(m.begin, m.end - m.begin));
       }
       output_buf.append(1, delim);
-      safePrint(output_buf);
+      emit(cfg, output_buf);
     }
   } else {
     append_prefix(output_buf, cfg, show_filename, display_name, line_no, offset);
@@ -640,209 +724,264 @@ auto process_selected_record(std::string_view line, bool had_delim,
     } else {
       output_buf.append(cfg.null_data ? "\0" : "\n");
     }
-    safePrint(output_buf);
+    emit(cfg, output_buf);
   }
-  return true;
 }
 
-auto scan_text(const std::string& text, std::string_view display_name,
-               bool show_filename, Config& cfg) -> std::pair<bool, size_t> {
+auto print_context_record(std::string_view line, bool had_delim,
+                          std::string_view display_name, bool show_filename,
+                          size_t line_no, size_t offset, const Config& cfg)
+    -> void {
   const char delim = cfg.null_data ? '\0' : '\n';
-  auto records = split_records(text, delim);
+  std::string line_buf;
+  line_buf.reserve(line.size() + 128);
+  append_prefix(line_buf, cfg, show_filename, display_name, line_no, offset);
+  if (cfg.initial_tab) line_buf.push_back('\t');
+  line_buf.append(line);
+  if (had_delim) {
+    line_buf.append(1, delim);
+  } else {
+    line_buf.append(cfg.null_data ? "\0" : "\n");
+  }
+  emit(cfg, line_buf);
+}
 
-  bool any_selected = false;
-  size_t selected_count = 0;
-  bool use_context = (cfg.before_context > 0 || cfg.after_context > 0) &&
-                     !cfg.count_only && !cfg.files_with_matches && !cfg.files_without_match;
-
-  if (!use_context) {
-    for (size_t i = 0; i < records.size(); ++i) {
-      const auto [b, e] = records[i];
-      std::string_view whole(text.data() + b, e - b);
-      bool had_delim = !whole.empty() && whole.back() == delim;
-      std::string_view line = had_delim ? whole.substr(0, whole.size() - 1) : whole;
-      if (!process_selected_record(line, had_delim, display_name, show_filename,
-                                   i + 1, b, cfg, selected_count))
-        continue;
-      any_selected = true;
+// Selected lines are printed (not just counted or reported by file name)
+auto wants_line_output(const Config& cfg) -> bool {
+  return !cfg.quiet && !cfg.files_with_matches && !cfg.files_without_match &&
+         !cfg.count_only;
+}
 
-      if (cfg.quiet) return {true, selected_count};
+// Printing needs the match positions only for -o and --color
+auto needs_match_pieces(const Config& cfg) -> bool {
+  return !cfg.invert_match && (cfg.only_matching || cfg.color);
+}
 
-      if (cfg.max_count >= 0 && static_cast<int>(selected_count) >= cfg.max_count)
-        break;
-    }
-    return {any_selected, selected_count};
-  }
+// A NUL byte in the first block marks binary input, as in GNU grep. UTF-16
+// text is full of NULs too, but it has been recognised (and is transcoded)
+// before this is asked. With -z, NUL is just the line terminator.
+auto looks_binary(std::string_view head, const Config& cfg) -> bool {
+  if (cfg.binary_files == BinaryFiles::Text || cfg.null_data) return false;
+  return head.find('\0') != std::string_view::npos;
+}
 
-  std::vector<std::pair<size_t, size_t>> match_indices;
-  for (size_t i = 0; i < records.size(); ++i) {
-    const auto [b, e] = records[i];
-    std::string_view whole(text.data() + b, e - b);
-    bool had_delim = !whole.empty() && whole.back() == delim;
-    std::string_view line = had_delim ? whole.substr(0, whole.size() - 1) : whole;
-    auto matches = collect_matches_in_line(line, cfg);
-    bool is_match = !matches.empty();
-    bool selected = cfg.invert_match ? !is_match : is_match;
-    if (selected) {
-      match_indices.push_back({i, i});
-      ++selected_count;
-      if (cfg.quiet) return {true, selected_count};
-      if (cfg.max_count >= 0 && static_cast<int>(selected_count) >= cfg.max_count)
-        break;
-    }
-  }
+// Stands in for the lines of a binary input; the scan stops after it
+auto report_binary_match(std::string_view display_name, const Config& cfg)
+    -> void {
+  emit_error(cfg, "grep: ");
+  emit_error(cfg, display_name);
+  emit_error(cfg, ": binary file matches\n");
+}
 
-  if (match_indices.empty()) {
-    return {false, 0};
-  }
+struct ContextLine {
+  std::string text;
+  size_t line_no = 0;
+  size_t offset = 0;
+  bool had_delim = false;
+};
 
-  std::vector<std::pair<size_t, size_t>> groups;
-  size_t group_start = match_indices[0].first;
-  size_t group_end = match_indices[0].first;
-  for (size_t i = 1; i < match_indices.size(); ++i) {
-    size_t idx = match_indices[i].first;
-    if (idx <= group_end + 1) {
-      group_end = idx;
-    } else {
-      groups.push_back({group_start, group_end});
-      group_start = idx;
-      group_end = idx;
+auto scan_stream(LineReader& reader, std::string_view display_name,
+                 bool show_filename, Config& cfg) -> std::pair<bool, size_t> {
+  const bool use_context = (cfg.before_context > 0 || cfg.after_context > 0) &&
+                           !cfg.count_only && !cfg.files_with_matches &&
+                           !cfg.files_without_match && !cfg.quiet;
+  const size_t before = static_cast<size_t>(std::max(cfg.before_context, 0));
+  const bool wants_output = wants_line_output(cfg);
+  const bool wants_pieces = wants_output && needs_match_pieces(cfg);
+
+  // Context is kept as a small ring of copied records (the reader's views do
+  // not outlive the next record), so memory stays bounded by -B.
+  std::deque<ContextLine> before_lines;
+  size_t after_remaining = 0;
+  size_t last_printed = 0;
+  bool max_reached = false;
+
+  auto separate = [&](size_t line_no) {
+    if (last_printed != 0 && line_no > last_printed + 1 &&
+        !cfg.no_group_separator) {
+      emit(cfg, cfg.group_separator);
+      emit(cfg, "\n");
     }
-  }
-  groups.push_back({group_start, group_end});
+    last_printed = line_no;
+  };
 
-  bool first_group = true;
-  for (const auto& [gs, ge] : groups) {
-    size_t start = (gs >= static_cast<size_t>(cfg.before_context)) ? gs - cfg.before_context : 0;
-    size_t end = ge + cfg.after_context;
-    if (end >= records.size()) end = records.size() - 1;
+  if (cfg.max_count == 0) return {false, 0};
 
-    if (!first_group) {
-      if (!cfg.no_group_separator) {
-        safePrint(cfg.group_separator);
-        safePrint("\n");
+  size_t line_no = 0;
+  size_t selected_count = 0;
+  std::string_view line;
+  while (reader.next(line)) {
+    ++line_no;
+    const bool had_delim = reader.had_delimiter();
+    const auto offset = static_cast<size_t>(reader.record_offset());
+
+    if (max_reached) {
+      // -m stops at the last selected line but still prints its trailing
+      // context.
+      if (after_remaining == 0) break;
+      separate(line_no);
+      print_context_record(line, had_delim, display_name, show_filename,
+                           line_no, offset, cfg);
+      --after_remaining;
+      continue;
+    }
+
+    const bool is_match = line_matches(line, cfg);
+    const bool selected = cfg.invert_match ? !is_match : is_match;
+
+    if (!selected) {
+      if (!use_context) continue;
+      if (after_remaining > 0) {
+        separate(line_no);
+        print_context_record(line, had_delim, display_name, show_filename,
+                             line_no, offset, cfg);
+        --after_remaining;
+      } else if (before > 0) {
+        if (before_lines.size() == before) before_lines.pop_front();
+        before_lines.push_back(
+            ContextLine{std::string(line), line_no, offset, had_delim});
       }
+      continue;
     }
-    first_group = false;
-
-    for (size_t i = start; i <= end; ++i) {
-      const auto [b, e] = records[i];
-      std::string_view whole(text.data() + b, e - b);
-      bool had_delim = !whole.empty() && whole.back() == delim;
-      std::string_view line = had_delim ? whole.substr(0, whole.size() - 1) : whole;
-
-      bool is_in_match_group = (i >= gs && i <= ge);
-      if (is_in_match_group) {
-        auto matches = collect_matches_in_line(line, cfg);
-        bool is_match = !matches.empty();
-        bool selected = cfg.invert_match ? !is_match : is_match;
-        if (selected) {
-          std::string line_buf;
-          line_buf.reserve(line.size() + 128);
-          append_prefix(line_buf, cfg, show_filename, display_name, i + 1, b);
-          if (cfg.initial_tab) line_buf.push_back('\t');
-          append_line_with_color(line_buf, line, matches, cfg.color);
-          if (had_delim) {
-            line_buf.append(1, delim);
-          } else {
-            line_buf.append(cfg.null_data ? "\0" : "\n");
-          }
-          safePrint(line_buf);
-        }
-      } else {
-        std::string line_buf;
-        line_buf.reserve(line.size() + 128);
-        append_prefix(line_buf, cfg, show_filename, display_name, i + 1, b);
-        if (cfg.initial_tab) line_buf.push_back('\t');
-        line_buf.append(line);
-        if (had_delim) {
-          line_buf.append(1, delim);
-        } else {
-          line_buf.append(cfg.null_data ? "\0" : "\n");
-        }
-        safePrint(line_buf);
+
+    ++selected_count;
+    if (cfg.quiet) return {true, selected_count};
+    if (wants_output && cfg.binary_input) {
+      report_binary_match(display_name, cfg);
+      return {true, selected_count};
+    }
+
+    if (use_context) {
+      for (const auto& ctx_line : before_lines) {
+        separate(ctx_line.line_no);
+        print_context_record(ctx_line.text, ctx_line.had_delim, display_name,
+                             show_filename, ctx_line.line_no, ctx_line.offset,
+                             cfg);
       }
+      before_lines.clear();
+      separate(line_no);
+      after_remaining = static_cast<size_t>(std::max(cfg.after_context, 0));
+    }
+    if (wants_output) {
+      std::vector<MatchPiece> matches;
+      if (wants_pieces) matches = collect_matches_in_line(line, cfg);
+      print_selected_record(line, had_delim, matches, display_name,
+                            show_filename, line_no, offset, cfg);
+    }
+
+    if (cfg.max_count >= 0 &&
+        static_cast<int>(selected_count) >= cfg.max_count) {
+      if (!use_context || after_remaining == 0) break;
+      max_reached = true;
     }
   }
 
-  any_selected = !match_indices.empty();
-  return {any_selected, selected_count};
+  if (reader.failed()) {
+    cfg.has_error = true;
+    if (!cfg.no_messages) {
+      emit_error(cfg, "grep: ");
+      emit_error(cfg, display_name);
+      emit_error(cfg, ": read error\n");
+    }
+  }
+
+  return {selected_count > 0, selected_count};
 }
 
-auto scan_stream(std::istream& in, std::string_view display_name,
-                 bool show_filename, Config& cfg) -> std::pair<bool, size_t> {
-  const char delim = cfg.null_data ? '\0' : '\n';
-  std::array<char, 64 * 1024> chunk{};
-  std::string pending;
-  pending.reserve(chunk.size() * 2);
+// Can the input be searched as one buffer? Context and -v need every line
+// in order, so they stay on the streaming path.
+auto can_scan_buffer(const Config& cfg) -> bool {
+  if (cfg.invert_match) return false;
+  const bool has_context = cfg.before_context > 0 || cfg.after_context > 0;
+  return !has_context || !wants_line_output(cfg);
+}
 
-  size_t base_offset = 0;
-  size_t line_no = 1;
-  bool any_selected = false;
-  size_t selected_count = 0;
+/**
+ * @brief Search a whole in-memory input at once.
+ *
+ * Jumps from one candidate match to the next and only then expands it to
+ * its line, so lines that cannot match are never split out or looked at
+ * one by one. Line numbers are counted lazily, and only for -n; -q, -l and
+ * -L stop at the first selected line, -c counts without collecting match
+ * positions.
+ */
+auto scan_buffer(std::string_view data, size_t start,
+                 std::string_view display_name, bool show_filename,
+                 const Config& cfg) -> std::pair<bool, size_t> {
+  if (cfg.max_count == 0) return {false, 0};
 
-  while (in) {
-    in.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
-    std::streamsize got = in.gcount();
-    if (got <= 0) break;
-
-    pending.append(chunk.data(), static_cast<size_t>(got));
-
-    size_t start = 0;
-    for (size_t i = 0; i < pending.size(); ++i) {
-      if (pending[i] != delim) continue;
-
-      std::string_view line(pending.data() + start, i - start);
-      size_t offset = base_offset + start;
-      if (process_selected_record(line, true, display_name, show_filename,
-                                  line_no, offset, cfg, selected_count)) {
-        any_selected = true;
-        if (cfg.quiet) return {true, selected_count};
-        if (cfg.max_count >= 0 &&
-            static_cast<int>(selected_count) >= cfg.max_count) {
-          return {any_selected, selected_count};
-        }
-      }
+  const char delim = cfg.null_data ? '\0' : '\n';
+  const bool wants_output = wants_line_output(cfg);
+  const bool wants_pieces = wants_output && needs_match_pieces(cfg);
+  CandidateFinder finder(cfg);
 
-      ++line_no;
-      start = i + 1;
+  size_t selected_count = 0;
+  size_t counted_to = start;  // Delimiters before here are in lines_before
+  size_t lines_before = 0;
+  size_t pos = start;         // Always the start of a line
+  while (pos < data.size()) {
+    const size_t hit = finder.next(data, pos);
+    if (hit == std::string_view::npos) break;
+
+    size_t line_start = pos;
+    if (hit > pos) {
+      const size_t back = data.substr(pos, hit - pos).rfind(delim);
+      if (back != std::string_view::npos) line_start = pos + back + 1;
     }
-
-    if (start > 0) {
-      base_offset += start;
-      pending.erase(0, start);
+    size_t line_end = data.find(delim, hit);
+    const bool had_delim = line_end != std::string_view::npos;
+    if (!had_delim) line_end = data.size();
+    pos = had_delim ? line_end + 1 : data.size();
+
+    const auto line = data.substr(line_start, line_end - line_start);
+    if (!line_matches(line, cfg)) continue;
+
+    ++selected_count;
+    if (!wants_output) {
+      // Only -c needs more than the first selected line
+      if (cfg.quiet || !cfg.count_only) return {true, selected_count};
+    } else if (cfg.binary_input) {
+      report_binary_match(display_name, cfg);
+      return {true, selected_count};
+    } else {
+      size_t line_no = 0;
+      if (cfg.line_number) {
+        lines_before += static_cast<size_t>(
+            std::count(data.begin() + counted_to, data.begin() + line_start,
+                       delim));
+        counted_to = line_start;
+        line_no = lines_before + 1;
+      }
+      std::vector<MatchPiece> matches;
+      if (wants_pieces) matches = collect_matches_in_line(line, cfg);
+      print_selected_record(line, had_delim, matches, display_name,
+                            show_filename, line_no, line_start, cfg);
     }
-  }
 
-  if (!pending.empty()) {
-    if (process_selected_record(pending, false, display_name, show_filename,
-                                line_no, base_offset, cfg, selected_count)) {
-      any_selected = true;
+    if (cfg.max_count >= 0 &&
+        static_cast<int>(selected_count) >= cfg.max_count) {
+      break;
     }
   }
 
-  return {any_selected, selected_count};
+  return {selected_count > 0, selected_count};
 }
 
-auto read_file_binary(const std::string& path) -> cp::Result<std::string> {
-  std::ifstream in(path, std::ios::binary);
-  if (!in.is_open()) {
-    return std::unexpected("cannot open '" + path + "'");
-  }
-  return std::string((std::istreambuf_iterator<char>(in)),
-                     std::istreambuf_iterator<char>());
+auto matches_file_filters(const Config& cfg, const std::string& filename)
+    -> bool {
+  if (!cfg.include.empty() && !wildcard_match(cfg.include, filename))
+    return false;
+  if (!cfg.exclude.empty() && wildcard_match(cfg.exclude, filename))
+    return false;
+  return true;
 }
 
-auto gather_files_for_input(const Config& cfg, std::vector<std::string>& out)
-    -> cp::Result<void> {
+// FILE operands with wildcards expanded; directories are walked later.
+auto expand_operands(const Config& cfg) -> std::vector<std::string> {
+  std::vector<std::string> out;
   for (const auto& f : cfg.files) {
-    if (f == "-") {
-      out.push_back(f);
-      continue;
-    }
-
     // Smart glob expansion for wildcard patterns
-    if (contains_wildcard(f)) {
+    if (f != "-" && contains_wildcard(f)) {
       auto glob_result = glob_expand(f);
       if (glob_result.expanded) {
         // Pattern was expanded, add all matched files
@@ -853,137 +992,360 @@ auto gather_files_for_input(const Config& cfg, std::vector<std::string>& out)
       }
       // If expansion failed, fall through to normal processing
     }
+    out.push_back(f);
+  }
+  return out;
+}
 
+/**
+ * @brief Hand every input to VISIT in traversal order.
+ *
+ * Directories are walked for -r, skipped for -d skip, and otherwise passed
+ * on with IS_DIRECTORY set so the search reports them. A directory that
+ * cannot be read is handed to FAIL as a "grep: PATH: ERROR" message and
+ * the walk goes on with the rest of the tree. VISIT and FAIL return false
+ * to stop the walk.
+ */
+auto walk_inputs(
+    const Config& cfg, const std::vector<std::string>& operands,
+    const std::function<bool(std::string, bool is_directory)>& visit,
+    const std::function<bool(std::string message)>& fail) -> void {
+  namespace fs = std::filesystem;
+  for (const auto& f : operands) {
     std::error_code ec;
-    bool is_dir = std::filesystem::is_directory(f, ec);
-    if (ec) {
-      out.push_back(f);
+    if (f == "-" || !fs::is_directory(f, ec) || ec) {
+      if (f != "-" &&
+          !matches_file_filters(cfg, fs::path(f).filename().string())) {
+        continue;
+      }
+      if (!visit(f, false)) return;
       continue;
     }
 
-    if (!is_dir) {
-      if (!cfg.include.empty()) {
-        std::string filename = std::filesystem::path(f).filename().string();
-        if (!wildcard_match(cfg.include, filename)) {
-          continue;
+    if (cfg.directories == "skip") continue;
+    if (cfg.directories != "recurse") {
+      if (!visit(f, true)) return;
+      continue;
+    }
+
+    auto failed = [&](const fs::path& path, const std::error_code& error) {
+      return fail("grep: " + path.string() + ": " + error.message() + "\n");
+    };
+    fs::recursive_directory_iterator it(
+        f, fs::directory_options::skip_permission_denied, ec);
+    if (ec && !failed(f, ec)) return;
+    for (const fs::recursive_directory_iterator end; !ec && it != end;) {
+      std::error_code type_ec;
+      if (it->is_directory(type_ec) && !it->is_symlink(type_ec)) {
+        // A subdirectory that fails to open would end the whole iteration
+        // in increment(), so open it here and step over it on failure.
+        std::error_code open_ec;
+        fs::directory_iterator probe(it->path(), open_ec);
+        if (open_ec) {
+          if (!failed(it->path(), open_ec)) return;
+          it.disable_recursion_pending();
         }
+      } else if (it->is_regular_file(type_ec) &&
+                 matches_file_filters(cfg, it->path().filename().string())) {
+        if (!visit(it->path().string(), false)) return;
       }
-      if (!cfg.exclude.empty()) {
-        std::string filename = std::filesystem::path(f).filename().string();
-        if (wildcard_match(cfg.exclude, filename)) {
-          continue;
-        }
+
+      const fs::path previous = it->path();
+      it.increment(ec);
+      if (ec) {
+        // Reading the directory that held PREVIOUS failed part way
+        if (!failed(previous.parent_path(), ec)) return;
+        ec.clear();
+        if (it == end || it.depth() == 0) break;
+        it.pop(ec);
       }
-      out.push_back(f);
-      continue;
     }
+  }
+}
 
-    if (cfg.directories == "skip") continue;
+/**
+ * @brief Search one input and print its -l/-L/-c summary.
+ * @return Whether any line was selected
+ */
+auto search_input(const std::string& input, bool is_directory,
+                  bool show_filename, Config& cfg) -> bool {
+  auto display_name = record_name_for_output(input, cfg);
+  if (is_directory) {
+    cfg.has_error = true;
+    if (!cfg.no_messages && !cfg.quiet) {
+      emit_error(cfg, "grep: " + input + ": Is a directory\n");
+    }
+    return false;
+  }
 
-    if (cfg.directories == "recurse") {
-      for (const auto& e : std::filesystem::recursive_directory_iterator(f)) {
-        if (e.is_regular_file()) {
-          std::string filepath = e.path().string();
-          std::string filename = e.path().filename().string();
-          if (!cfg.include.empty() && !wildcard_match(cfg.include, filename)) {
-            continue;
-          }
-          if (!cfg.exclude.empty() && wildcard_match(cfg.exclude, filename)) {
-            continue;
-          }
-          out.push_back(filepath);
-        }
+  std::pair<bool, size_t> scan_result{false, 0};
+  LineReaderOptions reader_options;
+  reader_options.delimiter = cfg.null_data ? '\0' : '\n';
+
+  // Regular files are searched in place when the options allow it;
+  // UTF-16 input still goes through LineReader to be transcoded.
+  std::optional<MappedFile> mapped;
+  std::optional<size_t> text_start;
+  if (input != "-" && can_scan_buffer(cfg)) {
+    if (auto file = MappedFile::open(input, AccessHint::Sequential)) {
+      text_start = raw_text_start(file->view(), reader_options.delimiter);
+      if (text_start.has_value()) mapped.emplace(std::move(*file));
+    }
+  }
+
+  // Binary input is decided on the first block alone, so -I skips a file
+  // without reading the rest of it.
+  auto scan_reader = [&](LineReader& reader) {
+    cfg.binary_input = looks_binary(reader.peek(), cfg);
+    if (cfg.binary_input && cfg.binary_files == BinaryFiles::WithoutMatch)
+      return;
+    scan_result = scan_stream(reader, display_name, show_filename, cfg);
+  };
+
+  if (input == "-") {
+    auto reader = LineReader::for_stdin(reader_options);
+    scan_reader(reader);
+  } else if (mapped.has_value()) {
+    const auto data = mapped->view();
+    cfg.binary_input = looks_binary(
+        data.substr(*text_start, LineReaderOptions{}.block_size), cfg);
+    if (!cfg.binary_input || cfg.binary_files != BinaryFiles::WithoutMatch) {
+      scan_result = scan_buffer(data, *text_start, display_name,
+                                show_filename, cfg);
+    }
+  } else {
+    std::ifstream in(input, std::ios::binary);
+    if (!in.is_open()) {
+      cfg.has_error = true;
+      if (!cfg.no_messages && !cfg.quiet) {
+        emit_error(cfg, "grep: cannot open '" + input + "'\n");
       }
-      continue;
+      return false;
+    }
+    LineReader reader(in, reader_options);
+    scan_reader(reader);
+  }
+
+  auto [any_selected, selected_count] = scan_result;
+  if (!cfg.quiet) {
+    const std::string_view name_end = cfg.null_after_filename
+                                          ? std::string_view("\0", 1)
+                                          : std::string_view("\n");
+    if (cfg.files_with_matches && any_selected) {
+      emit(cfg, display_name);
+      emit(cfg, name_end);
     }
 
-    return std::unexpected("'" + f + "' is a directory");
+    if (cfg.files_without_match && !any_selected) {
+      emit(cfg, display_name);
+      emit(cfg, name_end);
+    }
+
+    if (cfg.count_only) {
+      if (show_filename) {
+        emit(cfg, display_name);
+        emit(cfg, ":");
+      }
+      emit(cfg, std::to_string(selected_count));
+      emit(cfg, "\n");
+    }
   }
-  return {};
+  return any_selected;
 }
 
-auto process(Config& cfg) -> int {
-  std::vector<std::string> inputs;
-  auto gather = gather_files_for_input(cfg, inputs);
-  if (!gather) {
-    if (!cfg.no_messages && !cfg.quiet) {
-      safeErrorPrint("grep: ");
-      safeErrorPrint(gather.error());
-      safeErrorPrint("\n");
+/**
+ * @brief Searches files on worker threads while the walk is still running.
+ *
+ * One thread walks the inputs and queues each path with its position in
+ * the walk; workers take paths from the queue, search them with their own
+ * copy of the config (a compiled Regex caches DFA states and must not be
+ * shared) and buffer the output. The calling thread prints finished files
+ * in walk order, or as they finish with --unordered. At most `window_`
+ * files are walked but not yet printed, which bounds both the queue and
+ * the buffered output.
+ */
+class ParallelSearch {
+ public:
+  ParallelSearch(Config& cfg, bool show_filename, size_t threads)
+      : cfg_(cfg),
+        show_filename_(show_filename),
+        threads_(threads),
+        window_(threads * 8) {}
+
+  /// Search everything under OPERANDS; returns whether any line was selected
+  auto run(const std::vector<std::string>& operands) -> bool {
+    std::vector<std::jthread> workers;
+    workers.reserve(threads_ + 1);
+    workers.emplace_back([&] { walk(operands); });
+    for (size_t i = 0; i < threads_; ++i) {
+      workers.emplace_back([this, local = cfg_]() mutable { work(local); });
     }
-    return 2;
+
+    bool any_selected = false;
+    std::unique_lock lock(mutex_);
+    while (true) {
+      done_cv_.wait(lock, [&] {
+        return next_ready() || (walk_done_ && printed_ == walked_);
+      });
+      if (!next_ready()) break;
+
+      auto node = cfg_.unordered ? finished_.extract(finished_.begin())
+                                 : finished_.extract(printed_);
+      ++printed_;
+      space_cv_.notify_one();
+      lock.unlock();
+
+      const FileResult& result = node.mapped();
+      if (!result.err.empty()) safeErrorPrint(result.err);
+      if (!result.out.empty()) safePrint(result.out);
+      any_selected = any_selected || result.any_selected;
+      cfg_.has_error = cfg_.has_error || result.error;
+
+      lock.lock();
+      // -q: the first selected line anywhere settles the exit status
+      if (cfg_.quiet && any_selected) break;
+    }
+    stop_ = true;
+    lock.unlock();
+    work_cv_.notify_all();
+    space_cv_.notify_all();
+    return any_selected;
   }
 
-  bool show_filename = false;
-  if (cfg.with_filename) {
-    show_filename = true;
-  } else if (!cfg.no_filename && inputs.size() > 1) {
-    show_filename = true;
+ private:
+  struct Job {
+    size_t seq = 0;
+    std::string path;
+    bool is_directory = false;
+    std::string walk_error;  // Set instead of PATH for an unreadable directory
+  };
+
+  Config& cfg_;
+  bool show_filename_;
+  size_t threads_;
+  size_t window_;
+
+  std::mutex mutex_;
+  std::condition_variable work_cv_;   // Queue gained a job, or walk ended
+  std::condition_variable done_cv_;   // A file finished, or walk ended
+  std::condition_variable space_cv_;  // A file was printed
+  std::deque<Job> queue_;
+  std::map<size_t, FileResult> finished_;
+  size_t walked_ = 0;
+  size_t printed_ = 0;
+  bool walk_done_ = false;
+  bool stop_ = false;
+
+  auto next_ready() const -> bool {
+    return cfg_.unordered ? !finished_.empty() : finished_.contains(printed_);
   }
 
-  bool any_selected_global = false;
+  void walk(const std::vector<std::string>& operands) {
+    // Walk errors are queued too so they print in walk order
+    auto enqueue = [&](Job job) {
+      std::unique_lock lock(mutex_);
+      space_cv_.wait(lock,
+                     [&] { return stop_ || walked_ - printed_ < window_; });
+      if (stop_) return false;
+      job.seq = walked_++;
+      queue_.push_back(std::move(job));
+      work_cv_.notify_one();
+      return true;
+    };
+    walk_inputs(
+        cfg_, operands,
+        [&](std::string path, bool is_directory) {
+          return enqueue(Job{0, std::move(path), is_directory});
+        },
+        [&](std::string message) {
+          return enqueue(Job{0, {}, false, std::move(message)});
+        });
+    std::lock_guard lock(mutex_);
+    walk_done_ = true;
+    work_cv_.notify_all();
+    done_cv_.notify_all();
+  }
 
-  for (const auto& input : inputs) {
-    std::pair<bool, size_t> scan_result{false, 0};
-    auto display_name = record_name_for_output(input, cfg);
-
-    bool use_context = (cfg.before_context > 0 || cfg.after_context > 0) &&
-                       !cfg.count_only && !cfg.files_with_matches && !cfg.files_without_match;
-
-    if (input == "-") {
-      scan_result = scan_stream(std::cin, display_name, show_filename, cfg);
-    } else if (use_context) {
-      // Read entire file for context support
-      auto content = read_file_binary(input);
-      if (!content) {
-        cfg.has_error = true;
-        if (!cfg.no_messages && !cfg.quiet) {
-          safeErrorPrint("grep: ");
-          safeErrorPrint(content.error());
-          safeErrorPrint("\n");
-        }
-        continue;
+  void work(Config& local) {
+    while (true) {
+      Job job;
+      {
+        std::unique_lock lock(mutex_);
+        work_cv_.wait(lock,
+                      [&] { return stop_ || walk_done_ || !queue_.empty(); });
+        if (stop_ || queue_.empty()) return;
+        job = std::move(queue_.front());
+        queue_.pop_front();
       }
-      scan_result = scan_text(*content, display_name, show_filename, cfg);
-    } else {
-      std::ifstream in(input, std::ios::binary);
-      if (!in.is_open()) {
-        cfg.has_error = true;
-        if (!cfg.no_messages && !cfg.quiet) {
-          safeErrorPrint("grep: ");
-          safeErrorPrint("cannot open '" + input + "'");
-          safeErrorPrint("\n");
-        }
+
+      FileResult result;
+      if (!job.walk_error.empty()) {
+        result.error = true;
+        if (!local.no_messages && !local.quiet) result.err = job.walk_error;
+        std::lock_guard lock(mutex_);
+        finished_.emplace(job.seq, std::move(result));
+        done_cv_.notify_one();
         continue;
       }
-      scan_result = scan_stream(in, display_name, show_filename, cfg);
+      local.capture = &result;
+      local.has_error = false;
+      result.any_selected =
+          search_input(job.path, job.is_directory, show_filename_, local);
+      result.error = local.has_error;
+      local.capture = nullptr;
+
+      std::lock_guard lock(mutex_);
+      finished_.emplace(job.seq, std::move(result));
+      done_cv_.notify_one();
     }
+  }
+};
 
-    auto [any_selected, selected_count] = scan_result;
-    any_selected_global = any_selected_global || any_selected;
+auto process(Config& cfg) -> int {
+  if (cfg.line_buffered) setOutputBuffering(OutputBufferMode::Line);
 
-    if (!cfg.quiet) {
-      if (cfg.files_with_matches && any_selected) {
-        safePrint(display_name);
-        safePrint(cfg.null_after_filename ? "\0" : "\n");
-      }
+  const auto operands = expand_operands(cfg);
+  const bool walks_directories =
+      cfg.directories == "recurse" &&
+      std::ranges::any_of(operands, [](const std::string& f) {
+        std::error_code ec;
+        return f != "-" && std::filesystem::is_directory(f, ec);
+      });
 
-      if (cfg.files_without_match && !any_selected) {
-        safePrint(display_name);
-        safePrint(cfg.null_after_filename ? "\0" : "\n");
-      }
+  bool show_filename = false;
+  if (cfg.with_filename) {
+    show_filename = true;
+  } else if (!cfg.no_filename &&
+             (operands.size() > 1 || walks_directories)) {
+    show_filename = true;
+  }
 
-      if (cfg.count_only) {
-        if (show_filename) {
-          safePrint(display_name);
-          safePrint(":");
-        }
-        safePrint(std::to_string(selected_count));
-        safePrint("\n");
-      }
-    }
+  size_t threads = cfg.threads > 0
+                       ? static_cast<size_t>(cfg.threads)
+                       : std::max(1u, std::thread::hardware_concurrency());
+  // Standard input is bound to this thread, so it is never handed off
+  const bool parallel =
+      walks_directories && threads > 1 &&
+      std::ranges::find(operands, std::string("-")) == operands.end();
 
-    if (cfg.quiet && any_selected_global) break;
+  bool any_selected_global = false;
+  if (parallel) {
+    ParallelSearch search(cfg, show_filename, threads);
+    any_selected_global = search.run(operands);
+  } else {
+    walk_inputs(
+        cfg, operands,
+        [&](std::string input, bool is_directory) {
+          any_selected_global =
+              search_input(input, is_directory, show_filename, cfg) ||
+              any_selected_global;
+          return !(cfg.quiet && any_selected_global);
+        },
+        [&](std::string message) {
+          cfg.has_error = true;
+          if (!cfg.no_messages && !cfg.quiet) emit_error(cfg, message);
+          return true;
+        });
   }
 
   if (cfg.has_error && !cfg.quiet) return 2;
@@ -305,8 +305,8 @@ auto config = *config_result;
     }
 
     if (file == "-") {
-      output_head(std::cin, config);
-      if (std::cin.bad()) {
+      output_head(stdin_stream(), config);
+      if (stdin_stream().bad()) {
         safeErrorPrint("head: error reading '-'\n");
         any_error = true;
       }
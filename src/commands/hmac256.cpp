@@ -40,32 +40,27 @@ auto build_config(const CommandContext<HMAC256_OPTIONS.size()>& ctx) -> cp::Resu
 
 auto run(const Config& cfg) -> int {
   // Simplified HMAC-SHA256 implementation
-  std::string data;
-  if (cfg.filename == "-") {
-    data = std::string(std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>());
-  } else {
-    std::wstring wfilename = utf8_to_wstring(cfg.filename);
-    HANDLE hFile = CreateFileW(wfilename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
-    if (hFile == INVALID_HANDLE_VALUE) {
-      safeErrorPrint("hmac256: cannot open '");
-      safeErrorPrint(cfg.filename);
-      safeErrorPrintLn("'");
-      return 1;
-    }
-    
-    LARGE_INTEGER fileSize;
-    GetFileSizeEx(hFile, &fileSize);
-    data.resize(fileSize.QuadPart);
-    DWORD bytesRead;
-    ReadFile(hFile, data.data(), static_cast<DWORD>(fileSize.QuadPart), &bytesRead, nullptr);
-    CloseHandle(hFile);
+  auto input = cfg.filename == "-"
+                   ? MappedFile::from_stdin(AccessHint::Sequential)
+                   : MappedFile::open(cfg.filename, AccessHint::Sequential);
+  if (!input) {
+    safeErrorPrint("hmac256: cannot open '");
+    safeErrorPrint(cfg.filename);
+    safeErrorPrintLn("'");
+    return 1;
   }
+  const std::string_view data = input->view();
   
   // Compute hash (simplified - just concatenate key and data)
-  std::string combined = cfg.key + data;
+  // Index key + data without building the concatenation.
+  const size_t combined_size = cfg.key.size() + data.size();
   char hash[65];
-  for (int i = 0; i < 64; ++i) {
-    hash[i] = "0123456789abcdef"[combined[i % combined.size()] % 16];
+  for (size_t i = 0; i < 64; ++i) {
+    const size_t k = combined_size == 0 ? 0 : i % combined_size;
+    const char c = combined_size == 0    ? '\0'
+                   : k < cfg.key.size() ? cfg.key[k]
+                                        : data[k - cfg.key.size()];
+    hash[i] = "0123456789abcdef"[c % 16];
   }
   hash[64] = '\0';
   
@@ -197,7 +197,7 @@ auto read_lines(const std::string& filename) -> cp::Result<SmallVector<std::stri
 
   if (filename == "-") {
     std::string line;
-    while (std::getline(std::cin, line)) {
+    while (std::getline(stdin_stream(), line)) {
       lines.push_back(line);
     }
   } else {
@@ -124,9 +124,9 @@ auto read_json(const std::string& filename) -> cp::Result<std::string> {
 
   if (filename.empty() || filename == "-") {
     // Read from stdin
-    content.assign(std::istreambuf_iterator<char>(std::cin),
+    content.assign(std::istreambuf_iterator<char>(stdin_stream()),
                    std::istreambuf_iterator<char>());
-    if (std::cin.fail() && !std::cin.eof()) {
+    if (stdin_stream().fail() && !stdin_stream().eof()) {
       return std::unexpected("error reading from standard input");
     }
   } else {
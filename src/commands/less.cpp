@@ -114,34 +114,23 @@ auto build_config(const CommandContext<LESS_OPTIONS.size()>& ctx)
   return cfg;
 }
 
-auto read_file_content(const std::string& filename) -> cp::Result<std::string> {
-  std::string content;
-
+auto open_content(const std::string& filename) -> cp::Result<MappedFile> {
   if (filename == "-" || filename.empty()) {
-    // Read from stdin
-    content.assign(std::istreambuf_iterator<char>(std::cin),
-                   std::istreambuf_iterator<char>());
-    if (std::cin.fail() && !std::cin.eof()) {
-      return std::unexpected("error reading from standard input");
-    }
-  } else {
-    // Read from file
-    std::ifstream file(filename, std::ios::binary);
-    if (!file) {
-      return std::unexpected(std::string("cannot open '") + filename + "' for reading");
-    }
-    content.assign(std::istreambuf_iterator<char>(file),
-                   std::istreambuf_iterator<char>());
-    if (file.fail() && !file.eof()) {
-      return std::unexpected("error reading from file");
-    }
+    auto input = MappedFile::from_stdin(AccessHint::Random);
+    if (!input) return std::unexpected("error reading from standard input");
+    return std::move(*input);
   }
 
-  return content;
+  // Paging jumps around the file, so map it rather than copy it.
+  auto input = MappedFile::open(filename, AccessHint::Random);
+  if (!input) {
+    return std::unexpected(std::string("cannot open '") + filename + "' for reading");
+  }
+  return std::move(*input);
 }
 
 // Simple pager implementation - displays content page by page
-auto simple_pager(const Config& cfg, const std::string& content) -> int {
+auto simple_pager(const Config& cfg, std::string_view content) -> int {
   if (!isOutputConsole()) {
     // Not a terminal, just output everything
     safePrint(content);
@@ -149,11 +138,11 @@ auto simple_pager(const Config& cfg, const std::string& content) -> int {
   }
 
   // Split into lines
-  SmallVector<std::string, 4096> lines;
+  std::vector<std::string_view> lines;
   size_t start = 0;
   while (start < content.size()) {
     size_t end = content.find('\n', start);
-    if (end == std::string::npos) {
+    if (end == std::string_view::npos) {
       lines.push_back(content.substr(start));
       break;
     }
@@ -205,6 +194,7 @@ auto simple_pager(const Config& cfg, const std::string& content) -> int {
 
     // Simple prompt (non-interactive for now)
     safePrintLn("--Press Enter to continue, q to quit--");
+    flushOutput();
 
     // For simplicity, just read one character
     // A full implementation would use proper console input handling
@@ -229,13 +219,13 @@ auto simple_pager(const Config& cfg, const std::string& content) -> int {
 
 auto run(const Config& cfg) -> int {
   for (const auto& file : cfg.files) {
-    auto content_result = read_file_content(file);
+    auto content_result = open_content(file);
     if (!content_result) {
       cp::report_error(content_result, L"less");
       return 1;
     }
 
-    int result = simple_pager(cfg, *content_result);
+    int result = simple_pager(cfg, content_result->view());
     if (result != 0) {
       return result;
     }
@@ -178,8 +178,9 @@ const std::array<const wchar_t *, 10> SCRIPT_EXTS = {
  * @return True if stream is a terminal
  */
 bool is_terminal(FILE *stream) {
-  DWORD mode;
-  return GetConsoleMode((HANDLE)_get_osfhandle(_fileno(stream)), &mode) != 0;
+  // The calling thread's handles, which differ from the process's on an
+  // in-process pipeline stage or a warm-server request
+  return stream == stderr ? isErrorConsole() : isOutputConsole();
 }
 
 // ======================================================
@@ -414,11 +415,7 @@ auto get_file_owner_and_group(bool use_numeric = false)
  * @return Terminal width in columns
  */
 auto get_terminal_width() -> int {
-  CONSOLE_SCREEN_BUFFER_INFO csbi;
-  if (GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &csbi)) {
-    return csbi.srWindow.Right - csbi.srWindow.Left + 1;
-  }
-  return 80;  // Default to 80 columns if we can't get terminal width
+  return getTerminalWidth();  // 80 when not writing to a console
 }
 
 /**
@@ -198,8 +198,8 @@ auto confirm_overwrite(const std::string& dest_path) -> cp::Result<bool> {
   safeErrorPrint(dest_path);
   safeErrorPrint("'? (y/n) ");
   char response;
-  std::cin.get(response);
-  std::cin.ignore(1024, '\n');
+  stdin_stream().get(response);
+  stdin_stream().ignore(1024, '\n');
   return response == 'y' || response == 'Y';
 }
 
@@ -118,6 +118,7 @@ REGISTER_COMMAND(
     priority_class = IDLE_PRIORITY_CLASS;
   }
 
+  flushOutput();
   if (!CreateProcessW(
         nullptr,
         const_cast<wchar_t*>(wcmd.c_str()),
@@ -59,7 +59,8 @@ namespace nl_pipeline {
 namespace cp = core::pipeline;
 
 struct Config {
-  std::string body_numbering = "t";  // t: non-empty, a: all, n: none
+  std::string body_numbering = "t";  // t: non-empty, a: all, n: none, pBRE
+  std::optional<Regex> body_regex;   // set for pBRE
   int line_increment = 1;
   std::string separator = "\t";
   int starting_number = 1;
@@ -77,7 +78,12 @@ auto build_config(const CommandContext<NL_OPTIONS.size()>& ctx)
   }
   if (!body_opt.empty()) {
     cfg.body_numbering = body_opt;
-    if (cfg.body_numbering != "t" && cfg.body_numbering != "a" && cfg.body_numbering != "n") {
+    if (cfg.body_numbering[0] == 'p') {
+      auto re = Regex::compile(std::string_view(cfg.body_numbering).substr(1));
+      if (!re) return std::unexpected(re.error());
+      cfg.body_regex.emplace(std::move(*re));
+    } else if (cfg.body_numbering != "t" && cfg.body_numbering != "a" &&
+               cfg.body_numbering != "n") {
       return std::unexpected("invalid body numbering style");
     }
   }
@@ -163,7 +169,7 @@ auto run(const Config& cfg) -> int {
     if (file == "-") {
       // Read from stdin
       std::string line;
-      while (std::getline(std::cin, line)) {
+      while (std::getline(stdin_stream(), line)) {
         bool should_number = false;
 
         if (cfg.body_numbering == "a") {
@@ -172,6 +178,9 @@ auto run(const Config& cfg) -> int {
         } else if (cfg.body_numbering == "t") {
           // Number only non-empty lines
           should_number = !line.empty();
+        } else if (cfg.body_regex) {
+          // Number lines matching the BRE
+          should_number = cfg.body_regex->search(line);
         }
         // cfg.body_numbering == "n" - don't number
 
@@ -215,6 +224,8 @@ auto run(const Config& cfg) -> int {
           should_number = true;
         } else if (cfg.body_numbering == "t") {
           should_number = !line.empty();
+        } else if (cfg.body_regex) {
+          should_number = cfg.body_regex->search(line);
         }
 
         if (should_number) {
@@ -90,6 +90,7 @@ REGISTER_COMMAND(
   // Set DETACHED_PROCESS to ignore console signals
   DWORD creation_flags = DETACHED_PROCESS | CREATE_NEW_PROCESS_GROUP;
 
+  flushOutput();
   if (!CreateProcessW(nullptr, const_cast<wchar_t*>(wcmd.c_str()), nullptr,
                       nullptr, FALSE, creation_flags, nullptr, nullptr, &si,
                       &pi)) {
@@ -167,7 +167,7 @@ REGISTER_COMMAND(
     }
   } else {
     std::string input;
-    input.assign(std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>());
+    input.assign(std::istreambuf_iterator<char>(stdin_stream()), std::istreambuf_iterator<char>());
     std::istringstream iss(input);
     std::string line;
     while (std::getline(iss, line)) {
@@ -184,7 +184,7 @@ namespace {
   }
 
   // Dump data using specified format
-  void dump_data(const std::vector<unsigned char>& data, size_t offset,
+  void dump_data(std::span<const unsigned char> data, size_t offset,
                  const std::vector<OutputType>& types, bool show_all) {
     const size_t bytes_per_line = 16;
     size_t pos = 0;
@@ -296,11 +296,17 @@ REGISTER_COMMAND(
     types = {OutputType::SHORT_HEX};
   }
 
-  // Read input
-  std::vector<unsigned char> data;
+  // Read input. A single file is used straight from its mapping; several
+  // files are concatenated.
+  std::vector<MappedFile> inputs;
 
   if (ctx.positionals.empty() || std::string(ctx.positionals[0]) == "-") {
-    data.assign(std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>());
+    auto input = MappedFile::from_stdin(AccessHint::Sequential);
+    if (!input) {
+      safeErrorPrintLn("od: " + input.error());
+      return 1;
+    }
+    inputs.push_back(std::move(*input));
   } else {
     for (const auto& filename : ctx.positionals) {
       std::string file_arg(filename);
@@ -318,38 +324,36 @@ REGISTER_COMMAND(
         expanded.push_back(file_arg);
       }
       for (const auto& exp : expanded) {
-        std::wstring wfile = utf8_to_wstring(exp);
-        HANDLE hFile = CreateFileW(wfile.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
-
-        if (hFile == INVALID_HANDLE_VALUE) {
-          safeErrorPrintLn("od: cannot open '" + exp + "'");
+        auto input = MappedFile::open(exp, AccessHint::Sequential);
+        if (!input) {
+          safeErrorPrintLn("od: " + input.error());
           continue;
         }
-
-        LARGE_INTEGER fileSize;
-        GetFileSizeEx(hFile, &fileSize);
-
-        size_t old_size = data.size();
-        data.resize(old_size + fileSize.QuadPart);
-        DWORD bytesRead;
-        ReadFile(hFile, data.data() + old_size, static_cast<DWORD>(fileSize.QuadPart), &bytesRead, nullptr);
-        data.resize(old_size + bytesRead);
-        CloseHandle(hFile);
+        inputs.push_back(std::move(*input));
       }
     }
   }
 
+  std::vector<unsigned char> joined;
+  std::span<const unsigned char> data;
+  if (inputs.size() == 1) {
+    data = std::span(reinterpret_cast<const unsigned char*>(inputs[0].data()),
+                     inputs[0].size());
+  } else {
+    for (const auto& input : inputs) {
+      joined.insert(joined.end(), input.data(), input.data() + input.size());
+    }
+    data = joined;
+  }
+
   // Apply skip and limit
   if (skip_bytes > 0) {
-    if (skip_bytes < data.size()) {
-      data.erase(data.begin(), data.begin() + skip_bytes);
-    } else {
-      data.clear();
-    }
+    data = skip_bytes < data.size() ? data.subspan(skip_bytes)
+                                    : std::span<const unsigned char>{};
   }
 
   if (limit_bytes > 0 && limit_bytes < data.size()) {
-    data.resize(limit_bytes);
+    data = data.first(limit_bytes);
   }
 
   // Dump data
@@ -103,7 +103,7 @@ auto read_lines(const std::string& filename, char delimiter = '\n') -> cp::Resul
     std::string content;
     {
       std::ostringstream oss;
-      oss << std::cin.rdbuf();
+      oss << stdin_stream().rdbuf();
       content = oss.str();
     }
     size_t start = 0;
@@ -259,7 +259,7 @@ REGISTER_COMMAND(
     ReadFile(hFile, patch_content.data(), static_cast<DWORD>(fileSize.QuadPart), &bytesRead, nullptr);
     CloseHandle(hFile);
   } else {
-    patch_content = std::string(std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>());
+    patch_content = std::string(std::istreambuf_iterator<char>(stdin_stream()), std::istreambuf_iterator<char>());
   }
 
   if (patch_content.empty()) {
@@ -195,7 +195,7 @@ auto read_file_content(const std::string& filename) -> std::vector<std::string>
   if (filename == "-") {
     // Read from stdin
     std::string line;
-    while (std::getline(std::cin, line)) {
+    while (std::getline(stdin_stream(), line)) {
       if (!line.empty() && line.back() == '\r') {
         line.pop_back();
       }
@@ -92,7 +92,7 @@ REV_OPTIONS) {
 
   if (files.empty()) {
     // Read from stdin
-    process_stream(std::cin);
+    process_stream(stdin_stream());
   } else {
     for (const auto& file : files) {
       auto wfile = utf8_to_wstring(file);
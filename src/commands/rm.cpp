@@ -197,7 +197,7 @@ auto remove_path(const std::string& path,
     safeErrorPrint(path);
     safeErrorPrint("'? (y/n) ");
     char response;
-    std::cin.get(response);
+    stdin_stream().get(response);
     if (response != 'y' && response != 'Y') {
       return true;
     }
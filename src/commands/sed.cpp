@@ -36,18 +36,17 @@ namespace sed_pipeline {
   
   struct Script {
     enum class Kind { Subst, Print, Delete, Append, Insert, Change, Quit } kind;
-    std::regex pattern;      // for Subst
+    std::optional<Regex> pattern;  // for Subst
     std::string replacement; // for Subst
     bool global = false;     // for Subst
     bool print_on_match = false;  // for Subst
-    bool ecma_repl = false;  // use $1 style in replacement
     std::string text;        // for Append/Insert/Change
     std::array<unsigned char, 256> ymap{}; // for y///
     bool has_ymap = false;
     struct Address {
       enum class Kind { None, Line, Last, Regex } kind = Kind::None;
       size_t line_no = 0;
-      std::regex regex;
+      std::optional<Regex> regex;
     } addr1, addr2;
   };
 
@@ -55,8 +54,7 @@ namespace sed_pipeline {
     bool suppress_output = false;
     SmallVector<Script, 32> scripts;
     SmallVector<std::string, 64> files;
-    std::regex_constants::syntax_option_type regex_syntax =
-        std::regex_constants::basic;
+    RegexSyntax regex_syntax = RegexSyntax::Basic;
   };
 
   struct ScriptState {
@@ -77,8 +75,7 @@ namespace sed_pipeline {
   }
 
   // parse s/pat/repl/flags
-  auto parse_subst(std::string_view expr,
-                   std::regex_constants::syntax_option_type syntax)
+  auto parse_subst(std::string_view expr, RegexSyntax syntax)
       -> cp::Result<Script> {
     if (expr.size() < 4 || expr[0] != 's')
       return std::unexpected("unsupported script (only s///)");
@@ -127,18 +124,24 @@ namespace sed_pipeline {
       else return std::unexpected("unknown flag in s command");
     }
 
-    try {
-      Script s;
-      s.kind = Script::Kind::Subst;
-      s.pattern = std::regex(pat, syntax);
-      s.replacement = repl;
-      s.global = g;
-      s.print_on_match = pflag;
-      s.ecma_repl = (syntax == std::regex_constants::ECMAScript);
-      return s;
-    } catch (const std::regex_error&) {
-      return std::unexpected("invalid regular expression");
+    // Only pay for group tracking when the replacement uses \1..\9
+    RegexOptions opts;
+    opts.syntax = syntax;
+    for (size_t k = 0; k + 1 < repl.size(); ++k) {
+      if (repl[k] != '\\') continue;
+      if (repl[k + 1] >= '1' && repl[k + 1] <= '9') opts.captures = true;
+      ++k;
     }
+    auto re = Regex::compile(pat, opts);
+    if (!re) return std::unexpected(re.error());
+
+    Script s;
+    s.kind = Script::Kind::Subst;
+    s.pattern.emplace(std::move(*re));
+    s.replacement = repl;
+    s.global = g;
+    s.print_on_match = pflag;
+    return s;
   }
 
   auto parse_simple_cmd(std::string_view line) -> cp::Result<Script> {
@@ -229,8 +232,7 @@ namespace sed_pipeline {
     return s;
   }
 
-  auto parse_address(std::string_view line, size_t& i,
-                     std::regex_constants::syntax_option_type syntax)
+  auto parse_address(std::string_view line, size_t& i, RegexSyntax syntax)
       -> cp::Result<Script::Address> {
     Script::Address addr;
     if (i >= line.size()) return addr;
@@ -254,6 +256,7 @@ namespace sed_pipeline {
       for (; i < line.size(); ++i) {
         char c = line[i];
         if (escape) {
+          if (c != '/') pat.push_back('\\');
           pat.push_back(c);
           escape = false;
           continue;
@@ -264,13 +267,11 @@ namespace sed_pipeline {
         }
         if (c == '/') {
           ++i;
-          try {
-            addr.kind = Script::Address::Kind::Regex;
-            addr.regex = std::regex(pat, syntax);
-            return addr;
-          } catch (const std::regex_error&) {
-            return std::unexpected("invalid address regex");
-          }
+          auto re = Regex::compile(pat, RegexOptions{syntax});
+          if (!re) return std::unexpected(re.error());
+          addr.kind = Script::Address::Kind::Regex;
+          addr.regex.emplace(std::move(*re));
+          return addr;
         }
         pat.push_back(c);
       }
@@ -279,8 +280,7 @@ namespace sed_pipeline {
     return addr;
   }
 
-  auto parse_script_line(std::string_view line,
-                         std::regex_constants::syntax_option_type syntax)
+  auto parse_script_line(std::string_view line, RegexSyntax syntax)
       -> cp::Result<std::vector<Script>> {
     if (!line.empty() && (line.back() == '\r')) line.remove_suffix(1);
     if (line.empty()) return std::unexpected("empty script line");
@@ -382,8 +382,7 @@ namespace sed_pipeline {
     return out;
   }
 
-  auto read_script_file(const std::string& path,
-                        std::regex_constants::syntax_option_type syntax)
+  auto read_script_file(const std::string& path, RegexSyntax syntax)
       -> cp::Result<std::vector<Script>> {
     std::ifstream in(path, std::ios::binary);
     if (!in.is_open()) return std::unexpected("cannot open script file '" + path + "'");
@@ -407,7 +406,7 @@ namespace sed_pipeline {
 
     if (ctx.get<bool>("--regexp-extended", false) || ctx.get<bool>("-E", false) ||
         ctx.get<bool>("-r", false)) {
-      cfg.regex_syntax = std::regex_constants::ECMAScript;
+      cfg.regex_syntax = RegexSyntax::Extended;
     }
 
     std::vector<Script> scripts;
@@ -470,33 +469,35 @@ namespace sed_pipeline {
     bool explicit_print = false;
     should_quit = false;
 
-    auto to_ecma_repl = [](const std::string& in) -> std::string {
-      std::string out;
-      out.reserve(in.size());
-      out.reserve(in.size());
-      bool escape = false;
-      for (size_t i = 0; i < in.size(); ++i) {
-        char c = in[i];
-        if (escape) {
-          if (std::isdigit(static_cast<unsigned char>(c))) {
-            out.push_back('$');
-            out.push_back(c);
-          } else {
-            out.push_back('\\');
-            out.push_back(c);
-          }
-          escape = false;
+    // Expands & and \1..\9 in a replacement against the current match
+    auto expand_replacement = [](std::string_view repl, std::string_view text,
+                                 const std::vector<RegexMatch>& groups,
+                                 std::string& out) {
+      for (size_t i = 0; i < repl.size(); ++i) {
+        char c = repl[i];
+        if (c == '&') {
+          out.append(text.substr(groups[0].begin, groups[0].size()));
           continue;
         }
-        if (c == '\\') {
-          escape = true;
+        if (c != '\\' || i + 1 == repl.size()) {
+          out.push_back(c);
           continue;
         }
-        out.push_back(c);
+        char e = repl[++i];
+        if (e >= '0' && e <= '9') {
+          size_t g = static_cast<size_t>(e - '0');
+          if (g < groups.size() && groups[g].matched())
+            out.append(text.substr(groups[g].begin, groups[g].size()));
+        } else if (e == 'n') {
+          out.push_back('\n');
+        } else if (e == 't') {
+          out.push_back('\t');
+        } else {
+          out.push_back(e);
+        }
       }
-      if (escape) out.push_back('\\');
-      return out;
     };
+    std::vector<RegexMatch> groups;
 
     for (size_t idx = 0; idx < scripts.size(); ++idx) {
       const auto& s = scripts[idx];
@@ -506,7 +507,7 @@ namespace sed_pipeline {
         if (a.kind == Script::Address::Kind::None) return true;
         if (a.kind == Script::Address::Kind::Line) return line_no == a.line_no;
         if (a.kind == Script::Address::Kind::Last) return is_last;
-        return std::regex_search(current, a.regex);
+        return a.regex->search(current);
       };
 
       bool apply = false;
@@ -534,16 +535,33 @@ namespace sed_pipeline {
                   s.ymap[static_cast<unsigned char>(ch)]);
             }
           } else {
-            std::regex_constants::match_flag_type mflags =
-                std::regex_constants::format_default;
-            if (!s.global) mflags |= std::regex_constants::format_first_only;
-            std::string repl = s.ecma_repl ? to_ecma_repl(s.replacement)
-                                           : s.replacement;
-            std::string replaced =
-                std::regex_replace(current, s.pattern, repl, mflags);
-            bool changed = (replaced != current);
+            std::string replaced;
+            bool changed = false;
+            size_t cursor = 0;   // where the next search starts
+            size_t copied = 0;   // input consumed into REPLACED so far
+            size_t last_end = std::string::npos;
+            while (cursor <= current.size() &&
+                   s.pattern->find(current, cursor, groups)) {
+              const RegexMatch m = groups[0];
+              // An empty match right after the previous one is not a new
+              // match (s/b*/-/g on "abc" gives "-a-c-")
+              if (m.size() == 0 && m.begin == last_end) {
+                cursor = m.begin + 1;
+                continue;
+              }
+              replaced.append(current, copied, m.begin - copied);
+              expand_replacement(s.replacement, current, groups, replaced);
+              copied = m.end;
+              last_end = m.end;
+              changed = true;
+              if (!s.global) break;
+              cursor = m.size() == 0 ? m.end + 1 : m.end;
+            }
+            if (changed) {
+              replaced.append(current, copied);
+              current.swap(replaced);
+            }
             matched_any = matched_any || changed;
-            current.swap(replaced);
             if (s.print_on_match && changed) explicit_print = true;
           }
           break;
@@ -627,7 +645,7 @@ namespace sed_pipeline {
       std::ifstream file;
       std::istream* in = nullptr;
       if (f == "-") {
-        in = &std::cin;
+        in = &stdin_stream();
       } else {
         file.open(f, std::ios::binary);
         if (!file.is_open()) {
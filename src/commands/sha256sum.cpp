@@ -29,14 +29,10 @@
 /// @Version: 0.1.0
 /// @License: MIT
 /// @Copyright: Copyright © 2026 WinuxCmd
-// *** SIMPLIFIED IMPLEMENTATION - Some features may not be fully supported ***
 
 #include "pch/pch.h"
 //include other header after pch.h
 #include "core/command_macros.h"
-#include <wincrypt.h>
-
-#pragma comment(lib, "advapi32.lib")
 
 import std;
 import core;
@@ -48,182 +44,13 @@ using cmd::meta::OptionType;
 
 auto constexpr SHA256SUM_OPTIONS = std::array{
     OPTION("-b", "--binary", "read in binary mode (default)", BOOL_TYPE),
-    OPTION("-c", "--check", "read SHA256 sums from the FILEs and check them", STRING_TYPE),
+    OPTION("-c", "--check", "read SHA256 sums from the FILEs and check them", BOOL_TYPE),
     OPTION("-t", "--text", "read in text mode", BOOL_TYPE),
     OPTION("-q", "--quiet", "don't print OK for each successfully verified file", BOOL_TYPE),
     OPTION("-s", "--status", "don't output anything, status code shows success", BOOL_TYPE),
     OPTION("-w", "--warn", "warn about improperly formatted checksum lines", BOOL_TYPE)
 };
 
-namespace sha256sum_pipeline {
-namespace cp = core::pipeline;
-
-struct Config {
-  bool binary_mode = true;
-  bool check_mode = false;
-  bool text_mode = false;
-  bool quiet = false;
-  bool status = false;
-  bool warn = false;
-  std::string check_file;
-  SmallVector<std::string, 64> files;
-};
-
-auto build_config(const CommandContext<SHA256SUM_OPTIONS.size()>& ctx)
-    -> cp::Result<Config> {
-  Config cfg;
-  cfg.binary_mode = ctx.get<bool>("--binary", false) || ctx.get<bool>("-b", false);
-  auto check_opt = ctx.get<std::string>("--check", "");
-  cfg.check_mode = !check_opt.empty() || !ctx.get<std::string>("-c", "").empty();
-  cfg.text_mode = ctx.get<bool>("--text", false) || ctx.get<bool>("-t", false);
-  cfg.quiet = ctx.get<bool>("--quiet", false) || ctx.get<bool>("-q", false);
-  cfg.status = ctx.get<bool>("--status", false) || ctx.get<bool>("-s", false);
-  cfg.warn = ctx.get<bool>("--warn", false) || ctx.get<bool>("-w", false);
-
-  if (cfg.check_mode) {
-    cfg.check_file = ctx.get<std::string>("--check", "");
-    if (cfg.check_file.empty()) {
-      cfg.check_file = ctx.get<std::string>("-c", "");
-    }
-  }
-
-  for (auto arg : ctx.positionals) {
-    std::string file_arg(arg);
-    if (contains_wildcard(file_arg)) {
-      auto glob_result = glob_expand(file_arg);
-      if (glob_result.expanded) {
-        for (const auto& file : glob_result.files) {
-          cfg.files.push_back(wstring_to_utf8(file));
-        }
-        continue;
-      }
-    }
-    cfg.files.push_back(file_arg);
-  }
-
-  if (cfg.files.empty() && !cfg.check_mode) {
-    cfg.files.push_back("-");
-  }
-
-  return cfg;
-}
-
-// Calculate SHA256 hash using Windows CryptoAPI
-auto calculate_sha256(const std::string& filename) -> cp::Result<std::string> {
-  HCRYPTPROV hProv = 0;
-  HCRYPTHASH hHash = 0;
-
-  // Open cryptographic provider
-  if (!CryptAcquireContext(&hProv, NULL, NULL, PROV_RSA_AES, CRYPT_VERIFYCONTEXT)) {
-    return std::unexpected("failed to acquire cryptographic context");
-  }
-
-  // Create hash object for SHA256
-  // Note: SHA256 requires PROV_RSA_AES or a SHA256-capable provider
-  // For older Windows versions, we might need a different approach
-  ALG_ID alg_id = CALG_SHA_256;
-  if (!CryptCreateHash(hProv, alg_id, 0, 0, &hHash)) {
-    CryptReleaseContext(hProv, 0);
-    return std::unexpected("failed to create hash object");
-  }
-
-  bool success = false;
-  if (filename == "-" || filename.empty()) {
-    // Read from stdin
-    std::array<char, 8192> buffer;
-    size_t bytes_read;
-
-    while ((bytes_read = fread(buffer.data(), 1, buffer.size(), stdin)) > 0) {
-      if (!CryptHashData(hHash, reinterpret_cast<BYTE*>(buffer.data()),
-                         static_cast<DWORD>(bytes_read), 0)) {
-        CryptDestroyHash(hHash);
-        CryptReleaseContext(hProv, 0);
-        return std::unexpected("failed to hash data");
-      }
-    }
-    success = true;
-  } else {
-    // Read from file
-    std::ifstream file(filename, std::ios::binary);
-    if (!file) {
-      CryptDestroyHash(hHash);
-      CryptReleaseContext(hProv, 0);
-      return std::unexpected(std::string("cannot open '") + filename + "' for reading");
-    }
-
-    std::array<char, 8192> buffer;
-    while (file) {
-      file.read(buffer.data(), buffer.size());
-      std::streamsize bytes_read = file.gcount();
-      if (bytes_read > 0) {
-        if (!CryptHashData(hHash, reinterpret_cast<BYTE*>(buffer.data()),
-                           static_cast<DWORD>(bytes_read), 0)) {
-          CryptDestroyHash(hHash);
-          CryptReleaseContext(hProv, 0);
-          return std::unexpected("failed to hash data");
-        }
-      }
-    }
-    success = !file.fail();
-  }
-
-  // Get hash value
-  DWORD hash_len = 32;  // SHA256 produces 32 bytes
-  std::array<BYTE, 32> hash_value{};
-
-  if (!CryptGetHashParam(hHash, HP_HASHVAL, hash_value.data(), &hash_len, 0)) {
-    CryptDestroyHash(hHash);
-    CryptReleaseContext(hProv, 0);
-    return std::unexpected("failed to get hash value");
-  }
-
-  CryptDestroyHash(hHash);
-  CryptReleaseContext(hProv, 0);
-
-  // Convert to hex string
-  std::string result;
-  result.reserve(64);
-  for (DWORD i = 0; i < hash_len; ++i) {
-    char buf[3];
-    snprintf(buf, sizeof(buf), "%02x", hash_value[i]);
-    result += buf;
-  }
-
-  return result;
-}
-
-auto run(const Config& cfg) -> int {
-  if (cfg.check_mode) {
-    // Check mode (not fully implemented)
-    cp::report_custom_error(L"sha256sum", L"check mode is not fully implemented in this version");
-    return 1;
-  }
-
-  bool all_ok = true;
-
-  for (const auto& file : cfg.files) {
-    auto hash_result = calculate_sha256(file);
-    if (!hash_result) {
-      cp::report_error(hash_result, L"sha256sum");
-      all_ok = false;
-      continue;
-    }
-
-    // Output format: HASH  FILENAME
-    safePrint(*hash_result);
-    safePrint("  ");
-    if (file == "-") {
-      safePrint("-\n");
-    } else {
-      safePrintLn(file);
-    }
-  }
-
-  return all_ok ? 0 : 1;
-}
-
-}  // namespace sha256sum_pipeline
-
 REGISTER_COMMAND(sha256sum, "sha256sum",
                  "sha256sum [OPTION]... [FILE]...",
                  "Compute and check SHA256 message digest.\n"
@@ -234,13 +61,5 @@ REGISTER_COMMAND(sha256sum, "sha256sum",
                  "  sha256sum *.txt > checksums.sha256",
                  "md5sum(1), sha1sum(1)", "WinuxCmd",
                  "Copyright © 2026 WinuxCmd", SHA256SUM_OPTIONS) {
-  using namespace sha256sum_pipeline;
-
-  auto cfg_result = build_config(ctx);
-  if (!cfg_result) {
-    cp::report_error(cfg_result, L"sha256sum");
-    return 1;
-  }
-
-  return run(*cfg_result);
+  return checksum_main(ctx, L"sha256sum", "SHA256", HashAlgorithm::Sha256);
 }
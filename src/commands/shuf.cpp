@@ -149,7 +149,7 @@ auto run(const Config& cfg) -> int {
     for (const auto& file : files) {
       if (file == "-") {
         std::string line;
-        while (std::getline(std::cin, line)) {
+        while (std::getline(stdin_stream(), line)) {
           lines.push_back(line);
         }
       } else {
@@ -57,7 +57,7 @@ auto constexpr SORT_OPTIONS = std::array{
            "compare human readable numbers (e.g., 1K, 2M)"),
     OPTION("-M", "--month-sort",
            "compare as month names [NOT SUPPORT]"),
-    OPTION("-m", "--merge", "merge already sorted files [NOT SUPPORT]"),
+    OPTION("-m", "--merge", "merge already sorted files; do not sort"),
     OPTION("-n", "--numeric-sort", "compare according to string numerical value"),
     OPTION("-R", "--random-sort", "shuffle [NOT SUPPORT]"),
     OPTION("-r", "--reverse", "reverse the result of comparisons"),
@@ -70,7 +70,20 @@ auto constexpr SORT_OPTIONS = std::array{
     OPTION("-t", "--field-separator",
            "use SEP instead of non-blank to blank transition", STRING_TYPE),
     OPTION("-k", "--key",
-           "sort via a key; KEYDEF has form F[.C][,F[.C]]", STRING_TYPE)};
+           "sort via a key; KEYDEF has form F[.C][,F[.C]]", STRING_TYPE),
+    OPTION("-S", "--buffer-size",
+           "use SIZE for the main memory buffer (b, K, M, G, T or %)",
+           STRING_TYPE),
+    OPTION("-T", "--temporary-directory",
+           "use DIR for temporaries, not $TMPDIR or the system temp dir",
+           STRING_TYPE),
+    OPTION("", "--batch-size",
+           "merge at most NMERGE inputs at once; for more use temp files",
+           INT_TYPE),
+    OPTION("", "--compress-runs",
+           "front-code temporary files, storing shared prefixes once"),
+    OPTION("", "--parallel", "change the number of sorts run concurrently to N",
+           INT_TYPE)};
 
 namespace sort_pipeline {
 namespace cp = core::pipeline;
@@ -88,51 +101,29 @@ struct Config {
   bool general_numeric = false;
   bool reverse = false;
   bool unique = false;
+  bool merge = false;  // -m: inputs are already sorted
   char delimiter = '\n';
   std::optional<char> field_separator;
   std::string output_file;
   KeySpec key;
   SmallVector<std::string, 64> files{};  // SmallVector for paths, stack-allocated
+  size_t buffer_size = 0;  // -S in bytes
+  std::string temp_dir;
+  size_t batch_size = 16;
+  bool compress_runs = false;
+  size_t parallel = 1;  // threads for sorting a chunk
 };
 
-auto read_all(std::istream& in) -> std::string {
-  return read_text_stream(in);
-}
-
-auto read_source(std::string_view path) -> cp::Result<std::string> {
-  if (path == "-") return read_all(std::cin);
-
-  std::ifstream in(std::string(path), std::ios::binary);
+auto open_reader(std::string_view path, char delimiter, std::ifstream& in)
+    -> cp::Result<LineReader> {
+  LineReaderOptions options;
+  options.delimiter = delimiter;
+  if (path == "-") return LineReader::for_stdin(options);
+  in.open(std::string(path), std::ios::binary);
   if (!in.is_open()) {
-    return std::unexpected("cannot open '" + std::string(path) + "'");
-  }
-  return read_all(in);
-}
-
-auto split_records(std::string_view content, char delimiter)
-    -> std::vector<std::string> {
-  std::vector<std::string> out;
-  out.reserve(content.size() / 20);  // Estimate: assume ~20 chars per record
-  size_t start = 0;
-  for (size_t i = 0; i < content.size(); ++i) {
-    if (content[i] == delimiter) {
-      out.emplace_back(content.substr(start, i - start));
-      start = i + 1;
-    }
-  }
-  if (start < content.size()) {
-    out.emplace_back(content.substr(start));
-  }
-  return out;
-}
-
-auto to_lower_ascii(std::string_view s) -> std::string {
-  std::string out;
-  out.reserve(s.size());
-  for (unsigned char c : s) {
-    out.push_back(static_cast<char>(std::tolower(c)));
+    return std::unexpected("cannot open input file");
   }
-  return out;
+  return LineReader(in, options);
 }
 
 auto ltrim_ascii(std::string_view s) -> std::string_view {
@@ -224,18 +215,42 @@ auto extract_key(std::string_view line, const Config& cfg) -> std::string_view {
   return key;
 }
 
+// Run FN on a NUL-terminated copy of S (strtod needs one; keys are views
+// into a line). Short keys stay on the stack.
+template <typename Fn>
+auto with_c_string(std::string_view s, Fn&& fn) {
+  char small[64];
+  if (s.size() < sizeof(small)) {
+    std::memcpy(small, s.data(), s.size());
+    small[s.size()] = '\0';
+    return fn(static_cast<const char*>(small));
+  }
+  std::string copy(s);
+  return fn(copy.c_str());
+}
+
 auto parse_double_strict(std::string_view s) -> std::optional<double> {
   auto trimmed = ltrim_ascii(s);
   if (trimmed.empty()) return std::nullopt;
 
-  std::string local(trimmed);
-  char* end = nullptr;
-  errno = 0;
-  const double value = std::strtod(local.c_str(), &end);
-  if (end == local.c_str() || *end != '\0' || errno == ERANGE) {
-    return std::nullopt;
-  }
-  return value;
+  return with_c_string(trimmed, [](const char* text) -> std::optional<double> {
+    char* end = nullptr;
+    errno = 0;
+    const double value = std::strtod(text, &end);
+    if (end == text || *end != '\0' || errno == ERANGE) return std::nullopt;
+    return value;
+  });
+}
+
+// -g: the longest numeric prefix, 0 when there is none or it overflows
+auto parse_general_numeric(std::string_view s) -> double {
+  return with_c_string(s, [](const char* text) {
+    char* end = nullptr;
+    errno = 0;
+    const double value = std::strtod(text, &end);
+    if (end == text || errno == ERANGE) return 0.0;
+    return value;
+  });
 }
 
 auto parse_human_readable(std::string_view s) -> double {
@@ -261,96 +276,685 @@ auto parse_human_readable(std::string_view s) -> double {
   }
 
   if (num_str.empty()) return 0.0;
-  try {
-    return std::stod(num_str) * multiplier;
-  } catch (...) {
-    return 0.0;
-  }
+  return parse_general_numeric(num_str) * multiplier;
 }
 
-auto compare_records(std::string_view a, std::string_view b, const Config& cfg)
-    -> int {
-  auto key_a = extract_key(a, cfg);
-  auto key_b = extract_key(b, cfg);
+/**
+ * @brief A record decorated with everything its comparisons need.
+ *
+ * The key is located and parsed once, when the record is read, instead of
+ * on every comparison. `prefix` holds the first eight key bytes (folded for
+ * -f) in big-endian order, so most comparisons are settled by a single
+ * integer compare before the bytes themselves are looked at.
+ */
+struct SortRecord {
+  std::string_view line;
+  std::string_view key;     // Inside line
+  double number = 0.0;      // -n, -h, -g
+  bool has_number = false;  // -n leaves it false for non-numbers
+  std::uint64_t prefix = 0;
+};
+
+auto fold_ascii(unsigned char c) -> unsigned char {
+  return c >= 'A' && c <= 'Z' ? static_cast<unsigned char>(c + ('a' - 'A')) : c;
+}
+
+auto key_prefix(std::string_view key, bool fold) -> std::uint64_t {
+  std::uint64_t prefix = 0;
+  for (size_t i = 0; i < 8; ++i) {
+    prefix <<= 8;
+    if (i < key.size()) {
+      const auto c = static_cast<unsigned char>(key[i]);
+      prefix |= fold ? fold_ascii(c) : c;
+    }
+  }
+  return prefix;
+}
 
+auto decorate(std::string_view line, const Config& cfg) -> SortRecord {
+  SortRecord rec;
+  rec.line = line;
+  rec.key = extract_key(line, cfg);
   if (cfg.numeric_sort) {
-    auto n_a = parse_double_strict(key_a);
-    auto n_b = parse_double_strict(key_b);
-    if (n_a.has_value() && n_b.has_value()) {
-      if (*n_a < *n_b) return -1;
-      if (*n_a > *n_b) return 1;
+    if (auto value = parse_double_strict(rec.key)) {
+      rec.number = *value;
+      rec.has_number = true;
     }
   } else if (cfg.human_numeric) {
-    double a_val = parse_human_readable(key_a);
-    double b_val = parse_human_readable(key_b);
-    if (a_val < b_val) return -1;
-    if (a_val > b_val) return 1;
+    rec.number = parse_human_readable(rec.key);
+    rec.has_number = true;
   } else if (cfg.general_numeric) {
-    double a_val = 0.0, b_val = 0.0;
-    try { a_val = std::stod(std::string(key_a)); } catch (...) {}
-    try { b_val = std::stod(std::string(key_b)); } catch (...) {}
-    if (a_val < b_val) return -1;
-    if (a_val > b_val) return 1;
+    rec.number = parse_general_numeric(rec.key);
+    rec.has_number = true;
   }
+  rec.prefix = key_prefix(rec.key, cfg.ignore_case);
+  return rec;
+}
 
-  std::string left = std::string(key_a);
-  std::string right = std::string(key_b);
-  if (cfg.ignore_case) {
-    left = to_lower_ascii(left);
-    right = to_lower_ascii(right);
+auto compare_folded(std::string_view a, std::string_view b) -> int {
+  const size_t n = std::min(a.size(), b.size());
+  for (size_t i = 0; i < n; ++i) {
+    const auto ca = fold_ascii(static_cast<unsigned char>(a[i]));
+    const auto cb = fold_ascii(static_cast<unsigned char>(b[i]));
+    if (ca != cb) return ca < cb ? -1 : 1;
   }
+  if (a.size() == b.size()) return 0;
+  return a.size() < b.size() ? -1 : 1;
+}
 
-  if (left < right) return -1;
-  if (left > right) return 1;
+auto compare_records(const SortRecord& a, const SortRecord& b,
+                     const Config& cfg) -> int {
+  // -n only orders two numbers; anything else falls back to the bytes
+  if (a.has_number && b.has_number) {
+    if (a.number < b.number) return -1;
+    if (a.number > b.number) return 1;
+  }
 
-  if (a < b) return -1;
-  if (a > b) return 1;
-  return 0;
+  if (a.prefix != b.prefix) return a.prefix < b.prefix ? -1 : 1;
+  int cmp = cfg.ignore_case ? compare_folded(a.key, b.key) : a.key.compare(b.key);
+  if (cmp == 0) cmp = a.line.compare(b.line);
+  return cmp < 0 ? -1 : (cmp > 0 ? 1 : 0);
+}
+
+// Order used for the output: compare_records, flipped by -r
+auto sort_order(const SortRecord& a, const SortRecord& b, const Config& cfg)
+    -> int {
+  int cmp = compare_records(a, b, cfg);
+  return cfg.reverse ? -cmp : cmp;
+}
+
+// Key byte DEPTH for multikey_quicksort, -1 past the end; the first eight
+// come from the cached prefix so the line itself is rarely touched
+auto key_byte(const SortRecord& rec, size_t depth) -> int {
+  if (depth >= rec.key.size()) return -1;
+  if (depth < 8) {
+    return static_cast<int>((rec.prefix >> (56 - 8 * depth)) & 0xff);
+  }
+  return static_cast<unsigned char>(rec.key[depth]);
+}
+
+// Unsigned integer that orders as VALUE does (not NaN)
+auto number_bits(double value) -> std::uint64_t {
+  if (value == 0.0) value = 0.0;  // -0 orders with +0
+  const auto bits = std::bit_cast<std::uint64_t>(value);
+  return (bits >> 63) != 0 ? ~bits : bits | (1ULL << 63);
+}
+
+/**
+ * @brief Sort [FIRST, LAST) into sort_order, by the fastest engine the
+ * keys allow.
+ *
+ * Plain byte keys (no -n/-h/-g/-f) go through multikey quicksort, and
+ * numeric keys through an LSD radix sort on their encoded values when every
+ * record has one. Records the engines leave in an arbitrary order compare
+ * equal down to the whole line, i.e. are identical, so the result is the
+ * same as the stable comparison sort, which handles everything else.
+ */
+template <typename Iter>
+auto sort_records(Iter first, Iter last, const Config& cfg) -> void {
+  constexpr std::ptrdiff_t kMinRadix = 256;
+  auto by_record = [&](const SortRecord& a, const SortRecord& b) {
+    return compare_records(a, b, cfg) < 0;
+  };
+  const bool numeric =
+      cfg.numeric_sort || cfg.human_numeric || cfg.general_numeric;
+
+  if (last - first >= kMinRadix && !numeric && !cfg.ignore_case) {
+    multikey_quicksort(first, last, key_byte, [&](Iter tie, Iter tie_end) {
+      // Equal keys are ordered by the whole line
+      if (!cfg.key.enabled) return;
+      std::sort(tie, tie_end, [](const SortRecord& a, const SortRecord& b) {
+        return a.line < b.line;
+      });
+    });
+    if (cfg.reverse) std::reverse(first, last);
+    return;
+  }
+
+  if (last - first >= kMinRadix && numeric &&
+      std::all_of(first, last, [](const SortRecord& r) {
+        return r.has_number && !std::isnan(r.number);
+      })) {
+    struct Slot {
+      std::uint64_t bits;
+      size_t index;
+    };
+    const auto n = static_cast<size_t>(last - first);
+    std::vector<Slot> slots(n);
+    for (size_t i = 0; i < n; ++i) {
+      slots[i] = {number_bits(first[i].number), i};
+    }
+    lsd_radix_sort(slots.begin(), slots.end(),
+                   [](const Slot& slot) { return slot.bits; });
+
+    std::vector<SortRecord> sorted;
+    sorted.reserve(n);
+    for (const Slot& slot : slots) sorted.push_back(first[slot.index]);
+    // Equal numbers are ordered by their bytes
+    for (size_t run = 0; run < n;) {
+      size_t end = run + 1;
+      while (end < n && slots[end].bits == slots[run].bits) ++end;
+      if (end - run > 1) {
+        std::sort(sorted.begin() + run, sorted.begin() + end, by_record);
+      }
+      run = end;
+    }
+    std::copy(sorted.begin(), sorted.end(), first);
+    if (cfg.reverse) std::reverse(first, last);
+    return;
+  }
+
+  std::stable_sort(first, last, [&](const SortRecord& a, const SortRecord& b) {
+    return sort_order(a, b, cfg) < 0;
+  });
+}
+
+// Sort one chunk of records and, for -u, keep the first of each equal run
+auto sort_chunk(std::vector<SortRecord>& records, const Config& cfg) -> void {
+  parallel_stable_sort(
+      records.begin(), records.end(),
+      [&](const SortRecord& a, const SortRecord& b) {
+        return sort_order(a, b, cfg) < 0;
+      },
+      cfg.parallel,
+      [&](auto first, auto last) { sort_records(first, last, cfg); });
+
+  if (cfg.unique) {
+    auto last = std::unique(records.begin(), records.end(),
+                            [&](const SortRecord& a, const SortRecord& b) {
+                              return compare_records(a, b, cfg) == 0;
+                            });
+    records.erase(last, records.end());
+  }
+}
+
+// Without --parallel: one thread per processor, as nproc counts them, but
+// no more than 8; past that the merge is limited by memory bandwidth.
+auto default_parallel() -> size_t {
+  SYSTEM_INFO sysInfo;
+  GetSystemInfo(&sysInfo);
+  return std::clamp<size_t>(sysInfo.dwNumberOfProcessors, 1, 8);
+}
+
+auto physical_memory() -> std::uint64_t {
+  MEMORYSTATUSEX mem_status;
+  mem_status.dwLength = sizeof(mem_status);
+  if (!GlobalMemoryStatusEx(&mem_status)) return 0;
+  return mem_status.ullTotalPhys;
+}
+
+// Without -S: a quarter of physical memory, capped so that a huge machine
+// still spills before it starts paging.
+auto default_buffer_size() -> size_t {
+  constexpr std::uint64_t kFallback = 512ULL * 1024 * 1024;
+  constexpr std::uint64_t kCap = 2ULL * 1024 * 1024 * 1024;
+  const std::uint64_t physical = physical_memory();
+  if (physical == 0) return static_cast<size_t>(kFallback);
+  return static_cast<size_t>(std::min(physical / 4, kCap));
+}
+
+// -S SIZE: a number with a b, K, M, G or T suffix (K when there is none, as
+// in GNU sort), or a percentage of physical memory
+auto parse_buffer_size(std::string_view text) -> cp::Result<size_t> {
+  std::uint64_t value = 0;
+  auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+  if (ec != std::errc() || ptr == text.data()) {
+    return std::unexpected("invalid -S argument");
+  }
+  std::string_view suffix(ptr, text.data() + text.size() - ptr);
+
+  std::uint64_t bytes = 0;
+  if (suffix == "%") {
+    if (value > 100) return std::unexpected("invalid -S argument");
+    bytes = physical_memory() / 100 * value;
+  } else {
+    std::uint64_t multiplier = 0;
+    if (suffix.empty()) suffix = "K";
+    if (suffix.size() == 1) {
+      switch (suffix[0]) {
+        case 'b': multiplier = 1; break;
+        case 'k': case 'K': multiplier = 1ULL << 10; break;
+        case 'm': case 'M': multiplier = 1ULL << 20; break;
+        case 'g': case 'G': multiplier = 1ULL << 30; break;
+        case 't': case 'T': multiplier = 1ULL << 40; break;
+        default: break;
+      }
+    }
+    if (multiplier == 0 ||
+        value > std::numeric_limits<std::uint64_t>::max() / multiplier) {
+      return std::unexpected("invalid -S argument");
+    }
+    bytes = value * multiplier;
+  }
+  bytes = std::min<std::uint64_t>(bytes, std::numeric_limits<size_t>::max());
+  return static_cast<size_t>(std::max<std::uint64_t>(bytes, 1));
+}
+
+auto default_temp_dir() -> std::string {
+  if (const char* env = std::getenv("TMPDIR"); env != nullptr && *env != '\0')
+    return env;
+  std::error_code ec;
+  auto dir = std::filesystem::temp_directory_path(ec);
+  return ec ? std::string(".") : dir.string();
 }
 
-auto is_unsupported_used(const CommandContext<SORT_OPTIONS.size()>& ctx)
+auto temp_dir(const Config& cfg) -> std::string {
+  return cfg.temp_dir.empty() ? default_temp_dir() : cfg.temp_dir;
+}
+
+/**
+ * @brief A temporary file that is removed when its owner goes away.
+ */
+class TempFile {
+ public:
+  static auto create(const std::string& dir) -> cp::Result<TempFile> {
+    static std::atomic<std::uint64_t> counter{0};
+    std::random_device rd;
+    for (int attempt = 0; attempt < 100; ++attempt) {
+      const std::uint64_t tag =
+          (static_cast<std::uint64_t>(rd()) << 32) ^ rd() ^ ++counter;
+      auto path = std::filesystem::path(dir) /
+                  std::format("sort{:016x}.tmp", tag);
+      std::error_code ec;
+      if (std::filesystem::exists(path, ec) || ec) continue;
+      TempFile file;
+      file.path_ = std::move(path);
+      return file;
+    }
+    return std::unexpected("cannot create temporary file");
+  }
+
+  TempFile() = default;
+  TempFile(TempFile&& other) noexcept : path_(std::exchange(other.path_, {})) {}
+  TempFile& operator=(TempFile&& other) noexcept {
+    if (this != &other) {
+      remove();
+      path_ = std::exchange(other.path_, {});
+    }
+    return *this;
+  }
+  TempFile(const TempFile&) = delete;
+  TempFile& operator=(const TempFile&) = delete;
+  ~TempFile() { remove(); }
+
+  const std::filesystem::path& path() const { return path_; }
+
+ private:
+  std::filesystem::path path_;
+
+  void remove() {
+    if (path_.empty()) return;
+    std::error_code ec;
+    std::filesystem::remove(path_, ec);
+    path_.clear();
+  }
+};
+
+constexpr size_t kRunIoBuffer = 256 * 1024;
+
+/**
+ * @brief Writes one sorted run to a temporary file.
+ *
+ * Records are stored length-prefixed (LEB128), so any byte may appear in
+ * them. With --compress-runs each record only stores what differs from the
+ * previous one: sorted runs share long prefixes, which are kept once.
+ */
+class RunWriter {
+ public:
+  RunWriter(const std::filesystem::path& path, bool front_code)
+      : front_code_(front_code), buffer_(kRunIoBuffer) {
+    out_.rdbuf()->pubsetbuf(buffer_.data(),
+                            static_cast<std::streamsize>(buffer_.size()));
+    out_.open(path, std::ios::binary | std::ios::trunc);
+  }
+  RunWriter(const RunWriter&) = delete;
+  RunWriter& operator=(const RunWriter&) = delete;
+
+  bool is_open() const { return out_.is_open(); }
+
+  void write(std::string_view record) {
+    if (front_code_) {
+      const size_t limit = std::min(record.size(), previous_.size());
+      size_t shared = 0;
+      while (shared < limit && record[shared] == previous_[shared]) ++shared;
+      put_varint(shared);
+      put_varint(record.size() - shared);
+      out_.write(record.data() + shared,
+                 static_cast<std::streamsize>(record.size() - shared));
+      previous_.assign(record);
+    } else {
+      put_varint(record.size());
+      out_.write(record.data(), static_cast<std::streamsize>(record.size()));
+    }
+  }
+
+  /// Flush and close; false if any write failed
+  bool finish() {
+    out_.flush();
+    const bool ok = out_.good();
+    out_.close();
+    return ok;
+  }
+
+ private:
+  std::ofstream out_;
+  bool front_code_;
+  std::string previous_;
+  std::vector<char> buffer_;
+
+  void put_varint(size_t value) {
+    while (value >= 0x80) {
+      out_.put(static_cast<char>((value & 0x7F) | 0x80));
+      value >>= 7;
+    }
+    out_.put(static_cast<char>(value));
+  }
+};
+
+/// Reads back a run written by RunWriter
+class RunReader {
+ public:
+  RunReader(const std::filesystem::path& path, bool front_coded)
+      : front_coded_(front_coded), buffer_(kRunIoBuffer) {
+    in_.rdbuf()->pubsetbuf(buffer_.data(),
+                           static_cast<std::streamsize>(buffer_.size()));
+    in_.open(path, std::ios::binary);
+    failed_ = !in_.is_open();
+  }
+  RunReader(const RunReader&) = delete;
+  RunReader& operator=(const RunReader&) = delete;
+
+  /// Load the next record into current(); false at the end or on error
+  bool next() {
+    if (failed_) return false;
+    size_t shared = 0;
+    if (front_coded_) {
+      if (!get_varint(shared)) return false;
+      if (shared > current_.size()) return fail();
+    }
+    size_t length = 0;
+    if (!get_varint(length)) return front_coded_ ? fail() : false;
+    current_.resize(shared + length);
+    in_.read(current_.data() + shared, static_cast<std::streamsize>(length));
+    if (static_cast<size_t>(in_.gcount()) != length) return fail();
+    return true;
+  }
+
+  std::string_view current() const { return current_; }
+  bool failed() const { return failed_; }
+
+ private:
+  std::ifstream in_;
+  bool front_coded_;
+  bool failed_ = false;
+  std::string current_;
+  std::vector<char> buffer_;
+
+  bool fail() {
+    failed_ = true;
+    return false;
+  }
+
+  // False at a clean end of file
+  bool get_varint(size_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      const int c = in_.get();
+      if (c == std::char_traits<char>::eof()) {
+        return shift == 0 ? false : fail();
+      }
+      value |= static_cast<size_t>(c & 0x7F) << shift;
+      if ((c & 0x80) == 0) return true;
+    }
+    return fail();
+  }
+};
+
+/// One input of a merge: a run file, the last chunk still in memory, or
+/// (for -m) an input file that is already sorted
+class RunCursor {
+ public:
+  RunCursor(const std::filesystem::path& path, const Config& cfg)
+      : file_(std::make_unique<RunReader>(path, cfg.compress_runs)),
+        cfg_(&cfg) {}
+  explicit RunCursor(const std::vector<SortRecord>& records)
+      : memory_(&records) {}
+
+  static auto open_input(std::string_view path, const Config& cfg)
+      -> cp::Result<RunCursor> {
+    RunCursor cursor;
+    cursor.stream_ = std::make_unique<std::ifstream>();
+    auto reader = open_reader(path, cfg.delimiter, *cursor.stream_);
+    if (!reader) return std::unexpected(reader.error());
+    cursor.text_.emplace(std::move(*reader));
+    cursor.cfg_ = &cfg;
+    return cursor;
+  }
+
+  bool next() {
+    if (file_ || text_) {
+      std::string_view record;
+      if (file_) {
+        if (!file_->next()) return false;
+        record = file_->current();
+      } else if (!text_->next(record)) {
+        return false;
+      }
+      // Records read from disk are decorated once each, as they arrive
+      decorated_ = decorate(record, *cfg_);
+      current_ = &decorated_;
+      return true;
+    }
+    if (index_ >= memory_->size()) return false;
+    current_ = &(*memory_)[index_++];
+    return true;
+  }
+
+  const SortRecord& current() const { return *current_; }
+  bool failed() const { return file_ && file_->failed(); }
+
+ private:
+  std::unique_ptr<RunReader> file_;
+  std::unique_ptr<std::ifstream> stream_;  // Kept at a fixed address for text_
+  std::optional<LineReader> text_;
+  const Config* cfg_ = nullptr;
+  SortRecord decorated_;
+  const std::vector<SortRecord>* memory_ = nullptr;
+  size_t index_ = 0;
+  const SortRecord* current_ = nullptr;
+
+  RunCursor() = default;
+};
+
+/**
+ * @brief Merge sorted SOURCES into SINK, dropping -u duplicates.
+ *
+ * Sources must be in input order: ties go to the lower index, which keeps
+ * the merge stable and so gives the same output as one in-memory sort.
+ * @return false if a run could not be read back
+ */
+template <typename Sink>
+auto merge_runs(std::vector<RunCursor>& sources, const Config& cfg,
+                Sink&& sink) -> bool {
+  LoserTree tree(sources.size(), [&](size_t a, size_t b) {
+    return sort_order(sources[a].current(), sources[b].current(), cfg);
+  });
+  tree.build([&](size_t i) { return sources[i].next(); });
+
+  // -u compares against a copy: the source's view dies when it advances
+  std::string last_line;
+  SortRecord last;
+  bool has_last = false;
+  while (!tree.empty()) {
+    auto& source = sources[tree.top()];
+    const SortRecord& record = source.current();
+    if (!cfg.unique || !has_last || compare_records(last, record, cfg) != 0) {
+      sink(record.line);
+      if (cfg.unique) {
+        last_line.assign(record.line);
+        last = decorate(last_line, cfg);
+        has_last = true;
+      }
+    }
+    tree.replay(source.next());
+  }
+  return std::ranges::none_of(sources,
+                              [](const RunCursor& c) { return c.failed(); });
+}
+
+auto run_cursors(const std::vector<TempFile>& runs, size_t begin, size_t end,
+                 const Config& cfg) -> std::vector<RunCursor> {
+  std::vector<RunCursor> sources;
+  sources.reserve(end - begin + 1);
+  for (size_t i = begin; i < end; ++i) sources.emplace_back(runs[i].path(), cfg);
+  return sources;
+}
+
+// Merge SOURCES into a new temporary run
+auto merge_to_run(std::vector<RunCursor>& sources, const Config& cfg)
+    -> cp::Result<TempFile> {
+  auto out = TempFile::create(temp_dir(cfg));
+  if (!out) return std::unexpected(out.error());
+  RunWriter writer(out->path(), cfg.compress_runs);
+  if (!writer.is_open()) return std::unexpected("cannot write temporary file");
+  if (!merge_runs(sources, cfg, [&](std::string_view r) { writer.write(r); })) {
+    return std::unexpected("cannot read temporary file");
+  }
+  if (!writer.finish()) return std::unexpected("cannot write temporary file");
+  return out;
+}
+
+/**
+ * @brief Merge RUNS, --batch-size at a time, into fewer temporary runs
+ * until they fit in one final merge alongside EXTRA other sources.
+ */
+auto reduce_runs(std::vector<TempFile>& runs, size_t extra, const Config& cfg)
+    -> cp::Result<void> {
+  const size_t batch = std::max<size_t>(cfg.batch_size, 2);
+  while (runs.size() + extra > batch) {
+    std::vector<TempFile> merged;
+    for (size_t i = 0; i < runs.size(); i += batch) {
+      const size_t end = std::min(i + batch, runs.size());
+      if (end - i == 1) {
+        merged.push_back(std::move(runs[i]));
+        continue;
+      }
+      auto sources = run_cursors(runs, i, end, cfg);
+      auto out = merge_to_run(sources, cfg);
+      if (!out) return std::unexpected(out.error());
+      merged.push_back(std::move(*out));
+    }
+    runs = std::move(merged);
+  }
+  return {};
+}
+
+/**
+ * @brief Sort inputs of any size within the -S memory budget.
+ *
+ * Records are collected until the budget is used up; each full chunk is
+ * sorted and written to a temporary run file. If nothing was spilled the
+ * chunk is written out directly, exactly as before. Otherwise the runs are
+ * merged with a loser tree, --batch-size at a time (intermediate passes go
+ * to new temporary runs), and the last chunk joins the final merge straight
+ * from memory.
+ */
+class ExternalSorter {
+ public:
+  explicit ExternalSorter(const Config& cfg) : cfg_(cfg) {}
+
+  auto add(std::string_view record) -> cp::Result<void> {
+    chunk_.push_back(decorate(arena_.store(record), cfg_));
+    // A parallel sort merges into a second array of records
+    chunk_bytes_ +=
+        record.size() + sizeof(SortRecord) * (cfg_.parallel > 1 ? 2 : 1);
+    if (chunk_bytes_ < cfg_.buffer_size) return {};
+    return spill();
+  }
+
+  template <typename Sink>
+  auto finish(Sink&& sink) -> cp::Result<void> {
+    sort_chunk(chunk_, cfg_);
+    if (runs_.empty()) {
+      for (const auto& rec : chunk_) sink(rec.line);
+      return {};
+    }
+
+    // Leave one slot of the final merge for the in-memory chunk
+    auto reduced = reduce_runs(runs_, 1, cfg_);
+    if (!reduced) return reduced;
+
+    auto sources = run_cursors(runs_, 0, runs_.size(), cfg_);
+    sources.emplace_back(chunk_);
+    if (!merge_runs(sources, cfg_, sink)) {
+      return std::unexpected("cannot read temporary file");
+    }
+    return {};
+  }
+
+ private:
+  const Config& cfg_;
+  StringArena arena_;  // Bytes of the records in chunk_
+  std::vector<SortRecord> chunk_;
+  size_t chunk_bytes_ = 0;
+  std::vector<TempFile> runs_;
+
+  auto spill() -> cp::Result<void> {
+    sort_chunk(chunk_, cfg_);
+    auto run = TempFile::create(temp_dir(cfg_));
+    if (!run) return std::unexpected(run.error());
+    RunWriter writer(run->path(), cfg_.compress_runs);
+    if (!writer.is_open()) return std::unexpected("cannot write temporary file");
+    for (const auto& rec : chunk_) writer.write(rec.line);
+    if (!writer.finish()) return std::unexpected("cannot write temporary file");
+    runs_.push_back(std::move(*run));
+    chunk_.clear();
+    arena_.clear();
+    chunk_bytes_ = 0;
+    return {};
+  }
+};
+
+auto is_unsupported_used(const BoundCommandContext<SORT_OPTIONS>& ctx)
     -> std::optional<std::string_view> {
-  if (ctx.get<bool>("--dictionary-order", false) || ctx.get<bool>("-d", false))
+  if (ctx.get<"--dictionary-order">(false) || ctx.get<"-d">(false))
     return "--dictionary-order is [NOT SUPPORT]";
-  if (ctx.get<bool>("--ignore-nonprinting", false) || ctx.get<bool>("-i", false))
+  if (ctx.get<"--ignore-nonprinting">(false) || ctx.get<"-i">(false))
     return "--ignore-nonprinting is [NOT SUPPORT]";
-  if (ctx.get<bool>("--month-sort", false) || ctx.get<bool>("-M", false))
+  if (ctx.get<"--month-sort">(false) || ctx.get<"-M">(false))
     return "--month-sort is [NOT SUPPORT]";
-  if (ctx.get<bool>("--merge", false) || ctx.get<bool>("-m", false))
-    return "--merge is [NOT SUPPORT]";
-  if (ctx.get<bool>("--random-sort", false) || ctx.get<bool>("-R", false))
+  if (ctx.get<"--random-sort">(false) || ctx.get<"-R">(false))
     return "--random-sort is [NOT SUPPORT]";
-  if (ctx.get<bool>("--stable", false) || ctx.get<bool>("-s", false))
+  if (ctx.get<"--stable">(false) || ctx.get<"-s">(false))
     return "--stable is [NOT SUPPORT]";
   return std::nullopt;
 }
 
-auto build_config(const CommandContext<SORT_OPTIONS.size()>& ctx)
+auto build_config(const BoundCommandContext<SORT_OPTIONS>& ctx)
     -> cp::Result<Config> {
   Config cfg;
 
-  cfg.ignore_leading_blanks = ctx.get<bool>("--ignore-leading-blanks", false) ||
-                              ctx.get<bool>("-b", false);
-  cfg.ignore_case =
-      ctx.get<bool>("--ignore-case", false) || ctx.get<bool>("-f", false);
-  cfg.numeric_sort =
-      ctx.get<bool>("--numeric-sort", false) || ctx.get<bool>("-n", false);
+  cfg.ignore_leading_blanks = ctx.get<"--ignore-leading-blanks">(false) ||
+                              ctx.get<"-b">(false);
+  cfg.ignore_case = ctx.get<"--ignore-case">(false) || ctx.get<"-f">(false);
+  cfg.numeric_sort = ctx.get<"--numeric-sort">(false) || ctx.get<"-n">(false);
   cfg.human_numeric =
-      ctx.get<bool>("--human-numeric-sort", false) || ctx.get<bool>("-h", false);
+      ctx.get<"--human-numeric-sort">(false) || ctx.get<"-h">(false);
   cfg.general_numeric =
-      ctx.get<bool>("--general-numeric-sort", false) || ctx.get<bool>("-g", false);
-  cfg.reverse = ctx.get<bool>("--reverse", false) || ctx.get<bool>("-r", false);
-  cfg.unique = ctx.get<bool>("--unique", false) || ctx.get<bool>("-u", false);
+      ctx.get<"--general-numeric-sort">(false) || ctx.get<"-g">(false);
+  cfg.reverse = ctx.get<"--reverse">(false) || ctx.get<"-r">(false);
+  cfg.unique = ctx.get<"--unique">(false) || ctx.get<"-u">(false);
+  cfg.merge = ctx.get<"--merge">(false) || ctx.get<"-m">(false);
   cfg.delimiter =
-      (ctx.get<bool>("--zero-terminated", false) || ctx.get<bool>("-z", false))
+      (ctx.get<"--zero-terminated">(false) || ctx.get<"-z">(false))
           ? '\0'
           : '\n';
 
-  cfg.output_file = ctx.get<std::string>("--output", "");
-  if (cfg.output_file.empty()) cfg.output_file = ctx.get<std::string>("-o", "");
+  cfg.output_file = ctx.get<"--output", std::string>("");
+  if (cfg.output_file.empty()) cfg.output_file = ctx.get<"-o", std::string>("");
 
-  std::string sep = ctx.get<std::string>("--field-separator", "");
-  if (sep.empty()) sep = ctx.get<std::string>("-t", "");
+  std::string sep = ctx.get<"--field-separator", std::string>("");
+  if (sep.empty()) sep = ctx.get<"-t", std::string>("");
   if (!sep.empty()) {
     if (sep.size() != 1) {
       return std::unexpected("field separator must be a single character");
@@ -358,12 +962,35 @@ auto build_config(const CommandContext<SORT_OPTIONS.size()>& ctx)
     cfg.field_separator = sep[0];
   }
 
-  std::string key_text = ctx.get<std::string>("--key", "");
-  if (key_text.empty()) key_text = ctx.get<std::string>("-k", "");
+  std::string key_text = ctx.get<"--key", std::string>("");
+  if (key_text.empty()) key_text = ctx.get<"-k", std::string>("");
   auto key = parse_key_spec(key_text);
   if (!key) return std::unexpected(key.error());
   cfg.key = *key;
 
+  std::string buffer_size = ctx.get<"--buffer-size", std::string>("");
+  if (buffer_size.empty()) buffer_size = ctx.get<"-S", std::string>("");
+  if (buffer_size.empty()) {
+    cfg.buffer_size = default_buffer_size();
+  } else {
+    auto size = parse_buffer_size(buffer_size);
+    if (!size) return std::unexpected(size.error());
+    cfg.buffer_size = *size;
+  }
+
+  cfg.temp_dir = ctx.get<"--temporary-directory", std::string>("");
+  if (cfg.temp_dir.empty()) cfg.temp_dir = ctx.get<"-T", std::string>("");
+
+  const int batch_size = ctx.get<"--batch-size">(16);
+  if (batch_size < 2) return std::unexpected("--batch-size must be at least 2");
+  cfg.batch_size = static_cast<size_t>(batch_size);
+  cfg.compress_runs = ctx.get<"--compress-runs">(false);
+
+  const int parallel = ctx.get<"--parallel">(0);
+  if (parallel < 0) return std::unexpected("invalid number after --parallel");
+  cfg.parallel =
+      parallel == 0 ? default_parallel() : static_cast<size_t>(parallel);
+
 for (auto p : ctx.positionals) {
     std::string file_arg(p);
     if (contains_wildcard(file_arg)) {
@@ -382,57 +1009,147 @@ for (auto p : ctx.positionals) {
   return cfg;
 }
 
-auto run(const Config& cfg) -> int {
-  std::vector<std::string> records;
-  for (size_t i = 0; i < cfg.files.size(); ++i) {
-    auto content = read_source(cfg.files[i]);
-    if (!content) {
-      cp::report_error(content, L"sort");
-      return 1;
+// -o FILE, or standard output; nullptr if FILE cannot be created
+auto open_output(const Config& cfg, std::ofstream& file_out) -> std::ostream* {
+  if (cfg.output_file.empty()) return &stdout_stream();
+  file_out.open(cfg.output_file, std::ios::binary | std::ios::trunc);
+  return file_out.is_open() ? &file_out : nullptr;
+}
+
+auto write_record(std::ostream& out, std::string_view rec, const Config& cfg)
+    -> void {
+  out.write(rec.data(), static_cast<std::streamsize>(rec.size()));
+  out.put(cfg.delimiter);
+}
+
+// Is PATH the file that -o is going to overwrite?
+auto is_output_file(std::string_view path, const Config& cfg) -> bool {
+  if (cfg.output_file.empty() || path == "-") return false;
+  std::error_code ec;
+  return std::filesystem::equivalent(std::string(path), cfg.output_file, ec);
+}
+
+/**
+ * @brief sort -m: merge inputs that are each sorted already.
+ *
+ * The inputs are streamed through the loser tree, so memory use is one
+ * record per input rather than the size of the data. With more inputs than
+ * --batch-size, each group of that many is first merged into a temporary
+ * run. An input that -o names is copied aside before the output is opened,
+ * which makes "sort -m -o a a b" safe.
+ */
+auto run_merge(const Config& cfg) -> int {
+  std::vector<TempFile> snapshots;
+  std::vector<std::string> paths;
+  for (const auto& file : cfg.files) {
+    if (!is_output_file(file, cfg)) {
+      paths.push_back(file);
+      continue;
     }
-    auto chunk = split_records(*content, cfg.delimiter);
-    for (auto& r : chunk) {
-      records.push_back(std::move(r));
+    auto copy = TempFile::create(temp_dir(cfg));
+    std::error_code ec;
+    if (copy) std::filesystem::copy_file(file, copy->path(), ec);
+    if (!copy || ec) {
+      cp::report_custom_error(
+          L"sort", utf8_to_wstring("cannot copy '" + file + "'"));
+      return 1;
     }
+    paths.push_back(copy->path().string());
+    snapshots.push_back(std::move(*copy));
   }
 
-  std::stable_sort(records.begin(), records.end(), [&](const auto& a, const auto& b) {
-    int cmp = compare_records(a, b, cfg);
-    if (cfg.reverse) return cmp > 0;
-    return cmp < 0;
-  });
-
-  if (cfg.unique) {
-    std::vector<std::string> unique_records;
-    unique_records.reserve(records.size());
-    for (const auto& rec : records) {
-      if (unique_records.empty()) {
-        unique_records.push_back(rec);
-        continue;
+  auto open_inputs = [&](size_t begin, size_t end,
+                         std::vector<RunCursor>& sources) {
+    sources.reserve(end - begin);
+    for (size_t i = begin; i < end; ++i) {
+      auto cursor = RunCursor::open_input(paths[i], cfg);
+      if (!cursor) {
+        cp::report_custom_error(
+            L"sort", utf8_to_wstring("cannot open '" + cfg.files[i] + "'"));
+        return false;
       }
-      if (compare_records(unique_records.back(), rec, cfg) != 0) {
-        unique_records.push_back(rec);
+      sources.push_back(std::move(*cursor));
+    }
+    return true;
+  };
+
+  const size_t batch = std::max<size_t>(cfg.batch_size, 2);
+  std::vector<RunCursor> sources;
+  std::vector<TempFile> runs;
+  if (paths.size() <= batch) {
+    if (!open_inputs(0, paths.size(), sources)) return 1;
+  } else {
+    for (size_t i = 0; i < paths.size(); i += batch) {
+      std::vector<RunCursor> group;
+      if (!open_inputs(i, std::min(i + batch, paths.size()), group)) return 1;
+      auto run = merge_to_run(group, cfg);
+      if (!run) {
+        cp::report_error(run, L"sort");
+        return 1;
       }
+      runs.push_back(std::move(*run));
     }
-    records = std::move(unique_records);
+    auto reduced = reduce_runs(runs, 0, cfg);
+    if (!reduced) {
+      cp::report_error(reduced, L"sort");
+      return 1;
+    }
+    sources = run_cursors(runs, 0, runs.size(), cfg);
   }
 
-  std::ostream* out = &std::cout;
   std::ofstream file_out;
-  if (!cfg.output_file.empty()) {
-    file_out.open(cfg.output_file, std::ios::binary | std::ios::trunc);
-    if (!file_out.is_open()) {
-      cp::report_custom_error(L"sort", L"cannot open output file");
+  std::ostream* out = open_output(cfg, file_out);
+  if (out == nullptr) {
+    cp::report_custom_error(L"sort", L"cannot open output file");
+    return 1;
+  }
+  const bool done = merge_runs(
+      sources, cfg, [&](std::string_view rec) { write_record(*out, rec, cfg); });
+  out->flush();
+  if (!done) {
+    cp::report_custom_error(L"sort", L"cannot read temporary file");
+    return 1;
+  }
+  return 0;
+}
+
+auto run(const Config& cfg) -> int {
+  if (cfg.merge) return run_merge(cfg);
+
+  ExternalSorter sorter(cfg);
+  for (size_t i = 0; i < cfg.files.size(); ++i) {
+    std::ifstream in;
+    auto reader = open_reader(cfg.files[i], cfg.delimiter, in);
+    if (!reader) {
+      cp::report_custom_error(
+          L"sort", utf8_to_wstring("cannot open '" + cfg.files[i] + "'"));
       return 1;
     }
-    out = &file_out;
+    std::string_view record;
+    while (reader->next(record)) {
+      auto added = sorter.add(record);
+      if (!added) {
+        cp::report_error(added, L"sort");
+        return 1;
+      }
+    }
   }
 
-  for (const auto& rec : records) {
-    (*out) << rec;
-    (*out) << cfg.delimiter;
+  // Every input has been read by now, so -o may name one of them
+  std::ofstream file_out;
+  std::ostream* out = open_output(cfg, file_out);
+  if (out == nullptr) {
+    cp::report_custom_error(L"sort", L"cannot open output file");
+    return 1;
   }
+
+  auto done = sorter.finish(
+      [&](std::string_view rec) { write_record(*out, rec, cfg); });
   out->flush();
+  if (!done) {
+    cp::report_error(done, L"sort");
+    return 1;
+  }
   return 0;
 }
 
@@ -443,7 +1160,8 @@ REGISTER_COMMAND(sort, "sort", "sort [OPTION]... [FILE]...",
                  "With no FILE, or when FILE is -, read standard input.",
                  "  sort a.txt\n"
                  "  sort -n -r data.txt\n"
-                 "  sort -u -k 1 names.txt",
+                 "  sort -u -k 1 names.txt\n"
+                 "  sort -m -o all.log node1.log node2.log",
                  "uniq(1), grep(1), head(1)", "WinuxCmd",
                  "Copyright © 2026 WinuxCmd", SORT_OPTIONS) {
   using namespace sort_pipeline;
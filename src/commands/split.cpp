@@ -229,9 +229,9 @@ auto run(const Config& cfg) -> int {
 
   if (cfg.input_file.empty() || cfg.input_file == "-") {
     // Read from stdin
-    input.assign(std::istreambuf_iterator<char>(std::cin),
+    input.assign(std::istreambuf_iterator<char>(stdin_stream()),
                   std::istreambuf_iterator<char>());
-    if (std::cin.fail() && !std::cin.eof()) {
+    if (stdin_stream().fail() && !stdin_stream().eof()) {
       cp::Result<int> result = std::unexpected("error reading from file");
       cp::report_error(result, L"split");
       return 1;
@@ -106,6 +106,34 @@ namespace {
       }
     }
   }
+
+  // This process's environment block with NAME set to VALUE, for the child
+  // only; Windows compares variable names case-insensitively.
+  std::wstring child_environment(std::wstring_view name,
+                                 std::wstring_view value) {
+    std::wstring block;
+    if (wchar_t* env = GetEnvironmentStringsW()) {
+      for (const wchar_t* p = env; *p != L'\0';) {
+        std::wstring_view entry(p);
+        p += entry.size() + 1;
+        const bool same_name =
+            entry.size() > name.size() && entry[name.size()] == L'=' &&
+            CompareStringOrdinal(entry.data(), static_cast<int>(name.size()),
+                                 name.data(), static_cast<int>(name.size()),
+                                 TRUE) == CSTR_EQUAL;
+        if (same_name) continue;
+        block.append(entry);
+        block.push_back(L'\0');
+      }
+      FreeEnvironmentStringsW(env);
+    }
+    block.append(name);
+    block.push_back(L'=');
+    block.append(value);
+    block.push_back(L'\0');
+    block.push_back(L'\0');
+    return block;
+  }
 }
 
 // ======================================================
@@ -165,14 +193,23 @@ REGISTER_COMMAND(
 
   std::wstring wcmd = utf8_to_wstring(cmd);
 
+  // WinuxCmd children read this in their stdout sink, the same way GNU
+  // stdbuf hands its settings to libstdbuf. It goes into the child's
+  // environment block only, so this process's environment stays as it was.
+  std::wstring child_env;
+  if (!output_mode.empty()) {
+    child_env = child_environment(L"_STDBUF_O", utf8_to_wstring(output_mode));
+  }
+
+  flushOutput();
   if (!CreateProcessW(
         nullptr,
         const_cast<wchar_t*>(wcmd.c_str()),
         nullptr,
         nullptr,
         TRUE,
-        0,
-        nullptr,
+        CREATE_UNICODE_ENVIRONMENT,
+        child_env.empty() ? nullptr : child_env.data(),
         nullptr,
         &si,
         &pi)) {
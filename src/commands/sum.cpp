@@ -43,9 +43,10 @@ using cmd::meta::OptionMeta;
 using cmd::meta::OptionType;
 
 auto constexpr SUM_OPTIONS = std::array{
-    OPTION("-r", "--sysv", "use System V sum algorithm (512-byte blocks)", BOOL_TYPE),
-    OPTION("-s", "--bsd", "use BSD sum algorithm (1024-byte blocks)", BOOL_TYPE)
-};
+    OPTION("-r", "", "use BSD sum algorithm (the default), use 1K blocks",
+           BOOL_TYPE),
+    OPTION("-s", "--sysv", "use System V sum algorithm, use 512 bytes blocks",
+           BOOL_TYPE)};
 
 namespace sum_pipeline {
 namespace cp = core::pipeline;
@@ -55,10 +56,10 @@ struct Config {
   SmallVector<std::string, 64> files;
 };
 
-auto build_config(const CommandContext<SUM_OPTIONS.size()>& ctx)
+auto build_config(const BoundCommandContext<SUM_OPTIONS>& ctx)
     -> cp::Result<Config> {
   Config cfg;
-  cfg.use_sysv = ctx.get<bool>("--sysv", false) || ctx.get<bool>("-r", false);
+  cfg.use_sysv = ctx.get<"--sysv">(false);
 
   for (auto arg : ctx.positionals) {
     std::string file_arg(arg);
@@ -81,51 +82,71 @@ auto build_config(const CommandContext<SUM_OPTIONS.size()>& ctx)
   return cfg;
 }
 
-auto calculate_checksum(const std::string& filename, uint32_t& block_count, bool use_sysv) -> cp::Result<uint16_t> {
-  std::vector<char> data;
+// 16-bit checksum rotated right by one bit before each byte is added
+struct BsdSum {
+  std::uint32_t checksum = 0;
 
-  if (filename == "-" || filename.empty()) {
-    data.assign(std::istreambuf_iterator<char>(std::cin),
-                std::istreambuf_iterator<char>());
-  } else {
-    std::ifstream f(filename, std::ios::binary);
-    if (!f) {
-      return std::unexpected(std::string("cannot open '") + filename + "' for reading");
-    }
-    data.assign(std::istreambuf_iterator<char>(f),
-                std::istreambuf_iterator<char>());
-    if (f.fail() && !f.eof()) {
-      return std::unexpected("error reading from file");
+  void update(std::string_view block) {
+    for (unsigned char byte : block) {
+      checksum = (checksum >> 1) + ((checksum & 1) << 15);
+      checksum = (checksum + byte) & 0xFFFF;
     }
   }
+  auto value() const -> std::uint32_t { return checksum; }
+};
 
-  // Calculate block count
-  int block_size = use_sysv ? 512 : 1024;
-  block_count = (static_cast<uint32_t>(data.size()) + block_size - 1) / block_size;
+// Plain byte sum, folded to 16 bits at the end
+struct SysvSum {
+  std::uint64_t total = 0;
 
-  // Simple checksum algorithm (BSD)
-  uint16_t checksum = 0;
-  for (unsigned char byte : data) {
-    checksum = (checksum >> 1) + ((checksum & 1) << 15);
-    checksum += byte;
-    checksum &= 0xFFFF;
+  void update(std::string_view block) {
+    for (unsigned char byte : block) total += byte;
   }
+  auto value() const -> std::uint32_t {
+    const std::uint64_t r = (total & 0xFFFF) + ((total & 0xFFFFFFFF) >> 16);
+    return static_cast<std::uint32_t>((r & 0xFFFF) + (r >> 16));
+  }
+};
 
-  return checksum;
+struct FileSum {
+  std::uint32_t checksum;
+  std::uint64_t bytes;
+};
+
+template <typename Sum>
+auto sum_file(const std::string& file) -> std::expected<FileSum, std::string> {
+  auto reader = BlockReader::open(file);
+  if (!reader) return std::unexpected(reader.error());
+
+  Sum sum;
+  for (;;) {
+    auto block = reader->next();
+    if (!block) return std::unexpected(block.error());
+    if (block->empty()) break;
+    sum.update(*block);
+  }
+  return FileSum{sum.value(), reader->total()};
 }
 
 auto run(const Config& cfg) -> int {
+  bool failed = false;
   for (const auto& file : cfg.files) {
-    uint32_t block_count = 0;
-    auto checksum_result = calculate_checksum(file, block_count, cfg.use_sysv);
-
-    if (!checksum_result) {
-      cp::report_error(checksum_result, L"sum");
-      return 1;
+    auto result = cfg.use_sysv ? sum_file<SysvSum>(file)
+                               : sum_file<BsdSum>(file);
+    if (!result) {
+      cp::report_custom_error(L"sum", utf8_to_wstring(result.error()));
+      failed = true;
+      continue;
     }
 
     char buf[64];
-    snprintf(buf, sizeof(buf), "%u %u", *checksum_result, block_count);
+    if (cfg.use_sysv) {
+      snprintf(buf, sizeof(buf), "%u %ju", result->checksum,
+               static_cast<std::uintmax_t>((result->bytes + 511) / 512));
+    } else {
+      snprintf(buf, sizeof(buf), "%05u %5ju", result->checksum,
+               static_cast<std::uintmax_t>((result->bytes + 1023) / 1024));
+    }
     safePrint(buf);
 
     if (file != "-") {
@@ -135,22 +156,23 @@ auto run(const Config& cfg) -> int {
     safePrintLn("");
   }
 
-  return 0;
+  return failed ? 1 : 0;
 }
 
 }  // namespace sum_pipeline
 
 REGISTER_COMMAND(sum, "sum",
                  "sum [OPTION]... [FILE]...",
-                 "Checksum and count the blocks in a file.\n"
+                 "Print checksum and block counts for each FILE.\n"
                  "\n"
                  "With no FILE, or when FILE is -, read standard input.\n"
                  "\n"
-                 "Note: This is a simplified implementation. The BSD algorithm\n"
-                 "is used by default (1024-byte blocks).",
+                 "The BSD algorithm counts 1024-byte blocks, the System V one\n"
+                 "512-byte blocks. Input is read in blocks, so files of any\n"
+                 "size take the same memory.",
                  "  sum file.txt\n"
                  "  echo \"test\" | sum\n"
-                 "  sum -r file.txt",
+                 "  sum -s file.txt",
                  "cksum(1), md5sum(1)", "WinuxCmd",
                  "Copyright © 2026 WinuxCmd", SUM_OPTIONS) {
   using namespace sum_pipeline;
@@ -162,4 +184,4 @@ REGISTER_COMMAND(sum, "sum",
   }
 
   return run(*cfg_result);
-}
\ No newline at end of file
+}
@@ -42,24 +42,56 @@ import container;
 using cmd::meta::OptionMeta;
 using cmd::meta::OptionType;
 
+/**
+ * @brief TAC command options definition
+ *
+ * @par Options:
+ *
+ * - @a -b, @a --before: Attach the separator before instead of after
+ *   [IMPLEMENTED]
+ * - @a -r, @a --regex: Interpret the separator as a regular expression
+ *   [IMPLEMENTED]
+ * - @a -s, @a --separator: Use STRING as the separator instead of newline
+ *   [IMPLEMENTED]
+ */
 auto constexpr TAC_OPTIONS = std::array{
-    OPTION("", "", "concatenate and print files in reverse", STRING_TYPE)
-    // tac has no standard options
-    // -b, --before (not implemented - separator before)
-    // -r, --regex (not implemented - regex separator)
-    // -s, --separator (not implemented - custom separator)
-};
+    OPTION("-b", "--before", "attach the separator before instead of after"),
+    OPTION("-r", "--regex", "interpret the separator as a regular expression"),
+    OPTION("-s", "--separator",
+           "use STRING as the separator instead of newline", STRING_TYPE)};
 
 namespace tac_pipeline {
 namespace cp = core::pipeline;
 
+// Output is gathered into blocks of this size before it is written
+constexpr size_t kOutputBlock = 64 * 1024;
+// Piped input larger than this is spilled to a temporary file
+constexpr size_t kStdinBudget = 64 * 1024 * 1024;
+// Regex separators are located this many at a time
+constexpr size_t kRegexSegment = 4096;
+
 struct Config {
   SmallVector<std::string, 64> files;
+  std::string separator = "\n";
+  bool before = false;
+  std::optional<Regex> regex;
 };
 
-auto build_config(const CommandContext<TAC_OPTIONS.size()>& ctx)
+auto build_config(const BoundCommandContext<TAC_OPTIONS>& ctx)
     -> cp::Result<Config> {
   Config cfg;
+  cfg.before = ctx.get<"--before">(false);
+  if (ctx.has<"--separator">()) {
+    cfg.separator = ctx.get<"--separator", std::string>("");
+    if (cfg.separator.empty()) {
+      return std::unexpected("separator cannot be empty");
+    }
+  }
+  if (ctx.get<"--regex">(false)) {
+    auto re = Regex::compile(cfg.separator);
+    if (!re) return std::unexpected(re.error());
+    cfg.regex = std::move(*re);
+  }
 
   for (auto arg : ctx.positionals) {
     std::string file_arg(arg);
@@ -82,50 +114,265 @@ auto build_config(const CommandContext<TAC_OPTIONS.size()>& ctx)
   return cfg;
 }
 
-auto run(const Config& cfg) -> int {
-  // Use std::vector to avoid stack overflow (SmallVector with 1024 capacity is too large for stack)
-  std::vector<std::string> all_lines;
+/**
+ * @brief Gathers the reversed records into large writes.
+ *
+ * Records are appended straight from the mapping; one that does not fit
+ * the block is written on its own instead of being copied.
+ */
+class Output {
+ public:
+  Output() { block_.reserve(kOutputBlock); }
+  ~Output() { flush(); }
 
-  for (const auto& file : cfg.files) {
-    if (file == "-") {
-      // Read from stdin
-      std::string line;
-      while (std::getline(std::cin, line)) {
-        all_lines.push_back(line + "\n");
+  void write(std::string_view piece) {
+    if (block_.size() + piece.size() > kOutputBlock) {
+      flush();
+      if (piece.size() >= kOutputBlock) {
+        safePrint(piece);
+        return;
       }
-    } else {
-      // Read from file
-      std::ifstream f(file, std::ios::binary);
-      if (!f) {
-        auto err = std::string("cannot open '") + file + "' for reading";
-        cp::Result<int> result = std::unexpected(std::string_view(err));
-        cp::report_error(result, L"tac");
-        return 1;
+    }
+    block_.append(piece);
+  }
+
+  void flush() {
+    if (block_.empty()) return;
+    safePrint(block_);
+    block_.clear();
+  }
+
+ private:
+  std::string block_;
+};
+
+/**
+ * Emit DATA record by record, last first. NEXT_MATCH is called repeatedly
+ * and yields the separator matches from the last to the first, as
+ * [begin, end) offsets. A separator ends the record before it, or with
+ * --before starts the record after it. A last record without a separator
+ * gets one appended when the separator is a fixed string.
+ */
+template <typename NextMatch>
+void emit_reversed(std::string_view data, const Config& cfg,
+                   NextMatch next_match) {
+  Output out;
+  size_t end = data.size();
+  bool last = true;
+  while (auto match = next_match()) {
+    const size_t cut = cfg.before ? match->begin : match->end;
+    if (cut < end) {
+      out.write(data.substr(cut, end - cut));
+      if (last && !cfg.before && !cfg.regex) out.write(cfg.separator);
+    }
+    last = false;
+    end = cut;
+  }
+  if (end > 0) {
+    out.write(data.substr(0, end));
+    if (last && !cfg.before && !cfg.regex) out.write(cfg.separator);
+  }
+}
+
+/// Fixed separator: searched backwards from the end of the data.
+void reverse_fixed(std::string_view data, const Config& cfg) {
+  const std::string_view sep = cfg.separator;
+  size_t limit = data.size();  // the next match must end by here
+  emit_reversed(data, cfg, [&]() -> std::optional<RegexMatch> {
+    if (limit < sep.size()) return std::nullopt;
+    const size_t at = data.rfind(sep, limit - sep.size());
+    if (at == std::string_view::npos) return std::nullopt;
+    limit = at;
+    return RegexMatch{at, at + sep.size()};
+  });
+}
+
+/**
+ * Regex separator. Matches are found scanning forwards, which leftmost-
+ * longest matching requires; a first pass only records where every
+ * kRegexSegment-th match ends, then the segments are rescanned from the
+ * last to the first and their matches replayed backwards. A search started
+ * at a match end finds what the full scan found, so memory stays bounded
+ * by the number of segments. Empty matches do not separate records.
+ */
+void reverse_regex(std::string_view data, const Config& cfg) {
+  const Regex& re = *cfg.regex;
+  auto next_after = [&](size_t& pos) -> std::optional<RegexMatch> {
+    while (pos <= data.size()) {
+      auto m = re.find(data, pos);
+      if (!m) return std::nullopt;
+      if (m->size() > 0) {
+        pos = m->end;
+        return m;
       }
+      pos = m->begin + 1;
+    }
+    return std::nullopt;
+  };
 
-      std::string line;
-      while (std::getline(f, line)) {
-        // Skip UTF-8 BOM if present at the beginning of the first line
-        if (all_lines.empty() && line.size() >= 3 &&
-            static_cast<unsigned char>(line[0]) == 0xEF &&
-            static_cast<unsigned char>(line[1]) == 0xBB &&
-            static_cast<unsigned char>(line[2]) == 0xBF) {
-          line = line.substr(3);
-        }
-        all_lines.push_back(line + "\n");
+  std::vector<size_t> checkpoints{0};
+  size_t pos = 0;
+  for (size_t count = 1; next_after(pos); ++count) {
+    if (count % kRegexSegment == 0) checkpoints.push_back(pos);
+  }
+
+  std::vector<RegexMatch> segment;
+  size_t segment_index = checkpoints.size();
+  emit_reversed(data, cfg, [&]() -> std::optional<RegexMatch> {
+    while (segment.empty()) {
+      if (segment_index == 0) return std::nullopt;
+      size_t from = checkpoints[--segment_index];
+      while (segment.size() < kRegexSegment) {
+        auto m = next_after(from);
+        if (!m) break;
+        segment.push_back(*m);
+      }
+    }
+    const RegexMatch m = segment.back();
+    segment.pop_back();
+    return m;
+  });
+}
+
+void print_reversed(std::string_view data, const Config& cfg) {
+  if (data.empty()) return;
+  if (cfg.regex) {
+    reverse_regex(data, cfg);
+  } else {
+    reverse_fixed(data, cfg);
+  }
+}
+
+auto make_spill_path() -> std::filesystem::path {
+  std::error_code ec;
+  std::filesystem::path dir = std::filesystem::temp_directory_path(ec);
+  if (ec) dir = ".";
+  std::random_device rd;
+  const std::uint64_t tag = (static_cast<std::uint64_t>(rd()) << 32) ^ rd();
+  return dir / std::format("tac{:016x}.tmp", tag);
+}
+
+/**
+ * @brief Standard input that cannot be mapped in place.
+ *
+ * Pipes, the console and pipeline channels are read into memory; once
+ * they exceed kStdinBudget what was read, and the rest, goes to a
+ * temporary file that is mapped like any other input and removed
+ * afterwards.
+ */
+class PipedInput {
+ public:
+  PipedInput() = default;
+  ~PipedInput() {
+    spilled_ = MappedFile();
+    if (!spill_path_.empty()) {
+      std::error_code ec;
+      std::filesystem::remove(spill_path_, ec);
+    }
+  }
+  PipedInput(const PipedInput&) = delete;
+  PipedInput& operator=(const PipedInput&) = delete;
+
+  auto load() -> cp::Result<void> {
+    std::vector<char> block(1024 * 1024);
+    std::ofstream spill;
+    while (true) {
+      auto got = read_stdin(block.data(), block.size());
+      if (!got) return std::unexpected("error reading standard input");
+      if (*got == 0) break;
+      const std::string_view piece(block.data(), *got);
+      if (!spill.is_open() && buffer_.size() + piece.size() > kStdinBudget) {
+        spill_path_ = make_spill_path();
+        spill.open(spill_path_, std::ios::binary);
+        if (!spill) return std::unexpected("cannot create temporary file");
+        spill.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        buffer_ = std::string();
       }
+      if (spill.is_open()) {
+        spill.write(piece.data(), static_cast<std::streamsize>(piece.size()));
+        if (!spill) return std::unexpected("cannot write temporary file");
+      } else {
+        buffer_.append(piece);
+      }
+    }
+    if (!spill.is_open()) return {};
+    spill.close();
+    auto mapped = MappedFile::open(spill_path_.string(), AccessHint::Random);
+    if (!mapped) return std::unexpected("cannot read temporary file");
+    spilled_ = std::move(*mapped);
+    return {};
+  }
+
+  [[nodiscard]] auto view() const -> std::string_view {
+    return spill_path_.empty() ? std::string_view(buffer_) : spilled_.view();
+  }
+
+ private:
+  std::string buffer_;
+  std::filesystem::path spill_path_;
+  MappedFile spilled_;
+
+  /// Bytes read into BUF, 0 at end of input, nullopt on error.
+  static auto read_stdin(char* buf, size_t size) -> std::optional<size_t> {
+    HANDLE handle = thread_stdin_handle();
+    if (thread_stdin_channel() != nullptr || handle == nullptr ||
+        handle == INVALID_HANDLE_VALUE ||
+        GetFileType(handle) == FILE_TYPE_CHAR) {
+      auto& in = stdin_stream();
+      in.read(buf, static_cast<std::streamsize>(size));
+      if (in.bad()) return std::nullopt;
+      return static_cast<size_t>(in.gcount());
+    }
+    DWORD got = 0;
+    if (!ReadFile(handle, buf, static_cast<DWORD>(size), &got, nullptr)) {
+      if (GetLastError() == ERROR_BROKEN_PIPE) return 0;
+      return std::nullopt;
+    }
+    return got;
+  }
+};
+
+auto stdin_is_seekable() -> bool {
+  if (thread_stdin_channel() != nullptr) return false;
+  HANDLE handle = thread_stdin_handle();
+  return handle != nullptr && handle != INVALID_HANDLE_VALUE &&
+         GetFileType(handle) == FILE_TYPE_DISK;
+}
 
-      if (f.fail() && !f.eof()) {
-        cp::Result<int> result = std::unexpected("error reading from file");
-        cp::report_error(result, L"tac");
+void print_data(std::string_view data, const Config& cfg) {
+  // Skip UTF-8 BOM if present at the beginning of the file
+  if (data.size() >= 3 && static_cast<unsigned char>(data[0]) == 0xEF &&
+      static_cast<unsigned char>(data[1]) == 0xBB &&
+      static_cast<unsigned char>(data[2]) == 0xBF) {
+    data.remove_prefix(3);
+  }
+  print_reversed(data, cfg);
+}
+
+auto run(const Config& cfg) -> int {
+  for (const auto& file : cfg.files) {
+    if (file == "-" && !stdin_is_seekable()) {
+      PipedInput input;
+      auto loaded = input.load();
+      if (!loaded) {
+        cp::report_error(loaded, L"tac");
         return 1;
       }
+      print_data(input.view(), cfg);
+      continue;
     }
-  }
 
-  // Print lines in reverse order
-  for (auto it = all_lines.rbegin(); it != all_lines.rend(); ++it) {
-    safePrint(*it);
+    auto input = file == "-" ? MappedFile::from_stdin(AccessHint::Random)
+                             : MappedFile::open(file, AccessHint::Random);
+    if (!input) {
+      auto err = file == "-" ? std::string("error reading from standard input")
+                             : std::string("cannot open '") + file +
+                                   "' for reading";
+      cp::Result<int> result = std::unexpected(std::string_view(err));
+      cp::report_error(result, L"tac");
+      return 1;
+    }
+    print_data(input->view(), cfg);
   }
 
   return 0;
@@ -140,9 +387,10 @@ REGISTER_COMMAND(tac, "tac",
                  "Write each FILE to standard output, last line first.\n"
                  "With no FILE, or when FILE is -, read standard input.\n"
                  "\n"
-                 "Note: This is the reverse of 'cat'.\n"
-                 "Advanced features like custom separators are not implemented.",
+                 "Note: This is the reverse of 'cat'.",
                  "  tac file.txt\n"
+                 "  tac -s , list.csv\n"
+                 "  tac -r -s '[.!?] ' story.txt\n"
                  "  echo -e 'line1\\nline2\\nline3' | tac",
                  "cat(1), rev(1)", "WinuxCmd",
                  "Copyright © 2026 WinuxCmd", TAC_OPTIONS) {
@@ -155,4 +403,4 @@ REGISTER_COMMAND(tac, "tac",
   }
 
   return run(*cfg_result);
-}
\ No newline at end of file
+}
@@ -54,18 +54,19 @@ using cmd::meta::OptionType;
  *
  * - @a -c, @a --bytes: Output the last NUM bytes; or use -c +NUM to output
  *   starting with byte NUM of each file [IMPLEMENTED]
- * - @a -f, @a --follow: Output appended data as the file grows [NOT SUPPORT]
- * - @a -F: Same as --follow=name --retry [NOT SUPPORT]
+ * - @a -f, @a --follow[=HOW]: Output appended data as the file grows; HOW is
+ *   'descriptor' (default) or 'name' [IMPLEMENTED]
+ * - @a -F: Same as --follow=name --retry [IMPLEMENTED]
  * - @a -n, @a --lines: Output the last NUM lines, instead of the last 10; or
  *   use -n +NUM to skip NUM-1 lines at the start [IMPLEMENTED]
  * - @a --max-unchanged-stats: With --follow=name, reopen a FILE which has not changed
- *   size after N iterations to see if it has been renamed [NOT SUPPORT]
- * - @a --pid: With -f, terminate after process ID, PID dies [NOT SUPPORT]
+ *   size after N iterations to see if it has been renamed [IMPLEMENTED]
+ * - @a --pid: With -f, terminate after process ID, PID dies [IMPLEMENTED]
  * - @a -q, @a --quiet: Never output headers giving file names [IMPLEMENTED]
  * - @a --silent: Never output headers giving file names [IMPLEMENTED]
- * - @a --retry: Keep trying to open a file if it is inaccessible [NOT SUPPORT]
- * - @a -s, @a --sleep-interval: With -f, sleep for approximately N seconds between iterations
- *   [NOT SUPPORT]
+ * - @a --retry: Keep trying to open a file if it is inaccessible [IMPLEMENTED]
+ * - @a -s, @a --sleep-interval: With -f, check at least every N seconds when
+ *   no change notification arrives [IMPLEMENTED]
  * - @a -v, @a --verbose: Always output headers giving file names [IMPLEMENTED]
  * - @a -z, @a --zero-terminated: Line delimiter is NUL, not newline [IMPLEMENTED]
  */
@@ -75,27 +76,27 @@ auto constexpr TAIL_OPTIONS = std::array{
            "starting with byte NUM of each file",
            STRING_TYPE),
     OPTION("-f", "--follow",
-           "output appended data as the file grows"),
-    OPTION("-F", "", "same as --follow=name --retry [NOT SUPPORT]"),
+           "output appended data as the file grows;\n"
+           "--follow=name follows the file name across rotation\n"
+           "instead of the open file",
+           OPTIONAL_STRING_TYPE),
+    OPTION("-F", "", "same as --follow=name --retry"),
     OPTION("-n", "--lines",
            "output the last NUM lines, instead of the last 10; or\n"
            "use -n +NUM to skip NUM-1 lines at the start",
            STRING_TYPE),
     OPTION("", "--max-unchanged-stats",
            "with --follow=name, reopen a FILE which has not changed\n"
-           "size after N iterations to see if it has been renamed\n"
-           "[NOT SUPPORT]",
+           "size after N iterations to see if it has been renamed",
            INT_TYPE),
-    OPTION("", "--pid",
-           "with -f, terminate after process ID, PID dies [NOT SUPPORT]",
+    OPTION("", "--pid", "with -f, terminate after process ID, PID dies",
            INT_TYPE),
     OPTION("-q", "--quiet", "never output headers giving file names"),
     OPTION("", "--silent", "never output headers giving file names"),
-    OPTION("", "--retry",
-           "keep trying to open a file if it is inaccessible [NOT SUPPORT]"),
+    OPTION("", "--retry", "keep trying to open a file if it is inaccessible"),
     OPTION("-s", "--sleep-interval",
-           "with -f, sleep for approximately N seconds between iterations\n"
-           "[NOT SUPPORT]",
+           "with -f, check files at least every N seconds (default 1.0)\n"
+           "when no change notification arrives",
            STRING_TYPE),
     OPTION("-v", "--verbose", "always output headers giving file names"),
     OPTION("-z", "--zero-terminated", "line delimiter is NUL, not newline")};
@@ -108,18 +109,26 @@ struct CountSpec {
   bool from_start = false;
 };
 
+enum class FollowMode { None, Descriptor, Name };
+
 struct TailConfig {
   bool by_bytes = false;
   CountSpec spec;
   bool quiet = false;
   bool verbose = false;
-  bool follow = false;
-  bool stdin_mode = false;
+  FollowMode follow = FollowMode::None;
+  bool retry = false;
+  int pid = -1;
+  int max_unchanged_stats = 5;
+  std::chrono::milliseconds sleep_interval{1000};
   char delimiter = '\n';
 };
 
+// Input is pulled from pipes in blocks of this size
+constexpr size_t kReadBlock = 64 * 1024;
+
 auto stream_all(std::istream& in) -> void {
-  std::array<char, 8192> buffer{};
+  std::vector<char> buffer(kReadBlock);
   while (in.good()) {
     in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
     auto got = in.gcount();
@@ -128,6 +137,25 @@ auto stream_all(std::istream& in) -> void {
   }
 }
 
+/**
+ * Offset in DATA where its last N records start, or 0 when it holds no more
+ * than N. A trailing delimiter terminates the last record rather than
+ * starting a new one; a record without one still counts.
+ */
+auto last_records_start(std::string_view data, size_t n, char delimiter)
+    -> size_t {
+  if (n == 0) return data.size();
+  size_t end = data.size();
+  if (end > 0 && data.back() == delimiter) --end;
+  while (end > 0) {
+    const size_t hit = data.rfind(delimiter, end - 1);
+    if (hit == std::string_view::npos) return 0;
+    if (--n == 0) return hit + 1;
+    end = hit;
+  }
+  return 0;
+}
+
 auto suffix_multiplier(std::string_view suffix)
     -> std::optional<std::uintmax_t> {
   static constexpr auto kMultipliers = 
@@ -220,125 +248,471 @@ auto parse_count_spec(std::string spec_text, std::string_view opt_name)
   return spec;
 }
 
+/**
+ * Tail of an input that cannot be seeked (pipes, the console, pipeline
+ * channels). It is read in blocks; for the last N records or bytes only a
+ * window that still covers them is kept, and the window is trimmed whenever
+ * it has grown to twice what was last kept, so memory stays proportional to
+ * the output rather than to the input.
+ */
 auto output_tail(std::istream& in, const TailConfig& config) -> void {
+  const size_t n = static_cast<size_t>(config.spec.value);
+  std::vector<char> buffer(kReadBlock);
+  auto read_block = [&]() -> std::string_view {
+    if (!in.good()) return {};
+    in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    const auto got = in.gcount();
+    if (got <= 0) return {};
+    return {buffer.data(), static_cast<size_t>(got)};
+  };
+
+  if (config.spec.from_start) {
+    size_t skip = n > 0 ? n - 1 : 0;
+    for (auto block = read_block(); !block.empty(); block = read_block()) {
+      if (config.by_bytes) {
+        const size_t drop = std::min(skip, block.size());
+        block.remove_prefix(drop);
+        skip -= drop;
+      } else {
+        while (skip > 0 && !block.empty()) {
+          const size_t hit = block.find(config.delimiter);
+          if (hit == std::string_view::npos) {
+            block = {};
+            break;
+          }
+          block.remove_prefix(hit + 1);
+          --skip;
+        }
+      }
+      if (skip == 0) {
+        if (!block.empty()) safePrint(block);
+        stream_all(in);
+        return;
+      }
+    }
+    return;
+  }
+
+  if (n == 0) return;
+  std::string window;
+  size_t trim_at = kReadBlock;
+  for (auto block = read_block(); !block.empty(); block = read_block()) {
+    window.append(block);
+    if (window.size() < trim_at) continue;
+    const size_t start =
+        config.by_bytes ? window.size() - std::min(n, window.size())
+                        : last_records_start(window, n, config.delimiter);
+    window.erase(0, start);
+    trim_at = std::max(kReadBlock, 2 * window.size());
+  }
+  const size_t start =
+      config.by_bytes ? window.size() - std::min(n, window.size())
+                      : last_records_start(window, n, config.delimiter);
+  if (start < window.size()) safePrint(std::string_view(window).substr(start));
+}
+
+/// Tail of a file that is fully addressable (mapped or already read): the
+/// records are located by scanning back from the end instead of streaming
+/// the whole input through a ring of records.
+auto output_tail_mapped(std::string_view data, const TailConfig& config)
+    -> void {
+  const size_t n = static_cast<size_t>(
+      std::min<std::uintmax_t>(config.spec.value, data.size() + 1));
+
   if (config.by_bytes) {
-    size_t n = static_cast<size_t>(config.spec.value);
     if (config.spec.from_start) {
-      size_t skip = n > 0 ? n - 1 : 0;
-      std::array<char, 8192> discard{};
-      while (skip > 0 && in.good()) {
-        size_t chunk = std::min(skip, discard.size());
-        in.read(discard.data(), static_cast<std::streamsize>(chunk));
-        auto got = in.gcount();
-        if (got <= 0) return;
-        skip -= static_cast<size_t>(got);
-      }
-      stream_all(in);
+      const size_t skip = n > 0 ? n - 1 : 0;
+      if (skip < data.size()) safePrint(data.substr(skip));
       return;
     }
-
     if (n == 0) return;
-    std::deque<char> trailing;
-    std::array<char, 8192> buffer{};
-    while (in.good()) {
-      in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
-      auto got = in.gcount();
-      if (got <= 0) break;
-      for (std::streamsize i = 0; i < got; ++i) {
-        trailing.push_back(buffer[static_cast<size_t>(i)]);
-        if (trailing.size() > n) trailing.pop_front();
+    safePrint(data.substr(data.size() - std::min(n, data.size())));
+    return;
+  }
+
+  if (config.spec.from_start) {
+    size_t skip = n > 0 ? n - 1 : 0;
+    size_t pos = 0;
+    while (skip > 0 && pos < data.size()) {
+      const void* hit = std::memchr(data.data() + pos, config.delimiter,
+                                    data.size() - pos);
+      if (hit == nullptr) return;
+      pos = static_cast<size_t>(static_cast<const char*>(hit) - data.data()) + 1;
+      --skip;
+    }
+    if (skip == 0 && pos < data.size()) safePrint(data.substr(pos));
+    return;
+  }
+
+  if (n == 0 || data.empty()) return;
+  safePrint(data.substr(last_records_start(data, n, config.delimiter)));
+}
+
+/**
+ * Whether standard input is a file on disk, which can be mapped and scanned
+ * from the end like a named file instead of being read through.
+ */
+auto stdin_is_seekable() -> bool {
+  if (thread_stdin_channel() != nullptr) return false;
+  HANDLE handle = thread_stdin_handle();
+  return handle != nullptr && handle != INVALID_HANDLE_VALUE &&
+         GetFileType(handle) == FILE_TYPE_DISK;
+}
+
+// Event signalled by Ctrl+C / Ctrl+Break while a follow loop is running
+std::atomic<HANDLE> g_follow_stop{nullptr};
+
+BOOL WINAPI stop_following(DWORD ctrl_type) {
+  if (ctrl_type != CTRL_C_EVENT && ctrl_type != CTRL_BREAK_EVENT) return FALSE;
+  HANDLE event = g_follow_stop.load();
+  if (event == nullptr) return FALSE;
+  SetEvent(event);
+  return TRUE;
+}
+
+auto open_shared(const std::string& name) -> HANDLE {
+  // Sharing everything lets writers append, truncate, rename and delete
+  // the file while it is being followed.
+  return CreateFileW(utf8_to_wstring(name).c_str(), GENERIC_READ,
+                     FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                     nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+}
+
+/**
+ * @brief Follows appended data of several files from one thread.
+ *
+ * Each file stays open and only the bytes past the last offset read are
+ * printed. The thread sleeps in WaitForMultipleObjects on one change
+ * notification per directory, Ctrl+C, the --pid process and the thread's
+ * stop event, so output follows a write within milliseconds and an idle
+ * tail costs no CPU. The
+ * wait times out after the sleep interval as a fallback, because NTFS may
+ * report the size of a file held open by its writer only when its cache
+ * is flushed, and because only MAXIMUM_WAIT_OBJECTS handles can be waited
+ * on.
+ *
+ * With --follow=name the name is reopened after a directory notification
+ * (or after --max-unchanged-stats quiet checks) and compared by volume and
+ * file index, so a rotated log is followed into the new file. A size
+ * below the offset read so far means the file was truncated and is read
+ * again from the start.
+ */
+class Follower {
+ public:
+  Follower(const TailConfig& config, bool headers)
+      : config_(config), headers_(headers) {}
+
+  ~Follower() {
+    for (auto& file : files_) close(file);
+  }
+
+  Follower(const Follower&) = delete;
+  Follower& operator=(const Follower&) = delete;
+
+  /// Follow NAME from OFFSET, the size already printed; a file that could
+  /// not be opened (nullopt) is waited for and read from its start.
+  void add(std::string name, std::optional<std::uint64_t> offset) {
+    File file;
+    file.name = std::move(name);
+    if (offset) {
+      adopt(file, open_shared(file.name));
+      file.offset = *offset;
+    }
+    files_.push_back(std::move(file));
+    last_shown_ = files_.size() - 1;
+  }
+
+  /// Output that did not come from a followed file was printed last.
+  void other_output() { last_shown_ = kNone; }
+
+  [[nodiscard]] auto empty() const -> bool { return files_.empty(); }
+
+  /// Follow until Ctrl+C, the --pid process exits, the thread's stop event
+  /// is signalled, or no file is left.
+  /// @return false when following ended because every file was given up
+  auto run() -> bool {
+    HANDLE stop = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    HANDLE previous_stop = g_follow_stop.exchange(stop);
+    SetConsoleCtrlHandler(stop_following, TRUE);
+
+    std::vector<HANDLE> waits{stop};
+    HANDLE process = nullptr;
+    if (config_.pid > 0) {
+      process = OpenProcess(SYNCHRONIZE, FALSE,
+                            static_cast<DWORD>(config_.pid));
+      if (process != nullptr) waits.push_back(process);
+    }
+    // Set when a warm-server client goes away
+    size_t cancel = kNone;
+    if (HANDLE event = thread_stop_event()) {
+      cancel = waits.size();
+      waits.push_back(event);
+    }
+    const size_t first_watch = waits.size();
+    watch_directories(waits);
+
+    bool process_alive = config_.pid <= 0 || process != nullptr;
+    bool reopen = false;
+    bool ok = true;
+    const auto timeout = static_cast<DWORD>(std::min<std::int64_t>(
+        config_.sleep_interval.count(), INFINITE - 1));
+    while (true) {
+      for (size_t i = 0; i < files_.size(); ++i) check(i, reopen);
+      flushOutput();
+      if (!process_alive) break;
+      if (std::ranges::all_of(files_, [](const File& f) { return f.gone; })) {
+        safeErrorPrint("tail: no files remaining\n");
+        ok = false;
+        break;
+      }
+
+      const DWORD signalled = WaitForMultipleObjects(
+          static_cast<DWORD>(waits.size()), waits.data(), FALSE, timeout);
+      reopen = false;
+      if (signalled == WAIT_OBJECT_0 ||
+          (cancel != kNone && signalled == WAIT_OBJECT_0 + cancel)) {
+        break;
+      }
+      if (signalled == WAIT_FAILED) {
+        Sleep(timeout);
+        continue;
+      }
+      if (signalled >= WAIT_OBJECT_0 + first_watch &&
+          signalled < WAIT_OBJECT_0 + waits.size()) {
+        FindNextChangeNotification(waits[signalled - WAIT_OBJECT_0]);
+        reopen = true;
+      } else if (process != nullptr && signalled == WAIT_OBJECT_0 + 1) {
+        // One last read picks up what the process wrote before exiting.
+        process_alive = false;
       }
     }
-    if (!trailing.empty()) {
-      std::string out;
-      out.reserve(trailing.size());
-      for (char ch : trailing) out.push_back(ch);
-      safePrint(out);
+
+    for (size_t w = first_watch; w < waits.size(); ++w) {
+      FindCloseChangeNotification(waits[w]);
     }
-    return;
+    if (process != nullptr) CloseHandle(process);
+    SetConsoleCtrlHandler(stop_following, FALSE);
+    g_follow_stop.store(previous_stop);
+    CloseHandle(stop);
+    return ok;
   }
 
-  size_t n = static_cast<size_t>(config.spec.value);
-  if (config.spec.from_start) {
-    size_t start = n > 0 ? n - 1 : 0;
-    if (start == 0) {
-      stream_all(in);
+ private:
+  static constexpr size_t kNone = std::numeric_limits<size_t>::max();
+
+  struct File {
+    std::string name;
+    HANDLE handle = INVALID_HANDLE_VALUE;
+    std::uint64_t offset = 0;
+    // Volume serial number and file index identify the file behind a name
+    DWORD volume = 0;
+    std::uint64_t index = 0;
+    int unchanged = 0;  // Checks since the size last changed
+    bool gone = false;  // Given up on: inaccessible and no --retry
+  };
+
+  const TailConfig& config_;
+  bool headers_;
+  std::vector<File> files_;
+  size_t last_shown_ = kNone;
+
+  static void adopt(File& file, HANDLE handle) {
+    file.handle = handle;
+    file.offset = 0;
+    file.unchanged = 0;
+    BY_HANDLE_FILE_INFORMATION info{};
+    if (handle != INVALID_HANDLE_VALUE &&
+        GetFileInformationByHandle(handle, &info)) {
+      file.volume = info.dwVolumeSerialNumber;
+      file.index = (static_cast<std::uint64_t>(info.nFileIndexHigh) << 32) |
+                   info.nFileIndexLow;
+    }
+  }
+
+  static void close(File& file) {
+    if (file.handle != INVALID_HANDLE_VALUE) CloseHandle(file.handle);
+    file.handle = INVALID_HANDLE_VALUE;
+  }
+
+  static void report(const File& file, std::string_view what) {
+    flushOutput();
+    safeErrorPrint("tail: '");
+    safeErrorPrint(file.name);
+    safeErrorPrint(what);
+  }
+
+  void watch_directories(std::vector<HANDLE>& waits) const {
+    std::vector<std::filesystem::path> watched;
+    for (const auto& file : files_) {
+      std::error_code ec;
+      auto dir = std::filesystem::absolute(utf8_to_wstring(file.name), ec)
+                     .parent_path();
+      if (ec || std::ranges::find(watched, dir) != watched.end()) continue;
+      if (waits.size() >= MAXIMUM_WAIT_OBJECTS) break;
+      HANDLE change = FindFirstChangeNotificationW(
+          dir.c_str(), FALSE,
+          FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE |
+              FILE_NOTIFY_CHANGE_LAST_WRITE);
+      if (change == INVALID_HANDLE_VALUE) continue;
+      watched.push_back(std::move(dir));
+      waits.push_back(change);
+    }
+  }
+
+  void check(size_t i, bool reopen) {
+    File& file = files_[i];
+    if (file.gone) return;
+
+    const bool by_name = config_.follow == FollowMode::Name;
+    if (file.handle == INVALID_HANDLE_VALUE ||
+        (by_name && (reopen || file.unchanged >= config_.max_unchanged_stats))) {
+      reopen_by_name(i);
+      if (file.handle == INVALID_HANDLE_VALUE) return;
+    }
+
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file.handle, &size)) return;
+    const auto end = static_cast<std::uint64_t>(size.QuadPart);
+    if (end < file.offset) {
+      flushOutput();
+      safeErrorPrint("tail: " + file.name + ": file truncated\n");
+      file.offset = 0;
+    }
+    if (end == file.offset) {
+      ++file.unchanged;
       return;
     }
+    file.unchanged = 0;
+    drain(i, end);
+  }
 
-    size_t record_index = 0;
-    std::string current;
-    char ch = '\0';
-    while (in.get(ch)) {
-      current.push_back(ch);
-      if (ch == config.delimiter) {
-        if (record_index >= start) safePrint(current);
-        current.clear();
-        ++record_index;
+  void reopen_by_name(size_t i) {
+    File& file = files_[i];
+    file.unchanged = 0;
+    HANDLE fresh = open_shared(file.name);
+    if (fresh == INVALID_HANDLE_VALUE) {
+      if (file.handle == INVALID_HANDLE_VALUE) return;
+      finish(i);
+      close(file);
+      if (config_.retry) {
+        report(file, "' has become inaccessible\n");
+      } else {
+        report(file, "' has become inaccessible; giving up on this name\n");
+        file.gone = true;
       }
+      return;
     }
-    if (!current.empty() && record_index >= start) {
-      safePrint(current);
+
+    File probe;
+    adopt(probe, fresh);
+    if (file.handle == INVALID_HANDLE_VALUE) {
+      report(file, "' has appeared;  following new file\n");
+    } else if (probe.volume != file.volume || probe.index != file.index) {
+      finish(i);
+      close(file);
+      report(file, "' has been replaced;  following new file\n");
+    } else {
+      CloseHandle(fresh);
+      return;
     }
-    return;
+    adopt(file, fresh);
   }
 
-  if (n == 0) return;
-  std::deque<std::string> trailing_records;
-  std::string current;
-  char ch = '\0';
-  while (in.get(ch)) {
-    current.push_back(ch);
-    if (ch == config.delimiter) {
-      trailing_records.push_back(std::move(current));
-      current.clear();
-      if (trailing_records.size() > n) trailing_records.pop_front();
+  /// Print what was appended to a file that is about to be closed.
+  void finish(size_t i) {
+    LARGE_INTEGER size{};
+    if (GetFileSizeEx(files_[i].handle, &size) &&
+        static_cast<std::uint64_t>(size.QuadPart) > files_[i].offset) {
+      drain(i, static_cast<std::uint64_t>(size.QuadPart));
     }
   }
-  if (!current.empty()) {
-    trailing_records.push_back(std::move(current));
-    if (trailing_records.size() > n) trailing_records.pop_front();
+
+  void drain(size_t i, std::uint64_t end) {
+    File& file = files_[i];
+    LARGE_INTEGER position{};
+    position.QuadPart = static_cast<LONGLONG>(file.offset);
+    if (!SetFilePointerEx(file.handle, position, nullptr, FILE_BEGIN)) return;
+
+    std::vector<char> buffer(kReadBlock);
+    while (file.offset < end) {
+      const auto want = static_cast<DWORD>(
+          std::min<std::uint64_t>(buffer.size(), end - file.offset));
+      DWORD got = 0;
+      if (!ReadFile(file.handle, buffer.data(), want, &got, nullptr) ||
+          got == 0) {
+        break;
+      }
+      if (headers_ && last_shown_ != i) {
+        safePrint("\n==> ");
+        safePrint(file.name);
+        safePrint(" <==\n");
+        last_shown_ = i;
+      }
+      safePrint(std::string_view(buffer.data(), got));
+      file.offset += got;
+    }
   }
-  for (const auto& rec : trailing_records) safePrint(rec);
-}
+};
 
-template <size_t N>
-auto check_unsupported(const CommandContext<N>& ctx) -> cp::Result<void> {
-  if (ctx.get<bool>("-F", false)) {
-    return std::unexpected("-F is [NOT SUPPORT] on this platform");
+auto parse_follow_options(const BoundCommandContext<TAIL_OPTIONS>& ctx,
+                          TailConfig& config)
+    -> cp::Result<void> {
+  if (ctx.get<"-F">(false)) {
+    config.follow = FollowMode::Name;
+    config.retry = true;
   }
-  if (ctx.get<int>("--max-unchanged-stats", -1) >= 0) {
-    return std::unexpected("--max-unchanged-stats is [NOT SUPPORT]");
+  if (ctx.has<"--follow">()) {
+    const std::string how = ctx.get<"--follow", std::string>("");
+    if (how.empty() || how == "descriptor") {
+      if (config.follow == FollowMode::None) {
+        config.follow = FollowMode::Descriptor;
+      }
+    } else if (how == "name") {
+      config.follow = FollowMode::Name;
+    } else {
+      return std::unexpected("invalid argument for '--follow'");
+    }
   }
-  if (ctx.get<int>("--pid", -1) >= 0) {
-    return std::unexpected("--pid is [NOT SUPPORT]");
+  config.retry = config.retry || ctx.get<"--retry">(false);
+  config.pid = ctx.get<"--pid">(-1);
+  if (ctx.has<"--pid">() && config.pid <= 0) {
+    return std::unexpected("invalid PID");
   }
-  if (ctx.get<bool>("--retry", false)) {
-    return std::unexpected("--retry is [NOT SUPPORT]");
+  config.max_unchanged_stats = ctx.get<"--max-unchanged-stats">(5);
+  if (config.max_unchanged_stats < 0) {
+    return std::unexpected(
+        "invalid maximum number of unchanged stats between opens");
   }
-  if (!ctx.get<std::string>("--sleep-interval", "").empty() ||
-      !ctx.get<std::string>("-s", "").empty()) {
-    return std::unexpected("--sleep-interval is [NOT SUPPORT]");
+
+  const std::string interval = ctx.get<"--sleep-interval", std::string>("");
+  if (!interval.empty()) {
+    double seconds = 0;
+    auto [ptr, ec] = std::from_chars(
+        interval.data(), interval.data() + interval.size(), seconds);
+    if (ec != std::errc() || ptr != interval.data() + interval.size() ||
+        !(seconds >= 0) || seconds > 1e6) {
+      return std::unexpected("invalid number of seconds");
+    }
+    config.sleep_interval = std::chrono::milliseconds(
+        static_cast<std::int64_t>(std::ceil(seconds * 1000)));
   }
   return {};
 }
 
-template <size_t N>
-auto build_config(const CommandContext<N>& ctx) -> cp::Result<TailConfig> {
+auto build_config(const BoundCommandContext<TAIL_OPTIONS>& ctx)
+    -> cp::Result<TailConfig> {
   TailConfig config;
-  config.quiet =
-      ctx.get<bool>("--quiet", false) || ctx.get<bool>("--silent", false);
-  config.verbose = ctx.get<bool>("--verbose", false);
-  config.delimiter = ctx.get<bool>("--zero-terminated", false) ? '\0' : '\n';
-  config.follow = ctx.get<bool>("-f", false) || ctx.get<bool>("--follow", false);
+  config.quiet = ctx.get<"--quiet">(false) || ctx.get<"--silent">(false);
+  config.verbose = ctx.get<"--verbose">(false);
+  config.delimiter = ctx.get<"--zero-terminated">(false) ? '\0' : '\n';
 
-  auto unsupported = check_unsupported(ctx);
-  if (!unsupported) return std::unexpected(unsupported.error());
+  auto follow = parse_follow_options(ctx, config);
+  if (!follow) return std::unexpected(follow.error());
 
-  const std::string bytes_arg = ctx.get<std::string>("--bytes", "");
-  const std::string bytes_short = ctx.get<std::string>("-c", "");
-  const std::string lines_arg = ctx.get<std::string>("--lines", "");
-  const std::string lines_short = ctx.get<std::string>("-n", "");
+  const std::string bytes_arg = ctx.get<"--bytes", std::string>("");
+  const std::string bytes_short = ctx.get<"-c", std::string>("");
+  const std::string lines_arg = ctx.get<"--lines", std::string>("");
+  const std::string lines_short = ctx.get<"-n", std::string>("");
 
   std::string bytes_spec = bytes_arg.empty() ? bytes_short : bytes_arg;
   std::string lines_spec = lines_arg.empty() ? lines_short : lines_arg;
@@ -373,6 +747,7 @@ REGISTER_COMMAND(
     "  tail -n 20 file.txt\n"
     "  tail -n +5 file.txt\n"
     "  tail -c 64 file.txt\n"
+    "  tail -F app.log\n"
     "  tail -v a.txt b.txt",
     "head(1), cat(1)", "WinuxCmd", "Copyright © 2026 WinuxCmd", TAIL_OPTIONS) {
   using namespace tail_pipeline;
@@ -404,6 +779,8 @@ auto config = *config_result;
   bool any_error = false;
   bool first_print = true;
   bool multi = files.size() > 1;
+  const bool following = config.follow != FollowMode::None;
+  Follower follower(config, config.verbose || (multi && !config.quiet));
 
   for (size_t i = 0; i < files.size(); ++i) {
     const auto& file = files[i];
@@ -418,66 +795,45 @@ auto config = *config_result;
     }
 
     if (file == "-") {
-      config.stdin_mode = true;
-      output_tail(std::cin, config);
-      if (std::cin.bad()) {
-        safeErrorPrint("tail: error reading '-'\n");
-        any_error = true;
+      follower.other_output();
+      if (stdin_is_seekable()) {
+        auto input = MappedFile::from_stdin(AccessHint::Random);
+        if (input) {
+          output_tail_mapped(input->view(), config);
+        } else {
+          safeErrorPrint("tail: error reading '-'\n");
+          any_error = true;
+        }
+      } else {
+        output_tail(stdin_stream(), config);
+        if (stdin_stream().bad()) {
+          safeErrorPrint("tail: error reading '-'\n");
+          any_error = true;
+        }
       }
     } else {
-      std::ifstream input(file, std::ios::binary);
-      if (!input.is_open()) {
-        safeErrorPrint("tail: cannot open '");
-        safeErrorPrint(file);
-        safeErrorPrint("'\n");
-        any_error = true;
-        continue;
-      }
-
-      output_tail(input, config);
-      if (input.bad()) {
-        safeErrorPrint("tail: error reading '");
-        safeErrorPrint(file);
-        safeErrorPrint("'\n");
+      auto input = MappedFile::open(file, AccessHint::Random);
+      if (!input) {
+        safeErrorPrint("tail: ");
+        safeErrorPrint(input.error());
+        safeErrorPrint("\n");
         any_error = true;
-      }
-      input.close();
-
-      if (config.follow && !config.stdin_mode) {
-        std::ifstream monitor_file(file, std::ios::binary);
-        if (!monitor_file.is_open()) {
-          safeErrorPrint("tail: cannot open '");
-          safeErrorPrint(file);
-          safeErrorPrint("' for following\n");
-          any_error = true;
+        if (following && config.retry) {
+          follower.add(file, std::nullopt);
         } else {
-          monitor_file.seekg(0, std::ios::end);
-          while (true) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            auto current_pos = monitor_file.tellg();
-            monitor_file.seekg(0, std::ios::end);
-            auto end_pos = monitor_file.tellg();
-            if (end_pos > current_pos) {
-              monitor_file.seekg(current_pos);
-              std::string line;
-              while (std::getline(monitor_file, line)) {
-                safePrint(line);
-                safePrint("\n");
-              }
-            }
-            if (GetAsyncKeyState(VK_CONTROL) & 0x8000) {
-              if (GetAsyncKeyState('C') & 0x8000) {
-                break;
-              }
-            }
-          }
-          monitor_file.close();
+          follower.other_output();
         }
+        continue;
       }
+
+      output_tail_mapped(input->view(), config);
+      if (following) follower.add(file, input->size());
     }
 
     first_print = false;
   }
 
+  if (following && !follower.empty() && !follower.run()) any_error = true;
+
   return any_error ? 1 : 0;
 }
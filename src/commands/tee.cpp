@@ -91,10 +91,13 @@ REGISTER_COMMAND(tee, "tee",
     output_files.push_back(file_arg);
   }
 
+  // tee is used to watch long-running output; do not hold lines back.
+  setOutputBuffering(OutputBufferMode::Line);
+
   if (output_files.empty()) {
     // No files specified, just copy stdin to stdout
     std::string line;
-    while (std::getline(std::cin, line)) {
+    while (std::getline(stdin_stream(), line)) {
       safePrintLn(line);
     }
     return 0;
@@ -129,7 +132,7 @@ REGISTER_COMMAND(tee, "tee",
 
   // Read from stdin and write to all outputs
   std::string line;
-  while (std::getline(std::cin, line)) {
+  while (std::getline(stdin_stream(), line)) {
     // Write to stdout
     safePrintLn(line);
 
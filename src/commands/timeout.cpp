@@ -179,6 +179,7 @@ auto run(const Config& cfg) -> int {
     si.hStdOutput = GetStdHandle(STD_OUTPUT_HANDLE);
     si.hStdError = GetStdHandle(STD_ERROR_HANDLE);
 
+    flushOutput();
     if (!CreateProcessW(
         NULL,                   // No module name
         &wcmd_line[0],          // Command line
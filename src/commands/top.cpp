@@ -911,6 +911,7 @@ auto run_top(TopConfig& cfg) -> cp::Result<bool> {
     
     display.printHeader(stats, hostname, cfg.delay);
     display.printProcessList(processes, stats, 50, cfg);
+    flushOutput();
     
     if (!cfg.batch_mode) {
       for (int i = 0; i < cfg.delay * 10 && running; ++i) {
@@ -959,6 +960,7 @@ auto run_top(TopConfig& cfg) -> cp::Result<bool> {
             case 'S':
             case 'D': {
               safePrint("\nEnter new delay (seconds): ");
+              flushOutput();
               char input[32];
               if (fgets(input, sizeof(input), stdin)) {
                 int new_delay = atoi(input);
@@ -971,6 +973,7 @@ auto run_top(TopConfig& cfg) -> cp::Result<bool> {
             
             case 'K': {
               safePrint("\nEnter PID to kill: ");
+              flushOutput();
               char input[32];
               if (fgets(input, sizeof(input), stdin)) {
                 DWORD pid = atoi(input);
@@ -986,16 +989,19 @@ auto run_top(TopConfig& cfg) -> cp::Result<bool> {
                   safePrint("Failed to open process.\n");
                 }
               }
+              flushOutput();
               Sleep(2000);  // Give user time to read the message
               break;
             }
             
             case 'R': {
               safePrint("\nEnter PID to renice: ");
+              flushOutput();
               char input[32];
               if (fgets(input, sizeof(input), stdin)) {
                 DWORD pid = atoi(input);
                 safePrint("Enter priority (0-31, lower is higher): ");
+                flushOutput();
                 if (fgets(input, sizeof(input), stdin)) {
                   int priority = atoi(input);
                   HANDLE hProcess = OpenProcess(PROCESS_SET_INFORMATION, FALSE, pid);
@@ -1011,12 +1017,14 @@ auto run_top(TopConfig& cfg) -> cp::Result<bool> {
                   }
                 }
               }
+              flushOutput();
               Sleep(2000);
               break;
             }
             
             case 'U': {
               safePrint("\nEnter username to filter (empty to clear): ");
+              flushOutput();
               char input[256];
               if (fgets(input, sizeof(input), stdin)) {
                 // Remove newline
@@ -1033,6 +1041,7 @@ auto run_top(TopConfig& cfg) -> cp::Result<bool> {
             display.setCursorPos(0, 0);
             display.printHeader(stats, hostname, cfg.delay);
             display.printProcessList(processes, stats, 50, cfg);
+            flushOutput();
           }
         }
         Sleep(100);
@@ -264,7 +264,7 @@ auto run(const Config& cfg) -> int {
 
   // Read from stdin and process
   std::string input;
-  input.assign(std::istreambuf_iterator<char>(std::cin),
+  input.assign(std::istreambuf_iterator<char>(stdin_stream()),
                std::istreambuf_iterator<char>());
 
   std::string output;
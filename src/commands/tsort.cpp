@@ -26,7 +26,7 @@ REGISTER_COMMAND(
   
   if (ctx.positionals.empty()) {
     // Read from stdin
-    input.assign(std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>());
+    input.assign(std::istreambuf_iterator<char>(stdin_stream()), std::istreambuf_iterator<char>());
   } else {
     // Read from file
     std::string filename = std::string(ctx.positionals[0]);
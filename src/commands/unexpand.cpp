@@ -159,7 +159,7 @@ auto run(const Config& cfg) -> int {
 
     if (file == "-") {
       // Read from stdin
-      content.assign(std::istreambuf_iterator<char>(std::cin),
+      content.assign(std::istreambuf_iterator<char>(stdin_stream()),
                      std::istreambuf_iterator<char>());
     } else {
       // Read from file
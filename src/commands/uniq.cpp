@@ -60,6 +60,7 @@ using cmd::meta::OptionType;
  * - @a -u, @a --unique: Only print unique lines [IMPLEMENTED]
  * - @a -w, @a --check-chars: Compare no more than N characters [IMPLEMENTED]
  * - @a -z, @a --zero-terminated: Line delimiter is NUL, not newline [IMPLEMENTED]
+ * - @a --unsorted: Also merge lines that are not adjacent [IMPLEMENTED]
  * - @a --group: Show all items, separating groups [NOT SUPPORT]
  */
 auto constexpr UNIQ_OPTIONS = std::array{
@@ -74,6 +75,8 @@ auto constexpr UNIQ_OPTIONS = std::array{
     OPTION("-w", "--check-chars", "compare no more than N characters",
            INT_TYPE),
     OPTION("-z", "--zero-terminated", "line delimiter is NUL, not newline"),
+    OPTION("", "--unsorted",
+           "merge duplicates anywhere in the input, in first-seen order"),
     OPTION("", "--group", "show all items, separating groups [NOT SUPPORT]")};
 
 namespace uniq_pipeline {
@@ -88,48 +91,23 @@ struct Config {
   int skip_fields = 0;
   int skip_chars = 0;
   int check_chars = -1;
+  bool unsorted = false;  // Group by hash instead of adjacency
   char delimiter = '\n';
   std::string input = "-";
   std::string output = "-";
 };
 
-auto read_all(std::istream& in) -> std::string {
-  return read_text_stream(in);
-}
-
-auto read_source(std::string_view path) -> cp::Result<std::string> {
-  if (path == "-") return read_all(std::cin);
+auto open_reader(std::string_view path, std::ifstream& file, char delimiter)
+    -> cp::Result<LineReader> {
+  LineReaderOptions options;
+  options.delimiter = delimiter;
+  if (path == "-") return LineReader::for_stdin(options);
 
-  std::ifstream in(std::string(path), std::ios::binary);
-  if (!in.is_open()) {
+  file.open(std::string(path), std::ios::binary);
+  if (!file.is_open()) {
     return std::unexpected("cannot open '" + std::string(path) + "'");
   }
-  return read_all(in);
-}
-
-auto split_records(std::string_view content, char delimiter)
-    -> std::vector<std::string> {
-  SmallVector<std::string, 4096> out;
-  size_t start = 0;
-  for (size_t i = 0; i < content.size(); ++i) {
-    if (content[i] == delimiter) {
-      out.emplace_back(content.substr(start, i - start));
-      start = i + 1;
-    }
-  }
-  if (start < content.size()) {
-    out.emplace_back(content.substr(start));
-  }
-  return std::vector<std::string>(out.begin(), out.end());
-}
-
-auto to_lower_ascii(std::string_view s) -> std::string {
-  std::string out;
-  out.reserve(s.size());
-  for (unsigned char c : s) {
-    out.push_back(static_cast<char>(std::tolower(c)));
-  }
-  return out;
+  return LineReader(file, options);
 }
 
 auto skip_n_fields(std::string_view line, int n) -> std::string_view {
@@ -152,50 +130,197 @@ auto skip_n_fields(std::string_view line, int n) -> std::string_view {
   return line.substr(i);
 }
 
-auto comparison_key(std::string_view line, const Config& cfg) -> std::string {
+// The part of LINE that is compared (-f, -s, -w); -i is left to keys_equal
+auto comparison_key(std::string_view line, const Config& cfg)
+    -> std::string_view {
   auto key = skip_n_fields(line, cfg.skip_fields);
   size_t start = std::min<size_t>(key.size(), static_cast<size_t>(cfg.skip_chars));
   key = key.substr(start);
   if (cfg.check_chars >= 0) {
     key = key.substr(0, static_cast<size_t>(cfg.check_chars));
   }
-  if (cfg.ignore_case) return to_lower_ascii(key);
-  return std::string(key);
+  return key;
+}
+
+auto fold_ascii(unsigned char c) -> unsigned char {
+  return c >= 'A' && c <= 'Z' ? static_cast<unsigned char>(c + ('a' - 'A')) : c;
+}
+
+auto keys_equal(std::string_view a, std::string_view b, const Config& cfg)
+    -> bool {
+  if (a.size() != b.size()) return false;
+  if (!cfg.ignore_case) return a == b;
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (fold_ascii(static_cast<unsigned char>(a[i])) !=
+        fold_ascii(static_cast<unsigned char>(b[i]))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Lower-case the ASCII letters among the eight bytes of WORD
+auto fold_ascii_word(std::uint64_t word) -> std::uint64_t {
+  constexpr std::uint64_t kOnes = 0x0101010101010101ULL;
+  constexpr std::uint64_t kHigh = 0x8080808080808080ULL;
+  const std::uint64_t low7 = word & ~kHigh;
+  const std::uint64_t at_least_a = low7 + (0x80 - 'A') * kOnes;
+  const std::uint64_t past_z = low7 + (0x80 - 'Z' - 1) * kOnes;
+  const std::uint64_t upper = at_least_a & ~past_z & ~word & kHigh;
+  return word | (upper >> 2);
+}
+
+// 64-bit hash of KEY, eight bytes at a time; -i hashes the folded bytes
+auto hash_key(std::string_view key, const Config& cfg) -> std::uint64_t {
+  constexpr std::uint64_t kMul = 0x9E3779B97F4A7C15ULL;
+  std::uint64_t h = key.size() * kMul;
+  size_t i = 0;
+  auto mix = [&](std::uint64_t word) {
+    if (cfg.ignore_case) word = fold_ascii_word(word);
+    h = (h ^ word) * kMul;
+    h ^= h >> 29;
+  };
+  for (; i + 8 <= key.size(); i += 8) {
+    std::uint64_t word;
+    std::memcpy(&word, key.data() + i, 8);
+    mix(word);
+  }
+  if (i < key.size()) {
+    std::uint64_t word = 0;
+    std::memcpy(&word, key.data() + i, key.size() - i);
+    mix(word);
+  }
+  return h ^ (h >> 32);
 }
 
-auto is_unsupported_used(const CommandContext<UNIQ_OPTIONS.size()>& ctx)
+/**
+ * @brief Groups of equal keys collected from the whole input (--unsorted).
+ *
+ * An open-addressing table (linear probing, power-of-two size, at most half
+ * full) maps each key to its group; slots hold the full hash so probing and
+ * growing rarely touch the lines. Lines are copied into an arena once. Each
+ * group remembers its first line and count, and for -D the chain of all of
+ * its lines, so output comes out in first-seen order.
+ */
+class LineGroups {
+ public:
+  explicit LineGroups(const Config& cfg) : cfg_(cfg), slots_(1024) {}
+
+  void add(std::string_view line) {
+    const auto key = comparison_key(line, cfg_);
+    const std::uint64_t hash = hash_key(key, cfg_);
+    const size_t mask = slots_.size() - 1;
+    for (size_t i = static_cast<size_t>(hash) & mask;; i = (i + 1) & mask) {
+      Slot& slot = slots_[i];
+      if (slot.group == kEmpty) {
+        slot = {hash, static_cast<std::uint32_t>(groups_.size())};
+        const auto stored = arena_.store(line);
+        const std::uint32_t index = append_line(stored);
+        groups_.push_back(
+            {stored, comparison_key(stored, cfg_), 1, index, index});
+        if (groups_.size() * 2 > slots_.size()) grow();
+        return;
+      }
+      Group& group = groups_[slot.group];
+      if (slot.hash == hash && keys_equal(group.key, key, cfg_)) {
+        ++group.count;
+        if (cfg_.all_repeated) {
+          const std::uint32_t index = append_line(arena_.store(line));
+          next_[group.last] = index;
+          group.last = index;
+        }
+        return;
+      }
+    }
+  }
+
+  /// Call FN(first_line, count, lines) for every group in first-seen
+  /// order; lines(visit) walks all of a group's lines when -D kept them
+  template <typename Fn>
+  void for_each(Fn&& fn) const {
+    for (const Group& group : groups_) {
+      fn(group.first, group.count, [&](auto&& visit) {
+        for (std::uint32_t i = group.head; i != kEmpty; i = next_[i]) {
+          visit(lines_[i]);
+        }
+      });
+    }
+  }
+
+ private:
+  static constexpr std::uint32_t kEmpty = 0xFFFFFFFF;
+
+  struct Slot {
+    std::uint64_t hash = 0;
+    std::uint32_t group = kEmpty;
+  };
+  struct Group {
+    std::string_view first;
+    std::string_view key;  // Inside first
+    size_t count;
+    std::uint32_t head;  // Chain through lines_/next_ (-D only)
+    std::uint32_t last;
+  };
+
+  const Config& cfg_;
+  StringArena arena_;
+  std::vector<Slot> slots_;
+  std::vector<Group> groups_;
+  std::vector<std::string_view> lines_;
+  std::vector<std::uint32_t> next_;
+
+  // Keep LINE for -D; returns its index, or kEmpty without -D
+  std::uint32_t append_line(std::string_view line) {
+    if (!cfg_.all_repeated) return kEmpty;
+    lines_.push_back(line);
+    next_.push_back(kEmpty);
+    return static_cast<std::uint32_t>(lines_.size() - 1);
+  }
+
+  void grow() {
+    std::vector<Slot> bigger(slots_.size() * 2);
+    const size_t mask = bigger.size() - 1;
+    for (const Slot& slot : slots_) {
+      if (slot.group == kEmpty) continue;
+      size_t i = static_cast<size_t>(slot.hash) & mask;
+      while (bigger[i].group != kEmpty) i = (i + 1) & mask;
+      bigger[i] = slot;
+    }
+    slots_ = std::move(bigger);
+  }
+};
+
+auto is_unsupported_used(const BoundCommandContext<UNIQ_OPTIONS>& ctx)
     -> std::optional<std::string_view> {
-  if (ctx.get<bool>("--group", false))
+  if (ctx.get<"--group">(false))
     return "--group is [NOT SUPPORT]";
   return std::nullopt;
 }
 
-auto build_config(const CommandContext<UNIQ_OPTIONS.size()>& ctx)
+auto build_config(const BoundCommandContext<UNIQ_OPTIONS>& ctx)
     -> cp::Result<Config> {
   Config cfg;
 
-  cfg.show_count = ctx.get<bool>("--count", false) || ctx.get<bool>("-c", false);
-  cfg.repeated_only =
-      ctx.get<bool>("--repeated", false) || ctx.get<bool>("-d", false);
-  cfg.all_repeated =
-      ctx.get<bool>("--all-repeated", false) || ctx.get<bool>("-D", false);
-  cfg.unique_only = ctx.get<bool>("--unique", false) || ctx.get<bool>("-u", false);
-  cfg.ignore_case =
-      ctx.get<bool>("--ignore-case", false) || ctx.get<bool>("-i", false);
+  cfg.show_count = ctx.get<"--count">(false) || ctx.get<"-c">(false);
+  cfg.repeated_only = ctx.get<"--repeated">(false) || ctx.get<"-d">(false);
+  cfg.all_repeated = ctx.get<"--all-repeated">(false) || ctx.get<"-D">(false);
+  cfg.unique_only = ctx.get<"--unique">(false) || ctx.get<"-u">(false);
+  cfg.ignore_case = ctx.get<"--ignore-case">(false) || ctx.get<"-i">(false);
 
-  cfg.skip_fields = ctx.get<int>("--skip-fields", 0);
-  if (cfg.skip_fields == 0) cfg.skip_fields = ctx.get<int>("-f", 0);
+  cfg.skip_fields = ctx.get<"--skip-fields">(0);
+  if (cfg.skip_fields == 0) cfg.skip_fields = ctx.get<"-f">(0);
 
-  cfg.skip_chars = ctx.get<int>("--skip-chars", 0);
-  if (cfg.skip_chars == 0) cfg.skip_chars = ctx.get<int>("-s", 0);
+  cfg.skip_chars = ctx.get<"--skip-chars">(0);
+  if (cfg.skip_chars == 0) cfg.skip_chars = ctx.get<"-s">(0);
 
-  cfg.check_chars = ctx.get<int>("--check-chars", -1);
-  if (cfg.check_chars < 0) cfg.check_chars = ctx.get<int>("-w", -1);
+  cfg.check_chars = ctx.get<"--check-chars">(-1);
+  if (cfg.check_chars < 0) cfg.check_chars = ctx.get<"-w">(-1);
 
   cfg.delimiter =
-      (ctx.get<bool>("--zero-terminated", false) || ctx.get<bool>("-z", false))
+      (ctx.get<"--zero-terminated">(false) || ctx.get<"-z">(false))
           ? '\0'
           : '\n';
+  cfg.unsorted = ctx.get<"--unsorted">(false);
 
   if (cfg.skip_fields < 0 || cfg.skip_chars < 0 || cfg.check_chars < -1) {
     return std::unexpected("negative counts are not allowed");
@@ -228,15 +353,74 @@ auto emit_one(std::ostream& out, std::string_view line, size_t count,
   out << cfg.delimiter;
 }
 
+// Default mode: only the current group is kept in memory, its first record
+// and, when -D has to print the whole group, every member
+auto emit_adjacent_groups(LineReader& reader, std::ostream& out,
+                          const Config& cfg) -> void {
+  std::string first;
+  std::string_view key;  // Inside first
+  std::vector<std::string> members;
+  size_t count = 0;
+
+  auto flush_group = [&]() {
+    if (count == 0 || !should_emit(count, cfg)) return;
+    if (cfg.all_repeated && count > 1) {
+      for (const auto& member : members) {
+        emit_one(out, member, count, cfg, true);
+      }
+    } else {
+      emit_one(out, first, count, cfg);
+    }
+  };
+
+  std::string_view record;
+  while (reader.next(record)) {
+    if (count > 0 && keys_equal(comparison_key(record, cfg), key, cfg)) {
+      ++count;
+      if (cfg.all_repeated) members.emplace_back(record);
+      continue;
+    }
+
+    flush_group();
+    first.assign(record);
+    key = comparison_key(first, cfg);
+    count = 1;
+    if (cfg.all_repeated) {
+      members.clear();
+      members.emplace_back(record);
+    }
+  }
+  flush_group();
+}
+
+// --unsorted: equal keys form one group wherever they occur
+auto emit_hashed_groups(LineReader& reader, std::ostream& out,
+                        const Config& cfg) -> void {
+  LineGroups groups(cfg);
+  std::string_view record;
+  while (reader.next(record)) groups.add(record);
+
+  groups.for_each([&](std::string_view first, size_t count, auto&& lines) {
+    if (!should_emit(count, cfg)) return;
+    if (cfg.all_repeated && count > 1) {
+      lines([&](std::string_view line) {
+        emit_one(out, line, count, cfg, true);
+      });
+    } else {
+      emit_one(out, first, count, cfg);
+    }
+  });
+}
+
 auto run(const Config& cfg) -> int {
-  auto content = read_source(cfg.input);
-  if (!content) {
-    cp::report_error(content, L"uniq");
+  std::ifstream file_in;
+  auto reader = open_reader(cfg.input, file_in, cfg.delimiter);
+  if (!reader) {
+    cp::report_error(reader, L"uniq");
     return 1;
   }
 
-  auto records = split_records(*content, cfg.delimiter);
-  std::ostream* out = &std::cout;
+  std::ostream* out = &stdout_stream();
   std::ofstream file_out;
   if (cfg.output != "-") {
     file_out.open(cfg.output, std::ios::binary | std::ios::trunc);
@@ -247,27 +431,10 @@ auto run(const Config& cfg) -> int {
     out = &file_out;
   }
 
-  if (records.empty()) return 0;
-
-  size_t i = 0;
-  while (i < records.size()) {
-    size_t j = i + 1;
-    const auto key = comparison_key(records[i], cfg);
-    while (j < records.size() && comparison_key(records[j], cfg) == key) {
-      ++j;
-    }
-
-    const size_t count = j - i;
-    if (should_emit(count, cfg)) {
-      if (cfg.all_repeated && count > 1) {
-        for (size_t k = i; k < j; ++k) {
-          emit_one(*out, records[k], count, cfg, true);
-        }
-      } else {
-        emit_one(*out, records[i], count, cfg);
-      }
-    }
-    i = j;
+  if (cfg.unsorted) {
+    emit_hashed_groups(*reader, *out, cfg);
+  } else {
+    emit_adjacent_groups(*reader, *out, cfg);
   }
 
   out->flush();
@@ -281,7 +448,8 @@ REGISTER_COMMAND(uniq, "uniq", "uniq [OPTION]... [INPUT [OUTPUT]]",
                  "writing to OUTPUT (or standard output).",
                  "  uniq data.txt\n"
                  "  sort a.txt | uniq -c\n"
-                 "  uniq -i -d words.txt",
+                 "  uniq -i -d words.txt\n"
+                 "  uniq --unsorted -c access.log",
                  "sort(1), grep(1)", "WinuxCmd", "Copyright © 2026 WinuxCmd",
                  UNIQ_OPTIONS) {
   using namespace uniq_pipeline;
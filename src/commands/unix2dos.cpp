@@ -122,7 +122,7 @@ UNIX2DOS_OPTIONS) {
     // Read from stdin, write to stdout
     std::string line;
     bool first = true;
-    while (std::getline(std::cin, line)) {
+    while (std::getline(stdin_stream(), line)) {
       if (!first) {
         safePrint("\r\n");
       }
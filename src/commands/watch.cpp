@@ -171,6 +171,7 @@ auto run(const Config& cfg) -> int {
     }
 
     // Wait for interval
+    flushOutput();
     Sleep(cfg.interval * 1000);
   }
 
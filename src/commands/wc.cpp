@@ -39,7 +39,8 @@ using cmd::meta::OptionType;
 // Constants
 // ======================================================
 namespace wc_constants {
-// Add constants here
+// Read size; large enough that counting stays disk-bound
+constexpr size_t kReadBlock = 1024 * 1024;
 }
 
 // ======================================================
@@ -96,6 +97,7 @@ struct CountResult {
   std::uintmax_t bytes = 0;
   std::uintmax_t max_line_length = 0;
   std::string filename;
+  bool open_failed = false;
 };
 
 // ----------------------------------------------
@@ -131,116 +133,117 @@ auto validate_arguments(std::span<const std::string_view> args)
 }
 
 // ----------------------------------------------
-// 3. Count file contents
+// 3. Count contents
 // ----------------------------------------------
 /**
- * @brief Count lines, words, chars, bytes, and max line length in a file
- *
- * This function reads a file and counts the number of lines, words, characters,
- * bytes, and the maximum line length.
- *
- * @param path Path to the file to count
- * @return A Result containing the count result
+ * @brief Which counts to print, in output order
  */
-auto count_file(const std::string& path) -> cp::Result<CountResult> {
-  CountResult result;
-  result.filename = path;
-
-  std::ifstream file(path, std::ios::binary);
-  if (!file) {
-    return std::unexpected("cannot open file '" + path + "'");
-  }
-
-  std::string line;
-  std::uintmax_t current_line_length = 0;
-  bool in_word = false;
+struct CountSelection {
+  bool lines = false;
+  bool words = false;
+  bool chars = false;
+  bool bytes = false;
+  bool max_line_length = false;
+};
 
-  char c;
-  while (file.get(c)) {
-    result.bytes++;
-    result.chars++;
+auto select_counts(const BoundCommandContext<WC_OPTIONS>& ctx)
+    -> CountSelection {
+  CountSelection sel;
+  sel.lines = ctx.get<"--lines">(false) || ctx.get<"-l">(false);
+  sel.words = ctx.get<"--words">(false) || ctx.get<"-w">(false);
+  sel.chars = ctx.get<"--chars">(false) || ctx.get<"-m">(false);
+  sel.bytes = ctx.get<"--bytes">(false) || ctx.get<"-c">(false);
+  sel.max_line_length =
+      ctx.get<"--max-line-length">(false) || ctx.get<"-L">(false);
 
-    if (c == '\n') {
-      result.lines++;
-      if (current_line_length > result.max_line_length) {
-        result.max_line_length = current_line_length;
-      }
-      current_line_length = 0;
-      in_word = false;
-    } else if (std::isspace(static_cast<unsigned char>(c))) {
-      current_line_length++;
-      in_word = false;
-    } else {
-      current_line_length++;
-      if (!in_word) {
-        result.words++;
-        in_word = true;
-      }
-    }
+  // If no options specified, print lines, words, and bytes
+  if (!sel.lines && !sel.words && !sel.chars && !sel.bytes &&
+      !sel.max_line_length) {
+    sel.lines = true;
+    sel.words = true;
+    sel.bytes = true;
   }
+  return sel;
+}
 
-  // Check for final line without newline
-  if (current_line_length > 0) {
-    result.lines++;
-    if (current_line_length > result.max_line_length) {
-      result.max_line_length = current_line_length;
-    }
+/**
+ * @brief Count a stream read in large blocks
+ *
+ * A final line without a newline still counts as a line.
+ *
+ * @param in Stream to read to its end
+ * @param sel Counts that will be printed; the others are skipped
+ * @return The count result, without a filename
+ */
+auto count_stream(std::istream& in, const CountSelection& sel) -> CountResult {
+  TextCounter counter({.words = sel.words,
+                       .chars = sel.chars,
+                       .max_line_length = sel.max_line_length});
+  std::vector<char> buffer(wc_constants::kReadBlock);
+  while (in) {
+    in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    const auto got = static_cast<size_t>(in.gcount());
+    if (got == 0) break;
+    counter.feed(std::string_view(buffer.data(), got));
   }
 
+  const TextCounts counts = counter.counts();
+  CountResult result;
+  result.lines = counts.newlines + (counts.unterminated_line ? 1 : 0);
+  result.words = counts.words;
+  result.chars = counts.chars;
+  result.bytes = counts.bytes;
+  result.max_line_length = counts.max_line_length;
   return result;
 }
 
-// ----------------------------------------------
-// 4. Count stdin contents
-// ----------------------------------------------
 /**
- * @brief Count lines, words, chars, bytes, and max line length from stdin
- *
- * This function reads from standard input and counts the number of lines,
- * words, characters, bytes, and the maximum line length.
+ * @brief Count one FILE operand ("-" is standard input)
  *
- * @return A Result containing the count result
+ * @return The count result; open_failed is set if the file cannot be opened
  */
-auto count_stdin() -> cp::Result<CountResult> {
+auto count_path(const std::string& path, const CountSelection& sel)
+    -> CountResult {
   CountResult result;
-  result.filename = "-";
-
-  std::uintmax_t current_line_length = 0;
-  bool in_word = false;
-
-  char c;
-  while (std::cin.get(c)) {
-    result.bytes++;
-    result.chars++;
-
-    if (c == '\n') {
-      result.lines++;
-      if (current_line_length > result.max_line_length) {
-        result.max_line_length = current_line_length;
-      }
-      current_line_length = 0;
-      in_word = false;
-    } else if (std::isspace(static_cast<unsigned char>(c))) {
-      current_line_length++;
-      in_word = false;
-    } else {
-      current_line_length++;
-      if (!in_word) {
-        result.words++;
-        in_word = true;
-      }
-    }
+  if (path == "-") {
+    result = count_stream(stdin_stream(), sel);
+  } else if (std::ifstream file(path, std::ios::binary); file) {
+    result = count_stream(file, sel);
+  } else {
+    result.open_failed = true;
   }
+  result.filename = path;
+  return result;
+}
 
-  // Check for final line without newline
-  if (current_line_length > 0) {
-    result.lines++;
-    if (current_line_length > result.max_line_length) {
-      result.max_line_length = current_line_length;
+/**
+ * @brief Count every operand, several files at once
+ *
+ * Files are shared out to worker threads; standard input is bound to the
+ * calling thread, so "-" is counted there. Results keep argument order.
+ */
+auto count_paths(const std::vector<std::string>& paths,
+                 const CountSelection& sel) -> std::vector<CountResult> {
+  std::vector<CountResult> results(paths.size());
+  std::atomic<size_t> next{0};
+  auto worker = [&] {
+    for (size_t i = next++; i < paths.size(); i = next++) {
+      if (paths[i] != "-") results[i] = count_path(paths[i], sel);
     }
+  };
+
+  const size_t threads = std::min<size_t>(
+      paths.size(), std::max(1u, std::thread::hardware_concurrency()));
+  {
+    std::vector<std::jthread> workers;
+    for (size_t t = 1; t < threads; ++t) workers.emplace_back(worker);
+    worker();
   }
 
-  return result;
+  for (size_t i = 0; i < paths.size(); ++i) {
+    if (paths[i] == "-") results[i] = count_path(paths[i], sel);
+  }
+  return results;
 }
 
 // ----------------------------------------------
@@ -255,35 +258,17 @@ auto count_stdin() -> cp::Result<CountResult> {
  *
  * @tparam N Number of options in the command context
  * @param ctx Command context containing options and arguments
- * @return A Result containing the list of count results
+ * @param sel Counts that will be printed
+ * @return A Result containing one count result per operand, in order
  */
-template <size_t N>
-auto process_command(const CommandContext<N>& ctx)
+auto process_command(const BoundCommandContext<WC_OPTIONS>& ctx,
+                     const CountSelection& sel)
     -> cp::Result<std::vector<CountResult>> {
   return validate_arguments(ctx.positionals)
-      .and_then([](std::vector<std::string> paths)
-                    -> cp::Result<std::vector<CountResult>> {
-        SmallVector<CountResult, 64> results;
-
-        if (paths.empty()) {
-          // Read from stdin
-          auto stdin_result = count_stdin();
-          if (!stdin_result) {
-            return std::unexpected(stdin_result.error());
-          }
-          results.push_back(*stdin_result);
-        } else {
-          // Read from files
-          for (const auto& path : paths) {
-            auto file_result = count_file(path);
-            if (!file_result) {
-              return std::unexpected(file_result.error());
-            }
-            results.push_back(*file_result);
-          }
-        }
-
-        return std::vector<CountResult>(results.begin(), results.end());
+      .transform([&](std::vector<std::string> paths) {
+        // With no FILE, read standard input
+        if (paths.empty()) paths.push_back("-");
+        return count_paths(paths, sel);
       });
 }
 
@@ -348,36 +333,23 @@ REGISTER_COMMAND(
     WC_OPTIONS) {
   using namespace wc_pipeline;
 
-  auto result = process_command(ctx);
+  const CountSelection sel = select_counts(ctx);
+  const bool print_lines = sel.lines;
+  const bool print_words = sel.words;
+  const bool print_chars = sel.chars;
+  const bool print_bytes = sel.bytes;
+  const bool print_max_line_length = sel.max_line_length;
+
+  auto result = process_command(ctx, sel);
   if (!result) {
     cp::report_error(result, L"wc");
     return 1;
   }
 
-  auto count_results = *result;
-
-  // Determine which counts to print
-  bool print_lines =
-      ctx.get<bool>("--lines", false) || ctx.get<bool>("-l", false);
-  bool print_words =
-      ctx.get<bool>("--words", false) || ctx.get<bool>("-w", false);
-  bool print_chars =
-      ctx.get<bool>("--chars", false) || ctx.get<bool>("-m", false);
-  bool print_bytes =
-      ctx.get<bool>("--bytes", false) || ctx.get<bool>("-c", false);
-  bool print_max_line_length =
-      ctx.get<bool>("--max-line-length", false) || ctx.get<bool>("-L", false);
-
-  // If no options specified, print lines, words, and bytes
-  if (!print_lines && !print_words && !print_chars && !print_bytes &&
-      !print_max_line_length) {
-    print_lines = true;
-    print_words = true;
-    print_bytes = true;
-  }
+  const auto& count_results = *result;
 
   // Determine when to print total
-  std::string total_when = ctx.get<std::string>("--total", "auto");
+  std::string total_when = ctx.get<"--total", std::string>("auto");
   bool print_total = false;
 
   if (total_when == "always") {
@@ -459,17 +431,22 @@ REGISTER_COMMAND(
     safePrintLn(std::string_view(buf, offset));
   };
 
-  if (total_when == "only") {
-    print_result(total_result);
-  } else {
-    for (const auto& result : count_results) {
+  // Files that could not be opened are reported in their place; the rest
+  // are still counted
+  bool failed = false;
+  for (const auto& result : count_results) {
+    if (result.open_failed) {
+      failed = true;
+      cp::report_custom_error(
+          L"wc", utf8_to_wstring("cannot open file '" + result.filename + "'"));
+    } else if (total_when != "only") {
       print_result(result);
     }
+  }
 
-    if (print_total) {
-      print_result(total_result);
-    }
+  if (print_total) {
+    print_result(total_result);
   }
 
-  return 0;
+  return failed ? 1 : 0;
 }
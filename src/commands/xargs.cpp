@@ -82,7 +82,7 @@ auto parse_arguments(char delimiter, const std::string &replace_str)
   std::string arg;
   
   char c;
-  while (std::cin.get(c)) {
+  while (stdin_stream().get(c)) {
     if (c == delimiter || c == '\n' || c == '\r') {
       if (!arg.empty()) {
         args.push_back(arg);
@@ -189,6 +189,7 @@ auto execute_command(const std::string &command,
     STARTUPINFOW si = {sizeof(si)};
     PROCESS_INFORMATION pi;
     
+    flushOutput();
     BOOL success = CreateProcessW(
       nullptr,
       cmd_line.data(),
@@ -10,6 +10,41 @@ import container;
 
 auto constexpr XXD_OPTIONS = std::array{OPTION("-r", "--reverse", "reverse: convert hex to binary")};
 
+namespace {
+
+void dump_hex(std::string_view data) {
+  static constexpr char kHex[] = "0123456789abcdef";
+  std::string line;
+  line.reserve(80);
+  for (size_t i = 0; i < data.size(); i += 16) {
+    const size_t count = std::min<size_t>(16, data.size() - i);
+    char buf[32];
+    sprintf_s(buf, sizeof(buf), "%08zx: ", i);
+    line.assign(buf);
+
+    for (size_t j = 0; j < 16; ++j) {
+      if (j < count) {
+        const auto byte = static_cast<unsigned char>(data[i + j]);
+        line.push_back(kHex[byte >> 4]);
+        line.push_back(kHex[byte & 0x0F]);
+      } else {
+        line.append("  ");
+      }
+      if (j % 2 == 1) line.push_back(' ');
+    }
+
+    line.push_back(' ');
+    for (size_t j = 0; j < count; ++j) {
+      const char c = data[i + j];
+      line.push_back((c >= 32 && c < 127) ? c : '.');
+    }
+    line.push_back('\n');
+    safePrint(line);
+  }
+}
+
+}  // namespace
+
 REGISTER_COMMAND(
     xxd,
     /* cmd_name */ "xxd",
@@ -28,79 +63,15 @@ REGISTER_COMMAND(
   }
   
   std::string filename = ctx.positionals.empty() ? "-" : std::string(ctx.positionals[0]);
-  
-  if (filename == "-") {
-    std::vector<char> data;
-    data.assign(std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>());
-    
-    for (size_t i = 0; i < data.size(); i += 16) {
-      char buf[32];
-      sprintf_s(buf, sizeof(buf), "%08zx: ", i);
-      safePrint(buf);
-      
-      for (size_t j = 0; j < 16 && i + j < data.size(); ++j) {
-        sprintf_s(buf, sizeof(buf), "%02x", static_cast<unsigned char>(data[i + j]));
-        safePrint(buf);
-        if (j % 2 == 1) safePrint(" ");
-      }
-      
-      // Padding
-      for (size_t j = data.size() % 16; j < 16; ++j) {
-        safePrint("  ");
-        if (j % 2 == 1) safePrint(" ");
-      }
-      
-      safePrint(" ");
-      
-      for (size_t j = 0; j < 16 && i + j < data.size(); ++j) {
-        char c = data[i + j];
-        safePrint((c >= 32 && c < 127) ? std::string(1, c) : ".");
-      }
-      safePrintLn("\n");
-    }
-  } else {
-    std::wstring wfilename = utf8_to_wstring(filename);
-    HANDLE hFile = CreateFileW(wfilename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
-    
-    if (hFile == INVALID_HANDLE_VALUE) {
-      safeErrorPrintLn("xxd: cannot open '" + filename + "'");
-      return 1;
-    }
-    
-    LARGE_INTEGER fileSize;
-    GetFileSizeEx(hFile, &fileSize);
-    std::vector<char> buffer(fileSize.QuadPart);
-    DWORD bytesRead;
-    ReadFile(hFile, buffer.data(), static_cast<DWORD>(fileSize.QuadPart), &bytesRead, nullptr);
-    CloseHandle(hFile);
-    
-    for (size_t i = 0; i < bytesRead; i += 16) {
-      char buf[32];
-      sprintf_s(buf, sizeof(buf), "%08zx: ", i);
-      safePrint(buf);
-      
-      for (size_t j = 0; j < 16 && i + j < bytesRead; ++j) {
-        sprintf_s(buf, sizeof(buf), "%02x", static_cast<unsigned char>(buffer[i + j]));
-        safePrint(buf);
-        if (j % 2 == 1) safePrint(" ");
-      }
-      
-      // Padding
-      size_t remaining = (bytesRead - i) % 16;
-      for (size_t j = remaining; j < 16; ++j) {
-        safePrint("  ");
-        if (j % 2 == 1) safePrint(" ");
-      }
-      
-      safePrint(" ");
-      
-      for (size_t j = 0; j < 16 && i + j < bytesRead; ++j) {
-        char c = buffer[i + j];
-        safePrint((c >= 32 && c < 127) ? std::string(1, c) : ".");
-      }
-      safePrintLn("\n");
-    }
+
+  auto input = filename == "-" ? MappedFile::from_stdin(AccessHint::Sequential)
+                               : MappedFile::open(filename, AccessHint::Sequential);
+  if (!input) {
+    safeErrorPrintLn("xxd: " + input.error());
+    return 1;
   }
-  
+
+  dump_hex(input->view());
+
   return 0;
 }
\ No newline at end of file
@@ -26,4 +26,8 @@
 export module container;
 
 export import :constexpr_map;
+export import :loser_tree;
+export import :parallel_sort;
+export import :radix_sort;
 export import :small_vector;
+export import :string_arena;
@@ -0,0 +1,112 @@
+/*
+ *  Copyright © 2026 [caomengxuan666]
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software
+ *  is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ *
+ *  - File: loser_tree.cppm
+ *  - Username: Administrator
+ *  - CopyrightYear: 2026
+ */
+
+export module container:loser_tree;
+
+import std;
+
+/**
+ * @brief Tournament tree for k-way merging.
+ *
+ * Each internal node remembers the loser of the match played there, so
+ * replacing the winner costs one comparison per tree level (log2 k) instead
+ * of the two a binary heap needs. The tree only sees source indices: the
+ * caller keeps the sources and supplies a three-way comparison of their
+ * current items.
+ *
+ * Ties go to the lower source index, so merging runs numbered in input order
+ * is stable.
+ *
+ * @tparam Compare int(size_t a, size_t b), negative when source a's current
+ *         item orders first
+ */
+export template <typename Compare>
+class LoserTree {
+ public:
+  LoserTree(size_t sources, Compare compare)
+      : k_(sources),
+        compare_(std::move(compare)),
+        nodes_(std::max<size_t>(sources, 1), 0),
+        live_(sources, 0) {}
+
+  /**
+   * @brief Play the initial tournament.
+   * @param live live(i) is false for sources that are already empty
+   */
+  template <typename Live>
+  void build(Live&& live) {
+    for (size_t i = 0; i < k_; ++i) live_[i] = live(i) ? 1 : 0;
+    if (k_ == 0) return;
+
+    // winners[n] is the winner of the subtree at node n; leaves sit at k..2k-1
+    std::vector<size_t> winners(2 * k_);
+    for (size_t i = 0; i < k_; ++i) winners[k_ + i] = i;
+    for (size_t n = k_ - 1; n >= 1; --n) {
+      size_t a = winners[2 * n];
+      size_t b = winners[2 * n + 1];
+      if (beats(a, b)) {
+        winners[n] = a;
+        nodes_[n] = b;
+      } else {
+        winners[n] = b;
+        nodes_[n] = a;
+      }
+    }
+    nodes_[0] = k_ == 1 ? 0 : winners[1];
+  }
+
+  /// True once every source is exhausted
+  bool empty() const { return k_ == 0 || live_[nodes_[0]] == 0; }
+
+  /// Source holding the smallest current item
+  size_t top() const { return nodes_[0]; }
+
+  /**
+   * @brief Re-run the tournament after the caller advanced top().
+   * @param still_live false when top() has no more items
+   */
+  void replay(bool still_live) {
+    size_t winner = nodes_[0];
+    live_[winner] = still_live ? 1 : 0;
+    for (size_t n = (winner + k_) / 2; n >= 1; n /= 2) {
+      if (beats(nodes_[n], winner)) std::swap(nodes_[n], winner);
+    }
+    nodes_[0] = winner;
+  }
+
+ private:
+  size_t k_;
+  Compare compare_;
+  std::vector<size_t> nodes_;  // [0] = winner, [1..k-1] = losers
+  std::vector<std::uint8_t> live_;
+
+  bool beats(size_t a, size_t b) {
+    if (live_[a] == 0) return false;
+    if (live_[b] == 0) return true;
+    int c = compare_(a, b);
+    return c < 0 || (c == 0 && a < b);
+  }
+};
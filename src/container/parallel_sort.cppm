@@ -0,0 +1,182 @@
+/*
+ *  Copyright © 2026 [caomengxuan666]
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software
+ *  is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ *
+ *  - File: parallel_sort.cppm
+ *  - Username: Administrator
+ *  - CopyrightYear: 2026
+ */
+
+export module container:parallel_sort;
+
+import std;
+import :loser_tree;
+
+namespace parallel_sort_detail {
+
+// Below this many elements per thread the threads cost more than they save
+constexpr size_t kMinPerThread = 16 * 1024;
+
+/**
+ * Number of elements of each run that come before output position K in the
+ * stable merge of RUNS. An element's place in the merge is given by the
+ * total order (value, run, index), so its rank can be computed by binary
+ * searching every run; within one run ranks increase, so the count for that
+ * run is found by a binary search over ranks.
+ */
+template <typename T, typename Less>
+auto split_at(const std::vector<std::span<T>>& runs, size_t k,
+              Less& less) -> std::vector<size_t> {
+  auto rank = [&](size_t r, size_t i) {
+    const T& x = runs[r][i];
+    size_t before = i;
+    for (size_t s = 0; s < runs.size(); ++s) {
+      if (s == r) continue;
+      auto run = runs[s];
+      // Equal elements of earlier runs come first, of later runs after
+      auto it = s < r ? std::upper_bound(run.begin(), run.end(), x, less)
+                      : std::lower_bound(run.begin(), run.end(), x, less);
+      before += static_cast<size_t>(it - run.begin());
+    }
+    return before;
+  };
+
+  std::vector<size_t> split(runs.size());
+  for (size_t r = 0; r < runs.size(); ++r) {
+    size_t lo = 0;
+    size_t hi = runs[r].size();
+    while (lo < hi) {
+      size_t mid = lo + (hi - lo) / 2;
+      if (rank(r, mid) < k) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    split[r] = lo;
+  }
+  return split;
+}
+
+}  // namespace parallel_sort_detail
+
+/**
+ * @brief Stable sort on up to THREADS threads.
+ *
+ * The range is cut into one contiguous part per thread and each part is
+ * sorted concurrently, by std::stable_sort unless SORT_PART is given. The
+ * sorted parts are then merged by all threads at once: the output is
+ * divided into equal slices, the slice boundaries are located in every part
+ * by a multi-sequence binary search, and each thread merges its slice with
+ * a loser tree. Ties go to the earlier part, so the result equals
+ * std::stable_sort's.
+ *
+ * Needs a scratch buffer as large as the range. Small ranges, or THREADS <=
+ * 1, are sorted on the calling thread.
+ *
+ * SORT_PART(begin, end) sorts one part (called with It or with span
+ * iterators); it must produce the order LESS gives, so a faster specialized
+ * sort can stand in for std::stable_sort.
+ */
+export template <std::random_access_iterator It, typename Less,
+                 typename SortPart>
+void parallel_stable_sort(It first, It last, Less less, size_t threads,
+                          SortPart sort_part) {
+  using T = std::iter_value_t<It>;
+  const size_t n = static_cast<size_t>(last - first);
+  threads = std::min(threads, n / parallel_sort_detail::kMinPerThread);
+  if (threads <= 1) {
+    sort_part(first, last);
+    return;
+  }
+
+  std::vector<std::span<T>> runs;
+  runs.reserve(threads);
+  for (size_t t = 0; t < threads; ++t) {
+    auto begin = first + static_cast<std::ptrdiff_t>(n * t / threads);
+    auto end = first + static_cast<std::ptrdiff_t>(n * (t + 1) / threads);
+    runs.emplace_back(std::to_address(begin),
+                      static_cast<size_t>(end - begin));
+  }
+
+  {
+    std::vector<std::jthread> workers;
+    workers.reserve(threads);
+    for (auto run : runs) {
+      workers.emplace_back(
+          [run, &sort_part] { sort_part(run.begin(), run.end()); });
+    }
+  }
+
+  // Slice boundaries are found before any element is moved out of a run
+  std::vector<std::vector<size_t>> splits(threads + 1);
+  splits[threads].resize(runs.size());
+  for (size_t r = 0; r < runs.size(); ++r) splits[threads][r] = runs[r].size();
+  {
+    std::vector<std::jthread> workers;
+    workers.reserve(threads);
+    for (size_t t = 0; t < threads; ++t) {
+      workers.emplace_back([&, t] {
+        Less local_less = less;
+        splits[t] =
+            parallel_sort_detail::split_at(runs, n * t / threads, local_less);
+      });
+    }
+  }
+
+  std::vector<T> merged(n);
+  {
+    std::vector<std::jthread> workers;
+    workers.reserve(threads);
+    for (size_t t = 0; t < threads; ++t) {
+      workers.emplace_back([&, t] {
+        Less local_less = less;
+        std::vector<size_t> lo = splits[t];
+        const std::vector<size_t>& hi = splits[t + 1];
+
+        auto compare = [&](size_t a, size_t b) {
+          const T& x = runs[a][lo[a]];
+          const T& y = runs[b][lo[b]];
+          if (local_less(x, y)) return -1;
+          if (local_less(y, x)) return 1;
+          return 0;
+        };
+        LoserTree tree(runs.size(), compare);
+        tree.build([&](size_t r) { return lo[r] < hi[r]; });
+        for (size_t out = n * t / threads; !tree.empty(); ++out) {
+          const size_t r = tree.top();
+          merged[out] = std::move(runs[r][lo[r]]);
+          ++lo[r];
+          tree.replay(lo[r] < hi[r]);
+        }
+      });
+    }
+  }
+
+  std::move(merged.begin(), merged.end(), first);
+}
+
+export template <std::random_access_iterator It, typename Less>
+void parallel_stable_sort(It first, It last, Less less, size_t threads) {
+  parallel_stable_sort(first, last, less, threads,
+                       [&less](auto begin, auto end) {
+                         std::stable_sort(begin, end, less);
+                       });
+}
@@ -0,0 +1,190 @@
+/*
+ *  Copyright © 2026 [caomengxuan666]
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software
+ *  is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ *
+ *  - File: radix_sort.cppm
+ *  - Username: Administrator
+ *  - CopyrightYear: 2026
+ */
+
+export module container:radix_sort;
+
+import std;
+
+namespace radix_sort_detail {
+
+// Partitions this small are finished with insertion sort
+constexpr size_t kInsertionThreshold = 16;
+
+// Order of A and B given that their first DEPTH bytes are equal
+template <typename T, typename ByteAt>
+int compare_from(const T& a, const T& b, size_t depth, ByteAt& byte_at) {
+  for (;; ++depth) {
+    const int ca = byte_at(a, depth);
+    const int cb = byte_at(b, depth);
+    if (ca != cb) return ca < cb ? -1 : 1;
+    if (ca < 0) return 0;
+  }
+}
+
+}  // namespace radix_sort_detail
+
+/**
+ * @brief Multikey quicksort (Bentley & Sedgewick) for byte strings.
+ *
+ * Partitions three ways on one byte at a time and only moves on to the next
+ * byte inside the "equal" partition, so a shared prefix is inspected once
+ * per element instead of once per comparison. That is what makes it beat a
+ * comparison sort on paths, timestamps and other keys with long common
+ * prefixes.
+ *
+ * The element type is opaque: BYTE_AT(elem, depth) returns the key byte at
+ * DEPTH as 0..255, or -1 past the end of the key, which lets the caller
+ * serve the first bytes from a cached prefix. Elements whose keys are equal
+ * end up adjacent and TIE(first, last) is called for each such group of two
+ * or more, to order them by whatever comes after the key.
+ *
+ * Not stable. Pending partitions are kept on an explicit stack, so long
+ * keys cannot exhaust the call stack.
+ */
+export template <std::random_access_iterator It, typename ByteAt,
+                 typename Tie>
+void multikey_quicksort(It first, It last, ByteAt byte_at, Tie tie) {
+  struct Task {
+    It first;
+    It last;
+    size_t depth;
+  };
+  std::vector<Task> pending;
+  pending.push_back({first, last, 0});
+
+  while (!pending.empty()) {
+    auto [lo, hi, depth] = pending.back();
+    pending.pop_back();
+    const auto n = hi - lo;
+    if (n < 2) continue;
+
+    if (static_cast<size_t>(n) <= radix_sort_detail::kInsertionThreshold) {
+      for (It i = lo + 1; i != hi; ++i) {
+        for (It j = i; j != lo; --j) {
+          if (radix_sort_detail::compare_from(*j, *(j - 1), depth, byte_at) >=
+              0) {
+            break;
+          }
+          std::iter_swap(j, j - 1);
+        }
+      }
+      for (It run = lo; run != hi;) {
+        It end = run + 1;
+        while (end != hi &&
+               radix_sort_detail::compare_from(*run, *end, depth, byte_at) ==
+                   0) {
+          ++end;
+        }
+        if (end - run > 1) tie(run, end);
+        run = end;
+      }
+      continue;
+    }
+
+    // Median of three bytes as the pivot
+    int a = byte_at(*lo, depth);
+    int b = byte_at(*(lo + n / 2), depth);
+    int c = byte_at(*(hi - 1), depth);
+    const int pivot =
+        std::max(std::min(a, b), std::min(std::max(a, b), c));
+
+    // [lo, lt) < pivot, [lt, i) == pivot, [gt, hi) > pivot
+    It lt = lo;
+    It i = lo;
+    It gt = hi;
+    while (i != gt) {
+      const int ch = byte_at(*i, depth);
+      if (ch < pivot) {
+        std::iter_swap(lt++, i++);
+      } else if (ch > pivot) {
+        std::iter_swap(i, --gt);
+      } else {
+        ++i;
+      }
+    }
+
+    pending.push_back({gt, hi, depth});
+    if (pivot < 0) {
+      if (gt - lt > 1) tie(lt, gt);
+    } else {
+      pending.push_back({lt, gt, depth + 1});
+    }
+    pending.push_back({lo, lt, depth});
+  }
+}
+
+/**
+ * @brief Stable LSD radix sort on 64-bit keys.
+ *
+ * KEY(elem) must map elements to unsigned integers that order as the
+ * elements do. Eight passes of one byte each, through a scratch buffer;
+ * passes on a byte that every key shares are skipped, which for keys like
+ * encoded doubles of small integers removes most of them.
+ */
+export template <std::random_access_iterator It, typename Key>
+void lsd_radix_sort(It first, It last, Key key) {
+  using T = std::iter_value_t<It>;
+  const size_t n = static_cast<size_t>(last - first);
+  if (n < 2) return;
+
+  std::array<std::array<size_t, 256>, 8> counts{};
+  for (It it = first; it != last; ++it) {
+    const std::uint64_t k = key(*it);
+    for (size_t pass = 0; pass < 8; ++pass) {
+      ++counts[pass][(k >> (8 * pass)) & 0xff];
+    }
+  }
+
+  std::vector<T> scratch(n);
+  bool in_scratch = false;
+  for (size_t pass = 0; pass < 8; ++pass) {
+    auto& count = counts[pass];
+    const std::uint64_t some_key = key(in_scratch ? scratch[0] : *first);
+    if (count[(some_key >> (8 * pass)) & 0xff] == n) continue;
+
+    size_t offset = 0;
+    for (auto& c : count) {
+      const size_t bucket = c;
+      c = offset;
+      offset += bucket;
+    }
+
+    auto scatter = [&](auto from, auto from_end, auto to) {
+      for (; from != from_end; ++from) {
+        const size_t digit = (key(*from) >> (8 * pass)) & 0xff;
+        to[count[digit]++] = std::move(*from);
+      }
+    };
+    if (in_scratch) {
+      scatter(scratch.begin(), scratch.end(), first);
+    } else {
+      scatter(first, last, scratch.begin());
+    }
+    in_scratch = !in_scratch;
+  }
+
+  if (in_scratch) std::move(scratch.begin(), scratch.end(), first);
+}
@@ -0,0 +1,100 @@
+/*
+ *  Copyright © 2026 [caomengxuan666]
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software
+ *  is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ *
+ *  - File: string_arena.cppm
+ *  - Username: Administrator
+ *  - CopyrightYear: 2026
+ */
+
+export module container:string_arena;
+
+import std;
+
+/**
+ * @brief Append-only storage for many small strings.
+ *
+ * Strings are copied into large blocks and handed back as string_views, so
+ * a million lines cost a handful of allocations instead of a million. Views
+ * stay valid until clear() (blocks never move); strings larger than a block
+ * get a block of their own.
+ */
+export class StringArena {
+ public:
+  explicit StringArena(size_t block_size = 1 << 20)
+      : block_size_(std::max<size_t>(block_size, 64)) {}
+
+  StringArena(StringArena&&) noexcept = default;
+  StringArena& operator=(StringArena&&) noexcept = default;
+  StringArena(const StringArena&) = delete;
+  StringArena& operator=(const StringArena&) = delete;
+
+  /// Copy TEXT into the arena
+  std::string_view store(std::string_view text) {
+    if (text.empty()) return {};
+    if (blocks_.empty() || blocks_.back().capacity - blocks_.back().used <
+                               text.size()) {
+      grow(text.size());
+    }
+    Block& block = blocks_.back();
+    char* dest = block.data.get() + block.used;
+    std::memcpy(dest, text.data(), text.size());
+    block.used += text.size();
+    used_ += text.size();
+    return {dest, text.size()};
+  }
+
+  /// Bytes of string data stored
+  size_t used() const { return used_; }
+
+  /// Bytes held from the allocator, including unused block tails
+  size_t reserved() const { return reserved_; }
+
+  /// Forget every string; the first block is kept for reuse
+  void clear() {
+    if (blocks_.size() > 1) {
+      blocks_.erase(blocks_.begin() + 1, blocks_.end());
+    }
+    if (!blocks_.empty()) {
+      blocks_.front().used = 0;
+      reserved_ = blocks_.front().capacity;
+    }
+    used_ = 0;
+  }
+
+ private:
+  struct Block {
+    std::unique_ptr<char[]> data;
+    size_t capacity = 0;
+    size_t used = 0;
+  };
+
+  size_t block_size_;
+  std::vector<Block> blocks_;
+  size_t used_ = 0;
+  size_t reserved_ = 0;
+
+  void grow(size_t at_least) {
+    const size_t capacity = std::max(block_size_, at_least);
+    blocks_.push_back(
+        Block{std::make_unique_for_overwrite<char[]>(capacity), capacity, 0});
+    reserved_ += capacity;
+  }
+};
@@ -31,7 +31,9 @@ import utils;
 
 namespace cmd::meta {
 // OptionMeta with constexpr support
-export enum class OptionType { Bool, Int, String };
+// OptionalString takes a value only as "--name=VALUE"; a bare "--name" (or
+// its short form) stores an empty string, so callers test has("--name").
+export enum class OptionType { Bool, Int, String, OptionalString };
 
 export struct OptionMeta {
   std::string_view short_name;
@@ -45,6 +47,97 @@ export struct OptionMeta {
       : short_name(s), long_name(l), description(d), type(t) {}
 };
 
+// FNV-1a over an option spelling. constexpr so the OptionIndex tables, and
+// the ctx.get<"--name">() lookups against them, are built at compile time.
+export constexpr std::uint64_t option_hash(std::string_view name) noexcept {
+  std::uint64_t h = 0xcbf29ce484222325ull;
+  for (char c : name) {
+    h ^= static_cast<unsigned char>(c);
+    h *= 0x100000001b3ull;
+  }
+  return h;
+}
+
+// Compile-time lookup tables for one command's options. Single-character
+// short flags ("-x") resolve through a 128-entry table; every other spelling
+// ("--long", "-name") goes through a small open-addressed hash table. When
+// two options share a spelling the first one wins, matching the order the
+// options were declared in.
+export template <size_t OptionCount>
+class OptionIndex {
+ public:
+  static constexpr size_t npos = static_cast<size_t>(-1);
+
+  constexpr explicit OptionIndex(
+      const std::array<OptionMeta, OptionCount> &options) {
+    short_.fill(kEmpty);
+    slots_.fill(kEmpty);
+    for (size_t i = 0; i < OptionCount; ++i) {
+      add(options[i].short_name, i);
+      add(options[i].long_name, i);
+    }
+  }
+
+  // Option index for the flag character in "-x", or npos
+  constexpr size_t find_short(char ch) const noexcept {
+    const auto uch = static_cast<unsigned char>(ch);
+    if (uch >= short_.size() || short_[uch] == kEmpty) return npos;
+    return short_[uch];
+  }
+
+  // Option index for an exact spelling such as "-x", "--long" or "-name"
+  constexpr size_t find(std::string_view name) const noexcept {
+    return find(name, option_hash(name));
+  }
+
+  constexpr size_t find(std::string_view name,
+                        std::uint64_t hash) const noexcept {
+    if (name.size() == 2 && name[0] == '-' && name[1] != '-')
+      return find_short(name[1]);
+    for (size_t slot = hash & kMask;; slot = (slot + 1) & kMask) {
+      const auto entry = slots_[slot];
+      if (entry == kEmpty) return npos;
+      if (entries_[entry].hash == hash && entries_[entry].name == name)
+        return entries_[entry].option;
+    }
+  }
+
+ private:
+  struct Entry {
+    std::uint64_t hash = 0;
+    std::string_view name;
+    std::uint16_t option = 0;
+  };
+
+  static constexpr std::uint16_t kEmpty = 0xFFFF;
+  // At most two spellings per option; keep the load factor at or below 1/2
+  static constexpr size_t kSlots = std::bit_ceil(OptionCount * 4 + 4);
+  static constexpr size_t kMask = kSlots - 1;
+  static_assert(OptionCount * 2 < kEmpty, "Too many options");
+
+  constexpr void add(std::string_view name, size_t option) {
+    if (name.empty()) return;
+    if (name.size() == 2 && name[0] == '-' && name[1] != '-') {
+      const auto uch = static_cast<unsigned char>(name[1]);
+      if (uch < short_.size() && short_[uch] == kEmpty)
+        short_[uch] = static_cast<std::uint16_t>(option);
+      return;
+    }
+    const auto hash = option_hash(name);
+    size_t slot = hash & kMask;
+    for (; slots_[slot] != kEmpty; slot = (slot + 1) & kMask) {
+      if (entries_[slots_[slot]].name == name) return;
+    }
+    entries_[entry_count_] = {hash, name, static_cast<std::uint16_t>(option)};
+    slots_[slot] = static_cast<std::uint16_t>(entry_count_++);
+  }
+
+  std::array<std::uint16_t, 128> short_{};
+  std::array<std::uint16_t, kSlots> slots_{};
+  std::array<Entry, OptionCount * 2> entries_{};
+  size_t entry_count_ = 0;
+};
+
 // Compile-time command metadata (fully compile-time)
 export template <size_t OptionCount>
 class CommandMeta {
@@ -58,6 +151,7 @@ class CommandMeta {
   std::string_view m_author;
   std::string_view m_copyright;
   std::string_view m_brief_desc;  // Brief description for help listing
+  OptionIndex<OptionCount> m_option_index;
 
   static constexpr std::array<OptionMeta, OptionCount> with_index(
       std::array<OptionMeta, OptionCount> opts) {
@@ -82,7 +176,8 @@ class CommandMeta {
         m_see_also(see_also),
         m_author(author),
         m_copyright(copyright),
-        m_brief_desc(brief_desc) {}
+        m_brief_desc(brief_desc),
+        m_option_index(options) {}
 
   // Accessors
   constexpr std::string_view name() const { return m_name; }
@@ -90,6 +185,7 @@ class CommandMeta {
   constexpr std::string_view description() const { return m_description; }
   constexpr const auto &options() const { return m_options; }
   constexpr size_t option_count() const { return OptionCount; }
+  constexpr const auto &option_index() const { return m_option_index; }
   constexpr std::string_view examples() const { return m_examples; }
   constexpr std::string_view see_also() const { return m_see_also; }
   constexpr std::string_view author() const { return m_author; }
@@ -410,92 +506,29 @@ class CommandMeta {
   }
 };
 
-// Runtime type-erased wrapper
-export class CommandMetaBase {
- public:
-  virtual ~CommandMetaBase() = default;
-
-  virtual std::string_view name() const = 0;
-
-  virtual std::string get_help() const = 0;
-
-  virtual std::string get_man() const = 0;
-
-  virtual std::string_view brief_desc() const = 0;
-
-  virtual std::span<const OptionMeta> options() const = 0;
-};
-
-export template <size_t N>
-class CommandMetaWrapper : public CommandMetaBase {
-  const CommandMeta<N> m_meta;
-
- public:
-  CommandMetaWrapper(const CommandMeta<N> &meta) : m_meta(meta) {}
-
-  std::string_view name() const override { return m_meta.name(); }
-  std::string get_help() const override { return m_meta.get_help(); }
-  std::string get_man() const override { return m_meta.get_man(); }
-  std::string_view brief_desc() const override { return m_meta.brief_desc(); }
-
-  std::span<const OptionMeta> options() const override {
-    return m_meta.options();
-  }
+// Runtime view of one command, emitted by REGISTER_COMMAND as a constant-
+// initialized object. Everything is a pointer or a view into the command's
+// constexpr CommandMeta, so building it costs nothing at startup.
+export struct CommandDescriptor {
+  std::string_view name;
+  std::string_view brief_desc;
+  std::span<const OptionMeta> options;
+  int (*run)(std::span<std::string_view> args) noexcept;
+  std::string (*help)();
+  std::string (*man)();
 };
 
-// Type-erased runtime handle
-export class CommandMetaHandle {
-  std::unique_ptr<CommandMetaBase> m_ptr;
-
- public:
-  constexpr CommandMetaHandle() noexcept : m_ptr(nullptr) {}
-
-  template <size_t N>
-  CommandMetaHandle(const CommandMeta<N> &meta)
-      : m_ptr(std::make_unique<CommandMetaWrapper<N> >(meta)) {}
-
-  std::string_view name() const { return m_ptr->name(); }
-  std::string get_help() const { return m_ptr->get_help(); }
-  std::string get_man() const { return m_ptr->get_man(); }
-  std::string_view brief_desc() const { return m_ptr->brief_desc(); }
-
-  std::span<const OptionMeta> options() const { return m_ptr->options(); }
+// One row of the command table, sorted by name at compile time.
+export struct CommandTableEntry {
+  std::string_view name;
+  const CommandDescriptor *command;
 };
 
-// Registry for metadata
-export class Registry {
- public:
-  template <size_t N>
-  static void register_command(std::string_view command_name,
-                               const CommandMeta<N> &meta) {
-    get_storage()[command_name] = CommandMetaHandle(meta);
-  }
-
-  static bool print_help(std::string_view cmd_name) {
-    auto &storage = get_storage();
-    auto it = storage.find(cmd_name);
-    if (it != storage.end()) {
-      std::wstring whelp = utf8_to_wstring(it->second.get_help().c_str());
-      safePrintLn(whelp);
-      return true;
-    }
-    return false;
-  }
-
-  static std::string get_man(std::string_view cmd_name) {
-    auto &storage = get_storage();
-    auto it = storage.find(cmd_name);
-    if (it != storage.end()) {
-      return it->second.get_man();
-    }
-    return "";
-  }
-
- private:
-  static std::unordered_map<std::string_view, CommandMetaHandle> &
-  get_storage() {
-    static std::unordered_map<std::string_view, CommandMetaHandle> instance;
-    return instance;
-  }
-};
+// Defined in src/core/command_table.cpp, which is compiled against the
+// command list CMake generates for each target (see
+// cmake/GenerateCommandTable.cmake).
+export extern "C++" auto command_table() noexcept
+    -> std::span<const CommandTableEntry>;
+export extern "C++" auto find_command(std::string_view name) noexcept
+    -> const CommandDescriptor *;
 }  // namespace cmd::meta
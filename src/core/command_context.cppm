@@ -24,37 +24,101 @@
  *  - CopyrightYear: 2026
  */
 export module core:command_context;
+import std;
+import :cmd_meta;
 import :opt;
 
+// Option spelling usable as a template argument, so that
+// ctx.get<"--name">(default) is resolved while compiling.
+export template <size_t L>
+struct OptionName {
+  char text[L]{};
+  std::uint64_t hash = 0;
+
+  consteval OptionName(const char (&name)[L]) {
+    for (size_t i = 0; i < L; ++i) text[i] = name[i];
+    hash = cmd::meta::option_hash(view());
+  }
+
+  constexpr std::string_view view() const { return {text, L - 1}; }
+};
+
 export template <size_t N>
 struct CommandContext {
   const std::array<cmd::meta::OptionMeta, N>* metas = nullptr;
+  const cmd::meta::OptionIndex<N>* index = nullptr;
 
   ParsedOptions<N> options;
   std::vector<std::string_view> positionals;
 
   template <typename T>
   T get(std::string_view name, T default_value) const {
-    if (!metas) return default_value;
-
-    for (size_t i = 0; i < N; ++i) {
-      if ((*metas)[i].long_name == name || (*metas)[i].short_name == name) {
-        return options.get<T>(i, default_value);
-      }
-    }
-    return default_value;
+    if (!index) return default_value;
+
+    size_t i = index->find(name);
+    if (i == cmd::meta::OptionIndex<N>::npos) return default_value;
+    return options.template get<T>(i, default_value);
+  }
+
+  bool has(std::string_view name) const {
+    if (!index) return false;
+
+    size_t i = index->find(name);
+    return i != cmd::meta::OptionIndex<N>::npos && options.has(i);
+  }
+};
+
+/**
+ * @brief A CommandContext whose option table is part of its type.
+ *
+ * REGISTER_COMMAND bodies receive one of these. ctx.get<"--name">(default)
+ * and ctx.has<"--name">() look the spelling up in OPTIONS at compile time,
+ * so the call costs one array access and a misspelled name does not
+ * compile. Helpers may take `const BoundCommandContext<X_OPTIONS>&` to use
+ * the same calls; ones taking `const CommandContext<N>&` keep working.
+ */
+export template <const auto& Options>
+struct BoundCommandContext : CommandContext<Options.size()> {
+  static constexpr size_t kCount = Options.size();
+  using Base = CommandContext<kCount>;
+
+  explicit BoundCommandContext(Base&& base) : Base(std::move(base)) {}
+
+  using Base::get;
+  using Base::has;
+
+  template <OptionName Name, typename T>
+  T get(T default_value) const {
+    return this->options.template get<T>(index_of<Name>(), default_value);
+  }
+
+  template <OptionName Name>
+  bool has() const {
+    return this->options.has(index_of<Name>());
+  }
+
+ private:
+  static constexpr cmd::meta::OptionIndex<kCount> kIndex{Options};
+
+  template <OptionName Name>
+  static consteval size_t index_of() {
+    constexpr size_t i = kIndex.find(Name.view(), Name.hash);
+    static_assert(i != cmd::meta::OptionIndex<kCount>::npos,
+                  "no option with this name is declared for the command");
+    return i;
   }
 };
 
 export template <size_t N>
-CommandContext<N> make_context(
-    std::span<std::string_view> args,
-    const std::array<cmd::meta::OptionMeta, N>& metas, bool& ok) {
-  auto parsed = parse_command(args, metas);
+CommandContext<N> make_context(std::span<std::string_view> args,
+                               const cmd::meta::CommandMeta<N>& meta,
+                               bool& ok) {
+  auto parsed = parse_command(args, meta.options(), meta.option_index());
   ok = parsed.ok;
 
   CommandContext<N> ctx;
-  ctx.metas = &metas;
+  ctx.metas = &meta.options();
+  ctx.index = &meta.option_index();
   ctx.options = std::move(parsed.options);
   ctx.positionals = std::move(parsed.positionals);
 
@@ -86,6 +86,20 @@
       return make_option_array_impl(__VA_ARGS__);                              \
     }();                                                                       \
     constexpr size_t option_count = options.size();                            \
+                                                                               \
+    /* The command's own X_OPTIONS array when it passed one, so helpers */     \
+    /* can name the same BoundCommandContext<X_OPTIONS> type. */               \
+    template <typename First, typename... Rest>                                \
+    consteval const auto& option_table(const auto& fallback,                   \
+                                       const First& first, const Rest&...) {   \
+      if constexpr (sizeof...(Rest) == 0 && IsOptionArray<First>) {            \
+        return first;                                                          \
+      } else {                                                                 \
+        return fallback;                                                       \
+      }                                                                        \
+    }                                                                          \
+    constexpr const auto& table = option_table(options, __VA_ARGS__);          \
+    using Context = BoundCommandContext<table>;                                \
     static_assert(option_count > 0, "No options registered!");                 \
     constexpr auto meta = cmd::meta::CommandMeta<option_count>(                \
         std::string_view(cmd_name), std::string_view(cmd_synopsis),            \
@@ -94,26 +108,33 @@
         std::string_view(copyright), std::string_view(cmd_synopsis));           \
   }                                                                            \
                                                                                \
-  template <size_t N>                                                          \
-  int execute##name(CommandContext<N>& ctx) noexcept;                          \
+  int execute##name(command_##name##_internal::Context& ctx) noexcept;         \
                                                                                \
-  namespace {                                                                  \
-  struct _Registrar_##name {                                                   \
-    _Registrar_##name() {                                                      \
-      constexpr size_t N = command_##name##_internal::option_count;            \
-      CommandRegistry::registerCommand<N>(                                     \
-          cmd_name, command_##name##_internal::meta, execute##name<N>);        \
+  namespace command_##name##_internal {                                        \
+    int run(std::span<std::string_view> args) noexcept {                       \
+      bool ok = true;                                                          \
+      Context ctx{make_context<option_count>(args, meta, ok)};                 \
+      if (!ok) return 1;                                                       \
+      return execute##name(ctx);                                               \
     }                                                                          \
-  };                                                                           \
-    _Registrar_##name _registrar_instance_##name;                                \
-    }                                                                            \
-                                                                                 \
-    template <size_t N>                                                          \
-      int execute##name(CommandContext<N>& ctx) noexcept
-    
-    #define BOOL_TYPE cmd::meta::OptionType::Bool
-    #define INT_TYPE cmd::meta::OptionType::Int
-    #define STRING_TYPE cmd::meta::OptionType::String
+    std::string help() { return meta.get_help(); }                             \
+    std::string man() { return meta.get_man(); }                               \
+  }                                                                            \
+                                                                               \
+  /* Picked up by the build-time command table (command_table.cpp). */         \
+  extern constinit const cmd::meta::CommandDescriptor winux_command_##name{    \
+      command_##name##_internal::meta.name(),                                  \
+      command_##name##_internal::meta.brief_desc(),                            \
+      command_##name##_internal::meta.options(),                               \
+      &command_##name##_internal::run, &command_##name##_internal::help,       \
+      &command_##name##_internal::man};                                        \
+                                                                               \
+  int execute##name(command_##name##_internal::Context& ctx) noexcept
+
+#define BOOL_TYPE cmd::meta::OptionType::Bool
+#define INT_TYPE cmd::meta::OptionType::Int
+#define STRING_TYPE cmd::meta::OptionType::String
+#define OPTIONAL_STRING_TYPE cmd::meta::OptionType::OptionalString
 #undef OPTION_TYPE
 #define OPTION_TYPE(...) OPTION_TYPE_IMPL(__VA_ARGS__, BOOL_TYPE)
 
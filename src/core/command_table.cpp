@@ -0,0 +1,95 @@
+/*
+ *  Copyright © 2026 [caomengxuan666]
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the “Software”), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *  - File: command_table.cpp
+ *  - Username: Administrator
+ *  - CopyrightYear: 2026
+ */
+/// @Description: Build-time command table.
+///
+/// command_table.inc is generated by CMake (cmake/GenerateCommandTable.cmake)
+/// from the command sources linked into the target, one
+/// WINUX_COMMAND(identifier, "name") line per REGISTER_COMMAND. The table is
+/// sorted at compile time and indexed by first byte, so a lookup touches a
+/// handful of entries and nothing runs before main().
+#include "pch/pch.h"
+
+import std;
+import core;
+
+#define WINUX_COMMAND(id, cmd_name) \
+  extern const cmd::meta::CommandDescriptor winux_command_##id;
+#include "command_table.inc"
+#undef WINUX_COMMAND
+
+namespace {
+using cmd::meta::CommandDescriptor;
+using cmd::meta::CommandTableEntry;
+
+constexpr auto kCommands = [] {
+  std::array entries{
+#define WINUX_COMMAND(id, cmd_name) \
+  CommandTableEntry{cmd_name, &winux_command_##id},
+#include "command_table.inc"
+#undef WINUX_COMMAND
+  };
+  std::ranges::sort(entries, {}, &CommandTableEntry::name);
+  return entries;
+}();
+
+static_assert(
+    std::ranges::adjacent_find(kCommands, {}, &CommandTableEntry::name) ==
+        kCommands.end(),
+    "duplicate command name");
+
+// kFirstByte[c] .. kFirstByte[c + 1] is the range of names starting with c.
+constexpr auto kFirstByte = [] {
+  std::array<std::uint16_t, 257> index{};
+  size_t pos = 0;
+  for (size_t c = 0; c < 256; ++c) {
+    index[c] = static_cast<std::uint16_t>(pos);
+    while (pos < kCommands.size() && !kCommands[pos].name.empty() &&
+           static_cast<unsigned char>(kCommands[pos].name.front()) == c) {
+      ++pos;
+    }
+  }
+  index[256] = static_cast<std::uint16_t>(pos);
+  return index;
+}();
+}  // namespace
+
+namespace cmd::meta {
+auto command_table() noexcept -> std::span<const CommandTableEntry> {
+  return kCommands;
+}
+
+auto find_command(std::string_view name) noexcept
+    -> const CommandDescriptor * {
+  if (name.empty()) return nullptr;
+  const auto first = static_cast<unsigned char>(name.front());
+  const auto begin = kCommands.begin() + kFirstByte[first];
+  const auto end = kCommands.begin() + kFirstByte[first + 1];
+  const auto it = std::ranges::lower_bound(begin, end, name, {},
+                                           &CommandTableEntry::name);
+  if (it == end || it->name != name) return nullptr;
+  return it->command;
+}
+}  // namespace cmd::meta
@@ -29,3 +29,4 @@ export import :opt;
 export import :dispatcher;
 export import :command_context;
 export import :pipeline;
+export import :stage_pipeline;
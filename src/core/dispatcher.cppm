@@ -27,23 +27,8 @@ export module core:dispatcher;
 
 import std;
 import :cmd_meta;
-import :command_context;
 import utils;
 
-export template <size_t N>
-using CommandFunc = int (*)(CommandContext<N> &) noexcept;
-
-export template <size_t N>
-struct CommandEntry {
-  cmd::meta::CommandMetaHandle meta;
-  CommandFunc<N> handler;
-  std::string_view brief_desc;
-
-  CommandEntry() = default;
-  CommandEntry(cmd::meta::CommandMetaHandle m, CommandFunc<N> h)
-      : meta(std::move(m)), handler(h), brief_desc(meta.brief_desc()) {}
-};
-
 // Per-option information returned for completion
 export struct OptionInfo {
   std::string short_name;
@@ -51,179 +36,92 @@ export struct OptionInfo {
   std::string description;
 };
 
-struct CommandEntryErased {
-  cmd::meta::CommandMetaHandle meta;
-  std::function<int(std::span<std::string_view>)> handler;
-  std::string_view brief_desc;
-
-  CommandEntryErased() = default;
-
-  CommandEntryErased(cmd::meta::CommandMetaHandle m,
-                     std::function<int(std::span<std::string_view>)> h,
-                     std::string_view brief)
-      : meta(std::move(m)), handler(std::move(h)), brief_desc(brief) {}
-};
-
-// Internal registry implementation class
-class RegistryImpl {
-  std::unordered_map<std::string_view, CommandEntryErased> registry_;
-
- public:
-  // Register a command with compile-time metadata
-  template <size_t N>
-  void add(std::string_view name, const cmd::meta::CommandMeta<N> &meta,
-           CommandFunc<N> handler) {
-    // compile-time meta registry
-    cmd::meta::Registry::register_command(name, meta);
-
-    // type erase
-    auto lambda = [meta, handler](std::span<std::string_view> args) -> int {
-      bool ok = true;
-      auto ctx = make_context<N>(args, meta.options(), ok);
-      if (!ok) return 1;
-      return handler(ctx);
-    };
+namespace {
+auto wants_help(const cmd::meta::CommandDescriptor &command,
+                std::span<std::string_view> args) -> bool {
+  for (const auto &arg : args) {
+    if (arg == "--help") return true;
+  }
 
-    registry_.emplace(
-        name, CommandEntryErased{cmd::meta::CommandMetaHandle(meta), lambda,
-                                 meta.brief_desc()});
+  // -h means help only when the command does not define its own -h
+  for (const auto &opt : command.options) {
+    if (opt.short_name == "-h") return false;
   }
+  for (const auto &arg : args) {
+    if (arg == "-h") return true;
+  }
+  return false;
+}
+}  // namespace
 
-  // Dispatch command execution
-  int run(std::string_view cmdName, std::span<std::string_view> args) {
-    auto it = registry_.find(cmdName);
-    if (it == registry_.end()) {
+// Static interface class. Commands live in a constant table generated at
+// build time (cmd::meta::command_table), so nothing is registered or
+// allocated at startup and dispatch is a table lookup plus a direct call.
+export class CommandRegistry {
+ public:
+  // Dispatch command execution (public interface)
+  static int dispatch(std::string_view cmdName,
+                      std::span<std::string_view> args) noexcept {
+    const auto *command = cmd::meta::find_command(cmdName);
+    if (command == nullptr) {
       safePrintLn(L"winuxcmd: command not found: " +
                   std::wstring(cmdName.begin(), cmdName.end()));
       return 127;
     }
 
-    // Get meta data from the command
-    const auto &meta = it->second.meta;
-    auto options = meta.options();  // std::span<const OptionMeta>
-
-    // Check if it contains help
-    bool wants_help = false;
-    for (const auto &arg : args) {
-      if (arg == "--help") {
-        wants_help = true;
-        break;
-      }
-    }
-
-    if (!wants_help) {
-      // Check if -h is already been registered
-      bool has_h_option = false;
-      for (const auto &opt : options) {
-        if (opt.short_name == "-h") {
-          has_h_option = true;
-          break;
-        }
-      }
-      if (!has_h_option) {
-        for (const auto &arg : args) {
-          if (arg == "-h") {
-            wants_help = true;
-            break;
-          }
-        }
-      }
-    }
-
-    if (wants_help) {
-      cmd::meta::Registry::print_help(cmdName);
+    if (wants_help(*command, args)) {
+      safePrintLn(utf8_to_wstring(command->help()));
+      flushOutput();
       return 0;
     }
 
-    return it->second.handler(args);
+    int exit_code = command->run(args);
+    finishOutput();
+    return exit_code;
   }
 
-  // Print command help
-  void help(std::string_view cmdName) {
-    cmd::meta::Registry::print_help(cmdName);
-  }
-
-  // Get man page for a command
-  std::string man(std::string_view cmdName) {
-    return cmd::meta::Registry::get_man(cmdName);
+  // Print command help (public interface)
+  static void printHelp(std::string_view cmdName) noexcept {
+    if (const auto *command = cmd::meta::find_command(cmdName)) {
+      safePrintLn(utf8_to_wstring(command->help()));
+    }
   }
 
-  // Get all registered command names
-  std::vector<std::pair<std::string_view, std::string_view>> list() {
+  // Get all registered command names (public interface)
+  static std::vector<std::pair<std::string_view, std::string_view>>
+  getAllCommands() noexcept {
+    const auto table = cmd::meta::command_table();
     std::vector<std::pair<std::string_view, std::string_view>> commands;
-    commands.reserve(registry_.size());
-    for (const auto &[name, entry] : registry_) {
-      commands.emplace_back(name, entry.brief_desc);
+    commands.reserve(table.size());
+    for (const auto &entry : table) {
+      commands.emplace_back(entry.name, entry.command->brief_desc);
     }
     return commands;
   }
 
-  // Get options for a specific command (for completion)
-  std::vector<OptionInfo> command_options(std::string_view cmdName) {
-    auto it = registry_.find(cmdName);
-    if (it == registry_.end()) return {};
-    auto opts = it->second.meta.options();
+  // Get options for a command (for completion)
+  static std::vector<OptionInfo> getCommandOptions(
+      std::string_view cmdName) noexcept {
+    const auto *command = cmd::meta::find_command(cmdName);
+    if (command == nullptr) return {};
     std::vector<OptionInfo> result;
-    result.reserve(opts.size());
-    for (const auto &opt : opts) {
+    result.reserve(command->options.size());
+    for (const auto &opt : command->options) {
       result.push_back({std::string(opt.short_name),
                         std::string(opt.long_name),
                         std::string(opt.description)});
     }
     return result;
   }
-};
-
-// Get singleton instance
-inline RegistryImpl &getImpl() {
-  static RegistryImpl instance;
-  return instance;
-}
-
-// Static interface class
-export class CommandRegistry {
- public:
-  // Template method for registering commands with compile-time metadata
-  template <size_t N>
-  static void registerCommand(std::string_view name,
-                              const cmd::meta::CommandMeta<N> &meta,
-                              CommandFunc<N> handler) {
-    getImpl().add<N>(name, meta, handler);
-  }
-
-  // Dispatch command execution (public interface)
-  static int dispatch(std::string_view cmdName,
-                      std::span<std::string_view> args) noexcept {
-    return getImpl().run(cmdName, args);
-  }
-
-  // Print command help (public interface)
-  static void printHelp(std::string_view cmdName) noexcept {
-    getImpl().help(cmdName);
-  }
-
-  // Get all registered command names (public interface)
-  static std::vector<std::pair<std::string_view, std::string_view>>
-  getAllCommands() noexcept {
-    return getImpl().list();
-  }
-
-  // Get options for a command (for completion)
-  static std::vector<OptionInfo> getCommandOptions(
-      std::string_view cmdName) noexcept {
-    return getImpl().command_options(cmdName);
-  }
 
   // Check whether a command is registered.
   static bool hasCommand(std::string_view cmdName) noexcept {
-    auto all = getImpl().list();
-    return std::ranges::any_of(all, [cmdName](const auto &item) {
-      return item.first == cmdName;
-    });
+    return cmd::meta::find_command(cmdName) != nullptr;
   }
 
   // Print man page for a command
   static std::string getManPage(std::string_view cmdName) noexcept {
-    return getImpl().man(cmdName);
+    const auto *command = cmd::meta::find_command(cmdName);
+    return command != nullptr ? command->man() : std::string();
   }
 };
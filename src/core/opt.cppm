@@ -28,7 +28,9 @@ export module core:opt;
 import std;
 import :cmd_meta;
 
-using OptionValue = std::variant<bool, int, std::string>;
+// String values are views into the argument vector, which outlives the
+// parsed options for the whole command invocation.
+using OptionValue = std::variant<bool, int, std::string_view>;
 
 export template <size_t N>
 class ParsedOptions {
@@ -41,7 +43,7 @@ class ParsedOptions {
 
   // Simple set method
   void set(size_t index, OptionValue v) {
-    values_[index] = std::move(v);
+    values_[index] = v;
     present_.set(index);
   }
 
@@ -51,7 +53,12 @@ class ParsedOptions {
   T get(size_t index, T default_value = {}) const {
     if (!present_.test(index)) return default_value;
 
-    if (auto p = std::get_if<T>(&values_[index])) return *p;
+    if constexpr (std::is_same_v<T, std::string>) {
+      if (auto p = std::get_if<std::string_view>(&values_[index]))
+        return std::string(*p);
+    } else {
+      if (auto p = std::get_if<T>(&values_[index])) return *p;
+    }
 
     return default_value;
   }
@@ -64,13 +71,55 @@ struct ParseResult {
   bool ok = true;
 };
 
+namespace detail {
+// Store one option value. `inline_value` is the text after '=' (possibly
+// empty); an empty inline value takes the next argument instead.
+inline bool store_value(std::span<std::string_view> args, size_t& i,
+                        cmd::meta::OptionType type,
+                        std::string_view inline_value, size_t idx,
+                        auto& options) {
+  using cmd::meta::OptionType;
+
+  if (type == OptionType::Bool) {
+    options.set(idx, true);
+    return true;
+  }
+
+  if (type == OptionType::OptionalString) {
+    options.set(idx, inline_value);
+    return true;
+  }
+
+  std::string_view value = inline_value;
+  if (value.empty()) {
+    if (i + 1 >= args.size()) return false;
+    value = args[++i];
+  }
+
+  if (type == OptionType::Int) {
+    int v = 0;
+    auto [ptr, ec] =
+        std::from_chars(value.data(), value.data() + value.size(), v);
+    if (ec != std::errc() || ptr != value.data() + value.size()) return false;
+    options.set(idx, v);
+    return true;
+  }
+
+  options.set(idx, value);
+  return true;
+}
+}  // namespace detail
+
 export template <size_t N>
 ParseResult<N> parse_command(
     std::span<std::string_view> args,
-    const std::array<cmd::meta::OptionMeta, N>& metas) {
+    const std::array<cmd::meta::OptionMeta, N>& metas,
+    const cmd::meta::OptionIndex<N>& index) {
   ParseResult<N> result;
   using cmd::meta::OptionType;
+  constexpr size_t npos = cmd::meta::OptionIndex<N>::npos;
 
+  result.positionals.reserve(args.size());
   bool end_of_options = false;
 
   for (size_t i = 0; i < args.size(); ++i) {
@@ -84,7 +133,6 @@ ParseResult<N> parse_command(
 
     // ---------- long option ----------
     if (!end_of_options && arg.starts_with("--")) {
-      const cmd::meta::OptionMeta* meta = nullptr;
       std::string_view value;
       std::string_view name = arg;
 
@@ -94,194 +142,66 @@ ParseResult<N> parse_command(
         value = arg.substr(eq_pos + 1);
       }
 
-      for (const auto& m : metas) {
-        if (m.long_name == name) {
-          meta = &m;
-          break;
-        }
-      }
-
-      if (!meta) {
+      size_t idx = index.find(name);
+      if (idx == npos ||
+          !detail::store_value(args, i, metas[idx].type, value, idx,
+                               result.options)) {
         result.ok = false;
         return result;
       }
 
-      size_t idx = meta->index;
-
-      switch (meta->type) {
-        case OptionType::Bool:
-          result.options.set(idx, true);
-          break;
-
-        case OptionType::Int: {
-          int v = 0;
-          std::string str;
-
-          if (!value.empty()) {
-            // --int=123
-            str = std::string(value);
-          } else {
-            // --int 123
-            if (i + 1 >= args.size()) {
-              result.ok = false;
-              return result;
-            }
-            str = std::string(args[++i]);
-          }
-
-          auto [ptr, ec] =
-              std::from_chars(str.data(), str.data() + str.size(), v);
-          if (ec != std::errc() || ptr != str.data() + str.size()) {
-            result.ok = false;
-            return result;
-          }
-
-          result.options.set(idx, v);
-          break;
-        }
-
-        case OptionType::String: {
-          if (!value.empty()) {
-            // --string=value
-            result.options.set(idx, std::string(value));
-          } else {
-            // --string value
-            if (i + 1 >= args.size()) {
-              result.ok = false;
-              return result;
-            }
-            result.options.set(idx, std::string(args[++i]));
-          }
-          break;
-        }
-      }
-
       continue;
     }
 
     // ---------- short option(s) ----------
     if (!end_of_options && arg.size() >= 2 && arg[0] == '-' && arg[1] != '-') {
       // Support GNU-style single-dash multi-char options (e.g. -name)
-      const cmd::meta::OptionMeta* exact_meta = nullptr;
-      std::string_view exact_value;
-      std::string_view exact_name = arg;
-      size_t exact_eq_pos = arg.find('=');
-      if (exact_eq_pos != std::string_view::npos) {
-        exact_name = arg.substr(0, exact_eq_pos);
-        exact_value = arg.substr(exact_eq_pos + 1);
-      }
-
-      for (const auto& m : metas) {
-        if (!m.short_name.empty() && m.short_name == exact_name) {
-          exact_meta = &m;
-          break;
+      if (arg.size() > 2) {
+        std::string_view exact_value;
+        std::string_view exact_name = arg;
+        size_t exact_eq_pos = arg.find('=');
+        if (exact_eq_pos != std::string_view::npos) {
+          exact_name = arg.substr(0, exact_eq_pos);
+          exact_value = arg.substr(exact_eq_pos + 1);
         }
-      }
 
-      if (exact_meta && exact_meta->short_name.size() > 2) {
-        size_t idx = exact_meta->index;
-        switch (exact_meta->type) {
-          case OptionType::Bool:
-            result.options.set(idx, true);
-            break;
-          case OptionType::Int: {
-            int v = 0;
-            std::string str;
-            if (!exact_value.empty()) {
-              str = std::string(exact_value);
-            } else {
-              if (i + 1 >= args.size()) {
-                result.ok = false;
-                return result;
-              }
-              str = std::string(args[++i]);
-            }
-
-            auto [ptr, ec] =
-                std::from_chars(str.data(), str.data() + str.size(), v);
-            if (ec != std::errc() || ptr != str.data() + str.size()) {
+        if (exact_name.size() > 2) {
+          size_t idx = index.find(exact_name);
+          if (idx != npos) {
+            if (!detail::store_value(args, i, metas[idx].type, exact_value,
+                                     idx, result.options)) {
               result.ok = false;
               return result;
             }
-
-            result.options.set(idx, v);
-            break;
+            continue;
           }
-          case OptionType::String:
-            if (!exact_value.empty()) {
-              result.options.set(idx, std::string(exact_value));
-            } else {
-              if (i + 1 >= args.size()) {
-                result.ok = false;
-                return result;
-              }
-              result.options.set(idx, std::string(args[++i]));
-            }
-            break;
         }
-
-        continue;
       }
 
       // iterate each short flag: -abc
       for (size_t pos = 1; pos < arg.size(); ++pos) {
-        char ch = arg[pos];
-
-        const cmd::meta::OptionMeta* meta = nullptr;
-
-        for (const auto& m : metas) {
-          if (!m.short_name.empty() && m.short_name.size() == 2 &&
-              m.short_name[0] == '-' && m.short_name[1] == ch) {
-            meta = &m;
-            break;
-          }
-        }
-
-        if (!meta) {
+        size_t idx = index.find_short(arg[pos]);
+        if (idx == npos) {
           result.ok = false;
           return result;
         }
 
-        size_t idx = meta->index;
-
-        switch (meta->type) {
-          // ----- bool: can be grouped -----
-          case OptionType::Bool:
-            result.options.set(idx, true);
-            break;
-
-          // ----- value option -----
-          case OptionType::Int:
-          case OptionType::String: {
-            // value option MUST be last in group
-            if (pos != arg.size() - 1) {
-              result.ok = false;
-              return result;
-            }
-
-            if (i + 1 >= args.size()) {
-              result.ok = false;
-              return result;
-            }
-
-            if (meta->type == OptionType::Int) {
-              int v = 0;
-              std::string str = std::string(args[++i]);
-              auto [ptr, ec] =
-                  std::from_chars(str.data(), str.data() + str.size(), v);
-
-              if (ec != std::errc() || ptr != str.data() + str.size()) {
-                result.ok = false;
-                return result;
-              }
-
-              result.options.set(idx, v);
-            } else {
-              result.options.set(idx, std::string(args[++i]));
-            }
+        // ----- bool: can be grouped -----
+        if (metas[idx].type == OptionType::Bool) {
+          result.options.set(idx, true);
+          continue;
+        }
+        if (metas[idx].type == OptionType::OptionalString) {
+          result.options.set(idx, std::string_view{});
+          continue;
+        }
 
-            break;
-          }
+        // ----- value option: MUST be last in group -----
+        if (pos != arg.size() - 1 ||
+            !detail::store_value(args, i, metas[idx].type, {}, idx,
+                                 result.options)) {
+          result.ok = false;
+          return result;
         }
       }
 
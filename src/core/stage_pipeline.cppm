@@ -0,0 +1,106 @@
+/*
+ *  Copyright © 2026 [caomengxuan666]
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the “Software”), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *  - File: stage_pipeline.cppm
+ *  - Username: Administrator
+ *  - CopyrightYear: 2026
+ */
+export module core:stage_pipeline;
+
+import std;
+import :dispatcher;
+import utils;
+
+// In-process execution of pipelines whose stages are all builtins
+// (`ls | grep x | sort`). Each stage runs on its own thread with standard
+// output of one stage connected to standard input of the next through a
+// bounded PipeChannel, so no process is spawned and no OS pipe is involved.
+export namespace core::stage_pipeline {
+// One stage: argv[0] is the command name
+struct Stage {
+  std::vector<std::string> argv;
+};
+
+// Commands that hand their standard handles to child processes or talk to
+// the console directly; they need a real pipe and stay out-of-process.
+inline constexpr std::array<std::string_view, 11> kNeedsOsHandles = {
+    "dd",  "less",  "nice",  "nohup", "stdbuf", "timeout",
+    "top", "tty",   "tzset", "watch", "xargs"};
+
+inline bool needs_os_handles(std::string_view name) {
+  return std::ranges::find(kNeedsOsHandles, name) != kNeedsOsHandles.end();
+}
+
+inline bool runnable(std::span<const Stage> stages) {
+  if (stages.size() < 2) return false;
+  for (const auto& stage : stages) {
+    if (stage.argv.empty()) return false;
+    const std::string_view name = stage.argv.front();
+    if (!CommandRegistry::hasCommand(name)) return false;
+    if (needs_os_handles(name)) return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Run all stages concurrently and wait for them.
+ * @return Exit status under pipefail rules: the status of the rightmost
+ *         stage that failed, or 0 when every stage succeeded
+ */
+inline int run(std::span<const Stage> stages) {
+  const size_t count = stages.size();
+  if (count == 0) return 0;
+
+  std::vector<std::unique_ptr<PipeChannel>> channels;
+  channels.reserve(count - 1);
+  for (size_t i = 0; i + 1 < count; ++i) {
+    channels.push_back(std::make_unique<PipeChannel>());
+  }
+
+  std::vector<int> status(count, 0);
+  {
+    std::vector<std::jthread> workers;
+    workers.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+      workers.emplace_back([&, i] {
+        PipeChannel* in = i > 0 ? channels[i - 1].get() : nullptr;
+        PipeChannel* out = i + 1 < count ? channels[i].get() : nullptr;
+        bind_thread_stdio(in, out);
+
+        const auto& argv = stages[i].argv;
+        std::vector<std::string_view> args(argv.begin() + 1, argv.end());
+        // dispatch() flushes the stage's output before returning.
+        status[i] = CommandRegistry::dispatch(argv.front(), args);
+
+        bind_thread_stdio(nullptr, nullptr);
+        // Downstream sees EOF; upstream writers fail like on a closed pipe.
+        if (out) out->close_write();
+        if (in) in->close_read();
+      });
+    }
+  }
+
+  for (size_t i = count; i-- > 0;) {
+    if (status[i] != 0) return status[i];
+  }
+  return 0;
+}
+}  // namespace core::stage_pipeline
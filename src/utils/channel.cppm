@@ -0,0 +1,234 @@
+/*
+ *  Copyright © 2026 [caomengxuan666]
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ *
+ *  - File: channel.cppm
+ *  - Username: Administrator
+ *  - CopyrightYear: 2026
+ */
+module;
+#include "pch/pch.h"
+export module utils:channel;
+
+import std;
+
+/**
+ * @brief Bounded in-memory byte pipe between two threads.
+ *
+ * Used by in-process pipelines: one stage writes its standard output into
+ * the channel and the next stage reads it as standard input. Writers block
+ * while the ring is full, readers block while it is empty, and either side
+ * can close its end so the other one sees EOF or a broken pipe.
+ */
+export class PipeChannel {
+ public:
+  static constexpr size_t DEFAULT_CAPACITY = 256 * 1024;
+
+  explicit PipeChannel(size_t capacity = DEFAULT_CAPACITY)
+      : ring_(std::max<size_t>(capacity, 4096)) {}
+
+  PipeChannel(const PipeChannel&) = delete;
+  PipeChannel& operator=(const PipeChannel&) = delete;
+
+  /**
+   * @brief Append bytes, waiting for room as needed.
+   * @return false once the reading end has been closed
+   */
+  bool write(std::string_view bytes) {
+    std::unique_lock lock(mutex_);
+    while (!bytes.empty()) {
+      not_full_.wait(lock,
+                     [&] { return reader_closed_ || size_ < ring_.size(); });
+      if (reader_closed_) return false;
+
+      const size_t tail = (head_ + size_) % ring_.size();
+      const size_t n = std::min({bytes.size(), ring_.size() - size_,
+                                 ring_.size() - tail});
+      std::memcpy(ring_.data() + tail, bytes.data(), n);
+      size_ += n;
+      bytes.remove_prefix(n);
+      not_empty_.notify_one();
+    }
+    return true;
+  }
+
+  /**
+   * @brief Take whatever is buffered, waiting only while the ring is empty.
+   * @return Number of bytes copied; 0 means the writer closed its end
+   */
+  size_t read(char* dest, size_t count) {
+    std::unique_lock lock(mutex_);
+    not_empty_.wait(lock, [&] { return writer_closed_ || size_ > 0; });
+
+    size_t copied = 0;
+    while (copied < count && size_ > 0) {
+      const size_t n =
+          std::min({count - copied, size_, ring_.size() - head_});
+      std::memcpy(dest + copied, ring_.data() + head_, n);
+      head_ = (head_ + n) % ring_.size();
+      size_ -= n;
+      copied += n;
+    }
+    if (copied > 0) not_full_.notify_one();
+    return copied;
+  }
+
+  /// Writer is done: readers drain what is left and then see EOF.
+  void close_write() {
+    std::lock_guard lock(mutex_);
+    writer_closed_ = true;
+    not_empty_.notify_all();
+  }
+
+  /// Reader is gone: pending and future writes fail.
+  void close_read() {
+    std::lock_guard lock(mutex_);
+    reader_closed_ = true;
+    size_ = 0;
+    not_full_.notify_all();
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable not_full_;
+  std::condition_variable not_empty_;
+  std::vector<char> ring_;
+  size_t head_ = 0;
+  size_t size_ = 0;
+  bool writer_closed_ = false;
+  bool reader_closed_ = false;
+};
+
+namespace {
+class PipeChannelReadBuf : public std::streambuf {
+ public:
+  explicit PipeChannelReadBuf(PipeChannel& channel) : channel_(channel) {}
+
+ protected:
+  int_type underflow() override {
+    if (gptr() < egptr()) return traits_type::to_int_type(*gptr());
+    const size_t got = channel_.read(buffer_.data(), buffer_.size());
+    if (got == 0) return traits_type::eof();
+    setg(buffer_.data(), buffer_.data(), buffer_.data() + got);
+    return traits_type::to_int_type(*gptr());
+  }
+
+ private:
+  PipeChannel& channel_;
+  std::array<char, 64 * 1024> buffer_{};
+};
+
+class HandleReadBuf : public std::streambuf {
+ public:
+  explicit HandleReadBuf(HANDLE handle) : handle_(handle) {}
+
+ protected:
+  int_type underflow() override {
+    if (gptr() < egptr()) return traits_type::to_int_type(*gptr());
+    DWORD got = 0;
+    if (!ReadFile(handle_, buffer_.data(), static_cast<DWORD>(buffer_.size()),
+                  &got, nullptr) ||
+        got == 0) {
+      return traits_type::eof();
+    }
+    setg(buffer_.data(), buffer_.data(), buffer_.data() + got);
+    return traits_type::to_int_type(*gptr());
+  }
+
+ private:
+  HANDLE handle_;
+  std::array<char, 64 * 1024> buffer_{};
+};
+
+struct ThreadInput {
+  explicit ThreadInput(std::unique_ptr<std::streambuf> source)
+      : buf(std::move(source)), stream(buf.get()) {}
+
+  std::unique_ptr<std::streambuf> buf;
+  std::istream stream;
+};
+
+thread_local PipeChannel* g_stdin_channel = nullptr;
+thread_local PipeChannel* g_stdout_channel = nullptr;
+thread_local HANDLE g_stdin_handle = nullptr;
+thread_local HANDLE g_stop_event = nullptr;
+thread_local std::unique_ptr<ThreadInput> g_thread_input;
+}  // namespace
+
+/**
+ * @brief Redirect standard input/output of the calling thread.
+ *
+ * nullptr keeps the process handle for that stream. Only code that goes
+ * through safePrint/stdout_stream() and stdin_stream()/LineReader/MappedFile
+ * sees the redirection.
+ */
+export void bind_thread_stdio(PipeChannel* in, PipeChannel* out) {
+  if (in != g_stdin_channel) g_thread_input.reset();
+  g_stdin_channel = in;
+  g_stdout_channel = out;
+}
+
+/**
+ * @brief Give the calling thread its own standard input handle, e.g. one
+ * duplicated from a client process. nullptr restores the process handle.
+ */
+export void bind_thread_stdin_handle(HANDLE handle) {
+  if (handle != g_stdin_handle) g_thread_input.reset();
+  g_stdin_handle = handle;
+}
+
+/**
+ * @brief Give the calling thread an event that is signalled when whoever
+ * started the command no longer wants its result (e.g. a server client that
+ * went away). Commands that wait indefinitely add it to their wait set.
+ * nullptr removes it.
+ */
+export void bind_thread_stop_event(HANDLE event) { g_stop_event = event; }
+
+/// Stop event of the calling thread, or nullptr when it has none
+export HANDLE thread_stop_event() { return g_stop_event; }
+
+export PipeChannel* thread_stdin_channel() { return g_stdin_channel; }
+
+export PipeChannel* thread_stdout_channel() { return g_stdout_channel; }
+
+/// Standard input handle of the calling thread
+export HANDLE thread_stdin_handle() {
+  return g_stdin_handle != nullptr ? g_stdin_handle
+                                   : GetStdHandle(STD_INPUT_HANDLE);
+}
+
+/**
+ * @brief Standard input for the calling thread: the bound channel on a
+ * pipeline stage, the bound handle on a server request, std::cin otherwise.
+ */
+export std::istream& stdin_stream() {
+  if (g_stdin_channel == nullptr && g_stdin_handle == nullptr) return std::cin;
+  if (!g_thread_input) {
+    std::unique_ptr<std::streambuf> source;
+    if (g_stdin_channel != nullptr) {
+      source = std::make_unique<PipeChannelReadBuf>(*g_stdin_channel);
+    } else {
+      source = std::make_unique<HandleReadBuf>(g_stdin_handle);
+    }
+    g_thread_input = std::make_unique<ThreadInput>(std::move(source));
+  }
+  return g_thread_input->stream;
+}
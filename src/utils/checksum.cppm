@@ -0,0 +1,306 @@
+/// @Author: caomengxuan666
+/// @Description: Shared driver for the md5sum/sha*sum/b2sum commands
+/// @Version: 0.1.0
+/// @License: MIT
+/// @Copyright: Copyright © 2026 WinuxCmd
+export module utils:checksum;
+
+import std;
+import :utf8;
+import :console;
+import :file_io;
+import :hash;
+import :wildcard;
+
+/**
+ * @brief What one *sum command computes and how it was invoked.
+ */
+export struct ChecksumOptions {
+  std::wstring_view command;  ///< For messages, e.g. L"md5sum"
+  std::string_view tag;       ///< Name in BSD-style lines, e.g. "MD5"
+  HashAlgorithm algorithm = HashAlgorithm::Md5;
+  size_t digest_size = 0;     ///< Bytes; 0 means the algorithm's full length
+  bool check = false;         ///< FILEs are lists of sums to verify
+  bool quiet = false;         ///< Check mode: don't print OK lines
+  bool status = false;        ///< Check mode: print nothing at all
+  bool warn = false;          ///< Check mode: report malformed lines
+};
+
+namespace checksum_detail {
+
+struct Entry {
+  std::string digest;  // Lowercase hex
+  std::string name;
+};
+
+inline void report(const ChecksumOptions& opts, std::string_view message) {
+  safeErrorPrint(std::wstring(opts.command) + L": " +
+                 utf8_to_wstring(message) + L"\n");
+}
+
+inline auto is_hex(std::string_view s) -> bool {
+  return !s.empty() && std::ranges::all_of(s, [](char c) {
+    return std::isxdigit(static_cast<unsigned char>(c)) != 0;
+  });
+}
+
+inline auto lowercase(std::string_view s) -> std::string {
+  std::string out(s);
+  for (char& c : out) {
+    c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+  }
+  return out;
+}
+
+// BLAKE2b lists may mix lengths; everything else has exactly one
+inline auto valid_length(const ChecksumOptions& opts, size_t hex_digits)
+    -> bool {
+  if (hex_digits % 2 != 0) return false;
+  if (opts.algorithm == HashAlgorithm::Blake2b && opts.digest_size == 0) {
+    return hex_digits >= 2 && hex_digits <= 2 * digest_size(opts.algorithm);
+  }
+  const size_t bytes = opts.digest_size != 0 ? opts.digest_size
+                                             : digest_size(opts.algorithm);
+  return hex_digits == 2 * bytes;
+}
+
+// "TAG (NAME) = DIGEST", as written by --tag and by BSD md5/sha*
+inline auto parse_tagged(const ChecksumOptions& opts, std::string_view line)
+    -> std::optional<Entry> {
+  if (!line.starts_with(opts.tag)) return std::nullopt;
+  std::string_view rest = line.substr(opts.tag.size());
+
+  size_t tag_bits = 0;
+  if (opts.algorithm == HashAlgorithm::Blake2b && rest.starts_with('-')) {
+    rest.remove_prefix(1);
+    const auto [end, ec] =
+        std::from_chars(rest.data(), rest.data() + rest.size(), tag_bits);
+    if (ec != std::errc{} || tag_bits == 0) return std::nullopt;
+    rest.remove_prefix(static_cast<size_t>(end - rest.data()));
+  }
+  if (!rest.starts_with(" (")) return std::nullopt;
+  rest.remove_prefix(2);
+
+  const size_t close = rest.rfind(") = ");
+  if (close == std::string_view::npos) return std::nullopt;
+  const std::string_view digest = rest.substr(close + 4);
+  if (!is_hex(digest) || !valid_length(opts, digest.size())) {
+    return std::nullopt;
+  }
+  if (tag_bits != 0 && tag_bits != digest.size() * 4) return std::nullopt;
+  return Entry{lowercase(digest), std::string(rest.substr(0, close))};
+}
+
+// "DIGEST  NAME" or "DIGEST *NAME", as the commands print by default
+inline auto parse_line(const ChecksumOptions& opts, std::string_view line)
+    -> std::optional<Entry> {
+  if (auto tagged = parse_tagged(opts, line)) return tagged;
+
+  const size_t space = line.find(' ');
+  if (space == std::string_view::npos || space + 2 > line.size()) {
+    return std::nullopt;
+  }
+  const std::string_view digest = line.substr(0, space);
+  const char mode = line[space + 1];
+  const std::string_view name = line.substr(space + 2);
+  if ((mode != ' ' && mode != '*') || name.empty()) return std::nullopt;
+  if (!is_hex(digest) || !valid_length(opts, digest.size())) {
+    return std::nullopt;
+  }
+  return Entry{lowercase(digest), std::string(name)};
+}
+
+inline auto plural(size_t n, std::string_view one, std::string_view many)
+    -> std::string {
+  return std::to_string(n) + " " + std::string(n == 1 ? one : many);
+}
+
+struct CheckTotals {
+  size_t malformed = 0;
+  size_t unreadable = 0;
+  size_t mismatched = 0;
+};
+
+/**
+ * Verifies every entry of one list. Consecutive entries with the same
+ * digest length are hashed together, so the multi-buffer kernels see the
+ * whole run at once.
+ */
+inline void check_entries(const ChecksumOptions& opts,
+                          const std::vector<Entry>& entries,
+                          CheckTotals& totals) {
+  size_t first = 0;
+  while (first < entries.size()) {
+    const size_t size = entries[first].digest.size() / 2;
+    size_t end = first + 1;
+    while (end < entries.size() && entries[end].digest.size() / 2 == size) {
+      ++end;
+    }
+
+    std::vector<std::string> names;
+    names.reserve(end - first);
+    for (size_t i = first; i < end; ++i) names.push_back(entries[i].name);
+
+    hash_files(opts.algorithm, size, std::span<const std::string>(names),
+               [&](size_t i, HashResult result) {
+                 const Entry& entry = entries[first + i];
+                 std::string_view verdict;
+                 if (!result) {
+                   report(opts, result.error());
+                   ++totals.unreadable;
+                   verdict = "FAILED open or read";
+                 } else if (result->hex() != entry.digest) {
+                   ++totals.mismatched;
+                   verdict = "FAILED";
+                 } else {
+                   if (opts.quiet) return;
+                   verdict = "OK";
+                 }
+                 if (opts.status) return;
+                 safePrint(entry.name + ": " + std::string(verdict) + "\n");
+               });
+    first = end;
+  }
+}
+
+inline auto check_list(const ChecksumOptions& opts, const std::string& list)
+    -> bool {
+  const std::string display = list == "-" ? "standard input" : list;
+  auto file = list == "-" ? MappedFile::from_stdin(AccessHint::Sequential)
+                          : MappedFile::open(list, AccessHint::Sequential);
+  if (!file) {
+    report(opts, file.error());
+    return false;
+  }
+
+  std::vector<Entry> entries;
+  CheckTotals totals;
+  std::string_view text = file->view();
+  size_t line_number = 0;
+  while (!text.empty()) {
+    const size_t eol = text.find('\n');
+    std::string_view line = text.substr(0, eol);
+    text.remove_prefix(eol == std::string_view::npos ? text.size() : eol + 1);
+    ++line_number;
+    if (line.ends_with('\r')) line.remove_suffix(1);
+    if (line.empty() || line.front() == '#') continue;
+
+    if (auto entry = parse_line(opts, line)) {
+      entries.push_back(std::move(*entry));
+      continue;
+    }
+    ++totals.malformed;
+    if (opts.warn) {
+      report(opts, display + ": " + std::to_string(line_number) +
+                       ": improperly formatted " + std::string(opts.tag) +
+                       " checksum line");
+    }
+  }
+
+  if (entries.empty()) {
+    report(opts, display + ": no properly formatted " + std::string(opts.tag) +
+                     " checksum lines found");
+    return false;
+  }
+
+  check_entries(opts, entries, totals);
+
+  if (!opts.status) {
+    if (totals.malformed != 0) {
+      report(opts, "WARNING: " + plural(totals.malformed,
+                                        "line is improperly formatted",
+                                        "lines are improperly formatted"));
+    }
+    if (totals.unreadable != 0) {
+      report(opts, "WARNING: " + plural(totals.unreadable,
+                                        "listed file could not be read",
+                                        "listed files could not be read"));
+    }
+    if (totals.mismatched != 0) {
+      report(opts, "WARNING: " + plural(totals.mismatched,
+                                        "computed checksum did NOT match",
+                                        "computed checksums did NOT match"));
+    }
+  }
+  return totals.unreadable == 0 && totals.mismatched == 0;
+}
+
+}  // namespace checksum_detail
+
+/**
+ * @brief Body of md5sum, sha1sum, sha2 *sum and b2sum.
+ *
+ * Without --check, prints "DIGEST  NAME" for every file ("-" is standard
+ * input). With it, every file is a list in that format (or the BSD
+ * "TAG (NAME) = DIGEST" one) and each listed file is verified, with GNU's
+ * messages and summary warnings.
+ *
+ * @param files Operands after wildcard expansion; never empty
+ * @return The command's exit status
+ */
+export auto run_checksum(const ChecksumOptions& opts,
+                         std::span<const std::string> files) -> int {
+  bool ok = true;
+  if (opts.check) {
+    for (const auto& list : files) {
+      ok = checksum_detail::check_list(opts, list) && ok;
+    }
+    return ok ? 0 : 1;
+  }
+
+  hash_files(opts.algorithm, opts.digest_size, files,
+             [&](size_t i, HashResult result) {
+               if (!result) {
+                 checksum_detail::report(opts, result.error());
+                 ok = false;
+                 return;
+               }
+               safePrint(result->hex() + "  " + files[i] + "\n");
+             });
+  return ok ? 0 : 1;
+}
+
+/**
+ * @brief Entry point shared by the *sum commands.
+ *
+ * Reads the --check, --quiet, --status and --warn flags every *sum command
+ * declares, expands wildcards in the operands (none means "-") and runs
+ * run_checksum(). -b and -t are accepted for compatibility; input is always
+ * read as bytes.
+ *
+ * @param ctx The command's parsed context
+ * @param digest_size Bytes; 0 means the algorithm's full length
+ * @return The command's exit status
+ */
+export template <typename Context>
+auto checksum_main(const Context& ctx, std::wstring_view command,
+                   std::string_view tag, HashAlgorithm algorithm,
+                   size_t digest_size = 0) -> int {
+  ChecksumOptions opts;
+  opts.command = command;
+  opts.tag = tag;
+  opts.algorithm = algorithm;
+  opts.digest_size = digest_size;
+  opts.check = ctx.template get<"--check">(false);
+  opts.quiet = ctx.template get<"--quiet">(false);
+  opts.status = ctx.template get<"--status">(false);
+  opts.warn = ctx.template get<"--warn">(false);
+
+  std::vector<std::string> files;
+  for (auto arg : ctx.positionals) {
+    std::string file_arg(arg);
+    if (contains_wildcard(file_arg)) {
+      auto glob_result = glob_expand(file_arg);
+      if (glob_result.expanded) {
+        for (const auto& file : glob_result.files) {
+          files.push_back(wstring_to_utf8(file));
+        }
+        continue;
+      }
+    }
+    files.push_back(std::move(file_arg));
+  }
+  if (files.empty()) files.push_back("-");
+
+  return run_checksum(opts, std::span<const std::string>(files));
+}
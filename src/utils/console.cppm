@@ -17,6 +17,7 @@ export module utils:console;
 
 import std;
 import :utf8;
+import :channel;
 
 /// @brief ANSI escape sequences for terminal text coloring.
 /// These follow the default GNU `ls --color=auto` scheme and are compatible
@@ -47,6 +48,9 @@ thread_local bool g_stderr_pipe_closed = false;
 thread_local bool g_stdout_is_console = false;
 thread_local bool g_stderr_is_console = false;
 thread_local bool g_console_checked = false;
+// Handles bound to this thread (e.g. a --serve request), see
+// bind_thread_std_handles()
+thread_local bool g_handles_bound = false;
 
 // Capture handles (set by daemon when capturing)
 HANDLE g_capture_stdout_write = nullptr;
@@ -58,7 +62,7 @@ HANDLE getStdOut() {
     return g_capture_stdout_write;
   }
 
-  if (!g_handles_valid) {
+  if (!g_handles_valid && !g_handles_bound) {
     g_cached_stdout = GetStdHandle(STD_OUTPUT_HANDLE);
     g_cached_stderr = GetStdHandle(STD_ERROR_HANDLE);
     g_handles_valid = true;
@@ -71,7 +75,7 @@ HANDLE getStdErr() {
     return g_capture_stderr_write;
   }
 
-  if (!g_handles_valid) {
+  if (!g_handles_valid && !g_handles_bound) {
     g_cached_stdout = GetStdHandle(STD_OUTPUT_HANDLE);
     g_cached_stderr = GetStdHandle(STD_ERROR_HANDLE);
     g_handles_valid = true;
@@ -82,10 +86,15 @@ HANDLE getStdErr() {
 bool isBrokenPipeError(DWORD err) {
   return err == ERROR_BROKEN_PIPE || err == ERROR_NO_DATA;
 }
+
+// Defined with the buffered stdout sink below.
+void flushStdoutSink(bool final = false);
 }  // namespace
 
 // Exported function to set output capture handles
 export void set_output_capture_handles(HANDLE stdout_handle, HANDLE stderr_handle, bool active) {
+  // Pending output belongs to the previous handle.
+  flushStdoutSink();
   g_capture_stdout_write = stdout_handle;
   g_capture_stderr_write = stderr_handle;
   g_capture_active = active;
@@ -95,10 +104,30 @@ export void set_output_capture_handles(HANDLE stdout_handle, HANDLE stderr_handl
 
 // Exported function to invalidate cached handles (call after SetStdHandle)
 export void invalidateCachedHandles() {
+  flushStdoutSink();
   g_handles_valid = false;
   g_console_checked = false;
 }
 
+/**
+ * @brief Use the given handles as this thread's standard streams.
+ *
+ * Lets one process serve several callers at once: output written through
+ * safePrint/safeErrorPrint and input read through stdin_stream() go to the
+ * bound handles. Pass nullptr for all three to restore the process handles.
+ */
+export void bind_thread_std_handles(HANDLE in, HANDLE out, HANDLE err) {
+  flushStdoutSink();
+  g_handles_bound = out != nullptr || err != nullptr;
+  g_cached_stdout = out;
+  g_cached_stderr = err;
+  g_handles_valid = g_handles_bound;
+  g_console_checked = false;
+  g_stdout_pipe_closed = false;
+  g_stderr_pipe_closed = false;
+  bind_thread_stdin_handle(in);
+}
+
 export bool is_stdout_pipe_closed() { return g_stdout_pipe_closed; }
 
 export bool is_stderr_pipe_closed() { return g_stderr_pipe_closed; }
@@ -116,6 +145,7 @@ bool isConsoleHandle(HANDLE h) {
 
 // Cached console check - only calls GetConsoleMode once per thread
 bool isStdoutConsole() {
+  if (thread_stdout_channel() != nullptr) return false;
   if (!g_console_checked) {
     g_stdout_is_console = isConsoleHandle(getStdOut());
     g_stderr_is_console = isConsoleHandle(getStdErr());
@@ -135,7 +165,8 @@ bool isStderrConsole() {
 
 
 export bool writeConsole(const std::wstring_view& wstr) {
-  HANDLE hOut = GetStdHandle(STD_OUTPUT_HANDLE);
+  flushStdoutSink();
+  HANDLE hOut = getStdOut();
   if (hOut == INVALID_HANDLE_VALUE) return false;
 
   DWORD written;
@@ -144,7 +175,7 @@ export bool writeConsole(const std::wstring_view& wstr) {
 }
 
 export bool writeErrorConsole(const std::wstring_view& wstr) {
-  HANDLE hErr = GetStdHandle(STD_ERROR_HANDLE);
+  HANDLE hErr = getStdErr();
   if (hErr == INVALID_HANDLE_VALUE) return false;
 
   DWORD written;
@@ -152,7 +183,10 @@ export bool writeErrorConsole(const std::wstring_view& wstr) {
                        &written, nullptr) != 0;
 }
 
-export bool isOutputConsole() { return isConsoleHandle(getStdOut()); }
+export bool isOutputConsole() {
+  if (thread_stdout_channel() != nullptr) return false;
+  return isConsoleHandle(getStdOut());
+}
 
 export bool isErrorConsole() { return isConsoleHandle(getStdErr()); }
 
@@ -167,7 +201,7 @@ export bool isTerminalSupportsColor() {
   }
 
   DWORD consoleMode;
-  HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
+  HANDLE hConsole = getStdOut();
   if (hConsole == INVALID_HANDLE_VALUE) {
     return false;
   }
@@ -189,7 +223,7 @@ export int getTerminalWidth() {
   }  // Default width for pipe/file
 
   CONSOLE_SCREEN_BUFFER_INFO csbi;
-  HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
+  HANDLE hConsole = getStdOut();
   if (hConsole == INVALID_HANDLE_VALUE) {
     return 80;
   }
@@ -249,8 +283,16 @@ bool writeConsoleW(HANDLE h, const wchar_t* data, size_t len) {
 
 bool writeFile(HANDLE h, const char* data, size_t len) {
   if (!data || len == 0) return true;
-  DWORD written;
-  return WriteFile(h, data, static_cast<DWORD>(len), &written, nullptr) != 0;
+  // WriteFile takes a DWORD length and may report a short write on pipes.
+  while (len > 0) {
+    DWORD chunk = static_cast<DWORD>(std::min<size_t>(len, 1u << 30));
+    DWORD written = 0;
+    if (!WriteFile(h, data, chunk, &written, nullptr)) return false;
+    if (written == 0) return false;
+    data += written;
+    len -= written;
+  }
+  return true;
 }
 }  // namespace detail
 
@@ -301,6 +343,225 @@ class wchar_buffer {
 };
 }  // namespace detail
 
+// ============================================================================
+// Buffered stdout sink
+//
+// safePrint() appends UTF-8 into a per-thread block buffer instead of issuing
+// one WriteFile/WriteConsoleW per fragment. Pipes and files are fully
+// buffered, consoles are line buffered. The buffer is flushed when it fills,
+// on newline in line mode, before anything is written to stderr, and at
+// dispatch exit (CommandRegistry::dispatch calls finishOutput()).
+//
+// The sink is per thread because stdout is: an in-process pipeline stage
+// writes into its channel and a warm-server request into its client's
+// handle, and a shared buffer would interleave their output and flush it to
+// the wrong place.
+// ============================================================================
+export enum class OutputBufferMode {
+  Auto,        ///< Line buffered on a console, fully buffered otherwise
+  Unbuffered,  ///< Write through on every call
+  Line,        ///< Flush whenever a newline is written
+  Full         ///< Flush only when the buffer is full
+};
+
+export constexpr size_t DEFAULT_OUTPUT_BUFFER_SIZE = 64 * 1024;
+
+namespace {
+struct OutputSink {
+  std::string buffer;
+  size_t capacity = DEFAULT_OUTPUT_BUFFER_SIZE;
+  OutputBufferMode mode = OutputBufferMode::Auto;
+  bool env_checked = false;
+
+  ~OutputSink() { flushStdoutSink(/*final=*/true); }
+};
+
+thread_local OutputSink g_stdout_sink;
+
+// Honour the _STDBUF_O convention used by GNU stdbuf ("0", "L" or a size
+// with an optional K/M/G suffix) so `stdbuf -oL` works for our binaries too.
+void applyStdbufEnvironment(OutputSink& sink) {
+  sink.env_checked = true;
+  char value[64];
+  DWORD len = GetEnvironmentVariableA("_STDBUF_O", value, sizeof(value));
+  if (len == 0 || len >= sizeof(value)) return;
+
+  std::string_view v(value, len);
+  if (v == "0") {
+    sink.mode = OutputBufferMode::Unbuffered;
+    return;
+  }
+  if (v == "L") {
+    sink.mode = OutputBufferMode::Line;
+    return;
+  }
+
+  size_t multiplier = 1;
+  switch (v.back()) {
+    case 'K': case 'k': multiplier = 1024; v.remove_suffix(1); break;
+    case 'M': case 'm': multiplier = 1024 * 1024; v.remove_suffix(1); break;
+    case 'G': case 'g': multiplier = 1024 * 1024 * 1024; v.remove_suffix(1); break;
+    default: break;
+  }
+  size_t size = 0;
+  auto [ptr, ec] = std::from_chars(v.data(), v.data() + v.size(), size);
+  if (ec != std::errc() || ptr != v.data() + v.size() || size == 0) return;
+  sink.mode = OutputBufferMode::Full;
+  sink.capacity = size * multiplier;
+}
+
+OutputBufferMode effectiveMode(OutputSink& sink) {
+  if (!sink.env_checked) applyStdbufEnvironment(sink);
+  if (sink.mode != OutputBufferMode::Auto) return sink.mode;
+  return isStdoutConsole() ? OutputBufferMode::Line : OutputBufferMode::Full;
+}
+
+// Length of the longest prefix that does not end in a partial UTF-8 sequence.
+size_t completeUtf8Prefix(std::string_view s) {
+  size_t i = s.size();
+  size_t back = 0;
+  while (i > 0 && back < 4) {
+    auto c = static_cast<unsigned char>(s[i - 1]);
+    if ((c & 0xC0) != 0x80) {
+      size_t need = c < 0x80 ? 1 : (c >> 5) == 0x06 ? 2 : (c >> 4) == 0x0E ? 3
+                                 : (c >> 3) == 0x1E ? 4 : 1;
+      return (back + 1 >= need) ? s.size() : i - 1;
+    }
+    --i;
+    ++back;
+  }
+  return s.size();
+}
+
+bool writeStdoutBytes(std::string_view bytes) {
+  // In-process pipeline stage: the next stage reading this thread's output
+  // is gone once the channel rejects the write.
+  if (auto* channel = thread_stdout_channel()) {
+    if (channel->write(bytes)) return true;
+    SetLastError(ERROR_BROKEN_PIPE);
+    return false;
+  }
+  HANDLE h = getStdOut();
+  if (isStdoutConsole()) {
+    detail::wchar_buffer<1024> buf(bytes);
+    if (!buf.valid()) return true;
+    return detail::writeConsoleW(h, buf.data(), buf.size());
+  }
+  return detail::writeFile(h, bytes.data(), bytes.size());
+}
+
+// FINAL also writes a trailing partial UTF-8 sequence, which no later
+// write can complete once the thread's output is over.
+void flushStdoutSink(bool final) {
+  auto& sink = g_stdout_sink;
+  if (sink.buffer.empty()) return;
+  if (g_stdout_pipe_closed) {
+    sink.buffer.clear();
+    return;
+  }
+
+  // A console write must not split a multi-byte sequence; keep the tail.
+  size_t n = isStdoutConsole() && !final ? completeUtf8Prefix(sink.buffer)
+                                         : sink.buffer.size();
+  if (!writeStdoutBytes(std::string_view(sink.buffer.data(), n)) &&
+      isBrokenPipeError(GetLastError())) {
+    g_stdout_pipe_closed = true;
+    sink.buffer.clear();
+    return;
+  }
+  sink.buffer.erase(0, n);
+}
+
+void sinkWrite(std::string_view bytes) {
+  if (bytes.empty() || g_stdout_pipe_closed) return;
+
+  auto& sink = g_stdout_sink;
+  const OutputBufferMode mode = effectiveMode(sink);
+
+  if (sink.buffer.size() + bytes.size() > sink.capacity) {
+    flushStdoutSink();
+    // Large blocks skip the copy when going to a pipe or file.
+    if (bytes.size() >= sink.capacity && !isStdoutConsole()) {
+      if (!writeStdoutBytes(bytes) && isBrokenPipeError(GetLastError())) {
+        g_stdout_pipe_closed = true;
+      }
+      return;
+    }
+  }
+
+  if (sink.buffer.capacity() == 0) {
+    sink.buffer.reserve(std::min(sink.capacity, DEFAULT_OUTPUT_BUFFER_SIZE));
+  }
+  sink.buffer.append(bytes);
+
+  if (mode == OutputBufferMode::Unbuffered ||
+      (mode == OutputBufferMode::Line &&
+       bytes.find('\n') != std::string_view::npos)) {
+    flushStdoutSink();
+  }
+}
+}  // namespace
+
+/**
+ * @brief Write any buffered standard output to the underlying handle
+ */
+export void flushOutput() { flushStdoutSink(); }
+
+/**
+ * @brief Write all buffered standard output at the end of a command,
+ * including a trailing partial UTF-8 sequence that flushOutput() holds back
+ * for consoles
+ */
+export void finishOutput() { flushStdoutSink(/*final=*/true); }
+
+/**
+ * @brief Configure buffering of standard output for the current thread
+ * @param mode Buffering mode (Auto picks line/full from the handle type)
+ * @param size Block size in bytes, 0 keeps the current size
+ */
+export void setOutputBuffering(OutputBufferMode mode, size_t size = 0) {
+  flushStdoutSink();
+  auto& sink = g_stdout_sink;
+  sink.env_checked = true;
+  sink.mode = mode;
+  if (size > 0) sink.capacity = size;
+}
+
+namespace {
+class SinkWriteBuf : public std::streambuf {
+ protected:
+  int_type overflow(int_type ch) override {
+    if (traits_type::eq_int_type(ch, traits_type::eof())) return 0;
+    const char c = traits_type::to_char_type(ch);
+    sinkWrite(std::string_view(&c, 1));
+    return ch;
+  }
+
+  std::streamsize xsputn(const char* s, std::streamsize n) override {
+    sinkWrite(std::string_view(s, static_cast<size_t>(n)));
+    return n;
+  }
+
+  int sync() override {
+    flushStdoutSink();
+    return 0;
+  }
+};
+}  // namespace
+
+/**
+ * @brief std::ostream over the buffered stdout sink of the calling thread
+ *
+ * For code written against iostreams (e.g. an output that may also be a
+ * std::ofstream). Unlike std::cout it shares the sink with safePrint, so
+ * output stays ordered and follows in-process pipeline redirection.
+ */
+export std::ostream& stdout_stream() {
+  thread_local SinkWriteBuf buf;
+  thread_local std::ostream stream(&buf);
+  return stream;
+}
+
 // ============================================================================
 // Core output functions - ALL PATHS use WriteFile/WriteConsoleW, NO fprintf
 // ============================================================================
@@ -309,22 +570,12 @@ class wchar_buffer {
 // Wide string overloads (zero conversion)
 // ----------------------------------------------------------------------------
 export void safePrint(std::wstring_view wsv) {
-  HANDLE h = getStdOut();
-  if (isStdoutConsole()) {
-    if (!detail::writeConsoleW(h, wsv.data(), wsv.size()) &&
-        isBrokenPipeError(GetLastError())) {
-      g_stdout_pipe_closed = true;
-    }
-  } else {
-    std::string utf8 = wstring_to_utf8(wsv);
-    if (!detail::writeFile(h, utf8.data(), utf8.size()) &&
-        isBrokenPipeError(GetLastError())) {
-      g_stdout_pipe_closed = true;
-    }
-  }
+  if (wsv.empty()) return;
+  sinkWrite(wstring_to_utf8(wsv));
 }
 
 export void safeErrorPrint(std::wstring_view wsv) {
+  flushStdoutSink();
   HANDLE h = getStdErr();
   if (isStderrConsole()) {
     if (!detail::writeConsoleW(h, wsv.data(), wsv.size()) &&
@@ -353,25 +604,10 @@ export void safeErrorPrintLn(std::wstring_view wsv) {
 // ----------------------------------------------------------------------------
 // UTF-8 string overloads (stack conversion)
 // ----------------------------------------------------------------------------
-export void safePrint(std::string_view sv) {
-  HANDLE h = getStdOut();
-  if (isStdoutConsole()) {
-    detail::wchar_buffer buf(sv);
-    if (buf.valid()) {
-      if (!detail::writeConsoleW(h, buf.data(), buf.size()) &&
-          isBrokenPipeError(GetLastError())) {
-        g_stdout_pipe_closed = true;
-      }
-    }
-  } else {
-    if (!detail::writeFile(h, sv.data(), sv.size()) &&
-        isBrokenPipeError(GetLastError())) {
-      g_stdout_pipe_closed = true;
-    }
-  }
-}
+export void safePrint(std::string_view sv) { sinkWrite(sv); }
 
 export void safeErrorPrint(std::string_view sv) {
+  flushStdoutSink();
   HANDLE h = getStdErr();
   if (isStderrConsole()) {
     detail::wchar_buffer buf(sv);
@@ -449,16 +685,19 @@ export void safeErrorPrintLn(const wchar_t* wstr) {
 // Character overloads (single char)
 // ----------------------------------------------------------------------------
 export void safePrint(char c) {
-  HANDLE h = getStdOut();
-  if (isStdoutConsole()) {
-    wchar_t wc = static_cast<wchar_t>(c);
-    detail::writeConsoleW(h, &wc, 1);
-  } else {
-    detail::writeFile(h, &c, 1);
+  auto uc = static_cast<unsigned char>(c);
+  if (uc >= 0x80 && isStdoutConsole()) {
+    // Consoles show a lone high byte as the Latin-1 character.
+    const char latin1[2] = {static_cast<char>(0xC0 | (uc >> 6)),
+                            static_cast<char>(0x80 | (uc & 0x3F))};
+    sinkWrite(std::string_view(latin1, 2));
+    return;
   }
+  sinkWrite(std::string_view(&c, 1));
 }
 
 export void safeErrorPrint(char c) {
+  flushStdoutSink();
   HANDLE h = getStdErr();
   if (isStderrConsole()) {
     wchar_t wc = static_cast<wchar_t>(c);
@@ -0,0 +1,124 @@
+/// @Author: caomengxuan666
+/// @Description: Run-time detection of optional x86 instruction sets
+/// @Version: 0.1.0
+/// @License: MIT
+/// @Copyright: Copyright © 2026 WinuxCmd
+module;
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || \
+    defined(__i386__)
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#define WINUX_CPUID 1
+#endif
+export module utils:cpu_features;
+
+import std;
+
+/**
+ * @brief Instruction set extensions that kernels may use when present.
+ *
+ * Only what some kernel in the tree dispatches on is listed. AVX2 also
+ * requires the OS to save the YMM registers, which is checked too.
+ */
+export struct CpuFeatures {
+  bool sse2 = false;
+  bool ssse3 = false;
+  bool sse41 = false;
+  bool pclmul = false;
+  bool avx2 = false;
+  bool sha = false;  ///< SHA-1 and SHA-256 instructions (SHA-NI)
+};
+
+namespace cpu_features_detail {
+
+#ifdef WINUX_CPUID
+inline void cpuid(unsigned leaf, unsigned subleaf, unsigned (&regs)[4]) {
+#ifdef _MSC_VER
+  int info[4] = {};
+  __cpuidex(info, static_cast<int>(leaf), static_cast<int>(subleaf));
+  for (int i = 0; i < 4; ++i) regs[i] = static_cast<unsigned>(info[i]);
+#else
+  __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+// XCR0: which register states the OS saves on a context switch
+inline auto xcr0() -> std::uint64_t {
+#ifdef _MSC_VER
+  return _xgetbv(0);
+#else
+  unsigned lo = 0;
+  unsigned hi = 0;
+  __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+  return (std::uint64_t{hi} << 32) | lo;
+#endif
+}
+#endif
+
+inline auto detect() -> CpuFeatures {
+  CpuFeatures f;
+#ifdef WINUX_CPUID
+  unsigned regs[4] = {};
+  cpuid(0, 0, regs);
+  const unsigned max_leaf = regs[0];
+  if (max_leaf < 1) return f;
+
+  cpuid(1, 0, regs);
+  const unsigned ecx = regs[2];
+  const unsigned edx = regs[3];
+  f.sse2 = (edx & (1u << 26)) != 0;
+  f.ssse3 = (ecx & (1u << 9)) != 0;
+  f.sse41 = (ecx & (1u << 19)) != 0;
+  f.pclmul = (ecx & (1u << 1)) != 0;
+  const bool osxsave = (ecx & (1u << 27)) != 0;
+  const bool avx = (ecx & (1u << 28)) != 0;
+  const bool ymm_saved = osxsave && (xcr0() & 0x6) == 0x6;
+
+  if (max_leaf >= 7) {
+    cpuid(7, 0, regs);
+    const unsigned ebx = regs[1];
+    f.avx2 = avx && ymm_saved && (ebx & (1u << 5)) != 0;
+    f.sha = (ebx & (1u << 29)) != 0;
+  }
+#endif
+  return f;
+}
+
+// WINUXCMD_CPU_DISABLE=avx2,sha hides the listed features, so the slower
+// kernels can be tested and timed on a CPU that has the faster ones
+inline void apply_disabled(CpuFeatures& f) {
+  const char* list = std::getenv("WINUXCMD_CPU_DISABLE");
+  if (list == nullptr) return;
+  std::string_view rest(list);
+  while (!rest.empty()) {
+    const size_t comma = rest.find(',');
+    const std::string_view name = rest.substr(0, comma);
+    if (name == "sse2") f.sse2 = false;
+    if (name == "ssse3") f.ssse3 = false;
+    if (name == "sse41") f.sse41 = false;
+    if (name == "pclmul") f.pclmul = false;
+    if (name == "avx2") f.avx2 = false;
+    if (name == "sha") f.sha = false;
+    rest = comma == std::string_view::npos ? std::string_view{}
+                                           : rest.substr(comma + 1);
+  }
+}
+
+}  // namespace cpu_features_detail
+
+/**
+ * @brief Features of the CPU this process runs on, detected once, less any
+ *        that WINUXCMD_CPU_DISABLE names.
+ */
+export auto cpu_features() -> const CpuFeatures& {
+  static const CpuFeatures features = [] {
+    CpuFeatures f = cpu_features_detail::detect();
+    cpu_features_detail::apply_disabled(f);
+    return f;
+  }();
+  return features;
+}
@@ -0,0 +1,354 @@
+/// @Author: caomengxuan666
+/// @Description: CRC-32 checksums (slicing-by-16 and PCLMULQDQ folding)
+/// @Version: 0.1.0
+/// @License: MIT
+/// @Copyright: Copyright © 2026 WinuxCmd
+module;
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || \
+    defined(__i386__)
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#include <wmmintrin.h>
+#define WINUX_CRC_CLMUL 1
+#endif
+// GCC and Clang only emit PCLMULQDQ/SSSE3 inside functions that ask for them
+#if defined(__GNUC__) || defined(__clang__)
+#define WINUX_CRC_TARGET __attribute__((target("sse2,ssse3,pclmul")))
+#else
+#define WINUX_CRC_TARGET
+#endif
+export module utils:crc;
+
+import std;
+import :cpu_features;
+
+/**
+ * @brief The CRC-32 flavours in common use.
+ */
+export enum class CrcModel {
+  Cksum,   ///< POSIX cksum: CRC-32/CKSUM of the data followed by its length
+  Crc32,   ///< CRC-32 of zlib, gzip, PNG and Ethernet (ISO-HDLC)
+  Crc32c,  ///< CRC-32C (Castagnoli), as in iSCSI, ext4 and SSE4.2
+};
+
+namespace crc_detail {
+
+using Table = std::array<std::array<std::uint32_t, 256>, 16>;
+
+constexpr auto reflect32(std::uint32_t v) -> std::uint32_t {
+  std::uint32_t r = 0;
+  for (int i = 0; i < 32; ++i, v >>= 1) r = (r << 1) | (v & 1);
+  return r;
+}
+
+/**
+ * Slicing-by-16 tables: T[0][b] is the CRC of byte B from a zero register,
+ * T[s][b] that of B followed by S zero bytes. POLY is written MSB-first;
+ * REFLECTED tables feed bytes least significant bit first, as zlib does.
+ */
+constexpr auto make_table(std::uint32_t poly, bool reflected) -> Table {
+  Table t{};
+  const std::uint32_t rpoly = reflect32(poly);
+  // A CRC is linear, so single-bit bytes are enough to XOR the rest together
+  for (std::uint32_t bit = 1; bit < 256; bit <<= 1) {
+    std::uint32_t c = reflected ? bit : bit << 24;
+    for (int k = 0; k < 8; ++k) {
+      if (reflected) {
+        c = (c & 1) ? (c >> 1) ^ rpoly : c >> 1;
+      } else {
+        c = (c & 0x80000000u) ? (c << 1) ^ poly : c << 1;
+      }
+    }
+    t[0][bit] = c;
+  }
+  for (std::uint32_t b = 1; b < 256; ++b) {
+    t[0][b] = t[0][b & (b - 1)] ^ t[0][b & (0u - b)];
+  }
+  for (size_t s = 1; s < 16; ++s) {
+    for (size_t b = 0; b < 256; ++b) {
+      const std::uint32_t prev = t[s - 1][b];
+      t[s][b] = reflected ? (prev >> 8) ^ t[0][prev & 0xFF]
+                          : (prev << 8) ^ t[0][prev >> 24];
+    }
+  }
+  return t;
+}
+
+// x^N mod POLY, MSB-first
+constexpr auto xpow_mod(unsigned n, std::uint32_t poly) -> std::uint32_t {
+  std::uint32_t r = 1;
+  for (unsigned i = 0; i < n; ++i) {
+    r = (r & 0x80000000u) ? (r << 1) ^ poly : r << 1;
+  }
+  return r;
+}
+
+/**
+ * Multipliers that carry a 128-bit lane D bits further down the message:
+ * the lane's low and high quadwords are multiplied by LO and HI. Reflected
+ * lanes hold their highest-degree bits in the low quadword, and a carry-less
+ * product of two reflected values comes out one bit short, hence the
+ * different exponents and the shift.
+ */
+struct FoldKeys {
+  std::uint64_t lo;
+  std::uint64_t hi;
+};
+
+constexpr auto fold_keys(unsigned distance, std::uint32_t poly, bool reflected)
+    -> FoldKeys {
+  if (reflected) {
+    return {std::uint64_t{reflect32(xpow_mod(distance + 32, poly))} << 1,
+            std::uint64_t{reflect32(xpow_mod(distance - 32, poly))} << 1};
+  }
+  return {xpow_mod(distance, poly), xpow_mod(distance + 64, poly)};
+}
+
+struct Engine {
+  bool reflected;
+  std::uint32_t init;
+  std::uint32_t xorout;
+  const Table* table;
+  FoldKeys fold4;  // Four lanes, 512 bits apart
+  FoldKeys fold1;  // One lane onto the next 128 bits
+};
+
+inline constexpr Table kCksumTable = make_table(0x04C11DB7u, false);
+inline constexpr Table kCrc32Table = make_table(0x04C11DB7u, true);
+inline constexpr Table kCrc32cTable = make_table(0x1EDC6F41u, true);
+
+inline constexpr Engine kCksum{false,
+                               0,
+                               0xFFFFFFFFu,
+                               &kCksumTable,
+                               fold_keys(512, 0x04C11DB7u, false),
+                               fold_keys(128, 0x04C11DB7u, false)};
+inline constexpr Engine kCrc32{true,
+                               0xFFFFFFFFu,
+                               0xFFFFFFFFu,
+                               &kCrc32Table,
+                               fold_keys(512, 0x04C11DB7u, true),
+                               fold_keys(128, 0x04C11DB7u, true)};
+inline constexpr Engine kCrc32c{true,
+                                0xFFFFFFFFu,
+                                0xFFFFFFFFu,
+                                &kCrc32cTable,
+                                fold_keys(512, 0x1EDC6F41u, true),
+                                fold_keys(128, 0x1EDC6F41u, true)};
+
+inline auto engine_for(CrcModel model) -> const Engine& {
+  switch (model) {
+    case CrcModel::Cksum:
+      return kCksum;
+    case CrcModel::Crc32c:
+      return kCrc32c;
+    case CrcModel::Crc32:
+      break;
+  }
+  return kCrc32;
+}
+
+inline auto load_le32(const unsigned char* p) -> std::uint32_t {
+  return std::uint32_t{p[0]} | (std::uint32_t{p[1]} << 8) |
+         (std::uint32_t{p[2]} << 16) | (std::uint32_t{p[3]} << 24);
+}
+
+inline auto load_be32(const unsigned char* p) -> std::uint32_t {
+  return (std::uint32_t{p[0]} << 24) | (std::uint32_t{p[1]} << 16) |
+         (std::uint32_t{p[2]} << 8) | std::uint32_t{p[3]};
+}
+
+inline auto table_update(const Engine& e, std::uint32_t crc,
+                         const unsigned char* p, size_t n) -> std::uint32_t {
+  const Table& t = *e.table;
+  if (e.reflected) {
+    for (; n >= 16; p += 16, n -= 16) {
+      const std::uint32_t a = load_le32(p) ^ crc;
+      const std::uint32_t b = load_le32(p + 4);
+      const std::uint32_t c = load_le32(p + 8);
+      const std::uint32_t d = load_le32(p + 12);
+      crc = t[15][a & 0xFF] ^ t[14][(a >> 8) & 0xFF] ^
+            t[13][(a >> 16) & 0xFF] ^ t[12][a >> 24] ^ t[11][b & 0xFF] ^
+            t[10][(b >> 8) & 0xFF] ^ t[9][(b >> 16) & 0xFF] ^ t[8][b >> 24] ^
+            t[7][c & 0xFF] ^ t[6][(c >> 8) & 0xFF] ^ t[5][(c >> 16) & 0xFF] ^
+            t[4][c >> 24] ^ t[3][d & 0xFF] ^ t[2][(d >> 8) & 0xFF] ^
+            t[1][(d >> 16) & 0xFF] ^ t[0][d >> 24];
+    }
+    for (; n > 0; ++p, --n) crc = (crc >> 8) ^ t[0][(crc ^ *p) & 0xFF];
+  } else {
+    for (; n >= 16; p += 16, n -= 16) {
+      const std::uint32_t a = load_be32(p) ^ crc;
+      const std::uint32_t b = load_be32(p + 4);
+      const std::uint32_t c = load_be32(p + 8);
+      const std::uint32_t d = load_be32(p + 12);
+      crc = t[15][a >> 24] ^ t[14][(a >> 16) & 0xFF] ^
+            t[13][(a >> 8) & 0xFF] ^ t[12][a & 0xFF] ^ t[11][b >> 24] ^
+            t[10][(b >> 16) & 0xFF] ^ t[9][(b >> 8) & 0xFF] ^ t[8][b & 0xFF] ^
+            t[7][c >> 24] ^ t[6][(c >> 16) & 0xFF] ^ t[5][(c >> 8) & 0xFF] ^
+            t[4][c & 0xFF] ^ t[3][d >> 24] ^ t[2][(d >> 16) & 0xFF] ^
+            t[1][(d >> 8) & 0xFF] ^ t[0][d & 0xFF];
+    }
+    for (; n > 0; ++p, --n) crc = (crc << 8) ^ t[0][(crc >> 24) ^ *p];
+  }
+  return crc;
+}
+
+#ifdef WINUX_CRC_CLMUL
+// Below this the lane setup costs more than the tables do
+constexpr size_t kFoldMin = 256;
+
+inline auto has_clmul() -> bool {
+  const CpuFeatures& cpu = cpu_features();
+  return cpu.sse2 && cpu.ssse3 && cpu.pclmul;
+}
+
+// MSB-first lanes are byte-swapped so bit 127 is the first bit of the data
+template <bool Reflected>
+WINUX_CRC_TARGET inline auto to_lane(__m128i v) -> __m128i {
+  if constexpr (Reflected) {
+    return v;
+  } else {
+    return _mm_shuffle_epi8(
+        v, _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+  }
+}
+
+template <bool Reflected>
+WINUX_CRC_TARGET inline auto load_lane(const unsigned char* p) -> __m128i {
+  return to_lane<Reflected>(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+}
+
+WINUX_CRC_TARGET inline auto fold(__m128i lane, __m128i keys, __m128i next)
+    -> __m128i {
+  return _mm_xor_si128(
+      _mm_xor_si128(_mm_clmulepi64_si128(lane, keys, 0x00),
+                    _mm_clmulepi64_si128(lane, keys, 0x11)),
+      next);
+}
+
+/**
+ * Folds N bytes (a multiple of 16, at least 64) into the 16 bytes at OUT,
+ * whose CRC from a zero register equals that of the input from register CRC.
+ * Four independent lanes keep the multiplier busy; they are merged into one
+ * at the end.
+ */
+template <bool Reflected>
+WINUX_CRC_TARGET void fold_blocks(const Engine& e, std::uint32_t crc,
+                                  const unsigned char* p, size_t n,
+                                  unsigned char* out) {
+  const __m128i seed = _mm_cvtsi32_si128(
+      static_cast<int>(Reflected ? crc : std::byteswap(crc)));
+  __m128i x0 = to_lane<Reflected>(_mm_xor_si128(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), seed));
+  __m128i x1 = load_lane<Reflected>(p + 16);
+  __m128i x2 = load_lane<Reflected>(p + 32);
+  __m128i x3 = load_lane<Reflected>(p + 48);
+  p += 64;
+  n -= 64;
+
+  const __m128i k4 = _mm_set_epi64x(static_cast<long long>(e.fold4.hi),
+                                    static_cast<long long>(e.fold4.lo));
+  for (; n >= 64; p += 64, n -= 64) {
+    x0 = fold(x0, k4, load_lane<Reflected>(p));
+    x1 = fold(x1, k4, load_lane<Reflected>(p + 16));
+    x2 = fold(x2, k4, load_lane<Reflected>(p + 32));
+    x3 = fold(x3, k4, load_lane<Reflected>(p + 48));
+  }
+
+  const __m128i k1 = _mm_set_epi64x(static_cast<long long>(e.fold1.hi),
+                                    static_cast<long long>(e.fold1.lo));
+  x0 = fold(x0, k1, x1);
+  x0 = fold(x0, k1, x2);
+  x0 = fold(x0, k1, x3);
+  for (; n >= 16; p += 16, n -= 16) x0 = fold(x0, k1, load_lane<Reflected>(p));
+
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(out), to_lane<Reflected>(x0));
+}
+#endif
+
+inline auto update(const Engine& e, std::uint32_t crc, const unsigned char* p,
+                   size_t n) -> std::uint32_t {
+#ifdef WINUX_CRC_CLMUL
+  if (n >= kFoldMin && has_clmul()) {
+    const size_t bulk = n & ~size_t{15};
+    alignas(16) unsigned char folded[16];
+    if (e.reflected) {
+      fold_blocks<true>(e, crc, p, bulk, folded);
+    } else {
+      fold_blocks<false>(e, crc, p, bulk, folded);
+    }
+    crc = table_update(e, 0, folded, sizeof(folded));
+    p += bulk;
+    n -= bulk;
+  }
+#endif
+  return table_update(e, crc, p, n);
+}
+
+}  // namespace crc_detail
+
+/**
+ * @brief Incremental CRC-32 of a byte stream fed in blocks.
+ *
+ * Uses slicing-by-16 tables built at compile time, which consume 16 bytes
+ * per step with no dependency between the lookups. On x86 CPUs with
+ * PCLMULQDQ (checked once at run time), large blocks are instead folded 64
+ * bytes at a time with carry-less multiplies, and only the last 16 folded
+ * bytes and the tail go through the tables.
+ *
+ * Any split of the input into blocks gives the same result.
+ */
+export class Crc {
+ public:
+  explicit Crc(CrcModel model = CrcModel::Crc32)
+      : model_(model),
+        engine_(&crc_detail::engine_for(model)),
+        crc_(engine_->init) {}
+
+  void update(std::string_view data) {
+    crc_ = crc_detail::update(
+        *engine_, crc_, reinterpret_cast<const unsigned char*>(data.data()),
+        data.size());
+    length_ += data.size();
+  }
+
+  /// The checksum of everything fed so far; more data may follow.
+  [[nodiscard]] auto value() const -> std::uint32_t {
+    std::uint32_t crc = crc_;
+    if (model_ == CrcModel::Cksum) {
+      // The length goes in least significant byte first, without zeros
+      unsigned char bytes[sizeof(std::uint64_t)];
+      size_t n = 0;
+      for (std::uint64_t len = length_; len != 0; len >>= 8) {
+        bytes[n++] = static_cast<unsigned char>(len & 0xFF);
+      }
+      crc = crc_detail::table_update(*engine_, crc, bytes, n);
+    }
+    return crc ^ engine_->xorout;
+  }
+
+  [[nodiscard]] auto length() const -> std::uint64_t { return length_; }
+
+  void reset() {
+    crc_ = engine_->init;
+    length_ = 0;
+  }
+
+ private:
+  CrcModel model_;
+  const crc_detail::Engine* engine_;
+  std::uint32_t crc_;
+  std::uint64_t length_ = 0;
+};
+
+/**
+ * @brief CRC-32 of one buffer.
+ */
+export auto crc32(std::string_view data, CrcModel model = CrcModel::Crc32)
+    -> std::uint32_t {
+  Crc crc(model);
+  crc.update(data);
+  return crc.value();
+}
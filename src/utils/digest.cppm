@@ -0,0 +1,1083 @@
+/// @Author: caomengxuan666
+/// @Description: Message digest engine (MD5, SHA-1, SHA-2, BLAKE2b)
+/// @Version: 0.1.0
+/// @License: MIT
+/// @Copyright: Copyright © 2026 WinuxCmd
+module;
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || \
+    defined(__i386__)
+#include <immintrin.h>
+#define WINUX_HASH_X86 1
+#endif
+// GCC and Clang only emit SHA-NI/AVX2 inside functions that ask for them
+#if defined(__GNUC__) || defined(__clang__)
+#define WINUX_HASH_SHA_TARGET \
+  __attribute__((target("sse2,ssse3,sse4.1,sha")))
+#define WINUX_HASH_AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define WINUX_HASH_SHA_TARGET
+#define WINUX_HASH_AVX2_TARGET
+#endif
+export module utils:digest;
+
+import std;
+import :cpu_features;
+
+
+export enum class HashAlgorithm {
+  Md5,
+  Sha1,
+  Sha224,
+  Sha256,
+  Sha384,
+  Sha512,
+  Blake2b,
+};
+
+/**
+ * @brief A finished message digest.
+ */
+export struct Digest {
+  std::array<unsigned char, 64> bytes{};
+  size_t size = 0;
+
+  [[nodiscard]] auto view() const -> std::span<const unsigned char> {
+    return {bytes.data(), size};
+  }
+
+  /// Lowercase hexadecimal, as the *sum commands print it.
+  [[nodiscard]] auto hex() const -> std::string {
+    static constexpr char kDigits[] = "0123456789abcdef";
+    std::string out(size * 2, '\0');
+    for (size_t i = 0; i < size; ++i) {
+      out[2 * i] = kDigits[bytes[i] >> 4];
+      out[2 * i + 1] = kDigits[bytes[i] & 0xF];
+    }
+    return out;
+  }
+};
+
+/**
+ * @brief Digest length of ALGORITHM in bytes (the longest, for BLAKE2b).
+ */
+export constexpr auto digest_size(HashAlgorithm algorithm) -> size_t {
+  switch (algorithm) {
+    case HashAlgorithm::Md5:
+      return 16;
+    case HashAlgorithm::Sha1:
+      return 20;
+    case HashAlgorithm::Sha224:
+      return 28;
+    case HashAlgorithm::Sha256:
+      return 32;
+    case HashAlgorithm::Sha384:
+      return 48;
+    case HashAlgorithm::Sha512:
+    case HashAlgorithm::Blake2b:
+      break;
+  }
+  return 64;
+}
+
+namespace hash_detail {
+
+inline auto load_le32(const unsigned char* p) -> std::uint32_t {
+  return std::uint32_t{p[0]} | (std::uint32_t{p[1]} << 8) |
+         (std::uint32_t{p[2]} << 16) | (std::uint32_t{p[3]} << 24);
+}
+
+inline auto load_be32(const unsigned char* p) -> std::uint32_t {
+  return (std::uint32_t{p[0]} << 24) | (std::uint32_t{p[1]} << 16) |
+         (std::uint32_t{p[2]} << 8) | std::uint32_t{p[3]};
+}
+
+inline auto load_le64(const unsigned char* p) -> std::uint64_t {
+  return std::uint64_t{load_le32(p)} | (std::uint64_t{load_le32(p + 4)} << 32);
+}
+
+inline auto load_be64(const unsigned char* p) -> std::uint64_t {
+  return (std::uint64_t{load_be32(p)} << 32) | std::uint64_t{load_be32(p + 4)};
+}
+
+template <typename Word>
+void store_le(unsigned char* p, Word v) {
+  for (size_t i = 0; i < sizeof(Word); ++i) {
+    p[i] = static_cast<unsigned char>(v >> (8 * i));
+  }
+}
+
+template <typename Word>
+void store_be(unsigned char* p, Word v) {
+  for (size_t i = 0; i < sizeof(Word); ++i) {
+    p[i] = static_cast<unsigned char>(v >> (8 * (sizeof(Word) - 1 - i)));
+  }
+}
+
+// ----------------------------------------------------------------------------
+// Constants
+// ----------------------------------------------------------------------------
+
+inline constexpr std::array<std::uint32_t, 64> kMd5K = {
+    0xd76aa478u, 0xe8c7b756u, 0x242070dbu, 0xc1bdceeeu,
+    0xf57c0fafu, 0x4787c62au, 0xa8304613u, 0xfd469501u,
+    0x698098d8u, 0x8b44f7afu, 0xffff5bb1u, 0x895cd7beu,
+    0x6b901122u, 0xfd987193u, 0xa679438eu, 0x49b40821u,
+    0xf61e2562u, 0xc040b340u, 0x265e5a51u, 0xe9b6c7aau,
+    0xd62f105du, 0x02441453u, 0xd8a1e681u, 0xe7d3fbc8u,
+    0x21e1cde6u, 0xc33707d6u, 0xf4d50d87u, 0x455a14edu,
+    0xa9e3e905u, 0xfcefa3f8u, 0x676f02d9u, 0x8d2a4c8au,
+    0xfffa3942u, 0x8771f681u, 0x6d9d6122u, 0xfde5380cu,
+    0xa4beea44u, 0x4bdecfa9u, 0xf6bb4b60u, 0xbebfbc70u,
+    0x289b7ec6u, 0xeaa127fau, 0xd4ef3085u, 0x04881d05u,
+    0xd9d4d039u, 0xe6db99e5u, 0x1fa27cf8u, 0xc4ac5665u,
+    0xf4292244u, 0x432aff97u, 0xab9423a7u, 0xfc93a039u,
+    0x655b59c3u, 0x8f0ccc92u, 0xffeff47du, 0x85845dd1u,
+    0x6fa87e4fu, 0xfe2ce6e0u, 0xa3014314u, 0x4e0811a1u,
+    0xf7537e82u, 0xbd3af235u, 0x2ad7d2bbu, 0xeb86d391u};
+
+inline constexpr std::array<int, 16> kMd5Shift = {7,  12, 17, 22, 5,  9,
+                                                  14, 20, 4,  11, 16, 23,
+                                                  6,  10, 15, 21};
+
+inline constexpr std::array<std::uint32_t, 4> kSha1K = {
+    0x5a827999u, 0x6ed9eba1u, 0x8f1bbcdcu, 0xca62c1d6u};
+
+inline constexpr std::array<std::uint32_t, 64> kSha256K = {
+    0x428a2f98u, 0x71374491u, 0xb5c0fbcfu, 0xe9b5dba5u,
+    0x3956c25bu, 0x59f111f1u, 0x923f82a4u, 0xab1c5ed5u,
+    0xd807aa98u, 0x12835b01u, 0x243185beu, 0x550c7dc3u,
+    0x72be5d74u, 0x80deb1feu, 0x9bdc06a7u, 0xc19bf174u,
+    0xe49b69c1u, 0xefbe4786u, 0x0fc19dc6u, 0x240ca1ccu,
+    0x2de92c6fu, 0x4a7484aau, 0x5cb0a9dcu, 0x76f988dau,
+    0x983e5152u, 0xa831c66du, 0xb00327c8u, 0xbf597fc7u,
+    0xc6e00bf3u, 0xd5a79147u, 0x06ca6351u, 0x14292967u,
+    0x27b70a85u, 0x2e1b2138u, 0x4d2c6dfcu, 0x53380d13u,
+    0x650a7354u, 0x766a0abbu, 0x81c2c92eu, 0x92722c85u,
+    0xa2bfe8a1u, 0xa81a664bu, 0xc24b8b70u, 0xc76c51a3u,
+    0xd192e819u, 0xd6990624u, 0xf40e3585u, 0x106aa070u,
+    0x19a4c116u, 0x1e376c08u, 0x2748774cu, 0x34b0bcb5u,
+    0x391c0cb3u, 0x4ed8aa4au, 0x5b9cca4fu, 0x682e6ff3u,
+    0x748f82eeu, 0x78a5636fu, 0x84c87814u, 0x8cc70208u,
+    0x90befffau, 0xa4506cebu, 0xbef9a3f7u, 0xc67178f2u};
+
+inline constexpr std::array<std::uint64_t, 80> kSha512K = {
+    0x428a2f98d728ae22ull, 0x7137449123ef65cdull, 0xb5c0fbcfec4d3b2full,
+    0xe9b5dba58189dbbcull, 0x3956c25bf348b538ull, 0x59f111f1b605d019ull,
+    0x923f82a4af194f9bull, 0xab1c5ed5da6d8118ull, 0xd807aa98a3030242ull,
+    0x12835b0145706fbeull, 0x243185be4ee4b28cull, 0x550c7dc3d5ffb4e2ull,
+    0x72be5d74f27b896full, 0x80deb1fe3b1696b1ull, 0x9bdc06a725c71235ull,
+    0xc19bf174cf692694ull, 0xe49b69c19ef14ad2ull, 0xefbe4786384f25e3ull,
+    0x0fc19dc68b8cd5b5ull, 0x240ca1cc77ac9c65ull, 0x2de92c6f592b0275ull,
+    0x4a7484aa6ea6e483ull, 0x5cb0a9dcbd41fbd4ull, 0x76f988da831153b5ull,
+    0x983e5152ee66dfabull, 0xa831c66d2db43210ull, 0xb00327c898fb213full,
+    0xbf597fc7beef0ee4ull, 0xc6e00bf33da88fc2ull, 0xd5a79147930aa725ull,
+    0x06ca6351e003826full, 0x142929670a0e6e70ull, 0x27b70a8546d22ffcull,
+    0x2e1b21385c26c926ull, 0x4d2c6dfc5ac42aedull, 0x53380d139d95b3dfull,
+    0x650a73548baf63deull, 0x766a0abb3c77b2a8ull, 0x81c2c92e47edaee6ull,
+    0x92722c851482353bull, 0xa2bfe8a14cf10364ull, 0xa81a664bbc423001ull,
+    0xc24b8b70d0f89791ull, 0xc76c51a30654be30ull, 0xd192e819d6ef5218ull,
+    0xd69906245565a910ull, 0xf40e35855771202aull, 0x106aa07032bbd1b8ull,
+    0x19a4c116b8d2d0c8ull, 0x1e376c085141ab53ull, 0x2748774cdf8eeb99ull,
+    0x34b0bcb5e19b48a8ull, 0x391c0cb3c5c95a63ull, 0x4ed8aa4ae3418acbull,
+    0x5b9cca4f7763e373ull, 0x682e6ff3d6b2b8a3ull, 0x748f82ee5defb2fcull,
+    0x78a5636f43172f60ull, 0x84c87814a1f0ab72ull, 0x8cc702081a6439ecull,
+    0x90befffa23631e28ull, 0xa4506cebde82bde9ull, 0xbef9a3f7b2c67915ull,
+    0xc67178f2e372532bull, 0xca273eceea26619cull, 0xd186b8c721c0c207ull,
+    0xeada7dd6cde0eb1eull, 0xf57d4f7fee6ed178ull, 0x06f067aa72176fbaull,
+    0x0a637dc5a2c898a6ull, 0x113f9804bef90daeull, 0x1b710b35131c471bull,
+    0x28db77f523047d84ull, 0x32caab7b40c72493ull, 0x3c9ebe0a15c9bebcull,
+    0x431d67c49c100d4cull, 0x4cc5d4becb3e42b6ull, 0x597f299cfc657e2aull,
+    0x5fcb6fab3ad6faecull, 0x6c44198c4a475817ull};
+
+inline constexpr std::array<std::uint32_t, 8> kSha224Init = {
+    0xc1059ed8u, 0x367cd507u, 0x3070dd17u, 0xf70e5939u,
+    0xffc00b31u, 0x68581511u, 0x64f98fa7u, 0xbefa4fa4u};
+
+inline constexpr std::array<std::uint32_t, 8> kSha256Init = {
+    0x6a09e667u, 0xbb67ae85u, 0x3c6ef372u, 0xa54ff53au,
+    0x510e527fu, 0x9b05688cu, 0x1f83d9abu, 0x5be0cd19u};
+
+inline constexpr std::array<std::uint64_t, 8> kSha384Init = {
+    0xcbbb9d5dc1059ed8ull, 0x629a292a367cd507ull, 0x9159015a3070dd17ull,
+    0x152fecd8f70e5939ull, 0x67332667ffc00b31ull, 0x8eb44a8768581511ull,
+    0xdb0c2e0d64f98fa7ull, 0x47b5481dbefa4fa4ull};
+
+// Also BLAKE2b's initialization vector
+inline constexpr std::array<std::uint64_t, 8> kSha512Init = {
+    0x6a09e667f3bcc908ull, 0xbb67ae8584caa73bull, 0x3c6ef372fe94f82bull,
+    0xa54ff53a5f1d36f1ull, 0x510e527fade682d1ull, 0x9b05688c2b3e6c1full,
+    0x1f83d9abfb41bd6bull, 0x5be0cd19137e2179ull};
+
+inline constexpr std::uint8_t kBlake2bSigma[12][16] = {
+    {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+    {14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3},
+    {11, 8, 12, 0, 5, 2, 15, 13, 10, 14, 3, 6, 7, 1, 9, 4},
+    {7, 9, 3, 1, 13, 12, 11, 14, 2, 6, 5, 10, 4, 0, 15, 8},
+    {9, 0, 5, 7, 2, 4, 10, 15, 14, 1, 11, 12, 6, 8, 3, 13},
+    {2, 12, 6, 10, 0, 11, 8, 3, 4, 13, 7, 5, 15, 14, 1, 9},
+    {12, 5, 1, 15, 14, 13, 4, 10, 0, 7, 6, 3, 9, 2, 8, 11},
+    {13, 11, 7, 14, 12, 1, 3, 9, 5, 0, 15, 4, 8, 6, 2, 10},
+    {6, 15, 14, 9, 11, 3, 0, 8, 12, 2, 13, 7, 1, 4, 10, 5},
+    {10, 2, 8, 4, 7, 6, 1, 5, 15, 11, 9, 14, 3, 12, 13, 0},
+    {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+    {14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3}};
+
+// ----------------------------------------------------------------------------
+// Portable compression functions
+//
+// Each takes the chaining state and COUNT consecutive blocks.
+// ----------------------------------------------------------------------------
+
+// Message word and rotation of MD5 step I
+constexpr auto md5_word(size_t i) -> size_t {
+  switch (i / 16) {
+    case 0:
+      return i;
+    case 1:
+      return (5 * i + 1) % 16;
+    case 2:
+      return (3 * i + 5) % 16;
+    default:
+      return 7 * i % 16;
+  }
+}
+
+constexpr auto md5_shift(size_t i) -> int {
+  return kMd5Shift[i / 16 * 4 + i % 4];
+}
+
+// The steps are unrolled so every rotation and message index is a constant
+template <size_t I>
+inline void md5_step(std::uint32_t& a, std::uint32_t& b, std::uint32_t& c,
+                     std::uint32_t& d, const std::uint32_t* m) {
+  std::uint32_t f;
+  if constexpr (I < 16) {
+    f = (b & c) | (~b & d);
+  } else if constexpr (I < 32) {
+    f = (d & b) | (~d & c);
+  } else if constexpr (I < 48) {
+    f = b ^ c ^ d;
+  } else {
+    f = c ^ (b | ~d);
+  }
+  f += a + kMd5K[I] + m[md5_word(I)];
+  a = d;
+  d = c;
+  c = b;
+  b += std::rotl(f, md5_shift(I));
+}
+
+template <size_t... I>
+inline void md5_steps(std::uint32_t& a, std::uint32_t& b, std::uint32_t& c,
+                      std::uint32_t& d, const std::uint32_t* m,
+                      std::index_sequence<I...>) {
+  (md5_step<I>(a, b, c, d, m), ...);
+}
+
+inline void md5_compress(std::uint32_t* state, const unsigned char* p,
+                         size_t count) {
+  for (; count > 0; --count, p += 64) {
+    std::uint32_t m[16];
+    for (size_t i = 0; i < 16; ++i) m[i] = load_le32(p + 4 * i);
+    std::uint32_t a = state[0];
+    std::uint32_t b = state[1];
+    std::uint32_t c = state[2];
+    std::uint32_t d = state[3];
+    md5_steps(a, b, c, d, m, std::make_index_sequence<64>{});
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+  }
+}
+
+inline void sha1_compress(std::uint32_t* state, const unsigned char* p,
+                          size_t count) {
+  for (; count > 0; --count, p += 64) {
+    std::uint32_t w[80];
+    for (size_t t = 0; t < 16; ++t) w[t] = load_be32(p + 4 * t);
+    for (size_t t = 16; t < 80; ++t) {
+      w[t] = std::rotl(w[t - 3] ^ w[t - 8] ^ w[t - 14] ^ w[t - 16], 1);
+    }
+    std::uint32_t a = state[0];
+    std::uint32_t b = state[1];
+    std::uint32_t c = state[2];
+    std::uint32_t d = state[3];
+    std::uint32_t e = state[4];
+    for (size_t t = 0; t < 80; ++t) {
+      std::uint32_t f;
+      if (t < 20) {
+        f = (b & c) | (~b & d);
+      } else if (t < 40 || t >= 60) {
+        f = b ^ c ^ d;
+      } else {
+        f = (b & c) | (b & d) | (c & d);
+      }
+      const std::uint32_t temp =
+          std::rotl(a, 5) + f + e + kSha1K[t / 20] + w[t];
+      e = d;
+      d = c;
+      c = std::rotl(b, 30);
+      b = a;
+      a = temp;
+    }
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+  }
+}
+
+inline void sha256_compress(std::uint32_t* state, const unsigned char* p,
+                            size_t count) {
+  for (; count > 0; --count, p += 64) {
+    std::uint32_t w[64];
+    for (size_t t = 0; t < 16; ++t) w[t] = load_be32(p + 4 * t);
+    for (size_t t = 16; t < 64; ++t) {
+      const std::uint32_t s0 = std::rotr(w[t - 15], 7) ^
+                               std::rotr(w[t - 15], 18) ^ (w[t - 15] >> 3);
+      const std::uint32_t s1 = std::rotr(w[t - 2], 17) ^
+                               std::rotr(w[t - 2], 19) ^ (w[t - 2] >> 10);
+      w[t] = w[t - 16] + s0 + w[t - 7] + s1;
+    }
+    std::uint32_t v[8];
+    for (size_t i = 0; i < 8; ++i) v[i] = state[i];
+    for (size_t t = 0; t < 64; ++t) {
+      const std::uint32_t s1 =
+          std::rotr(v[4], 6) ^ std::rotr(v[4], 11) ^ std::rotr(v[4], 25);
+      const std::uint32_t ch = (v[4] & v[5]) ^ (~v[4] & v[6]);
+      const std::uint32_t t1 = v[7] + s1 + ch + kSha256K[t] + w[t];
+      const std::uint32_t s0 =
+          std::rotr(v[0], 2) ^ std::rotr(v[0], 13) ^ std::rotr(v[0], 22);
+      const std::uint32_t maj = (v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]);
+      v[7] = v[6];
+      v[6] = v[5];
+      v[5] = v[4];
+      v[4] = v[3] + t1;
+      v[3] = v[2];
+      v[2] = v[1];
+      v[1] = v[0];
+      v[0] = t1 + s0 + maj;
+    }
+    for (size_t i = 0; i < 8; ++i) state[i] += v[i];
+  }
+}
+
+inline void sha512_compress(std::uint64_t* state, const unsigned char* p,
+                            size_t count) {
+  for (; count > 0; --count, p += 128) {
+    std::uint64_t w[80];
+    for (size_t t = 0; t < 16; ++t) w[t] = load_be64(p + 8 * t);
+    for (size_t t = 16; t < 80; ++t) {
+      const std::uint64_t s0 = std::rotr(w[t - 15], 1) ^
+                               std::rotr(w[t - 15], 8) ^ (w[t - 15] >> 7);
+      const std::uint64_t s1 = std::rotr(w[t - 2], 19) ^
+                               std::rotr(w[t - 2], 61) ^ (w[t - 2] >> 6);
+      w[t] = w[t - 16] + s0 + w[t - 7] + s1;
+    }
+    std::uint64_t v[8];
+    for (size_t i = 0; i < 8; ++i) v[i] = state[i];
+    for (size_t t = 0; t < 80; ++t) {
+      const std::uint64_t s1 =
+          std::rotr(v[4], 14) ^ std::rotr(v[4], 18) ^ std::rotr(v[4], 41);
+      const std::uint64_t ch = (v[4] & v[5]) ^ (~v[4] & v[6]);
+      const std::uint64_t t1 = v[7] + s1 + ch + kSha512K[t] + w[t];
+      const std::uint64_t s0 =
+          std::rotr(v[0], 28) ^ std::rotr(v[0], 34) ^ std::rotr(v[0], 39);
+      const std::uint64_t maj = (v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]);
+      v[7] = v[6];
+      v[6] = v[5];
+      v[5] = v[4];
+      v[4] = v[3] + t1;
+      v[3] = v[2];
+      v[2] = v[1];
+      v[1] = v[0];
+      v[0] = t1 + s0 + maj;
+    }
+    for (size_t i = 0; i < 8; ++i) state[i] += v[i];
+  }
+}
+
+// Eight streams at once: STATE[word][lane], one block from each LANES[i]
+using CompressX8 = void (*)(std::uint32_t (*state)[8],
+                            const unsigned char* const* lanes, size_t count);
+
+// ----------------------------------------------------------------------------
+// SHA-NI: one SHA-1 or SHA-256 stream on the dedicated instructions
+// ----------------------------------------------------------------------------
+
+#ifdef WINUX_HASH_X86
+template <int F>
+WINUX_HASH_SHA_TARGET inline auto sha1_rounds4(__m128i abcd, __m128i e)
+    -> __m128i {
+  return _mm_sha1rnds4_epu32(abcd, e, F);
+}
+
+WINUX_HASH_SHA_TARGET inline void sha1_compress_shani(std::uint32_t* state,
+                                                      const unsigned char* p,
+                                                      size_t count) {
+  const __m128i swap =
+      _mm_set_epi64x(0x0001020304050607ll, 0x08090a0b0c0d0e0fll);
+  __m128i abcd = _mm_shuffle_epi32(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0x1B);
+  __m128i e0 = _mm_set_epi32(static_cast<int>(state[4]), 0, 0, 0);
+
+  for (; count > 0; --count, p += 64) {
+    const __m128i abcd_saved = abcd;
+    const __m128i e_saved = e0;
+    __m128i e1 = _mm_setzero_si128();
+    __m128i msg[4];
+    // Twenty groups of four rounds; the schedule runs three groups ahead
+    for (int g = 0; g < 20; ++g) {
+      __m128i& cur = msg[g % 4];
+      if (g < 4) {
+        cur = _mm_shuffle_epi8(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * g)),
+            swap);
+      }
+      __m128i& e_in = g % 2 == 0 ? e0 : e1;
+      __m128i& e_out = g % 2 == 0 ? e1 : e0;
+      e_in = g == 0 ? _mm_add_epi32(e_in, cur) : _mm_sha1nexte_epu32(e_in, cur);
+      e_out = abcd;
+      if (g >= 3 && g <= 18) {
+        msg[(g + 1) % 4] = _mm_sha1msg2_epu32(msg[(g + 1) % 4], cur);
+      }
+      switch (g / 5) {
+        case 0:
+          abcd = sha1_rounds4<0>(abcd, e_in);
+          break;
+        case 1:
+          abcd = sha1_rounds4<1>(abcd, e_in);
+          break;
+        case 2:
+          abcd = sha1_rounds4<2>(abcd, e_in);
+          break;
+        default:
+          abcd = sha1_rounds4<3>(abcd, e_in);
+          break;
+      }
+      if (g >= 1 && g <= 16) {
+        msg[(g + 3) % 4] = _mm_sha1msg1_epu32(msg[(g + 3) % 4], cur);
+      }
+      if (g >= 2 && g <= 17) {
+        msg[(g + 2) % 4] = _mm_xor_si128(msg[(g + 2) % 4], cur);
+      }
+    }
+    e0 = _mm_sha1nexte_epu32(e0, e_saved);
+    abcd = _mm_add_epi32(abcd, abcd_saved);
+  }
+
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(state),
+                   _mm_shuffle_epi32(abcd, 0x1B));
+  state[4] = static_cast<std::uint32_t>(_mm_extract_epi32(e0, 3));
+}
+
+WINUX_HASH_SHA_TARGET inline void sha256_compress_shani(
+    std::uint32_t* state, const unsigned char* p, size_t count) {
+  const __m128i swap =
+      _mm_set_epi64x(0x0c0d0e0f08090a0bll, 0x0405060700010203ll);
+  // The instructions keep the state as ABEF and CDGH
+  const __m128i dcba = _mm_shuffle_epi32(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0xB1);
+  const __m128i efgh = _mm_shuffle_epi32(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(state + 4)), 0x1B);
+  __m128i abef = _mm_alignr_epi8(dcba, efgh, 8);
+  __m128i cdgh = _mm_blend_epi16(efgh, dcba, 0xF0);
+
+  for (; count > 0; --count, p += 64) {
+    const __m128i abef_saved = abef;
+    const __m128i cdgh_saved = cdgh;
+    __m128i msg[4];
+    // Sixteen groups of four rounds; the schedule runs three groups ahead
+    for (int g = 0; g < 16; ++g) {
+      __m128i& cur = msg[g % 4];
+      if (g < 4) {
+        cur = _mm_shuffle_epi8(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * g)),
+            swap);
+      }
+      __m128i k = _mm_add_epi32(
+          cur, _mm_loadu_si128(
+                   reinterpret_cast<const __m128i*>(kSha256K.data() + 4 * g)));
+      cdgh = _mm_sha256rnds2_epu32(cdgh, abef, k);
+      if (g >= 3 && g <= 14) {
+        __m128i& next = msg[(g + 1) % 4];
+        next = _mm_add_epi32(next, _mm_alignr_epi8(cur, msg[(g + 3) % 4], 4));
+        next = _mm_sha256msg2_epu32(next, cur);
+      }
+      k = _mm_shuffle_epi32(k, 0x0E);
+      abef = _mm_sha256rnds2_epu32(abef, cdgh, k);
+      if (g >= 1 && g <= 12) {
+        msg[(g + 3) % 4] = _mm_sha256msg1_epu32(msg[(g + 3) % 4], cur);
+      }
+    }
+    abef = _mm_add_epi32(abef, abef_saved);
+    cdgh = _mm_add_epi32(cdgh, cdgh_saved);
+  }
+
+  const __m128i feba = _mm_shuffle_epi32(abef, 0x1B);
+  const __m128i dchg = _mm_shuffle_epi32(cdgh, 0xB1);
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(state),
+                   _mm_blend_epi16(feba, dchg, 0xF0));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4),
+                   _mm_alignr_epi8(dchg, feba, 8));
+}
+
+// ----------------------------------------------------------------------------
+// AVX2 multi-buffer: eight independent streams, one per 32-bit lane
+//
+// MD5 and SHA-1/SHA-256 are serial within one stream, so instead of trying
+// to speed up one message the eight lanes each carry a different one. State
+// is kept transposed: STATE[word][lane].
+// ----------------------------------------------------------------------------
+
+struct Avx2Ops {
+  WINUX_HASH_AVX2_TARGET static auto add(__m256i x, __m256i y) -> __m256i {
+    return _mm256_add_epi32(x, y);
+  }
+  WINUX_HASH_AVX2_TARGET static auto bit_and(__m256i x, __m256i y) -> __m256i {
+    return _mm256_and_si256(x, y);
+  }
+  WINUX_HASH_AVX2_TARGET static auto bit_or(__m256i x, __m256i y) -> __m256i {
+    return _mm256_or_si256(x, y);
+  }
+  WINUX_HASH_AVX2_TARGET static auto bit_xor(__m256i x, __m256i y) -> __m256i {
+    return _mm256_xor_si256(x, y);
+  }
+  WINUX_HASH_AVX2_TARGET static auto bit_not(__m256i x) -> __m256i {
+    return _mm256_xor_si256(x, _mm256_set1_epi32(-1));
+  }
+  // ~X & Y
+  WINUX_HASH_AVX2_TARGET static auto and_not(__m256i x, __m256i y) -> __m256i {
+    return _mm256_andnot_si256(x, y);
+  }
+  WINUX_HASH_AVX2_TARGET static auto constant(std::uint32_t k) -> __m256i {
+    return _mm256_set1_epi32(static_cast<int>(k));
+  }
+  template <int N>
+  WINUX_HASH_AVX2_TARGET static auto rotl(__m256i x) -> __m256i {
+    return _mm256_or_si256(_mm256_slli_epi32(x, N),
+                           _mm256_srli_epi32(x, 32 - N));
+  }
+  template <int N>
+  WINUX_HASH_AVX2_TARGET static auto rotr(__m256i x) -> __m256i {
+    return rotl<32 - N>(x);
+  }
+};
+
+template <size_t I>
+WINUX_HASH_AVX2_TARGET inline void md5_step_x8(__m256i& a, __m256i& b,
+                                               __m256i& c, __m256i& d,
+                                               const __m256i* m) {
+  using V = Avx2Ops;
+  __m256i f;
+  if constexpr (I < 16) {
+    f = V::bit_or(V::bit_and(b, c), V::and_not(b, d));
+  } else if constexpr (I < 32) {
+    f = V::bit_or(V::bit_and(d, b), V::and_not(d, c));
+  } else if constexpr (I < 48) {
+    f = V::bit_xor(V::bit_xor(b, c), d);
+  } else {
+    f = V::bit_xor(c, V::bit_or(b, V::bit_not(d)));
+  }
+  f = V::add(V::add(f, a), V::add(V::constant(kMd5K[I]), m[md5_word(I)]));
+  a = d;
+  d = c;
+  c = b;
+  b = V::add(b, V::rotl<md5_shift(I)>(f));
+}
+
+template <size_t... I>
+WINUX_HASH_AVX2_TARGET inline void md5_steps_x8(__m256i& a, __m256i& b,
+                                                __m256i& c, __m256i& d,
+                                                const __m256i* m,
+                                                std::index_sequence<I...>) {
+  (md5_step_x8<I>(a, b, c, d, m), ...);
+}
+
+// Words OFFSET/4 .. OFFSET/4+7 of every lane's current block, one per vector
+WINUX_HASH_AVX2_TARGET inline void load_words_x8(
+    const unsigned char* const* lanes, size_t offset, __m256i* out) {
+  __m256i r[8];
+  for (int l = 0; l < 8; ++l) {
+    r[l] = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(lanes[l] + offset));
+  }
+  const __m256i t0 = _mm256_unpacklo_epi32(r[0], r[1]);
+  const __m256i t1 = _mm256_unpackhi_epi32(r[0], r[1]);
+  const __m256i t2 = _mm256_unpacklo_epi32(r[2], r[3]);
+  const __m256i t3 = _mm256_unpackhi_epi32(r[2], r[3]);
+  const __m256i t4 = _mm256_unpacklo_epi32(r[4], r[5]);
+  const __m256i t5 = _mm256_unpackhi_epi32(r[4], r[5]);
+  const __m256i t6 = _mm256_unpacklo_epi32(r[6], r[7]);
+  const __m256i t7 = _mm256_unpackhi_epi32(r[6], r[7]);
+  const __m256i u0 = _mm256_unpacklo_epi64(t0, t2);
+  const __m256i u1 = _mm256_unpackhi_epi64(t0, t2);
+  const __m256i u2 = _mm256_unpacklo_epi64(t1, t3);
+  const __m256i u3 = _mm256_unpackhi_epi64(t1, t3);
+  const __m256i u4 = _mm256_unpacklo_epi64(t4, t6);
+  const __m256i u5 = _mm256_unpackhi_epi64(t4, t6);
+  const __m256i u6 = _mm256_unpacklo_epi64(t5, t7);
+  const __m256i u7 = _mm256_unpackhi_epi64(t5, t7);
+  out[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+  out[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+  out[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+  out[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+  out[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+  out[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+  out[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+  out[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+}
+
+WINUX_HASH_AVX2_TARGET inline void load_block_x8(
+    const unsigned char* const* lanes, size_t offset, bool big_endian,
+    __m256i* m) {
+  load_words_x8(lanes, offset, m);
+  load_words_x8(lanes, offset + 32, m + 8);
+  if (big_endian) {
+    const __m256i swap = _mm256_set_epi8(
+        12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3, 12, 13, 14, 15,
+        8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+    for (int i = 0; i < 16; ++i) m[i] = _mm256_shuffle_epi8(m[i], swap);
+  }
+}
+
+WINUX_HASH_AVX2_TARGET inline auto load_state_x8(std::uint32_t (*state)[8],
+                                                 int word) -> __m256i {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(state[word]));
+}
+
+WINUX_HASH_AVX2_TARGET inline void store_state_x8(std::uint32_t (*state)[8],
+                                                  int word, __m256i v) {
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(state[word]), v);
+}
+
+WINUX_HASH_AVX2_TARGET inline void md5_x8(std::uint32_t (*state)[8],
+                                          const unsigned char* const* lanes,
+                                          size_t count) {
+  __m256i a = load_state_x8(state, 0);
+  __m256i b = load_state_x8(state, 1);
+  __m256i c = load_state_x8(state, 2);
+  __m256i d = load_state_x8(state, 3);
+  for (size_t block = 0; block < count; ++block) {
+    __m256i m[16];
+    load_block_x8(lanes, block * 64, false, m);
+    const __m256i a0 = a;
+    const __m256i b0 = b;
+    const __m256i c0 = c;
+    const __m256i d0 = d;
+    md5_steps_x8(a, b, c, d, m, std::make_index_sequence<64>{});
+    a = _mm256_add_epi32(a, a0);
+    b = _mm256_add_epi32(b, b0);
+    c = _mm256_add_epi32(c, c0);
+    d = _mm256_add_epi32(d, d0);
+  }
+  store_state_x8(state, 0, a);
+  store_state_x8(state, 1, b);
+  store_state_x8(state, 2, c);
+  store_state_x8(state, 3, d);
+}
+
+WINUX_HASH_AVX2_TARGET inline void sha1_x8(std::uint32_t (*state)[8],
+                                           const unsigned char* const* lanes,
+                                           size_t count) {
+  using V = Avx2Ops;
+  __m256i h[5];
+  for (int i = 0; i < 5; ++i) h[i] = load_state_x8(state, i);
+  for (size_t block = 0; block < count; ++block) {
+    __m256i w[16];
+    load_block_x8(lanes, block * 64, true, w);
+    __m256i a = h[0];
+    __m256i b = h[1];
+    __m256i c = h[2];
+    __m256i d = h[3];
+    __m256i e = h[4];
+    for (int t = 0; t < 80; ++t) {
+      if (t >= 16) {
+        w[t % 16] = V::rotl<1>(V::bit_xor(
+            V::bit_xor(w[(t - 3) % 16], w[(t - 8) % 16]),
+            V::bit_xor(w[(t - 14) % 16], w[t % 16])));
+      }
+      __m256i f;
+      if (t < 20) {
+        f = V::bit_or(V::bit_and(b, c), V::and_not(b, d));
+      } else if (t < 40 || t >= 60) {
+        f = V::bit_xor(V::bit_xor(b, c), d);
+      } else {
+        f = V::bit_or(V::bit_and(b, c), V::bit_and(d, V::bit_or(b, c)));
+      }
+      const __m256i temp =
+          V::add(V::add(V::rotl<5>(a), f),
+                 V::add(V::add(e, V::constant(kSha1K[t / 20])), w[t % 16]));
+      e = d;
+      d = c;
+      c = V::rotl<30>(b);
+      b = a;
+      a = temp;
+    }
+    h[0] = V::add(h[0], a);
+    h[1] = V::add(h[1], b);
+    h[2] = V::add(h[2], c);
+    h[3] = V::add(h[3], d);
+    h[4] = V::add(h[4], e);
+  }
+  for (int i = 0; i < 5; ++i) store_state_x8(state, i, h[i]);
+}
+
+WINUX_HASH_AVX2_TARGET inline void sha256_x8(std::uint32_t (*state)[8],
+                                             const unsigned char* const* lanes,
+                                             size_t count) {
+  using V = Avx2Ops;
+  __m256i h[8];
+  for (int i = 0; i < 8; ++i) h[i] = load_state_x8(state, i);
+  for (size_t block = 0; block < count; ++block) {
+    __m256i w[16];
+    load_block_x8(lanes, block * 64, true, w);
+    __m256i v[8];
+    for (int i = 0; i < 8; ++i) v[i] = h[i];
+    for (int t = 0; t < 64; ++t) {
+      if (t >= 16) {
+        const __m256i w15 = w[(t - 15) % 16];
+        const __m256i w2 = w[(t - 2) % 16];
+        const __m256i s0 =
+            V::bit_xor(V::bit_xor(V::rotr<7>(w15), V::rotr<18>(w15)),
+                       _mm256_srli_epi32(w15, 3));
+        const __m256i s1 =
+            V::bit_xor(V::bit_xor(V::rotr<17>(w2), V::rotr<19>(w2)),
+                       _mm256_srli_epi32(w2, 10));
+        w[t % 16] = V::add(V::add(w[t % 16], s0), V::add(w[(t - 7) % 16], s1));
+      }
+      const __m256i s1 = V::bit_xor(
+          V::bit_xor(V::rotr<6>(v[4]), V::rotr<11>(v[4])), V::rotr<25>(v[4]));
+      const __m256i ch =
+          V::bit_xor(V::bit_and(v[4], v[5]), V::and_not(v[4], v[6]));
+      const __m256i t1 =
+          V::add(V::add(V::add(v[7], s1), V::add(ch, w[t % 16])),
+                 V::constant(kSha256K[t]));
+      const __m256i s0 = V::bit_xor(
+          V::bit_xor(V::rotr<2>(v[0]), V::rotr<13>(v[0])), V::rotr<22>(v[0]));
+      const __m256i maj = V::bit_or(V::bit_and(v[0], v[1]),
+                                    V::bit_and(v[2], V::bit_or(v[0], v[1])));
+      v[7] = v[6];
+      v[6] = v[5];
+      v[5] = v[4];
+      v[4] = V::add(v[3], t1);
+      v[3] = v[2];
+      v[2] = v[1];
+      v[1] = v[0];
+      v[0] = V::add(t1, V::add(s0, maj));
+    }
+    for (int i = 0; i < 8; ++i) h[i] = V::add(h[i], v[i]);
+  }
+  for (int i = 0; i < 8; ++i) store_state_x8(state, i, h[i]);
+}
+#endif
+
+// ----------------------------------------------------------------------------
+// Streaming state
+// ----------------------------------------------------------------------------
+
+/**
+ * Merkle-Damgard framing shared by MD5, SHA-1 and SHA-2: whole blocks go
+ * straight from the caller's buffer to COMPRESS, only a partial block is
+ * copied.
+ */
+template <typename Word, size_t kBlockSize>
+struct MdState {
+  using Compress = void (*)(Word* state, const unsigned char* blocks,
+                            size_t count);
+
+  std::array<Word, 8> state{};
+  Compress compress = nullptr;
+  std::array<unsigned char, kBlockSize> buffer{};
+  size_t buffered = 0;
+  std::uint64_t length = 0;  // Bytes, including whole blocks hashed elsewhere
+
+  void update(const unsigned char* p, size_t n) {
+    length += n;
+    if (buffered != 0) {
+      const size_t take = std::min(n, kBlockSize - buffered);
+      std::copy_n(p, take, buffer.data() + buffered);
+      buffered += take;
+      p += take;
+      n -= take;
+      if (buffered < kBlockSize) return;
+      compress(state.data(), buffer.data(), 1);
+      buffered = 0;
+    }
+    if (n >= kBlockSize) {
+      compress(state.data(), p, n / kBlockSize);
+      p += n / kBlockSize * kBlockSize;
+      n %= kBlockSize;
+    }
+    std::copy_n(p, n, buffer.data());
+    buffered = n;
+  }
+
+  // 0x80, zeros, then the length in bits in the last 8 bytes. SHA-512's
+  // length field is 16 bytes, but the upper half is zero for any real input.
+  void pad(bool big_endian) {
+    const std::uint64_t bits = length * 8;
+    buffer[buffered++] = 0x80;
+    const size_t length_field = kBlockSize / 8;
+    if (buffered > kBlockSize - length_field) {
+      std::fill(buffer.begin() + buffered, buffer.end(), 0);
+      compress(state.data(), buffer.data(), 1);
+      buffered = 0;
+    }
+    std::fill(buffer.begin() + buffered, buffer.end() - 8, 0);
+    if (big_endian) {
+      store_be(buffer.data() + kBlockSize - 8, bits);
+    } else {
+      store_le(buffer.data() + kBlockSize - 8, bits);
+    }
+    compress(state.data(), buffer.data(), 1);
+    buffered = 0;
+  }
+};
+
+using Md32 = MdState<std::uint32_t, 64>;
+using Md64 = MdState<std::uint64_t, 128>;
+
+inline auto sha1_kernel() -> Md32::Compress {
+#ifdef WINUX_HASH_X86
+  const CpuFeatures& cpu = cpu_features();
+  if (cpu.sha && cpu.sse41 && cpu.ssse3) return sha1_compress_shani;
+#endif
+  return sha1_compress;
+}
+
+inline auto sha256_kernel() -> Md32::Compress {
+#ifdef WINUX_HASH_X86
+  const CpuFeatures& cpu = cpu_features();
+  if (cpu.sha && cpu.sse41 && cpu.ssse3) return sha256_compress_shani;
+#endif
+  return sha256_compress;
+}
+
+inline auto make_md32(HashAlgorithm algorithm) -> Md32 {
+  Md32 s;
+  switch (algorithm) {
+    case HashAlgorithm::Md5:
+      s.state = {0x67452301u, 0xefcdab89u, 0x98badcfeu, 0x10325476u};
+      s.compress = md5_compress;
+      break;
+    case HashAlgorithm::Sha1:
+      s.state = {0x67452301u, 0xefcdab89u, 0x98badcfeu, 0x10325476u,
+                 0xc3d2e1f0u};
+      s.compress = sha1_kernel();
+      break;
+    case HashAlgorithm::Sha224:
+      s.state = kSha224Init;
+      s.compress = sha256_kernel();
+      break;
+    default:
+      s.state = kSha256Init;
+      s.compress = sha256_kernel();
+      break;
+  }
+  return s;
+}
+
+inline auto finish_md32(Md32& s, HashAlgorithm algorithm) -> Digest {
+  const bool md5 = algorithm == HashAlgorithm::Md5;
+  s.pad(!md5);
+  Digest digest;
+  digest.size = digest_size(algorithm);
+  for (size_t i = 0; i < digest.size / 4; ++i) {
+    if (md5) {
+      store_le(digest.bytes.data() + 4 * i, s.state[i]);
+    } else {
+      store_be(digest.bytes.data() + 4 * i, s.state[i]);
+    }
+  }
+  return digest;
+}
+
+/**
+ * BLAKE2b, unkeyed, with a digest of 1 to 64 bytes. The last block has to
+ * be compressed with a flag set, so a full buffer is only flushed once more
+ * input arrives.
+ */
+struct Blake2bState {
+  std::array<std::uint64_t, 8> h{};
+  std::uint64_t t0 = 0;
+  std::uint64_t t1 = 0;
+  std::array<unsigned char, 128> buffer{};
+  size_t buffered = 0;
+  size_t out_size = 64;
+
+  explicit Blake2bState(size_t size) : h(kSha512Init), out_size(size) {
+    h[0] ^= 0x01010000u ^ static_cast<std::uint64_t>(size);
+  }
+
+  void update(const unsigned char* p, size_t n) {
+    if (n == 0) return;
+    if (buffered != 0) {
+      const size_t take = std::min(n, buffer.size() - buffered);
+      std::copy_n(p, take, buffer.data() + buffered);
+      buffered += take;
+      p += take;
+      n -= take;
+      if (n == 0) return;
+      count(buffer.size());
+      compress(buffer.data(), false);
+      buffered = 0;
+    }
+    for (; n > buffer.size(); p += buffer.size(), n -= buffer.size()) {
+      count(buffer.size());
+      compress(p, false);
+    }
+    std::copy_n(p, n, buffer.data());
+    buffered = n;
+  }
+
+  auto finish() -> Digest {
+    count(buffered);
+    std::fill(buffer.begin() + buffered, buffer.end(), 0);
+    compress(buffer.data(), true);
+    Digest digest;
+    digest.size = out_size;
+    unsigned char full[64];
+    for (size_t i = 0; i < 8; ++i) store_le(full + 8 * i, h[i]);
+    std::copy_n(full, out_size, digest.bytes.data());
+    return digest;
+  }
+
+ private:
+  void count(size_t n) {
+    t0 += n;
+    if (t0 < n) ++t1;
+  }
+
+  void compress(const unsigned char* block, bool last) {
+    std::uint64_t m[16];
+    for (size_t i = 0; i < 16; ++i) m[i] = load_le64(block + 8 * i);
+    std::uint64_t v[16];
+    for (size_t i = 0; i < 8; ++i) {
+      v[i] = h[i];
+      v[i + 8] = kSha512Init[i];
+    }
+    v[12] ^= t0;
+    v[13] ^= t1;
+    if (last) v[14] = ~v[14];
+
+    auto g = [&v](int a, int b, int c, int d, std::uint64_t x,
+                  std::uint64_t y) {
+      v[a] = v[a] + v[b] + x;
+      v[d] = std::rotr(v[d] ^ v[a], 32);
+      v[c] = v[c] + v[d];
+      v[b] = std::rotr(v[b] ^ v[c], 24);
+      v[a] = v[a] + v[b] + y;
+      v[d] = std::rotr(v[d] ^ v[a], 16);
+      v[c] = v[c] + v[d];
+      v[b] = std::rotr(v[b] ^ v[c], 63);
+    };
+    for (const auto& s : kBlake2bSigma) {
+      g(0, 4, 8, 12, m[s[0]], m[s[1]]);
+      g(1, 5, 9, 13, m[s[2]], m[s[3]]);
+      g(2, 6, 10, 14, m[s[4]], m[s[5]]);
+      g(3, 7, 11, 15, m[s[6]], m[s[7]]);
+      g(0, 5, 10, 15, m[s[8]], m[s[9]]);
+      g(1, 6, 11, 12, m[s[10]], m[s[11]]);
+      g(2, 7, 8, 13, m[s[12]], m[s[13]]);
+      g(3, 4, 9, 14, m[s[14]], m[s[15]]);
+    }
+    for (size_t i = 0; i < 8; ++i) h[i] ^= v[i] ^ v[i + 8];
+  }
+};
+
+// The eight-lane AVX2 kernel for ALGORITHM, or nullptr where the one-stream
+// code is as fast on this CPU
+inline auto multi_buffer_kernel(HashAlgorithm algorithm) -> CompressX8 {
+#ifdef WINUX_HASH_X86
+  const CpuFeatures& cpu = cpu_features();
+  if (!cpu.avx2) return nullptr;
+  // One SHA-NI stream hashes SHA-256 about as fast as eight AVX2 lanes; for
+  // SHA-1 the lanes still win, and tails go to SHA-NI anyway
+  const bool shani = cpu.sha && cpu.sse41 && cpu.ssse3;
+  switch (algorithm) {
+    case HashAlgorithm::Md5:
+      return md5_x8;
+    case HashAlgorithm::Sha1:
+      return sha1_x8;
+    case HashAlgorithm::Sha224:
+    case HashAlgorithm::Sha256:
+      return shani ? nullptr : sha256_x8;
+    default:
+      break;
+  }
+#endif
+  (void)algorithm;
+  return nullptr;
+}
+
+}  // namespace hash_detail
+
+/**
+ * @brief Incremental message digest.
+ *
+ * Feed the message with update() in blocks of any size, then call finish()
+ * once. SHA-1 and SHA-256 use the SHA-NI instructions when the CPU has them
+ * (checked once at run time); everything else is portable C++.
+ */
+export class Hasher {
+ public:
+  /**
+   * @param algorithm Digest to compute
+   * @param size Digest length in bytes; only BLAKE2b allows a shorter one
+   *             (1..64), 0 means the algorithm's full length
+   */
+  explicit Hasher(HashAlgorithm algorithm, size_t size = 0)
+      : algorithm_(algorithm), state_(make_state(algorithm, size)) {}
+
+  void update(std::string_view data) {
+    const auto* p = reinterpret_cast<const unsigned char*>(data.data());
+    std::visit([&](auto& s) { s.update(p, data.size()); }, state_);
+  }
+
+  /// Ends the message. The hasher is not usable afterwards.
+  [[nodiscard]] auto finish() -> Digest {
+    if (auto* md32 = std::get_if<hash_detail::Md32>(&state_)) {
+      return hash_detail::finish_md32(*md32, algorithm_);
+    }
+    if (auto* blake = std::get_if<hash_detail::Blake2bState>(&state_)) {
+      return blake->finish();
+    }
+    auto& md64 = std::get<hash_detail::Md64>(state_);
+    md64.pad(true);
+    Digest digest;
+    digest.size = digest_size(algorithm_);
+    for (size_t i = 0; i < digest.size / 8; ++i) {
+      hash_detail::store_be(digest.bytes.data() + 8 * i, md64.state[i]);
+    }
+    return digest;
+  }
+
+ private:
+  using State = std::variant<hash_detail::Md32, hash_detail::Md64,
+                             hash_detail::Blake2bState>;
+
+  static auto make_state(HashAlgorithm algorithm, size_t size) -> State {
+    switch (algorithm) {
+      case HashAlgorithm::Sha384:
+      case HashAlgorithm::Sha512: {
+        hash_detail::Md64 s;
+        s.state = algorithm == HashAlgorithm::Sha384 ? hash_detail::kSha384Init
+                                                     : hash_detail::kSha512Init;
+        s.compress = hash_detail::sha512_compress;
+        return s;
+      }
+      case HashAlgorithm::Blake2b:
+        return hash_detail::Blake2bState(size == 0 ? 64
+                                                   : std::min<size_t>(size, 64));
+      default:
+        return hash_detail::make_md32(algorithm);
+    }
+  }
+
+  HashAlgorithm algorithm_;
+  State state_;
+};
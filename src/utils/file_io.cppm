@@ -6,55 +6,458 @@
 module;
 
 #include "pch/pch.h"
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 export module utils:file_io;
 
 import std;
 import :utf8;
+import :channel;
 
 /**
- * @brief Read file into lines
- * @param filename File path
- * @return Vector of lines (empty on error)
+ * @brief How a mapped file is going to be walked.
+ *
+ * Passed to the OS as a read-ahead hint: FILE_FLAG_SEQUENTIAL_SCAN /
+ * FILE_FLAG_RANDOM_ACCESS and PrefetchVirtualMemory on Windows, madvise() on
+ * POSIX.
  */
-export std::vector<std::string> read_file_lines(const std::string& filename) {
-  std::vector<std::string> lines;
+export enum class AccessHint { Normal, Sequential, Random };
+
+/**
+ * @brief Read-only view of a whole file.
+ *
+ * Regular files are memory-mapped; pipes, consoles and other non-seekable
+ * inputs (or a mapping failure) fall back to reading everything into an
+ * owned buffer, so callers always get one contiguous byte range. Unlike the
+ * GetFileSizeEx + ReadFile pattern, sizes are never squeezed through a DWORD.
+ */
+export class MappedFile {
+ public:
+  MappedFile() = default;
+  ~MappedFile() { release(); }
+
+  MappedFile(MappedFile&& other) noexcept { *this = std::move(other); }
+  MappedFile& operator=(MappedFile&& other) noexcept {
+    if (this == &other) return *this;
+    release();
+    view_base_ = std::exchange(other.view_base_, nullptr);
+    view_length_ = std::exchange(other.view_length_, 0);
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    owned_ = std::move(other.owned_);
+    if (view_base_ == nullptr && !owned_.empty()) data_ = owned_.data();
+    return *this;
+  }
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  /**
+   * @brief Open PATH for reading.
+   * @param path UTF-8 file path
+   * @param hint Expected access pattern
+   * @return The mapped (or buffered) file, or an error message
+   */
+  static auto open(const std::string& path, AccessHint hint = AccessHint::Normal)
+      -> std::expected<MappedFile, std::string> {
+#ifdef _WIN32
+    DWORD flags = FILE_ATTRIBUTE_NORMAL;
+    if (hint == AccessHint::Sequential) flags |= FILE_FLAG_SEQUENTIAL_SCAN;
+    if (hint == AccessHint::Random) flags |= FILE_FLAG_RANDOM_ACCESS;
+
+    std::wstring wpath = utf8_to_wstring(path);
+    HANDLE handle = CreateFileW(
+        wpath.c_str(), GENERIC_READ,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+        OPEN_EXISTING, flags, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+      return std::unexpected("cannot open '" + path + "'");
+    }
+    auto result = from_handle(handle, hint);
+    CloseHandle(handle);
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return std::unexpected("cannot open '" + path + "'");
+    auto result = from_fd(fd, hint);
+    ::close(fd);
+#endif
+    if (!result) return std::unexpected(result.error() + " '" + path + "'");
+    return result;
+  }
+
+  /**
+   * @brief Take all of standard input.
+   *
+   * Standard input redirected from a file is mapped from its current
+   * position; pipes, the console and in-process pipeline channels are read
+   * to end of input.
+   */
+  static auto from_stdin(AccessHint hint = AccessHint::Normal)
+      -> std::expected<MappedFile, std::string> {
+    if (thread_stdin_channel() != nullptr) {
+      MappedFile file;
+      file.owned_.assign(std::istreambuf_iterator<char>(stdin_stream()),
+                         std::istreambuf_iterator<char>());
+      file.adopt_owned();
+      return file;
+    }
+#ifdef _WIN32
+    HANDLE handle = thread_stdin_handle();
+    if (handle == nullptr || handle == INVALID_HANDLE_VALUE ||
+        GetFileType(handle) == FILE_TYPE_CHAR) {
+      // Interactive input keeps the C runtime's line editing and Ctrl+Z.
+      MappedFile file;
+      file.owned_.assign(std::istreambuf_iterator<char>(stdin_stream()),
+                         std::istreambuf_iterator<char>());
+      file.adopt_owned();
+      return file;
+    }
+    auto result = from_handle(handle, hint);
+#else
+    auto result = from_fd(STDIN_FILENO, hint);
+#endif
+    if (!result) return std::unexpected(result.error() + " standard input");
+    return result;
+  }
 
-  std::wstring wfilename = utf8_to_wstring(filename);
-  HANDLE hFile = CreateFileW(wfilename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  [[nodiscard]] auto data() const -> const char* { return data_; }
+  [[nodiscard]] auto size() const -> size_t { return size_; }
+  [[nodiscard]] auto empty() const -> bool { return size_ == 0; }
+  [[nodiscard]] auto view() const -> std::string_view {
+    return {data_, size_};
+  }
+  /// False when the content was read into memory instead of mapped.
+  [[nodiscard]] auto is_mapped() const -> bool { return view_base_ != nullptr; }
+
+  /**
+   * @brief Re-hint part of the file, e.g. before walking it backwards.
+   */
+  void advise(AccessHint hint, size_t offset = 0,
+              size_t length = std::numeric_limits<size_t>::max()) const {
+    if (view_base_ == nullptr || offset >= size_) return;
+    length = std::min(length, size_ - offset);
+#ifdef _WIN32
+#if _WIN32_WINNT >= 0x0602
+    if (hint == AccessHint::Sequential) {
+      WIN32_MEMORY_RANGE_ENTRY range{const_cast<char*>(data_ + offset), length};
+      PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+    }
+#endif
+#else
+    // madvise() wants a page-aligned start.
+    const auto page = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    const auto begin = reinterpret_cast<uintptr_t>(data_ + offset);
+    const auto aligned = begin & ~(page - 1);
+    const int advice = hint == AccessHint::Sequential ? MADV_SEQUENTIAL
+                       : hint == AccessHint::Random   ? MADV_RANDOM
+                                                      : MADV_NORMAL;
+    ::madvise(reinterpret_cast<void*>(aligned), length + (begin - aligned),
+              advice);
+#endif
+  }
+
+ private:
+  static constexpr size_t kReadChunk = 1024 * 1024;
 
-  if (hFile == INVALID_HANDLE_VALUE) {
-    return lines;
+  void adopt_owned() {
+    data_ = owned_.empty() ? nullptr : owned_.data();
+    size_ = owned_.size();
   }
 
-  LARGE_INTEGER fileSize;
-  GetFileSizeEx(hFile, &fileSize);
+  void release() {
+    if (view_base_ != nullptr) {
+#ifdef _WIN32
+      UnmapViewOfFile(view_base_);
+#else
+      ::munmap(view_base_, view_length_);
+#endif
+    }
+    view_base_ = nullptr;
+    view_length_ = 0;
+    data_ = nullptr;
+    size_ = 0;
+    owned_.clear();
+  }
+
+#ifdef _WIN32
+  static auto from_handle(HANDLE handle, AccessHint hint)
+      -> std::expected<MappedFile, std::string> {
+    MappedFile file;
+    LARGE_INTEGER size{};
+    LARGE_INTEGER position{};
+    if (GetFileType(handle) == FILE_TYPE_DISK && GetFileSizeEx(handle, &size) &&
+        SetFilePointerEx(handle, LARGE_INTEGER{}, &position, FILE_CURRENT)) {
+      if (static_cast<std::uint64_t>(size.QuadPart) >
+          std::numeric_limits<size_t>::max()) {
+        return std::unexpected(std::string("file too large to map:"));
+      }
+      if (position.QuadPart >= size.QuadPart) return file;
 
-  if (fileSize.QuadPart > 0) {
-    std::string content;
-    content.resize(fileSize.QuadPart);
-    DWORD bytesRead;
-    ReadFile(hFile, content.data(), static_cast<DWORD>(fileSize.QuadPart), &bytesRead, nullptr);
-    content.resize(bytesRead);
+      // CreateFileMapping rejects empty files; those were handled above.
+      HANDLE mapping =
+          CreateFileMappingW(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+      if (mapping != nullptr) {
+        void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);
+        if (view != nullptr) {
+          file.view_base_ = view;
+          file.view_length_ = static_cast<size_t>(size.QuadPart);
+          file.data_ = static_cast<const char*>(view) + position.QuadPart;
+          file.size_ = static_cast<size_t>(size.QuadPart - position.QuadPart);
+          // Leave the handle positioned as if the data had been read.
+          SetFilePointerEx(handle, size, nullptr, FILE_BEGIN);
+          if (hint != AccessHint::Normal) file.advise(hint);
+          return file;
+        }
+      }
+    }
 
-    // Skip UTF-8 BOM if present
-    size_t start = 0;
-    if (bytesRead >= 3 && (unsigned char)content[0] == 0xEF &&
-        (unsigned char)content[1] == 0xBB && (unsigned char)content[2] == 0xBF) {
-      start = 3;
+    // Pipes, devices, or a failed mapping: read to end of input.
+    for (;;) {
+      const size_t used = file.owned_.size();
+      file.owned_.resize(used + kReadChunk);
+      DWORD got = 0;
+      const BOOL ok = ReadFile(handle, file.owned_.data() + used,
+                               static_cast<DWORD>(kReadChunk), &got, nullptr);
+      file.owned_.resize(used + got);
+      if (!ok) {
+        if (GetLastError() == ERROR_BROKEN_PIPE) break;
+        return std::unexpected(std::string("error reading"));
+      }
+      if (got == 0) break;
+    }
+    file.adopt_owned();
+    return file;
+  }
+#else
+  static auto from_fd(int fd, AccessHint hint)
+      -> std::expected<MappedFile, std::string> {
+    MappedFile file;
+    struct stat st {};
+    if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+      const off_t position = ::lseek(fd, 0, SEEK_CUR);
+      if (static_cast<std::uint64_t>(st.st_size) >
+          std::numeric_limits<size_t>::max()) {
+        return std::unexpected(std::string("file too large to map:"));
+      }
+      if (position >= 0 && position >= st.st_size) return file;
+      if (position >= 0) {
+        void* view = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ,
+                            MAP_PRIVATE, fd, 0);
+        if (view != MAP_FAILED) {
+          file.view_base_ = view;
+          file.view_length_ = static_cast<size_t>(st.st_size);
+          file.data_ = static_cast<const char*>(view) + position;
+          file.size_ = static_cast<size_t>(st.st_size - position);
+          ::lseek(fd, 0, SEEK_END);
+          if (hint != AccessHint::Normal) file.advise(hint);
+          return file;
+        }
+      }
     }
 
-    // Split into lines
-    std::istringstream iss(content.substr(start));
-    std::string line;
-    while (std::getline(iss, line)) {
-      // Remove trailing CR if present
-      if (!line.empty() && line.back() == '\r') {
-        line.pop_back();
+    for (;;) {
+      const size_t used = file.owned_.size();
+      file.owned_.resize(used + kReadChunk);
+      const ssize_t got = ::read(fd, file.owned_.data() + used, kReadChunk);
+      if (got < 0 && errno == EINTR) {
+        file.owned_.resize(used);
+        continue;
       }
-      lines.push_back(line);
+      file.owned_.resize(used + (got > 0 ? static_cast<size_t>(got) : 0));
+      if (got < 0) return std::unexpected(std::string("error reading"));
+      if (got == 0) break;
     }
+    file.adopt_owned();
+    return file;
+  }
+#endif
+
+  void* view_base_ = nullptr;
+  size_t view_length_ = 0;
+  const char* data_ = nullptr;
+  size_t size_ = 0;
+  std::vector<char> owned_;
+};
+
+/**
+ * @brief Reads a file, or standard input, one fixed-size block at a time.
+ *
+ * For checksums and other single passes over inputs that may be far larger
+ * than memory: one buffer is reused for the whole file, and files are opened
+ * with a sequential-scan hint so the OS reads ahead. "-" is standard input;
+ * in-process pipeline channels and the console go through stdin_stream().
+ */
+export class BlockReader {
+ public:
+  static constexpr size_t kDefaultBlock = 1024 * 1024;
+
+  BlockReader(BlockReader&& other) noexcept
+      : name_(std::move(other.name_)),
+        buffer_(std::move(other.buffer_)),
+        stream_(std::exchange(other.stream_, nullptr)),
+#ifdef _WIN32
+        handle_(std::exchange(other.handle_, INVALID_HANDLE_VALUE)),
+#else
+        fd_(std::exchange(other.fd_, -1)),
+#endif
+        owns_(std::exchange(other.owns_, false)),
+        total_(other.total_) {
+  }
+  BlockReader& operator=(BlockReader&&) = delete;
+  BlockReader(const BlockReader&) = delete;
+  BlockReader& operator=(const BlockReader&) = delete;
+  ~BlockReader() {
+    if (!owns_) return;
+#ifdef _WIN32
+    CloseHandle(handle_);
+#else
+    ::close(fd_);
+#endif
+  }
+
+  /**
+   * @brief Open PATH for reading.
+   * @param path UTF-8 file path, or "-" for standard input
+   * @param block_size Largest block next() returns
+   * @return The reader, or an error message
+   */
+  static auto open(const std::string& path, size_t block_size = kDefaultBlock)
+      -> std::expected<BlockReader, std::string> {
+    BlockReader reader(path, block_size);
+    if (path == "-") {
+      if (thread_stdin_channel() != nullptr) {
+        reader.stream_ = &stdin_stream();
+        return reader;
+      }
+#ifdef _WIN32
+      HANDLE handle = thread_stdin_handle();
+      if (handle == nullptr || handle == INVALID_HANDLE_VALUE ||
+          GetFileType(handle) == FILE_TYPE_CHAR) {
+        reader.stream_ = &stdin_stream();
+        return reader;
+      }
+      reader.handle_ = handle;
+#else
+      reader.fd_ = STDIN_FILENO;
+#endif
+      return reader;
+    }
+
+#ifdef _WIN32
+    std::wstring wpath = utf8_to_wstring(path);
+    HANDLE handle = CreateFileW(
+        wpath.c_str(), GENERIC_READ,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+        nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+      return std::unexpected("cannot open '" + path + "' for reading");
+    }
+    reader.handle_ = handle;
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      return std::unexpected("cannot open '" + path + "' for reading");
+    }
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    reader.fd_ = fd;
+#endif
+    reader.owns_ = true;
+    return reader;
+  }
+
+  /**
+   * @brief The next block of input.
+   * @return Up to the block size in bytes, empty at end of input, or an
+   *         error message. The view is valid until the next call.
+   */
+  auto next() -> std::expected<std::string_view, std::string> {
+    char* data = buffer_.data();
+    size_t got = 0;
+    if (stream_ != nullptr) {
+      stream_->read(data, static_cast<std::streamsize>(buffer_.size()));
+      got = static_cast<size_t>(stream_->gcount());
+      if (stream_->bad()) return std::unexpected(read_error());
+    } else {
+#ifdef _WIN32
+      DWORD n = 0;
+      if (!ReadFile(handle_, data, static_cast<DWORD>(buffer_.size()), &n,
+                    nullptr) &&
+          GetLastError() != ERROR_BROKEN_PIPE) {
+        return std::unexpected(read_error());
+      }
+      got = n;
+#else
+      ssize_t n;
+      do {
+        n = ::read(fd_, data, buffer_.size());
+      } while (n < 0 && errno == EINTR);
+      if (n < 0) return std::unexpected(read_error());
+      got = static_cast<size_t>(n);
+#endif
+    }
+    total_ += got;
+    return std::string_view(data, got);
+  }
+
+  /// Bytes returned by next() so far.
+  [[nodiscard]] auto total() const -> std::uint64_t { return total_; }
+
+ private:
+  BlockReader(const std::string& name, size_t block_size)
+      : name_(name), buffer_(std::max<size_t>(block_size, 1)) {}
+
+  auto read_error() const -> std::string {
+    return name_ == "-" ? std::string("error reading standard input")
+                        : "error reading '" + name_ + "'";
+  }
+
+  std::string name_;
+  std::vector<char> buffer_;
+  std::istream* stream_ = nullptr;
+#ifdef _WIN32
+  HANDLE handle_ = INVALID_HANDLE_VALUE;
+#else
+  int fd_ = -1;
+#endif
+  bool owns_ = false;
+  std::uint64_t total_ = 0;
+};
+
+/**
+ * @brief Read file into lines
+ * @param filename File path
+ * @return Vector of lines (empty on error)
+ */
+export std::vector<std::string> read_file_lines(const std::string& filename) {
+  std::vector<std::string> lines;
+
+  auto file = MappedFile::open(filename, AccessHint::Sequential);
+  if (!file) return lines;
+
+  std::string_view content = file->view();
+  // Skip UTF-8 BOM if present
+  if (content.size() >= 3 && static_cast<unsigned char>(content[0]) == 0xEF &&
+      static_cast<unsigned char>(content[1]) == 0xBB &&
+      static_cast<unsigned char>(content[2]) == 0xBF) {
+    content.remove_prefix(3);
+  }
+
+  // Split into lines
+  while (!content.empty()) {
+    const size_t end = content.find('\n');
+    std::string_view line = content.substr(0, end);
+    // Remove trailing CR if present
+    if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+    lines.emplace_back(line);
+    if (end == std::string_view::npos) break;
+    content.remove_prefix(end + 1);
   }
 
-  CloseHandle(hFile);
   return lines;
-}
\ No newline at end of file
+}
@@ -0,0 +1,173 @@
+/// @Author: caomengxuan666
+/// @Description: Digests of files, one stream or eight at a time
+/// @Version: 0.1.0
+/// @License: MIT
+/// @Copyright: Copyright © 2026 WinuxCmd
+export module utils:hash;
+
+import std;
+export import :digest;
+import :file_io;
+
+export using HashResult = std::expected<Digest, std::string>;
+
+/**
+ * @brief Digest of one file ("-" for standard input), read in 1 MiB blocks.
+ */
+export auto hash_file(HashAlgorithm algorithm, size_t size,
+                      const std::string& path) -> HashResult {
+  auto reader = BlockReader::open(path);
+  if (!reader) return std::unexpected(reader.error());
+  Hasher hasher(algorithm, size);
+  for (;;) {
+    auto block = reader->next();
+    if (!block) return std::unexpected(block.error());
+    if (block->empty()) break;
+    hasher.update(*block);
+  }
+  return hasher.finish();
+}
+
+namespace hash_detail {
+
+// Fewer busy lanes than this are cheaper on the one-stream code
+constexpr size_t kMinLanes = 3;
+
+struct Lane {
+  size_t slot;
+  std::optional<BlockReader> reader;
+  Md32 state;
+  std::string_view pending;  // Read but not yet hashed
+};
+
+/**
+ * Hashes up to eight files side by side. Each round, every busy lane is
+ * brought to a block boundary (partial blocks go through its own buffer)
+ * and then as many whole blocks as all lanes have buffered run through
+ * KERNEL together. Idle lanes repeat a busy lane's data and are ignored.
+ */
+inline void hash_lanes(HashAlgorithm algorithm, CompressX8 kernel,
+                       std::span<const std::string> paths,
+                       std::vector<HashResult>& results) {
+  std::vector<Lane> lanes;
+  lanes.reserve(paths.size());
+  for (size_t i = 0; i < paths.size(); ++i) {
+    auto reader = BlockReader::open(paths[i]);
+    if (!reader) {
+      results[i] = std::unexpected(reader.error());
+      continue;
+    }
+    Lane& lane = lanes.emplace_back();
+    lane.slot = i;
+    lane.reader.emplace(std::move(*reader));
+    lane.state = make_md32(algorithm);
+  }
+
+  // False once the lane's file is finished or failed
+  auto settle = [&](Lane& lane) {
+    while (lane.state.buffered != 0 || lane.pending.size() < 64) {
+      if (lane.pending.empty()) {
+        auto block = lane.reader->next();
+        if (!block) {
+          results[lane.slot] = std::unexpected(block.error());
+          return false;
+        }
+        if (block->empty()) {
+          results[lane.slot] = finish_md32(lane.state, algorithm);
+          return false;
+        }
+        lane.pending = *block;
+        continue;
+      }
+      const size_t take =
+          lane.state.buffered != 0
+              ? std::min(lane.pending.size(), 64 - lane.state.buffered)
+              : lane.pending.size();
+      lane.state.update(
+          reinterpret_cast<const unsigned char*>(lane.pending.data()), take);
+      lane.pending.remove_prefix(take);
+    }
+    return true;
+  };
+
+  std::vector<Lane*> busy;
+  for (auto& lane : lanes) busy.push_back(&lane);
+  while (true) {
+    std::erase_if(busy, [&](Lane* lane) { return !settle(*lane); });
+    if (busy.empty()) break;
+
+    if (busy.size() < kMinLanes) {
+      for (Lane* lane : busy) {
+        lane->state.update(
+            reinterpret_cast<const unsigned char*>(lane->pending.data()),
+            lane->pending.size());
+        lane->pending = {};
+      }
+      continue;
+    }
+
+    size_t blocks = std::numeric_limits<size_t>::max();
+    for (Lane* lane : busy) {
+      blocks = std::min(blocks, lane->pending.size() / 64);
+    }
+
+    std::uint32_t words[8][8];
+    const unsigned char* data[8];
+    for (size_t l = 0; l < 8; ++l) {
+      const Lane* lane = busy[l < busy.size() ? l : 0];
+      data[l] = reinterpret_cast<const unsigned char*>(lane->pending.data());
+      for (size_t w = 0; w < 8; ++w) words[w][l] = lane->state.state[w];
+    }
+    kernel(words, data, blocks);
+    for (size_t l = 0; l < busy.size(); ++l) {
+      Lane* lane = busy[l];
+      for (size_t w = 0; w < 8; ++w) lane->state.state[w] = words[w][l];
+      lane->pending.remove_prefix(blocks * 64);
+      lane->state.length += blocks * 64;
+    }
+  }
+}
+
+}  // namespace hash_detail
+
+/**
+ * @brief Digests of several files, reported in order through ON_RESULT.
+ *
+ * Each file is streamed in 1 MiB blocks, so memory does not depend on file
+ * sizes. When the algorithm has an AVX2 multi-buffer kernel that beats the
+ * one-stream code on this CPU (MD5 and SHA-1; SHA-256 only without SHA-NI),
+ * up to eight files are hashed at once, one per vector lane.
+ *
+ * @param on_result Called as on_result(index, result) for every path
+ */
+export template <typename OnResult>
+void hash_files(HashAlgorithm algorithm, size_t size,
+                std::span<const std::string> paths, OnResult&& on_result) {
+  const hash_detail::CompressX8 kernel =
+      hash_detail::multi_buffer_kernel(algorithm);
+  size_t i = 0;
+  while (i < paths.size()) {
+    // Batches never read standard input twice
+    size_t end = i + 1;
+    if (kernel != nullptr) {
+      bool has_stdin = paths[i] == "-";
+      while (end < paths.size() && end - i < 8) {
+        if (paths[end] == "-") {
+          if (has_stdin) break;
+          has_stdin = true;
+        }
+        ++end;
+      }
+    }
+
+    if (end - i < hash_detail::kMinLanes) {
+      for (; i < end; ++i) on_result(i, hash_file(algorithm, size, paths[i]));
+      continue;
+    }
+
+    std::vector<HashResult> results(end - i);
+    hash_detail::hash_lanes(algorithm, kernel, paths.subspan(i, end - i),
+                            results);
+    for (auto& result : results) on_result(i++, std::move(result));
+  }
+}
@@ -0,0 +1,297 @@
+/// @Author: caomengxuan666
+/// @Description: Multi-literal search (Aho-Corasick)
+/// @Version: 0.1.0
+/// @License: MIT
+/// @Copyright: Copyright © 2026 WinuxCmd
+module;
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define WINUX_LITERAL_SSE2 1
+#endif
+export module utils:literal_set;
+
+import std;
+import :regex;
+
+/**
+ * @brief A compiled set of literal strings, searched in one pass.
+ *
+ * Built as an Aho-Corasick automaton with the failure links resolved into a
+ * dense transition table over byte classes (bytes that occur in no pattern
+ * share one class), so scanning costs one table lookup per byte no matter
+ * how many patterns there are. ASCII case folding is part of the byte
+ * classes, so -i needs no lowered copy of the input.
+ *
+ * While the automaton sits in its root state, the scan skips ahead to the
+ * next byte that can start a pattern; for small sets this uses SSE2 to test
+ * 16 positions at a time against the first and second pattern bytes.
+ *
+ * Searching does not modify the set, so one instance can be shared between
+ * threads.
+ */
+export class LiteralSet {
+ public:
+  LiteralSet() = default;
+
+  /**
+   * @brief Compile PATTERNS.
+   * @param icase Fold ASCII letters when matching
+   */
+  static auto compile(std::span<const std::string> patterns, bool icase)
+      -> LiteralSet {
+    LiteralSet set;
+    set.build(patterns, icase);
+    return set;
+  }
+
+  size_t size() const { return pattern_count_; }
+
+  /// Does any pattern occur in TEXT?
+  bool search(std::string_view text) const {
+    if (has_empty_) return true;
+    const size_t n = text.size();
+    std::uint32_t state = 0;
+    for (size_t i = 0; i < n; ++i) {
+      if (state == 0) {
+        i = skip_to_candidate(text, i);
+        if (i >= n) break;
+      }
+      state = next(state, text[i]);
+      if (out_len_[state] != 0) return true;
+    }
+    return false;
+  }
+
+  /// Is TEXT, as a whole, one of the patterns?
+  bool full_match(std::string_view text) const {
+    if (text.empty()) return has_empty_;
+    std::uint32_t state = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+      state = next(state, text[i]);
+      // Falling back along a failure link means TEXT left the trie
+      if (depth_[state] != i + 1) return false;
+    }
+    return out_len_[state] == depth_[state];
+  }
+
+  /**
+   * @brief Call FN(end) for every non-empty pattern that occurs at POS,
+   * shortest first.
+   */
+  template <typename Fn>
+  void for_each_match_at(std::string_view text, size_t pos, Fn&& fn) const {
+    std::uint32_t state = 0;
+    for (size_t i = pos; i < text.size(); ++i) {
+      state = next(state, text[i]);
+      // Falling back along a failure link means the match left POS behind
+      if (depth_[state] != i + 1 - pos) return;
+      if (out_len_[state] == depth_[state]) fn(i + 1);
+    }
+  }
+
+  /// Leftmost-longest occurrence of any pattern at or after FROM
+  auto find(std::string_view text, size_t from = 0) const
+      -> std::optional<RegexMatch> {
+    if (from > text.size()) return std::nullopt;
+    RegexMatch best;
+    if (has_empty_) best = RegexMatch{from, from};
+
+    const size_t n = text.size();
+    std::uint32_t state = 0;
+    for (size_t i = from; i < n; ++i) {
+      if (state == 0 && !best.matched()) {
+        i = skip_to_candidate(text, i);
+        if (i >= n) break;
+      }
+      state = next(state, text[i]);
+      if (std::uint32_t len = out_len_[state]; len != 0) {
+        // The longest pattern ending here gives the leftmost start
+        size_t start = i + 1 - len;
+        if (!best.matched() || start < best.begin) {
+          best = RegexMatch{start, i + 1};
+        } else if (start == best.begin && i + 1 > best.end) {
+          best.end = i + 1;
+        }
+      }
+      // No later match can start at or before the best one any more
+      if (best.matched() && i + 1 - depth_[state] > best.begin) break;
+    }
+    if (!best.matched()) return std::nullopt;
+    return best;
+  }
+
+ private:
+  // Dense transition table: states x classes
+  std::vector<std::uint32_t> trans_;
+  std::vector<std::uint32_t> depth_;
+  // Length of the longest pattern that is a suffix of the state's string
+  std::vector<std::uint32_t> out_len_;
+  std::array<std::uint16_t, 256> class_of_{};
+  std::array<bool, 256> first_byte_{};
+  size_t class_count_ = 1;
+  size_t pattern_count_ = 0;
+  bool has_empty_ = false;
+
+#ifdef WINUX_LITERAL_SSE2
+  static constexpr size_t kMaxSimdBytes = 8;
+  std::array<std::uint8_t, kMaxSimdBytes> simd_first_{};
+  std::array<std::uint8_t, kMaxSimdBytes> simd_second_{};
+  size_t simd_first_count_ = 0;   // 0: prefilter disabled
+  size_t simd_second_count_ = 0;  // 0: first byte only
+#endif
+
+  std::uint32_t next(std::uint32_t state, char c) const {
+    return trans_[state * class_count_ +
+                  class_of_[static_cast<unsigned char>(c)]];
+  }
+
+  static unsigned char fold(unsigned char c, bool icase) {
+    return icase && c >= 'A' && c <= 'Z' ? static_cast<unsigned char>(c + 32)
+                                         : c;
+  }
+
+  void build(std::span<const std::string> patterns, bool icase) {
+    pattern_count_ = patterns.size();
+
+    // Byte classes: one per (folded) byte used by some pattern, plus 0
+    std::array<std::uint16_t, 256> folded_class{};
+    size_t classes = 1;
+    for (const auto& p : patterns) {
+      for (unsigned char c : p) {
+        unsigned char f = fold(c, icase);
+        if (folded_class[f] == 0)
+          folded_class[f] = static_cast<std::uint16_t>(classes++);
+      }
+    }
+    class_count_ = classes;
+    for (int b = 0; b < 256; ++b)
+      class_of_[b] = folded_class[fold(static_cast<unsigned char>(b), icase)];
+
+    // Trie
+    constexpr std::uint32_t kNone = std::numeric_limits<std::uint32_t>::max();
+    trans_.assign(class_count_, kNone);
+    depth_.assign(1, 0);
+    out_len_.assign(1, 0);
+    for (const auto& p : patterns) {
+      if (p.empty()) {
+        has_empty_ = true;
+        continue;
+      }
+      std::uint32_t state = 0;
+      for (unsigned char c : p) {
+        size_t slot = state * class_count_ + class_of_[c];
+        if (trans_[slot] == kNone) {
+          auto fresh = static_cast<std::uint32_t>(depth_.size());
+          trans_[slot] = fresh;
+          depth_.push_back(depth_[state] + 1);
+          out_len_.push_back(0);
+          trans_.resize(trans_.size() + class_count_, kNone);
+        }
+        state = trans_[slot];
+      }
+      out_len_[state] = depth_[state];
+    }
+
+    // Failure links, folded into the table in breadth-first order
+    std::vector<std::uint32_t> fail(depth_.size(), 0);
+    std::vector<std::uint32_t> queue;
+    queue.reserve(depth_.size());
+    for (size_t c = 0; c < class_count_; ++c) {
+      std::uint32_t& t = trans_[c];
+      if (t == kNone) {
+        t = 0;
+      } else {
+        queue.push_back(t);
+      }
+    }
+    for (size_t head = 0; head < queue.size(); ++head) {
+      std::uint32_t u = queue[head];
+      out_len_[u] = std::max(out_len_[u], out_len_[fail[u]]);
+      for (size_t c = 0; c < class_count_; ++c) {
+        std::uint32_t& t = trans_[u * class_count_ + c];
+        std::uint32_t via_fail = trans_[fail[u] * class_count_ + c];
+        if (t == kNone) {
+          t = via_fail;
+        } else {
+          fail[t] = via_fail;
+          queue.push_back(t);
+        }
+      }
+    }
+
+    build_prefilter(patterns, icase);
+  }
+
+  void build_prefilter(std::span<const std::string> patterns, bool icase) {
+    std::array<bool, 256> second{};
+    bool all_long = !patterns.empty();
+    for (const auto& p : patterns) {
+      if (p.empty()) continue;
+      auto mark = [&](std::array<bool, 256>& table, unsigned char c) {
+        table[c] = true;
+        if (icase && std::isalpha(c)) {
+          table[std::tolower(c)] = true;
+          table[std::toupper(c)] = true;
+        }
+      };
+      mark(first_byte_, static_cast<unsigned char>(p[0]));
+      if (p.size() >= 2) mark(second, static_cast<unsigned char>(p[1]));
+      else all_long = false;
+    }
+
+#ifdef WINUX_LITERAL_SSE2
+    auto collect = [](const std::array<bool, 256>& table,
+                      std::array<std::uint8_t, kMaxSimdBytes>& out) {
+      size_t count = 0;
+      for (int b = 0; b < 256; ++b) {
+        if (!table[b]) continue;
+        if (count == kMaxSimdBytes) return size_t{0};
+        out[count++] = static_cast<std::uint8_t>(b);
+      }
+      return count;
+    };
+    simd_first_count_ = collect(first_byte_, simd_first_);
+    simd_second_count_ =
+        simd_first_count_ != 0 && all_long ? collect(second, simd_second_) : 0;
+#else
+    (void)second;
+    (void)all_long;
+#endif
+  }
+
+#ifdef WINUX_LITERAL_SSE2
+  static int match_mask(const char* p, const std::uint8_t* bytes,
+                        size_t count) {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    __m128i hits = _mm_setzero_si128();
+    for (size_t k = 0; k < count; ++k) {
+      hits = _mm_or_si128(
+          hits, _mm_cmpeq_epi8(chunk, _mm_set1_epi8(static_cast<char>(bytes[k]))));
+    }
+    return _mm_movemask_epi8(hits);
+  }
+#endif
+
+  // First index >= I where some pattern could start (or TEXT.size())
+  size_t skip_to_candidate(std::string_view text, size_t i) const {
+    const size_t n = text.size();
+#ifdef WINUX_LITERAL_SSE2
+    if (simd_first_count_ != 0) {
+      const char* data = text.data();
+      while (i + 17 <= n) {
+        int mask = match_mask(data + i, simd_first_.data(), simd_first_count_);
+        if (mask != 0 && simd_second_count_ != 0)
+          mask &= match_mask(data + i + 1, simd_second_.data(),
+                             simd_second_count_);
+        if (mask != 0)
+          return i + static_cast<size_t>(
+                         std::countr_zero(static_cast<unsigned>(mask)));
+        i += 16;
+      }
+    }
+#endif
+    while (i < n && !first_byte_[static_cast<unsigned char>(text[i])]) ++i;
+    return i;
+  }
+};
@@ -0,0 +1,1238 @@
+/// @Author: caomengxuan666
+/// @Description: POSIX BRE/ERE regular expressions with a lazy DFA
+/// @Version: 0.1.0
+/// @License: MIT
+/// @Copyright: Copyright © 2026 WinuxCmd
+export module utils:regex;
+
+import std;
+
+/**
+ * @brief Which POSIX dialect a pattern is written in.
+ *
+ * Basic is what grep -G, sed, expr, csplit and nl use; Extended is grep -E
+ * and sed -E. Both accept the usual GNU escapes (\w \W \s \S \b \B \< \>
+ * \` \') plus \d \D, and Basic additionally accepts \+ \? \|.
+ */
+export enum class RegexSyntax { Basic, Extended };
+
+export struct RegexOptions {
+  RegexSyntax syntax = RegexSyntax::Basic;
+  bool icase = false;
+  /// Record \(...\) groups; only needed when the caller reads them back
+  bool captures = false;
+};
+
+/// Byte offsets of a match or group; npos/npos for a group that did not take part
+export struct RegexMatch {
+  static constexpr size_t npos = static_cast<size_t>(-1);
+  size_t begin = npos;
+  size_t end = npos;
+
+  bool matched() const { return begin != npos; }
+  size_t size() const { return matched() ? end - begin : 0; }
+};
+
+namespace regex_impl {
+
+using ByteSet = std::bitset<256>;
+
+// Keeps {m,n} expansion and nesting from producing unbounded programs.
+constexpr int kMaxRepeat = 1000;
+constexpr int kMaxDepth = 500;
+constexpr size_t kMaxProgram = 200000;
+constexpr size_t kMaxLiteral = 256;
+// Lazy DFA cache budget in bytes; the cache is flushed and rebuilt when
+// exceeded.
+constexpr size_t kDfaCacheBytes = 8 * 1024 * 1024;
+
+enum class AssertKind : std::uint8_t {
+  TextStart,
+  TextEnd,
+  WordBoundary,
+  NotWordBoundary,
+  WordStart,
+  WordEnd
+};
+
+struct Node {
+  enum class Kind : std::uint8_t {
+    Empty,
+    Set,
+    Concat,
+    Alternate,
+    Repeat,
+    Group,
+    Assert
+  } kind = Kind::Empty;
+  ByteSet set;
+  std::vector<int> children;
+  int min = 0;
+  int max = -1;  // -1: unbounded
+  int group = 0;
+  AssertKind assert_kind = AssertKind::TextStart;
+};
+
+inline bool is_word_byte(unsigned char c) {
+  return std::isalnum(c) || c == '_';
+}
+
+inline void fold_case(ByteSet& set) {
+  for (int c = 'a'; c <= 'z'; ++c) {
+    int u = c - 'a' + 'A';
+    if (set[c] || set[u]) {
+      set.set(c);
+      set.set(u);
+    }
+  }
+}
+
+// ----------------------------------------------------------------------
+// Parser: pattern text -> syntax tree
+// ----------------------------------------------------------------------
+class Parser {
+ public:
+  Parser(std::string_view pattern, const RegexOptions& opts)
+      : p_(pattern), ere_(opts.syntax == RegexSyntax::Extended),
+        icase_(opts.icase) {}
+
+  auto parse() -> std::expected<int, std::string_view> {
+    int root = parse_alternation(0);
+    if (!error_.empty()) return std::unexpected(error_);
+    if (pos_ < p_.size()) return std::unexpected("unmatched ) or \\)");
+    return root;
+  }
+
+  std::vector<Node> nodes;
+  int groups = 0;
+  bool backrefs = false;  // Parsing stopped at \1..\9
+
+ private:
+  std::string_view p_;
+  size_t pos_ = 0;
+  bool ere_;
+  bool icase_;
+  std::string_view error_;
+
+  int add(Node n) {
+    nodes.push_back(std::move(n));
+    return static_cast<int>(nodes.size() - 1);
+  }
+
+  int fail(std::string_view msg) {
+    if (error_.empty()) error_ = msg;
+    return -1;
+  }
+
+  int add_set(ByteSet set) {
+    if (icase_) fold_case(set);
+    return add_raw_set(set);
+  }
+
+  int add_raw_set(const ByteSet& set) {
+    Node n;
+    n.kind = Node::Kind::Set;
+    n.set = set;
+    return add(std::move(n));
+  }
+
+  int add_byte(unsigned char c) {
+    ByteSet s;
+    s.set(c);
+    return add_set(s);
+  }
+
+  int add_assert(AssertKind k) {
+    Node n;
+    n.kind = Node::Kind::Assert;
+    n.assert_kind = k;
+    return add(std::move(n));
+  }
+
+  bool at_alternation() const {
+    if (pos_ >= p_.size()) return false;
+    if (ere_) return p_[pos_] == '|';
+    return p_[pos_] == '\\' && pos_ + 1 < p_.size() && p_[pos_ + 1] == '|';
+  }
+
+  bool at_group_close() const {
+    if (pos_ >= p_.size()) return false;
+    if (ere_) return p_[pos_] == ')';
+    return p_[pos_] == '\\' && pos_ + 1 < p_.size() && p_[pos_ + 1] == ')';
+  }
+
+  int parse_alternation(int depth) {
+    if (depth > kMaxDepth) return fail("regular expression nested too deeply");
+    Node alt;
+    alt.kind = Node::Kind::Alternate;
+    alt.children.push_back(parse_concat(depth));
+    while (error_.empty() && at_alternation()) {
+      pos_ += ere_ ? 1 : 2;
+      alt.children.push_back(parse_concat(depth));
+    }
+    if (!error_.empty()) return -1;
+    if (alt.children.size() == 1) return alt.children[0];
+    return add(std::move(alt));
+  }
+
+  int parse_concat(int depth) {
+    Node cat;
+    cat.kind = Node::Kind::Concat;
+    bool at_start = true;
+    while (pos_ < p_.size() && !at_alternation()) {
+      if (at_group_close() && depth > 0) break;
+      if (ere_ && p_[pos_] == ')' && depth == 0) {
+        // An unopened ')' is an ordinary character in GNU EREs
+        ++pos_;
+        cat.children.push_back(parse_quantifiers(add_byte(')')));
+        at_start = false;
+        continue;
+      }
+      bool anchor = false;
+      int atom = parse_atom(depth, at_start, anchor);
+      if (atom < 0) return -1;
+      // A leading ^ keeps the next '*' literal in BREs, as POSIX requires
+      if (!(anchor && !ere_)) atom = parse_quantifiers(atom);
+      if (atom < 0) return -1;
+      cat.children.push_back(atom);
+      at_start = anchor && !ere_ ? at_start : false;
+    }
+    if (cat.children.empty()) {
+      Node empty;
+      return add(std::move(empty));
+    }
+    if (cat.children.size() == 1) return cat.children[0];
+    return add(std::move(cat));
+  }
+
+  bool dollar_is_anchor() const {
+    // In a BRE '$' is only special at the end of the RE or a subexpression
+    size_t next = pos_ + 1;
+    if (next >= p_.size()) return true;
+    if (p_[next] != '\\' || next + 1 >= p_.size()) return false;
+    return p_[next + 1] == ')' || p_[next + 1] == '|';
+  }
+
+  int parse_atom(int depth, bool at_start, bool& anchor) {
+    unsigned char c = static_cast<unsigned char>(p_[pos_]);
+    switch (c) {
+      case '.': {
+        ++pos_;
+        ByteSet all;
+        all.set();
+        return add_set(all);
+      }
+      case '[':
+        ++pos_;
+        return parse_bracket();
+      case '^':
+        ++pos_;
+        if (ere_ || at_start) {
+          anchor = true;
+          return add_assert(AssertKind::TextStart);
+        }
+        return add_byte(c);
+      case '$':
+        if (ere_ || dollar_is_anchor()) {
+          ++pos_;
+          anchor = true;
+          return add_assert(AssertKind::TextEnd);
+        }
+        ++pos_;
+        return add_byte(c);
+      case '*':
+        // Nothing to repeat: literal, as in GNU grep
+        ++pos_;
+        return add_byte(c);
+      case '\\':
+        return parse_escape(depth);
+      default:
+        break;
+    }
+    if (ere_) {
+      if (c == '(') {
+        ++pos_;
+        return parse_group(depth);
+      }
+      if (c == '+' || c == '?' || c == '{') {
+        ++pos_;
+        return add_byte(c);
+      }
+    }
+    ++pos_;
+    return add_byte(c);
+  }
+
+  int parse_group(int depth) {
+    int index = ++groups;
+    int body = parse_alternation(depth + 1);
+    if (body < 0) return -1;
+    if (!at_group_close()) return fail("unmatched ( or \\(");
+    pos_ += ere_ ? 1 : 2;
+    Node g;
+    g.kind = Node::Kind::Group;
+    g.group = index;
+    g.children.push_back(body);
+    return add(std::move(g));
+  }
+
+  int parse_escape(int depth) {
+    if (pos_ + 1 >= p_.size()) return fail("trailing backslash (\\)");
+    unsigned char c = static_cast<unsigned char>(p_[pos_ + 1]);
+    pos_ += 2;
+    if (!ere_) {
+      if (c == '(') return parse_group(depth);
+      if (c == '{' || c == '+' || c == '?') return add_byte(c);
+    }
+    if (c >= '1' && c <= '9') {
+      backrefs = true;
+      return fail("back-references are not supported");
+    }
+    ByteSet s;
+    switch (c) {
+      case 'w':
+      case 'W':
+        for (int b = 0; b < 256; ++b)
+          if (is_word_byte(static_cast<unsigned char>(b))) s.set(b);
+        if (c == 'W') s.flip();
+        return add_raw_set(s);
+      case 's':
+      case 'S':
+        for (int b = 0; b < 256; ++b)
+          if (std::isspace(b)) s.set(b);
+        if (c == 'S') s.flip();
+        return add_raw_set(s);
+      case 'd':
+      case 'D':
+        for (int b = '0'; b <= '9'; ++b) s.set(b);
+        if (c == 'D') s.flip();
+        return add_raw_set(s);
+      case 'b':
+        return add_assert(AssertKind::WordBoundary);
+      case 'B':
+        return add_assert(AssertKind::NotWordBoundary);
+      case '<':
+        return add_assert(AssertKind::WordStart);
+      case '>':
+        return add_assert(AssertKind::WordEnd);
+      case '`':
+        return add_assert(AssertKind::TextStart);
+      case '\'':
+        return add_assert(AssertKind::TextEnd);
+      case 'n':
+        return add_byte('\n');
+      case 't':
+        return add_byte('\t');
+      default:
+        return add_byte(c);
+    }
+  }
+
+  // Parses "m", "m,", ",n" or "m,n" followed by '}' (ERE) or '\}' (BRE).
+  bool parse_interval(int& min, int& max) {
+    size_t save = pos_;
+    auto number = [&](int& out) {
+      size_t start = pos_;
+      long long v = 0;
+      while (pos_ < p_.size() && std::isdigit(static_cast<unsigned char>(p_[pos_]))) {
+        v = std::min<long long>(v * 10 + (p_[pos_] - '0'), kMaxRepeat + 1);
+        ++pos_;
+      }
+      out = static_cast<int>(v);
+      return pos_ > start;
+    };
+    bool has_min = number(min);
+    if (!has_min) min = 0;
+    max = min;
+    if (pos_ < p_.size() && p_[pos_] == ',') {
+      ++pos_;
+      if (!number(max)) max = -1;
+    } else if (!has_min) {
+      pos_ = save;
+      return false;
+    }
+    if (ere_ && pos_ < p_.size() && p_[pos_] == '}') {
+      ++pos_;
+      return true;
+    }
+    if (!ere_ && pos_ + 1 < p_.size() && p_[pos_] == '\\' && p_[pos_ + 1] == '}') {
+      pos_ += 2;
+      return true;
+    }
+    pos_ = save;
+    return false;
+  }
+
+  int parse_quantifiers(int atom) {
+    while (atom >= 0 && pos_ < p_.size()) {
+      int min = 0, max = -1;
+      char c = p_[pos_];
+      if (c == '*') {
+        ++pos_;
+      } else if (ere_ && c == '+') {
+        ++pos_;
+        min = 1;
+      } else if (ere_ && c == '?') {
+        ++pos_;
+        max = 1;
+      } else if (ere_ && c == '{') {
+        ++pos_;
+        if (!parse_interval(min, max)) {
+          // GNU treats a '{' that does not start an interval as literal
+          --pos_;
+          break;
+        }
+      } else if (!ere_ && c == '\\' && pos_ + 1 < p_.size() &&
+                 (p_[pos_ + 1] == '+' || p_[pos_ + 1] == '?' ||
+                  p_[pos_ + 1] == '{')) {
+        char q = p_[pos_ + 1];
+        pos_ += 2;
+        if (q == '+') {
+          min = 1;
+        } else if (q == '?') {
+          max = 1;
+        } else if (!parse_interval(min, max)) {
+          return fail("invalid content of \\{\\}");
+        }
+      } else {
+        break;
+      }
+      if (min > kMaxRepeat || max > kMaxRepeat)
+        return fail("regular expression too big");
+      if (max >= 0 && max < min) return fail("invalid content of \\{\\}");
+      Node rep;
+      rep.kind = Node::Kind::Repeat;
+      rep.min = min;
+      rep.max = max;
+      rep.children.push_back(atom);
+      atom = add(std::move(rep));
+    }
+    return atom;
+  }
+
+  int parse_bracket() {
+    ByteSet set;
+    bool negate = false;
+    if (pos_ < p_.size() && p_[pos_] == '^') {
+      negate = true;
+      ++pos_;
+    }
+    bool first = true;
+    while (true) {
+      if (pos_ >= p_.size()) return fail("unmatched [, [^, [:, [., or [=");
+      unsigned char c = static_cast<unsigned char>(p_[pos_]);
+      if (c == ']' && !first) {
+        ++pos_;
+        break;
+      }
+      first = false;
+      if (c == '[' && pos_ + 1 < p_.size() &&
+          (p_[pos_ + 1] == ':' || p_[pos_ + 1] == '=' || p_[pos_ + 1] == '.')) {
+        char kind = p_[pos_ + 1];
+        size_t close = p_.find(std::string{kind, ']'}, pos_ + 2);
+        if (close == std::string_view::npos)
+          return fail("unmatched [, [^, [:, [., or [=");
+        std::string_view name = p_.substr(pos_ + 2, close - pos_ - 2);
+        pos_ = close + 2;
+        if (kind == ':') {
+          if (!add_class(set, name)) return fail("invalid character class");
+          continue;
+        }
+        if (name.size() != 1) return fail("invalid collation character");
+        c = static_cast<unsigned char>(name[0]);
+      } else {
+        ++pos_;
+      }
+      if (pos_ + 1 < p_.size() && p_[pos_] == '-' && p_[pos_ + 1] != ']') {
+        unsigned char hi = static_cast<unsigned char>(p_[pos_ + 1]);
+        pos_ += 2;
+        if (hi < c) return fail("invalid range end");
+        for (int b = c; b <= hi; ++b) set.set(b);
+      } else {
+        set.set(c);
+      }
+    }
+    if (icase_) fold_case(set);
+    if (negate) set.flip();
+    return add_raw_set(set);
+  }
+
+  static bool add_class(ByteSet& set, std::string_view name) {
+    int (*pred)(int) = nullptr;
+    if (name == "alpha") pred = [](int c) { return std::isalpha(c); };
+    else if (name == "digit") pred = [](int c) { return std::isdigit(c); };
+    else if (name == "alnum") pred = [](int c) { return std::isalnum(c); };
+    else if (name == "upper") pred = [](int c) { return std::isupper(c); };
+    else if (name == "lower") pred = [](int c) { return std::islower(c); };
+    else if (name == "space") pred = [](int c) { return std::isspace(c); };
+    else if (name == "blank") pred = [](int c) { return static_cast<int>(c == ' ' || c == '\t'); };
+    else if (name == "punct") pred = [](int c) { return std::ispunct(c); };
+    else if (name == "print") pred = [](int c) { return std::isprint(c); };
+    else if (name == "graph") pred = [](int c) { return std::isgraph(c); };
+    else if (name == "cntrl") pred = [](int c) { return std::iscntrl(c); };
+    else if (name == "xdigit") pred = [](int c) { return std::isxdigit(c); };
+    if (!pred) return false;
+    for (int b = 0; b < 128; ++b)
+      if (pred(b)) set.set(b);
+    return true;
+  }
+};
+
+// ----------------------------------------------------------------------
+// Program: Thompson NFA in instruction form
+// ----------------------------------------------------------------------
+enum class Op : std::uint8_t { Set, Split, Jmp, Save, Assert, Match };
+
+struct Inst {
+  Op op = Op::Match;
+  AssertKind assert_kind = AssertKind::TextStart;
+  int x = 0;  // Set: set index; Split/Jmp: target; Save: slot
+  int y = 0;  // Split: second (lower priority) target
+};
+
+struct Program {
+  std::vector<Inst> insts;
+  std::vector<ByteSet> sets;
+  int match_pc = 0;
+  int unanchored_pc = 0;  // ".*" loop in front of the pattern, DFA only
+  int groups = 0;
+  bool captures = false;
+  bool word_asserts = false;
+  std::array<std::uint8_t, 256> byte_class{};
+  int class_count = 1;
+  std::vector<std::uint8_t> class_rep;  // one representative byte per class
+};
+
+class Compiler {
+ public:
+  Compiler(const std::vector<Node>& nodes, Program& prog)
+      : nodes_(nodes), prog_(prog) {}
+
+  bool emit(int id) {
+    if (prog_.insts.size() > kMaxProgram) return false;
+    const Node& n = nodes_[id];
+    switch (n.kind) {
+      case Node::Kind::Empty:
+        return true;
+      case Node::Kind::Set:
+        prog_.sets.push_back(n.set);
+        push({Op::Set, {}, static_cast<int>(prog_.sets.size() - 1)});
+        return true;
+      case Node::Kind::Concat:
+        for (int c : n.children)
+          if (!emit(c)) return false;
+        return true;
+      case Node::Kind::Alternate: {
+        std::vector<int> jumps;
+        for (size_t i = 0; i < n.children.size(); ++i) {
+          int split = -1;
+          if (i + 1 < n.children.size()) split = push({Op::Split});
+          if (split >= 0) prog_.insts[split].x = here();
+          if (!emit(n.children[i])) return false;
+          if (i + 1 < n.children.size()) {
+            jumps.push_back(push({Op::Jmp}));
+            prog_.insts[split].y = here();
+          }
+        }
+        for (int j : jumps) prog_.insts[j].x = here();
+        return true;
+      }
+      case Node::Kind::Group:
+        if (prog_.captures) push({Op::Save, {}, 2 * n.group});
+        if (!emit(n.children[0])) return false;
+        if (prog_.captures) push({Op::Save, {}, 2 * n.group + 1});
+        return true;
+      case Node::Kind::Assert:
+        if (n.assert_kind != AssertKind::TextStart &&
+            n.assert_kind != AssertKind::TextEnd)
+          prog_.word_asserts = true;
+        push({Op::Assert, n.assert_kind});
+        return true;
+      case Node::Kind::Repeat:
+        return emit_repeat(n);
+    }
+    return true;
+  }
+
+ private:
+  const std::vector<Node>& nodes_;
+  Program& prog_;
+
+  int here() const { return static_cast<int>(prog_.insts.size()); }
+  int push(Inst inst) {
+    prog_.insts.push_back(inst);
+    return here() - 1;
+  }
+
+  bool emit_repeat(const Node& n) {
+    int child = n.children[0];
+    for (int i = 0; i < n.min; ++i)
+      if (!emit(child)) return false;
+    if (n.max < 0) {
+      int loop = push({Op::Split});
+      prog_.insts[loop].x = here();
+      if (!emit(child)) return false;
+      push({Op::Jmp, {}, loop});
+      prog_.insts[loop].y = here();
+      return true;
+    }
+    std::vector<int> splits;
+    for (int i = n.min; i < n.max; ++i) {
+      int split = push({Op::Split});
+      prog_.insts[split].x = here();
+      splits.push_back(split);
+      if (!emit(child)) return false;
+    }
+    for (int s : splits) prog_.insts[s].y = here();
+    return true;
+  }
+};
+
+// Partitions the byte range into classes no instruction can tell apart, so
+// DFA transition rows have one slot per class rather than per byte.
+inline void compute_byte_classes(Program& prog) {
+  std::array<bool, 257> boundary{};
+  for (const auto& s : prog.sets)
+    for (int b = 1; b < 256; ++b)
+      if (s[b] != s[b - 1]) boundary[b] = true;
+  int cls = 0;
+  prog.class_rep.assign(1, 0);
+  for (int b = 0; b < 256; ++b) {
+    if (b > 0 && boundary[b]) {
+      ++cls;
+      prog.class_rep.push_back(static_cast<std::uint8_t>(b));
+    }
+    prog.byte_class[b] = static_cast<std::uint8_t>(cls);
+  }
+  prog.class_count = cls + 1;
+}
+
+// ----------------------------------------------------------------------
+// Required literals, for prefiltering with a plain substring search
+// ----------------------------------------------------------------------
+struct Literal {
+  std::string text;
+  bool exact = true;  // the node matches exactly TEXT and nothing else
+};
+
+inline auto single_byte(const ByteSet& s) -> std::optional<char> {
+  if (s.count() != 1) return std::nullopt;
+  for (int b = 0; b < 256; ++b)
+    if (s[b]) return static_cast<char>(b);
+  return std::nullopt;
+}
+
+inline auto common_prefix(std::string_view a, std::string_view b) -> size_t {
+  size_t i = 0;
+  while (i < a.size() && i < b.size() && a[i] == b[i]) ++i;
+  return i;
+}
+
+inline auto literal_of(const std::vector<Node>& nodes, int id, bool suffix)
+    -> Literal {
+  const Node& n = nodes[id];
+  switch (n.kind) {
+    case Node::Kind::Empty:
+    case Node::Kind::Assert:
+      return {};
+    case Node::Kind::Set:
+      if (auto c = single_byte(n.set)) return {std::string(1, *c), true};
+      return {"", false};
+    case Node::Kind::Group:
+      return literal_of(nodes, n.children[0], suffix);
+    case Node::Kind::Concat: {
+      Literal out;
+      auto walk = [&](int child) {
+        Literal l = literal_of(nodes, child, suffix);
+        if (suffix) out.text.insert(0, l.text);
+        else out.text += l.text;
+        if (!l.exact || out.text.size() > kMaxLiteral) {
+          out.exact = false;
+          return false;
+        }
+        return true;
+      };
+      if (suffix) {
+        for (auto it = n.children.rbegin(); it != n.children.rend(); ++it)
+          if (!walk(*it)) break;
+      } else {
+        for (int c : n.children)
+          if (!walk(c)) break;
+      }
+      return out;
+    }
+    case Node::Kind::Alternate: {
+      Literal out = literal_of(nodes, n.children[0], suffix);
+      for (size_t i = 1; i < n.children.size(); ++i) {
+        Literal l = literal_of(nodes, n.children[i], suffix);
+        if (l.text != out.text || !l.exact) out.exact = false;
+        if (suffix) {
+          std::string ra(out.text.rbegin(), out.text.rend());
+          std::string rb(l.text.rbegin(), l.text.rend());
+          out.text = out.text.substr(out.text.size() - common_prefix(ra, rb));
+        } else {
+          out.text.resize(common_prefix(out.text, l.text));
+        }
+      }
+      return out;
+    }
+    case Node::Kind::Repeat: {
+      if (n.min == 0) return {"", false};
+      Literal l = literal_of(nodes, n.children[0], suffix);
+      if (!l.exact) return {l.text, false};
+      std::string text;
+      for (int i = 0; i < n.min && text.size() <= kMaxLiteral; ++i) text += l.text;
+      return {text, n.min == n.max && text.size() <= kMaxLiteral};
+    }
+  }
+  return {"", false};
+}
+
+inline bool has_assert(const std::vector<Node>& nodes, int id) {
+  const Node& n = nodes[id];
+  if (n.kind == Node::Kind::Assert) return true;
+  for (int c : n.children)
+    if (has_assert(nodes, c)) return true;
+  return false;
+}
+
+// ----------------------------------------------------------------------
+// Lazy DFA: subset construction performed on demand and cached
+// ----------------------------------------------------------------------
+class LazyDfa {
+ public:
+  static constexpr int kDead = 0;
+
+  void reset(const Program& prog) {
+    states_.clear();
+    index_.clear();
+    trans_.clear();
+    starts_.fill(-1);
+    mark_.assign(prog.insts.size(), 0);
+    generation_ = 0;
+    memory_ = 0;
+    intern(prog, {}, false);  // kDead
+  }
+
+  bool accepting(int s) const { return states_[s].accept; }
+  bool accepting_at_end(int s) const { return states_[s].accept_at_end; }
+
+  /// Start state; UNANCHORED prepends the implicit ".*" loop
+  int start(const Program& prog, bool unanchored, bool at_text_start) {
+    int slot = (unanchored ? 2 : 0) + (at_text_start ? 1 : 0);
+    if (starts_[slot] >= 0) return starts_[slot];
+    std::vector<int> pcs;
+    closure(prog, {unanchored ? prog.unanchored_pc : 0}, at_text_start, false,
+            pcs);
+    int id = intern(prog, pcs, at_text_start);
+    starts_[slot] = id;
+    return id;
+  }
+
+  int step(const Program& prog, int s, unsigned char byte) {
+    const size_t row = static_cast<size_t>(s) * prog.class_count;
+    int cached = trans_[row + prog.byte_class[byte]];
+    if (cached >= 0) return cached;
+
+    std::vector<int> seeds;
+    for (int pc : states_[s].pcs) {
+      const Inst& in = prog.insts[pc];
+      if (in.op == Op::Set && prog.sets[in.x][byte]) seeds.push_back(pc + 1);
+    }
+    std::vector<int> pcs;
+    closure(prog, seeds, false, false, pcs);
+    if (memory_ >= kDfaCacheBytes) {
+      // Flush and carry on from the target state alone
+      reset(prog);
+      return intern(prog, pcs, false);
+    }
+    int next = intern(prog, pcs, false);
+    trans_[static_cast<size_t>(s) * prog.class_count + prog.byte_class[byte]] =
+        next;
+    return next;
+  }
+
+ private:
+  struct State {
+    std::vector<int> pcs;
+    bool accept = false;
+    bool accept_at_end = false;
+  };
+
+  std::vector<State> states_;
+  std::vector<int> trans_;
+  std::unordered_map<std::string, int> index_;
+  std::array<int, 4> starts_{-1, -1, -1, -1};
+  std::vector<std::uint32_t> mark_;
+  std::uint32_t generation_ = 0;
+  size_t memory_ = 0;
+
+  // Follows empty transitions from SEEDS. Byte-consuming instructions,
+  // Match, and TextEnd assertions that cannot be decided yet are kept.
+  void closure(const Program& prog, const std::vector<int>& seeds,
+               bool at_text_start, bool at_text_end, std::vector<int>& out) {
+    if (++generation_ == 0) {
+      std::ranges::fill(mark_, 0u);
+      generation_ = 1;
+    }
+    std::vector<int> stack(seeds.rbegin(), seeds.rend());
+    while (!stack.empty()) {
+      int pc = stack.back();
+      stack.pop_back();
+      if (mark_[pc] == generation_) continue;
+      mark_[pc] = generation_;
+      const Inst& in = prog.insts[pc];
+      switch (in.op) {
+        case Op::Set:
+        case Op::Match:
+          out.push_back(pc);
+          break;
+        case Op::Split:
+          stack.push_back(in.y);
+          stack.push_back(in.x);
+          break;
+        case Op::Jmp:
+          stack.push_back(in.x);
+          break;
+        case Op::Save:
+          stack.push_back(pc + 1);
+          break;
+        case Op::Assert:
+          if (in.assert_kind == AssertKind::TextStart) {
+            if (at_text_start) stack.push_back(pc + 1);
+          } else if (at_text_end) {
+            stack.push_back(pc + 1);
+          } else {
+            out.push_back(pc);
+          }
+          break;
+      }
+    }
+    std::ranges::sort(out);
+  }
+
+  int intern(const Program& prog, const std::vector<int>& pcs,
+             bool at_text_start) {
+    std::string key(1, at_text_start ? 'S' : 's');
+    key.append(reinterpret_cast<const char*>(pcs.data()),
+               pcs.size() * sizeof(int));
+    if (auto it = index_.find(key); it != index_.end()) return it->second;
+
+    State st;
+    st.pcs = pcs;
+    std::vector<int> pending;
+    for (int pc : pcs) {
+      const Inst& in = prog.insts[pc];
+      if (in.op == Op::Match) st.accept = true;
+      if (in.op == Op::Assert) pending.push_back(pc + 1);
+    }
+    st.accept_at_end = st.accept;
+    if (!st.accept && !pending.empty()) {
+      std::vector<int> at_end;
+      closure(prog, pending, at_text_start, true, at_end);
+      st.accept_at_end = std::ranges::binary_search(at_end, prog.match_pc);
+    }
+
+    int id = static_cast<int>(states_.size());
+    states_.push_back(std::move(st));
+    trans_.resize(trans_.size() + prog.class_count, -1);
+    memory_ += sizeof(State) + 2 * key.size() + prog.class_count * sizeof(int);
+    index_.emplace(std::move(key), id);
+    return id;
+  }
+};
+
+// ----------------------------------------------------------------------
+// Pike VM: linear-time simulation that also tracks match positions
+// ----------------------------------------------------------------------
+class PikeVm {
+ public:
+  /**
+   * Leftmost-longest search starting at FROM. SLOTS receives
+   * 2 * (groups + 1) offsets when the program records captures, else 2.
+   * With FIRST_ONLY the search stops at the first Match reached.
+   */
+  bool run(const Program& prog, std::string_view text, size_t from,
+           std::string_view prefix, bool first_only,
+           std::vector<size_t>& slots) {
+    nslots_ = prog.captures ? 2 * (prog.groups + 1) : 2;
+    for (List* l : {&a_, &b_}) l->prepare(prog.insts.size(), nslots_);
+    slots.assign(nslots_, RegexMatch::npos);
+    work_.assign(nslots_, RegexMatch::npos);
+
+    bool matched = false;
+    List* cur = &a_;
+    List* next = &b_;
+    cur->clear();
+    for (size_t pos = from;; ++pos) {
+      if (!matched) {
+        if (cur->size == 0 && !prefix.empty()) {
+          // Nothing in flight: jump to where the next match could start
+          pos = text.find(prefix, pos);
+          if (pos == std::string_view::npos) break;
+        }
+        std::ranges::fill(work_, RegexMatch::npos);
+        work_[0] = pos;
+        add(prog, *cur, 0, text, pos);
+      }
+      if (cur->size == 0) {
+        if (matched || pos >= text.size()) break;
+        cur->clear();
+        continue;
+      }
+
+      next->clear();
+      const bool more = pos < text.size();
+      const unsigned char byte =
+          more ? static_cast<unsigned char>(text[pos]) : 0;
+      for (size_t i = 0; i < cur->size; ++i) {
+        const Inst& in = prog.insts[cur->pcs[i]];
+        const size_t* caps = cur->caps_of(i);
+        if (in.op == Op::Match) {
+          if (!matched || caps[0] < slots[0] ||
+              (caps[0] == slots[0] && pos > slots[1])) {
+            std::copy_n(caps, nslots_, slots.begin());
+            slots[1] = pos;
+            matched = true;
+            if (first_only) return true;
+          }
+          continue;
+        }
+        if (!more || !prog.sets[in.x][byte]) continue;
+        // Threads that began after the current best can no longer win
+        if (matched && caps[0] > slots[0]) continue;
+        std::copy_n(caps, nslots_, work_.begin());
+        add(prog, *next, cur->pcs[i] + 1, text, pos + 1);
+      }
+      if (!more) break;
+      std::swap(cur, next);
+    }
+    return matched;
+  }
+
+ private:
+  // Threads waiting on a Set or Match, in priority order. SEEN marks every
+  // instruction visited at this position so each is followed once.
+  struct List {
+    std::vector<int> pcs;
+    std::vector<size_t> caps;
+    std::vector<std::uint32_t> seen;
+    std::uint32_t generation = 0;
+    size_t size = 0;
+    size_t nslots = 2;
+
+    void prepare(size_t insts, size_t slots) {
+      nslots = slots;
+      pcs.resize(insts);
+      caps.resize(insts * slots);
+      if (seen.size() != insts) {
+        seen.assign(insts, 0);
+        generation = 0;
+      }
+      size = 0;
+    }
+    void clear() {
+      size = 0;
+      if (++generation == 0) {
+        std::ranges::fill(seen, 0u);
+        generation = 1;
+      }
+    }
+    const size_t* caps_of(size_t i) const { return &caps[i * nslots]; }
+  };
+
+  struct Frame {
+    int pc;
+    int restore_slot;  // >= 0: restore WORK_[slot] to VALUE instead
+    size_t value;
+  };
+
+  List a_, b_;
+  std::vector<size_t> work_;
+  std::vector<Frame> stack_;
+  size_t nslots_ = 2;
+
+  static bool check(AssertKind kind, std::string_view text, size_t pos) {
+    bool before =
+        pos > 0 && is_word_byte(static_cast<unsigned char>(text[pos - 1]));
+    bool after = pos < text.size() &&
+                 is_word_byte(static_cast<unsigned char>(text[pos]));
+    switch (kind) {
+      case AssertKind::TextStart: return pos == 0;
+      case AssertKind::TextEnd: return pos == text.size();
+      case AssertKind::WordBoundary: return before != after;
+      case AssertKind::NotWordBoundary: return before == after;
+      case AssertKind::WordStart: return !before && after;
+      case AssertKind::WordEnd: return before && !after;
+    }
+    return false;
+  }
+
+  // Adds PC0 and everything reachable from it without consuming input,
+  // in priority order, each thread carrying a copy of WORK_ as captures.
+  void add(const Program& prog, List& list, int pc0, std::string_view text,
+           size_t pos) {
+    stack_.clear();
+    stack_.push_back({pc0, -1, 0});
+    while (!stack_.empty()) {
+      Frame f = stack_.back();
+      stack_.pop_back();
+      if (f.restore_slot >= 0) {
+        work_[f.restore_slot] = f.value;
+        continue;
+      }
+      int pc = f.pc;
+      if (list.seen[pc] == list.generation) continue;
+      list.seen[pc] = list.generation;
+      const Inst& in = prog.insts[pc];
+      switch (in.op) {
+        case Op::Set:
+        case Op::Match:
+          list.pcs[list.size] = pc;
+          std::ranges::copy(work_, list.caps.begin() + list.size * nslots_);
+          ++list.size;
+          break;
+        case Op::Split:
+          stack_.push_back({in.y, -1, 0});
+          stack_.push_back({in.x, -1, 0});
+          break;
+        case Op::Jmp:
+          stack_.push_back({in.x, -1, 0});
+          break;
+        case Op::Save:
+          if (static_cast<size_t>(in.x) < nslots_) {
+            stack_.push_back({0, in.x, work_[in.x]});
+            work_[in.x] = pos;
+          }
+          stack_.push_back({pc + 1, -1, 0});
+          break;
+        case Op::Assert:
+          if (check(in.assert_kind, text, pos))
+            stack_.push_back({pc + 1, -1, 0});
+          break;
+      }
+    }
+  }
+};
+
+}  // namespace regex_impl
+
+/**
+ * @brief A compiled POSIX regular expression.
+ *
+ * Matching never backtracks: membership tests run on a DFA that is built
+ * lazily from the NFA and cached across calls, and position/group queries
+ * use a Pike VM, so every call is linear in the input. Results follow the
+ * POSIX leftmost-longest rule.
+ *
+ * Back-references cannot be matched in linear time. A pattern that uses
+ * them is handed to std::regex instead, with the grammars grep and sed used
+ * before this engine existed (basic for BRE, ECMAScript for ERE).
+ *
+ * The DFA cache makes matching mutate internal state: a Regex must not be
+ * used from several threads at once. Copy it per thread instead.
+ */
+export class Regex {
+ public:
+  /**
+   * @brief Compile PATTERN.
+   * @return The compiled expression, or a GNU-style error message (a
+   *         string literal, safe to keep around)
+   */
+  static auto compile(std::string_view pattern, const RegexOptions& opts = {})
+      -> std::expected<Regex, std::string_view> {
+    using namespace regex_impl;
+    Parser parser(pattern, opts);
+    auto root = parser.parse();
+    if (!root && parser.backrefs) return compile_backtracking(pattern, opts);
+    if (!root) return std::unexpected(root.error());
+
+    Regex re;
+    auto prog = std::make_shared<Program>();
+    prog->groups = parser.groups;
+    prog->captures = opts.captures;
+    Compiler compiler(parser.nodes, *prog);
+    if (!compiler.emit(*root) || prog->insts.size() > kMaxProgram)
+      return std::unexpected("regular expression too big");
+    prog->match_pc = static_cast<int>(prog->insts.size());
+    prog->insts.push_back({Op::Match});
+
+    // Unanchored entry: L: split(0, L+1); L+1: any byte; jmp L
+    ByteSet any;
+    any.set();
+    prog->sets.push_back(any);
+    prog->unanchored_pc = static_cast<int>(prog->insts.size());
+    prog->insts.push_back({Op::Split, {}, 0, prog->unanchored_pc + 1});
+    prog->insts.push_back({Op::Set, {}, static_cast<int>(prog->sets.size() - 1)});
+    prog->insts.push_back({Op::Jmp, {}, prog->unanchored_pc});
+    compute_byte_classes(*prog);
+
+    if (!opts.icase) {
+      Literal pre = literal_of(parser.nodes, *root, false);
+      Literal suf = literal_of(parser.nodes, *root, true);
+      re.prefix_ = std::move(pre.text);
+      re.suffix_ = std::move(suf.text);
+      re.pure_literal_ = pre.exact && !re.prefix_.empty() &&
+                         !has_assert(parser.nodes, *root) &&
+                         (prog->groups == 0 || !prog->captures);
+    }
+    re.prog_ = std::move(prog);
+    re.dfa_.reset(*re.prog_);
+    return re;
+  }
+
+  /// Number of \(...\) / (...) groups in the pattern
+  size_t group_count() const {
+    if (backtrack_) return backtrack_->mark_count();
+    return static_cast<size_t>(prog_->groups);
+  }
+
+  /// Literal every match starts with (empty if none or case-insensitive)
+  std::string_view literal_prefix() const { return prefix_; }
+
+  /// Literal every match ends with (empty if none or case-insensitive)
+  std::string_view literal_suffix() const { return suffix_; }
+
+  /// Does any part of TEXT at or after FROM match?
+  bool search(std::string_view text, size_t from = 0) const {
+    if (from > text.size()) return false;
+    if (backtrack_) return backtrack_search(text, from).has_value();
+    if (!prefix_.empty() && text.find(prefix_, from) == std::string_view::npos)
+      return false;
+    if (pure_literal_) return true;
+    if (!suffix_.empty() && suffix_ != prefix_ &&
+        text.find(suffix_, from) == std::string_view::npos)
+      return false;
+    if (prog_->word_asserts) {
+      return vm_.run(*prog_, text, from, prefix_, true, slots_);
+    }
+    // Every match starts at an occurrence of the prefix, so skip ahead to it
+    size_t pos = from;
+    if (!prefix_.empty()) pos = text.find(prefix_, from);
+    int s = dfa_.start(*prog_, true, pos == 0);
+    if (dfa_.accepting(s)) return true;
+    for (; pos < text.size(); ++pos) {
+      s = dfa_.step(*prog_, s, static_cast<unsigned char>(text[pos]));
+      if (dfa_.accepting(s)) return true;
+    }
+    return dfa_.accepting_at_end(s);
+  }
+
+  /// Does the whole of TEXT match?
+  bool full_match(std::string_view text) const {
+    if (backtrack_) {
+      return std::regex_match(text.data(), text.data() + text.size(),
+                              *backtrack_);
+    }
+    if (pure_literal_) return text == prefix_;
+    if (prog_->word_asserts) {
+      if (!vm_.run(*prog_, text, 0, {}, false, slots_)) return false;
+      return slots_[0] == 0 && slots_[1] == text.size();
+    }
+    int s = dfa_.start(*prog_, false, true);
+    for (char c : text) {
+      s = dfa_.step(*prog_, s, static_cast<unsigned char>(c));
+      if (s == regex_impl::LazyDfa::kDead) return false;
+    }
+    return dfa_.accepting_at_end(s);
+  }
+
+  /// Leftmost-longest match at or after FROM
+  auto find(std::string_view text, size_t from = 0) const
+      -> std::optional<RegexMatch> {
+    if (backtrack_) {
+      auto m = backtrack_search(text, from);
+      if (!m) return std::nullopt;
+      return span_of(text, (*m)[0]);
+    }
+    if (pure_literal_) {
+      size_t at = from <= text.size() ? text.find(prefix_, from)
+                                      : std::string_view::npos;
+      if (at == std::string_view::npos) return std::nullopt;
+      return RegexMatch{at, at + prefix_.size()};
+    }
+    if (!search(text, from)) return std::nullopt;
+    if (!vm_.run(*prog_, text, from, prefix_, false, slots_)) return std::nullopt;
+    return RegexMatch{slots_[0], slots_[1]};
+  }
+
+  /**
+   * @brief Leftmost-longest match at or after FROM, with groups.
+   * @param groups Receives group_count() + 1 entries; [0] is the whole
+   *        match. Groups are only filled in when compiled with captures.
+   */
+  bool find(std::string_view text, size_t from,
+            std::vector<RegexMatch>& groups) const {
+    groups.assign(group_count() + 1, RegexMatch{});
+    if (backtrack_) {
+      auto m = backtrack_search(text, from);
+      if (!m) return false;
+      for (size_t g = 0; g < groups.size() && g < m->size(); ++g) {
+        if ((*m)[g].matched) groups[g] = span_of(text, (*m)[g]);
+      }
+      return true;
+    }
+    if (pure_literal_) {
+      auto m = find(text, from);
+      if (!m) return false;
+      groups[0] = *m;
+      return true;
+    }
+    if (!search(text, from)) return false;
+    if (!vm_.run(*prog_, text, from, prefix_, false, slots_)) return false;
+    for (size_t g = 0; g * 2 + 1 < slots_.size() && g < groups.size(); ++g) {
+      if (slots_[2 * g] != RegexMatch::npos && slots_[2 * g + 1] != RegexMatch::npos)
+        groups[g] = RegexMatch{slots_[2 * g], slots_[2 * g + 1]};
+    }
+    return true;
+  }
+
+ private:
+  Regex() = default;
+
+  static auto compile_backtracking(std::string_view pattern,
+                                   const RegexOptions& opts)
+      -> std::expected<Regex, std::string_view> {
+    auto flags = opts.syntax == RegexSyntax::Basic
+                     ? std::regex_constants::basic
+                     : std::regex_constants::ECMAScript;
+    if (opts.icase) flags |= std::regex_constants::icase;
+    Regex re;
+    try {
+      re.backtrack_ = std::make_shared<const std::regex>(
+          pattern.data(), pattern.size(), flags);
+    } catch (const std::regex_error&) {
+      return std::unexpected("invalid back reference");
+    }
+    return re;
+  }
+
+  auto backtrack_search(std::string_view text, size_t from) const
+      -> std::optional<std::cmatch> {
+    // prev_avail lets ^ and \b see the byte before FROM
+    auto flags = from > 0 ? std::regex_constants::match_prev_avail
+                          : std::regex_constants::match_default;
+    std::cmatch m;
+    if (!std::regex_search(text.data() + from, text.data() + text.size(), m,
+                           *backtrack_, flags)) {
+      return std::nullopt;
+    }
+    return m;
+  }
+
+  static RegexMatch span_of(std::string_view text, const std::csub_match& m) {
+    return RegexMatch{static_cast<size_t>(m.first - text.data()),
+                      static_cast<size_t>(m.second - text.data())};
+  }
+
+  std::shared_ptr<const regex_impl::Program> prog_;
+  // Set instead of prog_ for patterns with back-references
+  std::shared_ptr<const std::regex> backtrack_;
+  std::string prefix_;
+  std::string suffix_;
+  bool pure_literal_ = false;
+
+  mutable regex_impl::LazyDfa dfa_;
+  mutable regex_impl::PikeVm vm_;
+  mutable std::vector<size_t> slots_;
+};
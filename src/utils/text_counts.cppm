@@ -0,0 +1,139 @@
+/// @Author: caomengxuan666
+/// @Description: Line, word and character counting kernel
+/// @Version: 0.1.0
+/// @License: MIT
+/// @Copyright: Copyright © 2026 WinuxCmd
+module;
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define WINUX_COUNTS_SSE2 1
+#endif
+export module utils:text_counts;
+
+import std;
+
+/**
+ * @brief What TextCounter has seen so far.
+ */
+export struct TextCounts {
+  std::uint64_t newlines = 0;
+  std::uint64_t words = 0;  ///< Runs of bytes other than C-locale whitespace
+  std::uint64_t chars = 0;  ///< UTF-8 code points: bytes that do not continue one
+  std::uint64_t bytes = 0;
+  std::uint64_t max_line_length = 0;  ///< In bytes, newline excluded
+  bool unterminated_line = false;     ///< Bytes follow the last newline
+};
+
+/**
+ * @brief Counts lines, words and characters of a stream fed in blocks.
+ *
+ * Works on 16 bytes at a time with SSE2: newlines, whitespace and UTF-8
+ * continuation bytes are each one compare, turned into bit masks that are
+ * popcounted. A word starts at every non-space byte whose predecessor is a
+ * space, so word counting is a shift and an AND on the masks, with the last
+ * bit carried into the next chunk (and the next block). Only the counts
+ * asked for are computed; newlines and bytes always are.
+ */
+export class TextCounter {
+ public:
+  struct Options {
+    bool words = true;
+    bool chars = true;
+    bool max_line_length = true;
+  };
+
+  TextCounter() = default;
+  explicit TextCounter(Options options) : options_(options) {}
+
+  void feed(std::string_view block) {
+    const auto* data = reinterpret_cast<const unsigned char*>(block.data());
+    const size_t n = block.size();
+    counts_.bytes += n;
+    size_t i = 0;
+
+#ifdef WINUX_COUNTS_SSE2
+    const __m128i newline = _mm_set1_epi8('\n');
+    const __m128i blank = _mm_set1_epi8(' ');
+    // '\t' .. '\r' are 9 .. 13: subtract 9, then compare unsigned below 5
+    const __m128i control_base = _mm_set1_epi8(9);
+    const __m128i control_span = _mm_set1_epi8(4);
+    const __m128i continuation_limit = _mm_set1_epi8(-64);  // 0xC0
+    for (; i + 16 <= n; i += 16) {
+      const __m128i chunk =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+      unsigned newlines = static_cast<unsigned>(
+          _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline)));
+      counts_.newlines += std::popcount(newlines);
+
+      if (options_.words) {
+        const __m128i offset = _mm_sub_epi8(chunk, control_base);
+        const __m128i control = _mm_cmpeq_epi8(
+            _mm_min_epu8(offset, control_span), offset);
+        const auto spaces = static_cast<unsigned>(_mm_movemask_epi8(
+            _mm_or_si128(control, _mm_cmpeq_epi8(chunk, blank))));
+        const unsigned after_space = (spaces << 1) | (after_space_ ? 1u : 0u);
+        counts_.words += std::popcount(~spaces & after_space & 0xFFFFu);
+        after_space_ = (spaces & 0x8000u) != 0;
+      }
+
+      if (options_.chars) {
+        // Continuation bytes 0x80..0xBF are the signed bytes below -64
+        const auto continuation = static_cast<unsigned>(_mm_movemask_epi8(
+            _mm_cmplt_epi8(chunk, continuation_limit)));
+        counts_.chars += 16 - std::popcount(continuation);
+      }
+
+      if (options_.max_line_length) {
+        unsigned start = 0;
+        while (newlines != 0) {
+          const auto at = static_cast<unsigned>(std::countr_zero(newlines));
+          end_line(line_length_ + (at - start));
+          start = at + 1;
+          newlines &= newlines - 1;
+        }
+        line_length_ += 16 - start;
+      }
+    }
+    if (!options_.max_line_length && i != 0) {
+      // Only whether the last line is unterminated is needed
+      line_length_ = data[i - 1] == '\n' ? 0 : 1;
+    }
+#endif
+
+    for (; i < n; ++i) {
+      const unsigned char c = data[i];
+      if (c == '\n') {
+        ++counts_.newlines;
+        end_line(line_length_);
+      } else {
+        ++line_length_;
+      }
+      const bool space = c == ' ' || (c >= '\t' && c <= '\r');
+      if (!space && after_space_) ++counts_.words;
+      after_space_ = space;
+      if ((c & 0xC0) != 0x80) ++counts_.chars;
+    }
+  }
+
+  TextCounts counts() const {
+    TextCounts result = counts_;
+    if (!options_.words) result.words = 0;
+    if (!options_.chars) result.chars = 0;
+    result.max_line_length = std::max(result.max_line_length, line_length_);
+    if (!options_.max_line_length) result.max_line_length = 0;
+    result.unterminated_line = line_length_ > 0;
+    return result;
+  }
+
+ private:
+  Options options_;
+  TextCounts counts_;
+  std::uint64_t line_length_ = 0;  // Bytes since the last newline
+  bool after_space_ = true;        // The start of input acts as a space
+
+  void end_line(std::uint64_t length) {
+    counts_.max_line_length = std::max(counts_.max_line_length, length);
+    line_length_ = 0;
+  }
+};
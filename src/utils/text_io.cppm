@@ -23,10 +23,14 @@
  *  - Username: Administrator
  *  - CopyrightYear: 2026
  */
+module;
+
+#include "pch/pch.h"
 export module utils:textio;
 
 import std;
 import :utf8;
+import :channel;
 
 namespace {
 enum class EncodingHint { Utf8, Utf16Le, Utf16Be };
@@ -69,32 +73,383 @@ auto decode_utf16(std::string_view bytes, bool little_endian) -> std::string {
 
   return wstring_to_utf8(wide);
 }
+
+auto detect_encoding(std::string_view head) -> EncodingHint {
+  if (head.size() >= 2 && static_cast<std::uint8_t>(head[0]) == 0xFF &&
+      static_cast<std::uint8_t>(head[1]) == 0xFE) {
+    return EncodingHint::Utf16Le;
+  }
+  if (head.size() >= 2 && static_cast<std::uint8_t>(head[0]) == 0xFE &&
+      static_cast<std::uint8_t>(head[1]) == 0xFF) {
+    return EncodingHint::Utf16Be;
+  }
+  if (auto guessed = guess_utf16_from_nuls(head); guessed.has_value()) {
+    return *guessed;
+  }
+  return EncodingHint::Utf8;
+}
+
+auto detect_record_encoding(std::string_view head, char delimiter)
+    -> EncodingHint {
+  const EncodingHint encoding = detect_encoding(head);
+  // A NUL-delimited stream is full of NUL bytes by design; only trust an
+  // explicit BOM there.
+  if (delimiter == '\0' && encoding != EncodingHint::Utf8 &&
+      !(head.size() >= 2 &&
+        ((static_cast<std::uint8_t>(head[0]) == 0xFF &&
+          static_cast<std::uint8_t>(head[1]) == 0xFE) ||
+         (static_cast<std::uint8_t>(head[0]) == 0xFE &&
+          static_cast<std::uint8_t>(head[1]) == 0xFF)))) {
+    return EncodingHint::Utf8;
+  }
+  return encoding;
+}
+
+auto has_utf8_bom(std::string_view bytes) -> bool {
+  return bytes.size() >= 3 && static_cast<std::uint8_t>(bytes[0]) == 0xEF &&
+         static_cast<std::uint8_t>(bytes[1]) == 0xBB &&
+         static_cast<std::uint8_t>(bytes[2]) == 0xBF;
+}
 }  // namespace
 
+/**
+ * @brief Options for LineReader.
+ */
+export struct LineReaderOptions {
+  char delimiter = '\n';       ///< Record terminator ('\0' for -z style input)
+  bool strip_cr = false;       ///< Drop a trailing '\r' from each record
+  bool decode_text = true;     ///< Strip UTF-8 BOM, transcode UTF-16 to UTF-8
+  size_t block_size = 256 * 1024;
+};
+
+/**
+ * @brief Chunked, zero-copy record reader.
+ *
+ * Reads the input in fixed-size blocks and hands out records as views into
+ * its own buffer, so memory use is bounded by the block size (or the longest
+ * record) instead of the input size. A view stays valid until the next call
+ * to next(). Encoding detection mirrors read_text_stream(): the first block is
+ * sniffed for a BOM or for UTF-16 NUL patterns, and UTF-16 input is
+ * transcoded to UTF-8 block by block.
+ */
+export class LineReader {
+ public:
+  explicit LineReader(std::istream& in, LineReaderOptions options = {})
+      : stream_(&in), options_(options) {
+    init();
+  }
+
+  /// Read straight from a file/pipe handle. Unlike std::istream::read this
+  /// returns whatever a pipe has available, so records written by a slow
+  /// producer are seen as soon as they are complete.
+  explicit LineReader(HANDLE handle, LineReaderOptions options = {})
+      : handle_(handle), options_(options) {
+    init();
+  }
+
+  /// Read the output of the previous stage of an in-process pipeline.
+  explicit LineReader(PipeChannel& channel, LineReaderOptions options = {})
+      : channel_(&channel), options_(options) {
+    init();
+  }
+
+  /// Reader for standard input: raw handle reads for pipes and files, the
+  /// C++ stream for an interactive console.
+  static auto for_stdin(LineReaderOptions options = {}) -> LineReader {
+    if (auto* channel = thread_stdin_channel()) {
+      return LineReader(*channel, options);
+    }
+    HANDLE handle = thread_stdin_handle();
+    if (handle == nullptr || handle == INVALID_HANDLE_VALUE ||
+        GetFileType(handle) == FILE_TYPE_CHAR) {
+      return LineReader(stdin_stream(), options);
+    }
+    return LineReader(handle, options);
+  }
+
+  LineReader(LineReader&&) noexcept = default;
+  LineReader& operator=(LineReader&&) noexcept = default;
+  LineReader(const LineReader&) = delete;
+  LineReader& operator=(const LineReader&) = delete;
+
+  /**
+   * @brief Fetch the next record without its delimiter.
+   * @return false once the input is exhausted
+   */
+  auto next(std::string_view& record) -> bool {
+    while (true) {
+      if (scan_ < end_) {
+        const void* hit = std::memchr(buffer_.data() + scan_,
+                                      options_.delimiter, end_ - scan_);
+        if (hit != nullptr) {
+          const size_t at =
+              static_cast<size_t>(static_cast<const char*>(hit) - buffer_.data());
+          emit(at, true, record);
+          pos_ = scan_ = at + 1;
+          return true;
+        }
+        scan_ = end_;
+      }
+      if (eof_) {
+        if (pos_ == end_) return false;
+        emit(end_, false, record);
+        pos_ = scan_ = end_;
+        return true;
+      }
+      refill();
+    }
+  }
+
+  /**
+   * @brief Look at the input that next() has not returned yet.
+   *
+   * Reads the first block if nothing has been read so far, so callers can
+   * sniff the start of the input (e.g. for binary data) before consuming
+   * records. The view is invalidated by the next call to next().
+   */
+  auto peek() -> std::string_view {
+    if (pos_ == end_ && !eof_) refill();
+    return {buffer_.data() + pos_, end_ - pos_};
+  }
+
+  /// Whether the last record returned by next() was terminated by the
+  /// delimiter (false only for an unterminated final record).
+  [[nodiscard]] auto had_delimiter() const -> bool { return had_delimiter_; }
+
+  /// Byte offset of the last record. For UTF-8 input this is the offset in
+  /// the raw input; for UTF-16 input it is the offset in the decoded text.
+  [[nodiscard]] auto record_offset() const -> std::uint64_t {
+    return record_offset_;
+  }
+
+  /// True when the input was detected as UTF-16 and is being transcoded.
+  [[nodiscard]] auto transcoding() const -> bool {
+    return encoding_ != EncodingHint::Utf8;
+  }
+
+  /// True when reading failed for a reason other than end of input.
+  [[nodiscard]] auto failed() const -> bool { return failed_; }
+
+ private:
+  void init() {
+    if (options_.block_size < 4096) options_.block_size = 4096;
+    buffer_.resize(options_.block_size);
+  }
+
+  void emit(size_t stop, bool delimited, std::string_view& record) {
+    size_t length = stop - pos_;
+    if (options_.strip_cr && length > 0 && buffer_[pos_ + length - 1] == '\r') {
+      --length;
+    }
+    record = std::string_view(buffer_.data() + pos_, length);
+    record_offset_ = consumed_ + pos_;
+    had_delimiter_ = delimited;
+  }
+
+  auto read_raw(char* dest, size_t count) -> size_t {
+    if (channel_ != nullptr) return channel_->read(dest, count);
+    if (stream_ != nullptr) {
+      stream_->read(dest, static_cast<std::streamsize>(count));
+      const auto got = static_cast<size_t>(stream_->gcount());
+      if (got < count && stream_->bad()) failed_ = true;
+      return got;
+    }
+    DWORD got = 0;
+    const DWORD want = static_cast<DWORD>(
+        std::min<size_t>(count, std::numeric_limits<DWORD>::max()));
+    if (!ReadFile(handle_, dest, want, &got, nullptr)) {
+      if (GetLastError() != ERROR_BROKEN_PIPE) failed_ = true;
+      return 0;
+    }
+    return got;
+  }
+
+  void compact() {
+    if (pos_ == 0) return;
+    const size_t remaining = end_ - pos_;
+    if (remaining > 0) {
+      std::memmove(buffer_.data(), buffer_.data() + pos_, remaining);
+    }
+    consumed_ += pos_;
+    scan_ -= pos_;
+    end_ = remaining;
+    pos_ = 0;
+  }
+
+  void ensure_room(size_t needed) {
+    if (buffer_.size() - end_ >= needed) return;
+    compact();
+    if (buffer_.size() - end_ >= needed) return;
+    buffer_.resize(std::max(buffer_.size() * 2, end_ + needed));
+  }
+
+  void refill() {
+    if (encoding_ == EncodingHint::Utf8) {
+      // One full block of free space keeps reads large; the buffer only
+      // grows when a single record is longer than what is buffered.
+      ensure_room(options_.block_size);
+      const size_t got = read_raw(buffer_.data() + end_, options_.block_size);
+      if (got == 0) {
+        eof_ = true;
+        return;
+      }
+      const size_t start = end_;
+      end_ += got;
+      if (first_block_) sniff(start);
+      return;
+    }
+    refill_utf16();
+  }
+
+  void sniff(size_t start) {
+    first_block_ = false;
+    if (!options_.decode_text) return;
+    // Make sure the sniffed prefix is long enough to be meaningful.
+    while (end_ - start < 4 && !eof_) {
+      ensure_room(options_.block_size);
+      const size_t got = read_raw(buffer_.data() + end_, 4 - (end_ - start));
+      if (got == 0) break;
+      end_ += got;
+    }
+    const std::string_view head(buffer_.data() + start, end_ - start);
+    const EncodingHint encoding = detect_record_encoding(head, options_.delimiter);
+    if (encoding == EncodingHint::Utf8) {
+      if (has_utf8_bom(head)) pos_ = scan_ = start + 3;
+      return;
+    }
+    encoding_ = encoding;
+    raw_.assign(head.begin(), head.end());
+    end_ = scan_ = pos_ = start;
+    decode_pending();
+  }
+
+  void refill_utf16() {
+    const size_t carried = raw_.size();
+    raw_.resize(carried + options_.block_size);
+    const size_t got = read_raw(raw_.data() + carried, options_.block_size);
+    raw_.resize(carried + got);
+    if (got == 0) {
+      eof_ = true;
+      if (high_surrogate_ != 0 || !raw_.empty()) {
+        ensure_room(3);
+        append_code_point(0xFFFD);
+        high_surrogate_ = 0;
+        raw_.clear();
+      }
+      return;
+    }
+    decode_pending();
+  }
+
+  void decode_pending() {
+    const bool little_endian = encoding_ == EncodingHint::Utf16Le;
+    const size_t units = raw_.size() / 2;
+    // Each UTF-16 unit expands to at most three UTF-8 bytes.
+    ensure_room(units * 3 + 3);
+    for (size_t i = 0; i < units; ++i) {
+      const auto b0 = static_cast<std::uint8_t>(raw_[i * 2]);
+      const auto b1 = static_cast<std::uint8_t>(raw_[i * 2 + 1]);
+      const auto unit =
+          little_endian
+              ? static_cast<std::uint16_t>(b0 | (static_cast<std::uint16_t>(b1) << 8))
+              : static_cast<std::uint16_t>((static_cast<std::uint16_t>(b0) << 8) | b1);
+      decode_unit(unit);
+    }
+    // Keep an odd trailing byte for the next block.
+    raw_.erase(raw_.begin(), raw_.begin() + static_cast<std::ptrdiff_t>(units * 2));
+  }
+
+  void decode_unit(std::uint16_t unit) {
+    if (high_surrogate_ != 0) {
+      if (unit >= 0xDC00 && unit <= 0xDFFF) {
+        append_code_point(0x10000 + ((static_cast<std::uint32_t>(high_surrogate_) - 0xD800) << 10) +
+                          (unit - 0xDC00));
+        high_surrogate_ = 0;
+        return;
+      }
+      append_code_point(0xFFFD);
+      high_surrogate_ = 0;
+    }
+    if (unit == 0xFEFF) return;  // Drop BOM markers, as decode_utf16() does.
+    if (unit >= 0xD800 && unit <= 0xDBFF) {
+      high_surrogate_ = unit;
+      return;
+    }
+    if (unit >= 0xDC00 && unit <= 0xDFFF) {
+      append_code_point(0xFFFD);
+      return;
+    }
+    append_code_point(unit);
+  }
+
+  void append_code_point(std::uint32_t cp) {
+    char* out = buffer_.data() + end_;
+    if (cp < 0x80) {
+      out[0] = static_cast<char>(cp);
+      end_ += 1;
+    } else if (cp < 0x800) {
+      out[0] = static_cast<char>(0xC0 | (cp >> 6));
+      out[1] = static_cast<char>(0x80 | (cp & 0x3F));
+      end_ += 2;
+    } else if (cp < 0x10000) {
+      out[0] = static_cast<char>(0xE0 | (cp >> 12));
+      out[1] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+      out[2] = static_cast<char>(0x80 | (cp & 0x3F));
+      end_ += 3;
+    } else {
+      out[0] = static_cast<char>(0xF0 | (cp >> 18));
+      out[1] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+      out[2] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+      out[3] = static_cast<char>(0x80 | (cp & 0x3F));
+      end_ += 4;
+    }
+  }
+
+  std::istream* stream_ = nullptr;
+  PipeChannel* channel_ = nullptr;
+  HANDLE handle_ = nullptr;
+  LineReaderOptions options_;
+  std::vector<char> buffer_;
+  std::vector<char> raw_;  // Undecoded UTF-16 bytes carried between blocks
+  size_t pos_ = 0;         // Start of the next record
+  size_t scan_ = 0;        // First byte not yet searched for a delimiter
+  size_t end_ = 0;         // End of valid data
+  std::uint64_t consumed_ = 0;
+  std::uint64_t record_offset_ = 0;
+  EncodingHint encoding_ = EncodingHint::Utf8;
+  std::uint16_t high_surrogate_ = 0;
+  bool first_block_ = true;
+  bool eof_ = false;
+  bool failed_ = false;
+  bool had_delimiter_ = false;
+};
+
 export auto read_text_stream(std::istream& in) -> std::string {
   std::string bytes{std::istreambuf_iterator<char>{in},
                     std::istreambuf_iterator<char>{}};
   if (bytes.empty()) return bytes;
 
-  EncodingHint encoding = EncodingHint::Utf8;
-  if (bytes.size() >= 2 && static_cast<std::uint8_t>(bytes[0]) == 0xFF &&
-      static_cast<std::uint8_t>(bytes[1]) == 0xFE) {
-    encoding = EncodingHint::Utf16Le;
-  } else if (bytes.size() >= 2 && static_cast<std::uint8_t>(bytes[0]) == 0xFE &&
-             static_cast<std::uint8_t>(bytes[1]) == 0xFF) {
-    encoding = EncodingHint::Utf16Be;
-  } else if (auto guessed = guess_utf16_from_nuls(bytes); guessed.has_value()) {
-    encoding = *guessed;
-  }
-
+  const EncodingHint encoding = detect_encoding(bytes);
   if (encoding == EncodingHint::Utf16Le) return decode_utf16(bytes, true);
   if (encoding == EncodingHint::Utf16Be) return decode_utf16(bytes, false);
 
   // Strip UTF-8 BOM if present.
-  if (bytes.size() >= 3 && static_cast<std::uint8_t>(bytes[0]) == 0xEF &&
-      static_cast<std::uint8_t>(bytes[1]) == 0xBB &&
-      static_cast<std::uint8_t>(bytes[2]) == 0xBF) {
-    bytes.erase(0, 3);
-  }
+  if (has_utf8_bom(bytes)) bytes.erase(0, 3);
   return bytes;
 }
+
+/**
+ * @brief Where the UTF-8 records of an in-memory buffer start.
+ *
+ * Applies LineReader's encoding sniffing to a buffer that is scanned in
+ * place (e.g. a MappedFile): returns 0, or 3 past a UTF-8 BOM, or nullopt
+ * when the buffer is UTF-16 and has to go through LineReader instead.
+ */
+export auto raw_text_start(std::string_view bytes, char delimiter = '\n')
+    -> std::optional<size_t> {
+  const size_t head_size = std::min(bytes.size(), LineReaderOptions{}.block_size);
+  const std::string_view head = bytes.substr(0, head_size);
+  if (detect_record_encoding(head, delimiter) != EncodingHint::Utf8)
+    return std::nullopt;
+  return has_utf8_bom(head) ? size_t{3} : size_t{0};
+}
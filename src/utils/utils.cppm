@@ -26,6 +26,7 @@
 export module utils;
 
 export import :utf8;
+export import :channel;
 export import :console;
 export import :textio;
 export import :wildcard;
@@ -34,3 +35,11 @@ export import :json;
 export import :file_io;
 export import :cppbar;
 export import :encoding;
+export import :regex;
+export import :literal_set;
+export import :text_counts;
+export import :cpu_features;
+export import :crc;
+export import :digest;
+export import :hash;
+export import :checksum;
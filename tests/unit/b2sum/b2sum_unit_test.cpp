@@ -19,4 +19,103 @@ TEST(b2sum, b2sum_basic) {
   TEST_LOG("b2sum output", r.stdout_text);
 
   EXPECT_EQ(r.exit_code, 0);
-}
\ No newline at end of file
+}
+
+TEST(b2sum, b2sum_known_digests) {
+  TempDir tmp;
+  tmp.write("test.txt", "hello world\n");
+
+  Pipeline p;
+  p.set_cwd(tmp.wpath());
+  p.add(L"b2sum.exe", {L"test.txt"});
+  auto r = p.run();
+
+  EXPECT_EQ(r.exit_code, 0);
+  EXPECT_EQ_TEXT(r.stdout_text,
+                 "fec91c70284c72d0d4e3684788a90de9338a5b2f47f01fedbe203cafd6870871"
+                 "8ae5672d10eca804a8121904047d40d1d6cf11e7a76419357a9469af41f22d01"
+                 "  test.txt\n");
+
+  Pipeline p2;
+  p2.set_cwd(tmp.wpath());
+  p2.add(L"b2sum.exe", {L"-l", L"256", L"test.txt"});
+  auto r2 = p2.run();
+
+  EXPECT_EQ(r2.exit_code, 0);
+  EXPECT_EQ_TEXT(r2.stdout_text,
+                 "c71b05fd1d1c7bf7e928ff18e58db5193e9316416cc26ba9cc9094da80d7011e"
+                 "  test.txt\n");
+
+  // A check list may mix digest lengths
+  tmp.write("sums.b2",
+            "c71b05fd1d1c7bf7e928ff18e58db5193e9316416cc26ba9cc9094da80d7011e  test.txt\n"
+            "BLAKE2b-512 (test.txt) = "
+            "fec91c70284c72d0d4e3684788a90de9338a5b2f47f01fedbe203cafd6870871"
+            "8ae5672d10eca804a8121904047d40d1d6cf11e7a76419357a9469af41f22d01\n");
+  Pipeline p3;
+  p3.set_cwd(tmp.wpath());
+  p3.add(L"b2sum.exe", {L"-c", L"sums.b2"});
+  auto r3 = p3.run();
+
+  EXPECT_EQ(r3.exit_code, 0);
+  EXPECT_EQ_TEXT(r3.stdout_text, "test.txt: OK\ntest.txt: OK\n");
+}
+
+// RFC 7693 Appendix A and lengths either side of the 128-byte block boundary
+TEST(b2sum, b2sum_known_answers) {
+  TempDir tmp;
+  tmp.write("abc", "abc");
+  std::vector<std::wstring> files = {L"abc"};
+  for (int n : {0, 111, 112, 127, 128, 129, 239, 240, 255, 256, 257, 1000}) {
+    tmp.write("a" + std::to_string(n), std::string(n, 'a'));
+    files.push_back(L"a" + std::to_wstring(n));
+  }
+  const std::string expected =
+      "ba80a53f981c4d0d6a2797b69f12f6e94c212f14685ac4b74b12bb6fdbffa2d1"
+      "7d87c5392aab792dc252d5de4533cc9518d38aa8dbf1925ab92386edd4009923"
+      "  abc\n"
+      "786a02f742015903c6c6fd852552d272912f4740e15847618a86e217f71f5419"
+      "d25e1031afee585313896444934eb04b903a685b1448b755d56f701afe9be2ce"
+      "  a0\n"
+      "4b7f5437a69577c9136df89878e35f91b8a18d16d424b998765d6b94cea4d5ef"
+      "4df470f34641cfe452d7551215da3a3541e5f5fe6359ab4629888136a3abf900"
+      "  a111\n"
+      "e1201705a397d6ef5ccdad804976df1fb38d8a3d058415f39213829fd1e3e6a3"
+      "4a0182fbba7ecce7e4a664a3f847e870a6821267d318791b59809758614ccf7b"
+      "  a112\n"
+      "94596b9d6199c807c40ae1a935f3633ba5a8dd5655f7f1bd44f5285b1ce8dbb0"
+      "054771eba409539df85a963296d28788807105153c90fa3ec3d761228e90f8b8"
+      "  a127\n"
+      "fc6c71f688f43ea7d60817478808f3cac753e61571865c95adbc2d9122c943a7"
+      "6b92c2cb1047ef3fe7bf6e436ec1d0a99a9e5b216780bf7fed9d7ca91d3a8f3b"
+      "  a128\n"
+      "55e6e0eb418149a8af92fd9ddc99254781b2f522a131b4f4d984404b71a00e11"
+      "67b8124d5dcddd4c6977b299392335d6edd303da6d344d74bbef2d38101b232b"
+      "  a129\n"
+      "6f48651fbd69813ee2daf7eb79bc2f334244b1816e17b1e5ba77cb31c2447970"
+      "7d66a7c760478382ace3a3b8628bc1bb83cf55d06bc7f99bd87d74e33920f8ec"
+      "  a239\n"
+      "15fafe0d8746abd4d12972f87ed0d0d2cc86d98c7a11c40e62a9736b44bbd403"
+      "2462f7e89ffade454674678894f0a426dee8bcfcb549d29503967f31202fae41"
+      "  a240\n"
+      "792ea4793169359d36f13f472d4b427b40c663c680f47932a0cf3a110e6d8430"
+      "5f46825da8ada4d83a6247bb09fb3bb1b5781186a81b2aff8c9c39a597e447dd"
+      "  a255\n"
+      "0eee13d0c73a2710c5015a8b4be0a16120bb88f826b662951ffe4b3b81441cfd"
+      "ce1f712c58e237dba72a0dad7f9c86b9745ea0b4b3b850ff3a260fb7df9d3e81"
+      "  a256\n"
+      "0d686cbcff66401ab36b8a8e7fcf4085319eb296eaa55c4470c36bccaff2ecd4"
+      "b3572c32ed48e8bb97cc5d08302a79b3a26e751feb7f565b19fa0d8f65247dd1"
+      "  a257\n"
+      "d6a69459fe93fc6b9537ed4336e5099e0dcca3e97290a412500ed7a0daffb03d"
+      "80cf3650a20e0591f748e10c3c534945ee83d5f2c9722f1a68d98b8c01af23fd"
+      "  a1000\n";
+
+  Pipeline p;
+  p.set_cwd(tmp.wpath());
+  p.add(L"b2sum.exe", files);
+  auto r = p.run();
+
+  EXPECT_EQ(r.exit_code, 0);
+  EXPECT_EQ_TEXT(r.stdout_text, expected);
+}
@@ -152,3 +152,29 @@ TEST(cat, cat_wildcard_char_class) {
   EXPECT_TRUE(r.stdout_text.find("bbb") != std::string::npos);
   EXPECT_TRUE(r.stdout_text.find("ccc") == std::string::npos);
 }
+
+TEST(cat, cat_large_copy_and_show_all) {
+  std::string big;
+  for (int i = 0; i < 3 * 1024 * 1024; ++i) {
+    big.push_back(static_cast<char>((i * 7) & 0xFF));
+  }
+  TempDir tmp;
+  tmp.write("big.bin", big);
+  tmp.write("a.txt", "a\tb\x01\n\n\n\x7f\n");
+
+  Pipeline p1;
+  p1.set_cwd(tmp.wpath());
+  p1.add(L"cat.exe", {L"big.bin", L"a.txt"});
+  auto r1 = p1.run();
+
+  EXPECT_EQ(r1.exit_code, 0);
+  EXPECT_TRUE(r1.stdout_text == big + "a\tb\x01\n\n\n\x7f\n");
+
+  Pipeline p2;
+  p2.set_cwd(tmp.wpath());
+  p2.add(L"cat.exe", {L"-A", L"-s", L"a.txt"});
+  auto r2 = p2.run();
+
+  EXPECT_EQ(r2.exit_code, 0);
+  EXPECT_EQ_TEXT(r2.stdout_text, "a^Ib^A$\n$\n^?$\n");
+}
@@ -64,4 +64,31 @@ TEST(cksum, cksum_empty) {
 
   EXPECT_EQ(r.exit_code, 0);
   EXPECT_TRUE(r.stdout_text.find("0") != std::string::npos);
-}
\ No newline at end of file
+}
+
+TEST(cksum, cksum_known_values_and_crc32b) {
+  TempDir tmp;
+  tmp.write("test.txt", "hello\n");
+  // Large enough for the folded path, with a tail that is not a whole block
+  std::string big;
+  for (int i = 0; i < 100000; ++i) big += static_cast<char>('a' + i % 26);
+  tmp.write("big.txt", big);
+
+  Pipeline p;
+  p.set_cwd(tmp.wpath());
+  p.add(L"cksum.exe", {L"test.txt", L"missing.txt", L"big.txt"});
+  auto r = p.run();
+
+  EXPECT_EQ(r.exit_code, 1);
+  EXPECT_EQ_TEXT(r.stdout_text,
+                 "3015617425 6 test.txt\n"
+                 "909384261 100000 big.txt\n");
+
+  Pipeline p2;
+  p2.set_stdin("hello\n");
+  p2.add(L"cksum.exe", {L"-a", L"crc32b"});
+  auto r2 = p2.run();
+
+  EXPECT_EQ(r2.exit_code, 0);
+  EXPECT_EQ_TEXT(r2.stdout_text, "909783072 6\n");
+}
@@ -64,3 +64,24 @@ TEST(cut, cut_unsupported_bytes) {
 
   EXPECT_EQ(r.exit_code, 2);
 }
+
+TEST(cut, cut_records_spanning_read_blocks) {
+  TempDir tmp;
+  // Lines long enough that records straddle the reader's block boundaries.
+  const std::string filler(100000, 'x');
+  std::string content = "\xEF\xBB\xBF";
+  std::string expected;
+  for (int i = 0; i < 10; ++i) {
+    content += filler + ":" + std::to_string(i) + "\n";
+    expected += std::to_string(i) + "\n";
+  }
+  tmp.write("a.txt", content);
+
+  Pipeline p;
+  p.set_cwd(tmp.wpath());
+  p.add(L"cut.exe", {L"-d", L":", L"-f", L"2", L"a.txt"});
+  auto r = p.run();
+
+  EXPECT_EQ(r.exit_code, 0);
+  EXPECT_EQ_TEXT(r.stdout_text, expected);
+}
@@ -161,3 +161,276 @@ TEST(grep, grep_wildcard_pattern) {
   EXPECT_TRUE(r.stdout_text.find("#pragma once") == std::string::npos);
   EXPECT_TRUE(r.stdout_text.find("just text") == std::string::npos);
 }
+
+TEST(grep, grep_output_larger_than_buffer) {
+  TempDir tmp;
+  std::string content;
+  for (int i = 0; i < 20000; ++i) {
+    content += "line " + std::to_string(i) + "\n";
+  }
+  tmp.write("big.txt", content);
+
+  Pipeline p1;
+  p1.set_cwd(tmp.wpath());
+  p1.add(L"grep.exe", {L"line", L"big.txt"});
+  auto r1 = p1.run();
+
+  EXPECT_EQ(r1.exit_code, 0);
+  EXPECT_EQ(r1.stdout_text.size(), content.size());
+  EXPECT_TRUE(r1.stdout_text == content);
+
+  Pipeline p2;
+  p2.set_cwd(tmp.wpath());
+  p2.add(L"grep.exe", {L"--line-buffered", L"line", L"big.txt"});
+  auto r2 = p2.run();
+
+  EXPECT_EQ(r2.exit_code, 0);
+  EXPECT_TRUE(r2.stdout_text == content);
+}
+
+TEST(grep, grep_posix_basic_and_extended) {
+  TempDir tmp;
+  tmp.write("a.txt", "ab+c\nabbc\nfoo|bar\nbar\n");
+
+  // In a BRE '+' and '|' are ordinary characters
+  Pipeline p1;
+  p1.set_cwd(tmp.wpath());
+  p1.add(L"grep.exe", {L"b+c", L"a.txt"});
+  auto r1 = p1.run();
+  EXPECT_EQ(r1.exit_code, 0);
+  EXPECT_EQ_TEXT(r1.stdout_text, "ab+c\n");
+
+  Pipeline p2;
+  p2.set_cwd(tmp.wpath());
+  p2.add(L"grep.exe", {L"-E", L"-x", L"ab+c|bar", L"a.txt"});
+  auto r2 = p2.run();
+  EXPECT_EQ(r2.exit_code, 0);
+  EXPECT_EQ_TEXT(r2.stdout_text, "abbc\nbar\n");
+
+  // Leftmost-longest: the whole "abb" is reported, not "a"
+  Pipeline p3;
+  p3.set_cwd(tmp.wpath());
+  p3.add(L"grep.exe", {L"-o", L"a\\|ab*", L"a.txt"});
+  auto r3 = p3.run();
+  EXPECT_EQ(r3.exit_code, 0);
+  EXPECT_EQ_TEXT(r3.stdout_text, "ab\nabb\na\na\n");
+}
+
+TEST(grep, grep_fixed_strings_pattern_file) {
+  TempDir tmp;
+  tmp.write("pats.txt", "he\nHello\nworld\n");
+  tmp.write("a.txt", "say HELLO there\nnothing\nWorld peace\n");
+
+  Pipeline p;
+  p.set_cwd(tmp.wpath());
+  p.add(L"grep.exe", {L"-F", L"-i", L"-o", L"-f", L"pats.txt", L"a.txt"});
+  auto r = p.run();
+
+  // Longest pattern wins at a given start; matches do not overlap
+  EXPECT_EQ(r.exit_code, 0);
+  EXPECT_EQ_TEXT(r.stdout_text, "HELLO\nhe\nWorld\n");
+}
+
+TEST(grep, grep_sparse_matches_in_large_file) {
+  TempDir tmp;
+  std::string content;
+  size_t error_offset = 0;
+  for (int i = 1; i <= 5000; ++i) {
+    if (i == 4321) {
+      error_offset = content.size();
+      content += "ERROR disk full\n";
+    } else {
+      content += "entry " + std::to_string(i) + "\n";
+    }
+  }
+  content += "ERROR no newline";
+  tmp.write("big.log", content);
+
+  Pipeline p1;
+  p1.set_cwd(tmp.wpath());
+  p1.add(L"grep.exe", {L"-n", L"-b", L"ERR.R", L"big.log"});
+  auto r1 = p1.run();
+  EXPECT_EQ(r1.exit_code, 0);
+  EXPECT_EQ_TEXT(r1.stdout_text,
+                 "4321:" + std::to_string(error_offset) +
+                     ":ERROR disk full\n5001:" +
+                     std::to_string(content.size() - 16) +
+                     ":ERROR no newline\n");
+
+  Pipeline p2;
+  p2.set_cwd(tmp.wpath());
+  p2.add(L"grep.exe", {L"-c", L"-E", L"^entry [0-9]+0$", L"big.log"});
+  auto r2 = p2.run();
+  EXPECT_EQ(r2.exit_code, 0);
+  EXPECT_EQ_TEXT(r2.stdout_text, "500\n");
+
+  // A line with only an empty match is still selected
+  Pipeline p3;
+  p3.set_cwd(tmp.wpath());
+  p3.add(L"grep.exe", {L"-c", L"x*", L"big.log"});
+  auto r3 = p3.run();
+  EXPECT_EQ(r3.exit_code, 0);
+  EXPECT_EQ_TEXT(r3.stdout_text, "5001\n");
+
+  Pipeline p4;
+  p4.set_cwd(tmp.wpath());
+  p4.add(L"grep.exe", {L"-q", L"-F", L"disk", L"big.log"});
+  EXPECT_EQ(p4.run().exit_code, 0);
+}
+
+TEST(grep, grep_recursive_parallel_keeps_walk_order) {
+  TempDir tmp;
+  std::filesystem::create_directories(tmp.path / "src" / "sub");
+  for (int i = 0; i < 40; ++i) {
+    auto name = "src/f" + std::to_string(i) + ".txt";
+    tmp.write(name, i % 3 == 0 ? "needle\nhay\nneedle\n" : "hay\n");
+    tmp.write("src/sub/g" + std::to_string(i) + ".txt", "needle\n");
+  }
+
+  Pipeline p1;
+  p1.set_cwd(tmp.wpath());
+  p1.add(L"grep.exe", {L"-r", L"-c", L"-j", L"1", L"needle", L"src"});
+  auto r1 = p1.run();
+
+  Pipeline p2;
+  p2.set_cwd(tmp.wpath());
+  p2.add(L"grep.exe", {L"-r", L"-c", L"-j", L"4", L"needle", L"src"});
+  auto r2 = p2.run();
+
+  EXPECT_EQ(r1.exit_code, 0);
+  EXPECT_EQ(r2.exit_code, 0);
+  EXPECT_EQ_TEXT(r2.stdout_text, r1.stdout_text);
+
+  Pipeline p3;
+  p3.set_cwd(tmp.wpath());
+  p3.add(L"grep.exe", {L"-r", L"-l", L"--unordered", L"-j", L"4", L"needle",
+                       L"src"});
+  auto r3 = p3.run();
+  EXPECT_EQ(r3.exit_code, 0);
+  EXPECT_EQ(std::count(r3.stdout_text.begin(), r3.stdout_text.end(), '\n'),
+            54);
+
+  Pipeline p4;
+  p4.set_cwd(tmp.wpath());
+  p4.add(L"grep.exe", {L"-r", L"-q", L"-j", L"4", L"needle", L"src"});
+  auto r4 = p4.run();
+  EXPECT_EQ(r4.exit_code, 0);
+  EXPECT_TRUE(r4.stdout_text.empty());
+}
+
+TEST(grep, grep_binary_files) {
+  TempDir tmp;
+  tmp.write("a.txt", "needle in text\n");
+  tmp.write_bytes("b.bin", {'M', 'Z', '\0', '\1', 'n', 'e', 'e', 'd', 'l',
+                            'e', '\n', 'n', 'e', 'e', 'd', 'l', 'e', '\n'});
+
+  // Matching lines of a binary file are replaced by one notice
+  Pipeline p1;
+  p1.set_cwd(tmp.wpath());
+  p1.add(L"grep.exe", {L"needle", L"a.txt", L"b.bin"});
+  auto r1 = p1.run();
+  EXPECT_EQ(r1.exit_code, 0);
+  EXPECT_EQ_TEXT(r1.stdout_text, "a.txt:needle in text\n");
+  EXPECT_TRUE(r1.stderr_text.find("b.bin: binary file matches") !=
+              std::string::npos);
+
+  // Counting is unaffected
+  Pipeline p2;
+  p2.set_cwd(tmp.wpath());
+  p2.add(L"grep.exe", {L"-c", L"needle", L"b.bin"});
+  auto r2 = p2.run();
+  EXPECT_EQ(r2.exit_code, 0);
+  EXPECT_EQ_TEXT(r2.stdout_text, "2\n");
+
+  Pipeline p3;
+  p3.set_cwd(tmp.wpath());
+  p3.add(L"grep.exe", {L"-I", L"-l", L"needle", L"a.txt", L"b.bin"});
+  auto r3 = p3.run();
+  EXPECT_EQ(r3.exit_code, 0);
+  EXPECT_EQ_TEXT(r3.stdout_text, "a.txt\n");
+
+  Pipeline p4;
+  p4.set_cwd(tmp.wpath());
+  p4.add(L"grep.exe", {L"-a", L"-o", L"needle", L"b.bin"});
+  auto r4 = p4.run();
+  EXPECT_EQ(r4.exit_code, 0);
+  EXPECT_EQ_TEXT(r4.stdout_text, "needle\nneedle\n");
+}
+
+TEST(grep, grep_fixed_word_tries_shorter_patterns) {
+  // "a-" is the longest match at 0 but not a word; "a" at the same start is
+  Pipeline p;
+  p.set_stdin("a-x\nab\n");
+  p.add(L"grep.exe", {L"-F", L"-w", L"-o", L"-e", L"a-", L"-e", L"a"});
+  auto r = p.run();
+  EXPECT_EQ(r.exit_code, 0);
+  EXPECT_EQ_TEXT(r.stdout_text, "a\n");
+}
+
+TEST(grep, grep_back_references) {
+  Pipeline p;
+  p.set_stdin("abab\nabba\naa\n");
+  p.add(L"grep.exe", {L"\\(a\\)\\1"});
+  auto r = p.run();
+  EXPECT_EQ(r.exit_code, 0);
+  EXPECT_EQ_TEXT(r.stdout_text, "aa\n");
+
+  Pipeline p2;
+  p2.set_stdin("abab\nabba\naa\n");
+  p2.add(L"grep.exe", {L"-E", L"(ab)\\1"});
+  auto r2 = p2.run();
+  EXPECT_EQ(r2.exit_code, 0);
+  EXPECT_EQ_TEXT(r2.stdout_text, "abab\n");
+}
+
+// Denies everyone listing a directory for the lifetime of the guard
+class UnreadableDirectory {
+ public:
+  explicit UnreadableDirectory(std::filesystem::path dir)
+      : dir_(std::move(dir)) {
+    std::filesystem::create_directories(dir_);
+    icacls({L"/deny", L"*S-1-1-0:(RX)"});
+  }
+
+  ~UnreadableDirectory() { icacls({L"/remove:d", L"*S-1-1-0"}); }
+
+ private:
+  std::filesystem::path dir_;
+
+  void icacls(std::vector<std::wstring> args) const {
+    wchar_t system_dir[MAX_PATH];
+    GetSystemDirectoryW(system_dir, MAX_PATH);
+    args.insert(args.begin(), dir_.wstring());
+    Pipeline p;
+    p.add(std::wstring(system_dir) + L"\\icacls.exe", args);
+    p.run();
+  }
+};
+
+TEST(grep, grep_recursive_reports_unreadable_directory) {
+  TempDir tmp;
+  tmp.write("a/hit.txt", "needle\n");
+  tmp.write("z/hit.txt", "needle\n");
+  UnreadableDirectory locked(tmp.path / "m");
+
+  // -j 1 walks on the calling thread, -j 4 on the parallel walker
+  for (const wchar_t* threads : {L"1", L"4"}) {
+    Pipeline p;
+    p.set_cwd(tmp.wpath());
+    p.add(L"grep.exe", {L"-r", L"-l", L"-j", threads, L"needle", L"."});
+    auto r = p.run();
+    EXPECT_EQ(r.exit_code, 2);
+    // The walk goes on past m to z
+    EXPECT_TRUE(r.stdout_text.find("a\\hit.txt") != std::string::npos);
+    EXPECT_TRUE(r.stdout_text.find("z\\hit.txt") != std::string::npos);
+    EXPECT_TRUE(r.stderr_text.starts_with("grep: "));
+    EXPECT_TRUE(r.stderr_text.find("\\m: ") != std::string::npos);
+
+    Pipeline quiet;
+    quiet.set_cwd(tmp.wpath());
+    quiet.add(L"grep.exe", {L"-r", L"-s", L"-j", threads, L"needle", L"."});
+    auto rq = quiet.run();
+    EXPECT_EQ(rq.exit_code, 2);
+    EXPECT_TRUE(rq.stderr_text.empty());
+  }
+}
@@ -96,4 +96,98 @@ TEST(md5sum, md5sum_wildcard) {
   EXPECT_TRUE(r.stdout_text.find("file1.txt") != std::string::npos);
   EXPECT_TRUE(r.stdout_text.find("file2.txt") != std::string::npos);
   EXPECT_TRUE(r.stdout_text.find("other.log") == std::string::npos);
-}
\ No newline at end of file
+}
+
+TEST(md5sum, md5sum_known_digests) {
+  TempDir tmp;
+  tmp.write("a.txt", "hello world\n");
+  tmp.write("b.txt", "hello");
+  tmp.write("empty.txt", "");
+  // Several files at once may be hashed side by side; the large one keeps
+  // going after the others have finished
+  std::string big;
+  for (int i = 0; i < 100000; ++i) big += static_cast<char>('a' + i % 26);
+  tmp.write("big.txt", big);
+
+  Pipeline p;
+  p.set_cwd(tmp.wpath());
+  p.add(L"md5sum.exe",
+        {L"a.txt", L"big.txt", L"missing.txt", L"b.txt", L"empty.txt"});
+  auto r = p.run();
+
+  EXPECT_EQ(r.exit_code, 1);
+  EXPECT_EQ_TEXT(r.stdout_text,
+                 "6f5902ac237024bdd0c176cb93063dc4  a.txt\n"
+                 "eeb430124056cecabbfbc7e88a1a8b46  big.txt\n"
+                 "5d41402abc4b2a76b9719d911017c592  b.txt\n"
+                 "d41d8cd98f00b204e9800998ecf8427e  empty.txt\n");
+}
+
+TEST(md5sum, md5sum_check) {
+  TempDir tmp;
+  tmp.write("a.txt", "hello world\n");
+  tmp.write("b.txt", "changed");
+  tmp.write("sums.md5",
+            "6f5902ac237024bdd0c176cb93063dc4  a.txt\n"
+            "# comment\n"
+            "MD5 (b.txt) = 5d41402abc4b2a76b9719d911017c592\n"
+            "not a checksum line\n");
+
+  Pipeline p;
+  p.set_cwd(tmp.wpath());
+  p.add(L"md5sum.exe", {L"-c", L"sums.md5"});
+  auto r = p.run();
+
+  EXPECT_EQ(r.exit_code, 1);
+  EXPECT_EQ_TEXT(r.stdout_text, "a.txt: OK\nb.txt: FAILED\n");
+
+  Pipeline p2;
+  p2.set_cwd(tmp.wpath());
+  p2.add(L"md5sum.exe", {L"--check", L"--quiet", L"sums.md5"});
+  auto r2 = p2.run();
+
+  EXPECT_EQ(r2.exit_code, 1);
+  EXPECT_EQ_TEXT(r2.stdout_text, "b.txt: FAILED\n");
+}
+
+// NIST vectors and lengths either side of the padding boundaries, in one
+// run so that several files share the eight-lane AVX2 kernel.
+// WINUXCMD_CPU_DISABLE then forces each slower kernel in turn.
+TEST(md5sum, md5sum_known_answers_each_kernel) {
+  TempDir tmp;
+  tmp.write("abc", "abc");
+  tmp.write("nist448",
+            "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq");
+  std::vector<std::wstring> files = {L"abc", L"nist448"};
+  for (int n : {0, 55, 56, 63, 64, 65, 119, 120, 127, 128, 129, 1000}) {
+    tmp.write("a" + std::to_string(n), std::string(n, 'a'));
+    files.push_back(L"a" + std::to_wstring(n));
+  }
+  const std::string expected =
+      "900150983cd24fb0d6963f7d28e17f72  abc\n"
+      "8215ef0796a20bcaaae116d3876c664a  nist448\n"
+      "d41d8cd98f00b204e9800998ecf8427e  a0\n"
+      "ef1772b6dff9a122358552954ad0df65  a55\n"
+      "3b0c8ac703f828b04c6c197006d17218  a56\n"
+      "b06521f39153d618550606be297466d5  a63\n"
+      "014842d480b571495a4a0363793f7367  a64\n"
+      "c743a45e0d2e6a95cb859adae0248435  a65\n"
+      "8a7bd0732ed6a28ce75f6dabc90e1613  a119\n"
+      "5f61c0ccad4cac44c75ff505e1f1e537  a120\n"
+      "020406e1d05cdc2aa287641f7ae2cc39  a127\n"
+      "e510683b3f5ffe4093d021808bc6ff70  a128\n"
+      "b325dc1c6f5e7a2b7cf465b9feab7948  a129\n"
+      "cabe45dcc9ae5b66ba86600cca6b8ba8  a1000\n";
+
+  // Without AVX2 MD5 falls back to the portable code
+  for (const wchar_t* disable : {L"", L"avx2"}) {
+    Pipeline p;
+    p.set_cwd(tmp.wpath());
+    p.set_env(L"WINUXCMD_CPU_DISABLE", disable);
+    p.add(L"md5sum.exe", files);
+    auto r = p.run();
+
+    EXPECT_EQ(r.exit_code, 0);
+    EXPECT_EQ_TEXT(r.stdout_text, expected);
+  }
+}
@@ -190,3 +190,27 @@ TEST(sed, wildcard_question_mark) {
   EXPECT_TRUE(r.stdout_text.find("REPLACED baz") != std::string::npos);
   EXPECT_TRUE(r.stdout_text.find("REPLACED qux") == std::string::npos);
 }
+
+TEST(sed, basic_regex_groups_and_empty_matches) {
+  TempDir tmp;
+  tmp.write("a.txt", "hello world\nabc\n");
+
+  Pipeline p;
+  p.set_cwd(tmp.wpath());
+  p.add(L"sed.exe",
+        {L"1s/\\(o\\) \\(w\\)/\\2 \\1[&]/", L"2s/b*/-/g", L"a.txt"});
+  auto r = p.run();
+
+  EXPECT_EQ(r.exit_code, 0);
+  EXPECT_EQ_TEXT(r.stdout_text, "hellw o[o w]orld\n-a-c-\n");
+}
+
+TEST(sed, basic_regex_back_references) {
+  Pipeline p;
+  p.set_stdin("axxb\nxy\n");
+  p.add(L"sed.exe", {L"s/\\(x\\)\\1/[\\1]/"});
+  auto r = p.run();
+
+  EXPECT_EQ(r.exit_code, 0);
+  EXPECT_EQ_TEXT(r.stdout_text, "a[x]b\nxy\n");
+}
@@ -66,3 +66,66 @@ TEST(sha1sum, sha1sum_empty_file) {
   // SHA1 of empty string is: da39a3ee5e6b4b0d3255bfef95601890afd80709
   EXPECT_TRUE(r.stdout_text.find("da39a3ee5e6b4b0d3255bfef95601890afd80709") != std::string::npos);
 }
+
+TEST(sha1sum, sha1sum_known_digests) {
+  TempDir tmp;
+  tmp.write("a.txt", "hello world\n");
+  tmp.write("c.txt", "hello world\n");
+  std::string big;
+  for (int i = 0; i < 100000; ++i) big += static_cast<char>('a' + i % 26);
+  tmp.write("big.txt", big);
+
+  Pipeline p;
+  p.set_cwd(tmp.wpath());
+  p.add(L"sha1sum.exe", {L"a.txt", L"big.txt", L"c.txt"});
+  auto r = p.run();
+
+  EXPECT_EQ(r.exit_code, 0);
+  EXPECT_EQ_TEXT(r.stdout_text,
+                 "22596363b3de40b06f981fb85d82312e8c0ed511  a.txt\n"
+                 "807fab54d72457cf4bf06cbd68d831f2a87fb08c  big.txt\n"
+                 "22596363b3de40b06f981fb85d82312e8c0ed511  c.txt\n");
+}
+
+// NIST vectors and lengths either side of the padding boundaries, in one
+// run so that several files share the eight-lane AVX2 kernel.
+// WINUXCMD_CPU_DISABLE then forces each slower kernel in turn.
+TEST(sha1sum, sha1sum_known_answers_each_kernel) {
+  TempDir tmp;
+  tmp.write("abc", "abc");
+  tmp.write("nist448",
+            "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq");
+  std::vector<std::wstring> files = {L"abc", L"nist448"};
+  for (int n : {0, 55, 56, 63, 64, 65, 119, 120, 127, 128, 129, 1000}) {
+    tmp.write("a" + std::to_string(n), std::string(n, 'a'));
+    files.push_back(L"a" + std::to_wstring(n));
+  }
+  const std::string expected =
+      "a9993e364706816aba3e25717850c26c9cd0d89d  abc\n"
+      "84983e441c3bd26ebaae4aa1f95129e5e54670f1  nist448\n"
+      "da39a3ee5e6b4b0d3255bfef95601890afd80709  a0\n"
+      "c1c8bbdc22796e28c0e15163d20899b65621d65a  a55\n"
+      "c2db330f6083854c99d4b5bfb6e8f29f201be699  a56\n"
+      "03f09f5b158a7a8cdad920bddc29b81c18a551f5  a63\n"
+      "0098ba824b5c16427bd7a1122a5a442a25ec644d  a64\n"
+      "11655326c708d70319be2610e8a57d9a5b959d3b  a65\n"
+      "ee971065aaa017e0632a8ca6c77bb3bf8b1dfc56  a119\n"
+      "f34c1488385346a55709ba056ddd08280dd4c6d6  a120\n"
+      "89d95fa32ed44a7c610b7ee38517ddf57e0bb975  a127\n"
+      "ad5b3fdbcb526778c2839d2f151ea753995e26a0  a128\n"
+      "d96debf1bdcbc896e6c134ea76e8141f40d78536  a129\n"
+      "291e9a6c66994949b57ba5e650361e98fc36b1ba  a1000\n";
+
+  // "sha" takes away SHA-NI, "avx2" the eight-lane kernel, and both
+  // leave the portable code
+  for (const wchar_t* disable : {L"", L"sha", L"avx2", L"avx2,sha"}) {
+    Pipeline p;
+    p.set_cwd(tmp.wpath());
+    p.set_env(L"WINUXCMD_CPU_DISABLE", disable);
+    p.add(L"sha1sum.exe", files);
+    auto r = p.run();
+
+    EXPECT_EQ(r.exit_code, 0);
+    EXPECT_EQ_TEXT(r.stdout_text, expected);
+  }
+}
@@ -19,4 +19,59 @@ TEST(sha224sum, sha224sum_basic) {
   TEST_LOG("sha224sum output", r.stdout_text);
 
   EXPECT_EQ(r.exit_code, 0);
-}
\ No newline at end of file
+}
+
+TEST(sha224sum, sha224sum_known_digest) {
+  Pipeline p;
+  p.set_stdin("hello world\n");
+  p.add(L"sha224sum.exe", {});
+  auto r = p.run();
+
+  EXPECT_EQ(r.exit_code, 0);
+  EXPECT_EQ_TEXT(r.stdout_text,
+                 "95041dd60ab08c0bf5636d50be85"
+                 "fe9790300f39eb84602858a9b430  -\n");
+}
+
+// NIST vectors and lengths either side of the padding boundaries, in one
+// run so that several files share the eight-lane AVX2 kernel.
+// WINUXCMD_CPU_DISABLE then forces each slower kernel in turn.
+TEST(sha224sum, sha224sum_known_answers_each_kernel) {
+  TempDir tmp;
+  tmp.write("abc", "abc");
+  tmp.write("nist448",
+            "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq");
+  std::vector<std::wstring> files = {L"abc", L"nist448"};
+  for (int n : {0, 55, 56, 63, 64, 65, 119, 120, 127, 128, 129, 1000}) {
+    tmp.write("a" + std::to_string(n), std::string(n, 'a'));
+    files.push_back(L"a" + std::to_wstring(n));
+  }
+  const std::string expected =
+      "23097d223405d8228642a477bda255b32aadbce4bda0b3f7e36c9da7  abc\n"
+      "75388b16512776cc5dba5da1fd890150b0c6455cb4f58b1952522525  nist448\n"
+      "d14a028c2a3a2bc9476102bb288234c415a2b01f828ea62ac5b3e42f  a0\n"
+      "fb0bd626a70c28541dfa781bb5cc4d7d7f56622a58f01a0b1ddd646f  a55\n"
+      "d40854fc9caf172067136f2e29e1380b14626bf6f0dd06779f820dcd  a56\n"
+      "1d4e051f4d6fed2a63fd2421e65834cec00d64456553de3496ae8b1d  a63\n"
+      "a88cd5cde6d6fe9136a4e58b49167461ea95d388ca2bdb7afdc3cbf4  a64\n"
+      "ff8716f600af42959d0efb52e1f21b01bb328733009344d511c299fb  a65\n"
+      "e000e6709d26667b631faa7fc1bd404eb4774003c5fb4f51a0184875  a119\n"
+      "66924e30a9929327e7a6cf03747397226ed2efc180ebe3dea7132a79  a120\n"
+      "0822db3f33424aead078f71ed05f30edc077a3c254b7c79c89a7a4a1  a127\n"
+      "39873a2441c56608137850f4c54dde157710b9a2b83c8bdc756dd643  a128\n"
+      "321318841bcc3d0da8185fdd8643f3e4ac629d18f298fc141324074f  a129\n"
+      "4e8f0ce90b64661a2b5e84be6d93a7d9b76871062f1814433d04a03d  a1000\n";
+
+  // "sha" takes away SHA-NI, "avx2" the eight-lane kernel, and both
+  // leave the portable code
+  for (const wchar_t* disable : {L"", L"sha", L"avx2", L"avx2,sha"}) {
+    Pipeline p;
+    p.set_cwd(tmp.wpath());
+    p.set_env(L"WINUXCMD_CPU_DISABLE", disable);
+    p.add(L"sha224sum.exe", files);
+    auto r = p.run();
+
+    EXPECT_EQ(r.exit_code, 0);
+    EXPECT_EQ_TEXT(r.stdout_text, expected);
+  }
+}
@@ -50,4 +50,59 @@ TEST(sha256sum, sha256sum_stdin) {
 
   EXPECT_EQ(r.exit_code, 0);
   EXPECT_TRUE(r.stdout_text.length() > 64);
-}
\ No newline at end of file
+}
+
+TEST(sha256sum, sha256sum_known_digest) {
+  Pipeline p;
+  p.set_stdin("hello world\n");
+  p.add(L"sha256sum.exe", {});
+  auto r = p.run();
+
+  EXPECT_EQ(r.exit_code, 0);
+  EXPECT_EQ_TEXT(r.stdout_text,
+                 "a948904f2f0f479b8f8197694b30184b"
+                 "0d2ed1c1cd2a1ec0fb85d299a192a447  -\n");
+}
+
+// NIST vectors and lengths either side of the padding boundaries, in one
+// run so that several files share the eight-lane AVX2 kernel.
+// WINUXCMD_CPU_DISABLE then forces each slower kernel in turn.
+TEST(sha256sum, sha256sum_known_answers_each_kernel) {
+  TempDir tmp;
+  tmp.write("abc", "abc");
+  tmp.write("nist448",
+            "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq");
+  std::vector<std::wstring> files = {L"abc", L"nist448"};
+  for (int n : {0, 55, 56, 63, 64, 65, 119, 120, 127, 128, 129, 1000}) {
+    tmp.write("a" + std::to_string(n), std::string(n, 'a'));
+    files.push_back(L"a" + std::to_wstring(n));
+  }
+  const std::string expected =
+      "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad  abc\n"
+      "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1  nist448\n"
+      "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855  a0\n"
+      "9f4390f8d30c2dd92ec9f095b65e2b9ae9b0a925a5258e241c9f1e910f734318  a55\n"
+      "b35439a4ac6f0948b6d6f9e3c6af0f5f590ce20f1bde7090ef7970686ec6738a  a56\n"
+      "7d3e74a05d7db15bce4ad9ec0658ea98e3f06eeecf16b4c6fff2da457ddc2f34  a63\n"
+      "ffe054fe7ae0cb6dc65c3af9b61d5209f439851db43d0ba5997337df154668eb  a64\n"
+      "635361c48bb9eab14198e76ea8ab7f1a41685d6ad62aa9146d301d4f17eb0ae0  a65\n"
+      "31eba51c313a5c08226adf18d4a359cfdfd8d2e816b13f4af952f7ea6584dcfb  a119\n"
+      "2f3d335432c70b580af0e8e1b3674a7c020d683aa5f73aaaedfdc55af904c21c  a120\n"
+      "c57e9278af78fa3cab38667bef4ce29d783787a2f731d4e12200270f0c32320a  a127\n"
+      "6836cf13bac400e9105071cd6af47084dfacad4e5e302c94bfed24e013afb73e  a128\n"
+      "c12cb024a2e5551cca0e08fce8f1c5e314555cc3fef6329ee994a3db752166ae  a129\n"
+      "41edece42d63e8d9bf515a9ba6932e1c20cbc9f5a5d134645adb5db1b9737ea3  a1000\n";
+
+  // "sha" takes away SHA-NI, "avx2" the eight-lane kernel, and both
+  // leave the portable code
+  for (const wchar_t* disable : {L"", L"sha", L"avx2", L"avx2,sha"}) {
+    Pipeline p;
+    p.set_cwd(tmp.wpath());
+    p.set_env(L"WINUXCMD_CPU_DISABLE", disable);
+    p.add(L"sha256sum.exe", files);
+    auto r = p.run();
+
+    EXPECT_EQ(r.exit_code, 0);
+    EXPECT_EQ_TEXT(r.stdout_text, expected);
+  }
+}
@@ -19,4 +19,81 @@ TEST(sha384sum, sha384sum_basic) {
   TEST_LOG("sha384sum output", r.stdout_text);
 
   EXPECT_EQ(r.exit_code, 0);
-}
\ No newline at end of file
+}
+
+TEST(sha384sum, sha384sum_known_digest) {
+  Pipeline p;
+  p.set_stdin("hello world\n");
+  p.add(L"sha384sum.exe", {});
+  auto r = p.run();
+
+  EXPECT_EQ(r.exit_code, 0);
+  EXPECT_EQ_TEXT(r.stdout_text,
+                 "6b3b69ff0a404f28d75e98a066d3fc64fffd9940870cc68b"
+                 "ece28545b9a75086b343d7a1366838083e4b8f3ca6fd3c80  -\n");
+}
+
+// NIST vectors and lengths either side of the padding boundaries
+TEST(sha384sum, sha384sum_known_answers) {
+  TempDir tmp;
+  tmp.write("abc", "abc");
+  tmp.write("nist896",
+            "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmn"
+            "hijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu");
+  std::vector<std::wstring> files = {L"abc", L"nist896"};
+  for (int n : {0, 111, 112, 127, 128, 129, 239, 240, 255, 256, 257, 1000}) {
+    tmp.write("a" + std::to_string(n), std::string(n, 'a'));
+    files.push_back(L"a" + std::to_wstring(n));
+  }
+  const std::string expected =
+      "cb00753f45a35e8bb5a03d699ac65007272c32ab0eded1631a8b605a43ff5bed"
+      "8086072ba1e7cc2358baeca134c825a7"
+      "  abc\n"
+      "09330c33f71147e83d192fc782cd1b4753111b173b3b05d22fa08086e3b0f712"
+      "fcc7c71a557e2db966c3e9fa91746039"
+      "  nist896\n"
+      "38b060a751ac96384cd9327eb1b1e36a21fdb71114be07434c0cc7bf63f6e1da"
+      "274edebfe76f65fbd51ad2f14898b95b"
+      "  a0\n"
+      "3c37955051cb5c3026f94d551d5b5e2ac38d572ae4e07172085fed81f8466b8f"
+      "90dc23a8ffcdea0b8d8e58e8fdacc80a"
+      "  a111\n"
+      "187d4e07cb306103c69967bf544d0dfbe9042577599c73c330abc0cb64c61236"
+      "d5ed565ee19119d8c31779a38f791fcd"
+      "  a112\n"
+      "9bd06b1763c2cf7aef40e795dc65bc96d59c41b537f3ad72ebdefd485476b571"
+      "7c1aeb37c327fe9c1831b12b9efd08ae"
+      "  a127\n"
+      "edb12730a366098b3b2beac75a3bef1b0969b15c48e2163c23d96994f8d1bef7"
+      "60c7e27f3c464d3829f56c0d53808b0b"
+      "  a128\n"
+      "39b6f5a7b0e781dbc419f72e49b30eaac10f2c98c4403bc610da31067fd1b48f"
+      "324138c8615d2b496d08d73d5e865326"
+      "  a129\n"
+      "e247c35f4bc1aa38026f8880c8c97305545d00d3f859e00c57d1c1f0a176b3c6"
+      "b749c4eb081f08bd0fba500969cd056a"
+      "  a239\n"
+      "4d86957beab348a29180f02d02564ac1d32f5b4c217ece2b038f7c184f0cafc8"
+      "c8e438eb82aa03796170e0a7ce8c0675"
+      "  a240\n"
+      "c4f7cca9698ddde4fb9947aebd9da1bda11e9413958d1a5d26f32fbec24bf34c"
+      "b95f7c7eb84445cbaf84a63d3c705aa6"
+      "  a255\n"
+      "ee89d91a5f594f72052c561e5c2458280439eaa77cc1352e27893931c6d9ce5d"
+      "869fb8a024358c460adc1af9f4fe5b4a"
+      "  a256\n"
+      "2b18aee790b03d49f71d4c036bdc8dc3216660f29f92978768f7b7844a36986a"
+      "400b98186a294af656dc54985dd77e87"
+      "  a257\n"
+      "f54480689c6b0b11d0303285d9a81b21a93bca6ba5a1b4472765dca4da45ee32"
+      "8082d469c650cd3b61b16d3266ab8ced"
+      "  a1000\n";
+
+  Pipeline p;
+  p.set_cwd(tmp.wpath());
+  p.add(L"sha384sum.exe", files);
+  auto r = p.run();
+
+  EXPECT_EQ(r.exit_code, 0);
+  EXPECT_EQ_TEXT(r.stdout_text, expected);
+}
@@ -19,4 +19,82 @@ TEST(sha512sum, sha512sum_basic) {
   TEST_LOG("sha512sum output", r.stdout_text);
 
   EXPECT_EQ(r.exit_code, 0);
-}
\ No newline at end of file
+}
+
+TEST(sha512sum, sha512sum_known_digest) {
+  Pipeline p;
+  p.set_stdin("hello world\n");
+  p.add(L"sha512sum.exe", {});
+  auto r = p.run();
+
+  EXPECT_EQ(r.exit_code, 0);
+  EXPECT_EQ_TEXT(r.stdout_text,
+                 "db3974a97f2407b7cae1ae637c0030687a11913274d578492558e39c16c017de"
+                 "84eacdc8c62fe34ee4e12b4b1428817f09b6a2760c3f8a664ceae94d2434a593"
+                 "  -\n");
+}
+
+// NIST vectors and lengths either side of the padding boundaries
+TEST(sha512sum, sha512sum_known_answers) {
+  TempDir tmp;
+  tmp.write("abc", "abc");
+  tmp.write("nist896",
+            "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmn"
+            "hijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu");
+  std::vector<std::wstring> files = {L"abc", L"nist896"};
+  for (int n : {0, 111, 112, 127, 128, 129, 239, 240, 255, 256, 257, 1000}) {
+    tmp.write("a" + std::to_string(n), std::string(n, 'a'));
+    files.push_back(L"a" + std::to_wstring(n));
+  }
+  const std::string expected =
+      "ddaf35a193617abacc417349ae20413112e6fa4e89a97ea20a9eeee64b55d39a"
+      "2192992a274fc1a836ba3c23a3feebbd454d4423643ce80e2a9ac94fa54ca49f"
+      "  abc\n"
+      "8e959b75dae313da8cf4f72814fc143f8f7779c6eb9f7fa17299aeadb6889018"
+      "501d289e4900f7e4331b99dec4b5433ac7d329eeb6dd26545e96e55b874be909"
+      "  nist896\n"
+      "cf83e1357eefb8bdf1542850d66d8007d620e4050b5715dc83f4a921d36ce9ce"
+      "47d0d13c5d85f2b0ff8318d2877eec2f63b931bd47417a81a538327af927da3e"
+      "  a0\n"
+      "fa9121c7b32b9e01733d034cfc78cbf67f926c7ed83e82200ef8681819692176"
+      "0b4beff48404df811b953828274461673c68d04e297b0eb7b2b4d60fc6b566a2"
+      "  a111\n"
+      "c01d080efd492776a1c43bd23dd99d0a2e626d481e16782e75d54c2503b5dc32"
+      "bd05f0f1ba33e568b88fd2d970929b719ecbb152f58f130a407c8830604b70ca"
+      "  a112\n"
+      "828613968b501dc00a97e08c73b118aa8876c26b8aac93df128502ab360f91ba"
+      "b50a51e088769a5c1eff4782ace147dce3642554199876374291f5d921629502"
+      "  a127\n"
+      "b73d1929aa615934e61a871596b3f3b33359f42b8175602e89f7e06e5f658a24"
+      "3667807ed300314b95cacdd579f3e33abdfbe351909519a846d465c59582f321"
+      "  a128\n"
+      "4f681e0bd53cda4b5a2041cc8a06f2eabde44fb16c951fbd5b87702f07aeab61"
+      "1565b19c47fde30587177ebb852e3971bbd8d3fd30da18d71037dfbd98420429"
+      "  a129\n"
+      "52c853cb8d907f3d4d6b889beb027985d7c273486d75f8baf26f80d24e90c74c"
+      "6c3de3e22131582380a7d14d43f2941a31385439cd6ddc469f628015e50bf286"
+      "  a239\n"
+      "4c296d90c61052a62ffb1dd196f1b7b09373b1f93e71836baebf89690546b759"
+      "5684dbe9467a8e484fa0d1094272b4344a7c24f5fee8daedeb0bf549c985ab5f"
+      "  a240\n"
+      "d8b5a659e365f704ab114ae7079a8da24fb9997b3052a4a63b37d654652bad6f"
+      "bdd2b52d737e20a9d5ac3c5831d6afdd32ff737a3dd95269d2793bc2aa850aab"
+      "  a255\n"
+      "6a9169eb662f136d87374070e8828b3e615a7eca32a89446e9225b02832709be"
+      "095e635c824a2bb70213ba2ea0ababac0809827843992c851903b7ac0c136699"
+      "  a256\n"
+      "17fa1d01865805f9e657c5f5088754d19913eb418577b03cd040b99e5e1354fd"
+      "31d0d7f24b5474c62b49e3271860859510909685c5811eba23b06e1e3369899d"
+      "  a257\n"
+      "67ba5535a46e3f86dbfbed8cbbaf0125c76ed549ff8b0b9e03e0c88cf90fa634"
+      "fa7b12b47d77b694de488ace8d9a65967dc96df599727d3292a8d9d447709c97"
+      "  a1000\n";
+
+  Pipeline p;
+  p.set_cwd(tmp.wpath());
+  p.add(L"sha512sum.exe", files);
+  auto r = p.run();
+
+  EXPECT_EQ(r.exit_code, 0);
+  EXPECT_EQ_TEXT(r.stdout_text, expected);
+}
@@ -25,6 +25,9 @@
  */
 #include "framework/winuxtest.h"
 
+#include <algorithm>
+#include <numeric>
+
 TEST(sort, sort_basic_lexicographic) {
   TempDir tmp;
   tmp.write("a.txt", "pear\napple\nbanana\n");
@@ -78,16 +81,34 @@ TEST(sort, sort_output_file_option) {
   EXPECT_EQ_TEXT(tmp.read("out.txt"), "x\ny\nz\n");
 }
 
-TEST(sort, sort_unsupported_merge) {
+TEST(sort, sort_merge_sorted_inputs) {
   TempDir tmp;
-  tmp.write("a.txt", "x\n");
+  tmp.write("a.txt", "a,3\nb,2\nc,1\n");
+  tmp.write("b.txt", "d,2\nb,2\nb,0\n");
 
+  // Inputs are already sorted by -k 2 -r; -m only merges them
   Pipeline p;
   p.set_cwd(tmp.wpath());
-  p.add(L"sort.exe", {L"-m", L"a.txt"});
+  p.add(L"sort.exe",
+        {L"-m", L"-t", L",", L"-k", L"2", L"-r", L"-u", L"a.txt", L"b.txt"});
   auto r = p.run();
 
-  EXPECT_EQ(r.exit_code, 2);
+  EXPECT_EQ(r.exit_code, 0);
+  EXPECT_EQ_TEXT(r.stdout_text, "a,3\nd,2\nb,2\nc,1\nb,0\n");
+}
+
+TEST(sort, sort_merge_in_place) {
+  TempDir tmp;
+  tmp.write("a.txt", "apple\ncherry\n");
+  tmp.write("b.txt", "banana\ndate\n");
+
+  Pipeline p;
+  p.set_cwd(tmp.wpath());
+  p.add(L"sort.exe", {L"-m", L"-o", L"a.txt", L"a.txt", L"b.txt"});
+  auto r = p.run();
+
+  EXPECT_EQ(r.exit_code, 0);
+  EXPECT_EQ_TEXT(tmp.read("a.txt"), "apple\nbanana\ncherry\ndate\n");
 }
 
 TEST(sort, sort_uniq_pipeline_accepts_utf16le_stdin_with_bom) {
@@ -137,3 +158,107 @@ TEST(sort, sort_wildcard) {
   EXPECT_TRUE(r.stdout_text.find("aaa") == std::string::npos);
   EXPECT_TRUE(r.stdout_text.find("zzz") == std::string::npos);
 }
+
+TEST(sort, sort_spills_to_temporary_runs) {
+  TempDir tmp;
+  std::filesystem::create_directories(tmp.path / "runs");
+  std::string input;
+  for (int i = 0; i < 3000; ++i) {
+    input += "/data/item" + std::to_string((i * 7919) % 1000) + "\n";
+  }
+  tmp.write("big.txt", input);
+
+  Pipeline p1;
+  p1.set_cwd(tmp.wpath());
+  p1.add(L"sort.exe", {L"-u", L"big.txt"});
+  auto r1 = p1.run();
+  EXPECT_EQ(r1.exit_code, 0);
+
+  // A 4 KiB buffer forces dozens of runs and several merge passes
+  Pipeline p2;
+  p2.set_cwd(tmp.wpath());
+  p2.add(L"sort.exe", {L"-u", L"-S", L"4K", L"-T", L"runs", L"--batch-size",
+                       L"3", L"--compress-runs", L"big.txt"});
+  auto r2 = p2.run();
+  EXPECT_EQ(r2.exit_code, 0);
+  EXPECT_EQ_TEXT(r2.stdout_text, r1.stdout_text);
+  EXPECT_TRUE(std::filesystem::is_empty(tmp.path / "runs"));
+}
+
+TEST(sort, sort_parallel_matches_single_thread) {
+  TempDir tmp;
+  // Enough lines to split between threads, with many duplicate keys
+  std::string input;
+  for (int i = 0; i < 200000; ++i) {
+    std::string word = "key" + std::to_string((i * 7919) % 5000);
+    if (i % 3 == 0) word[0] = 'K';
+    input += word + "," + std::to_string(i % 7) + "\n";
+  }
+  tmp.write("big.txt", input);
+
+  for (const wchar_t* flag : {L"-f", L"-u"}) {
+    Pipeline p1;
+    p1.set_cwd(tmp.wpath());
+    p1.add(L"sort.exe", {flag, L"-t", L",", L"-k", L"1", L"--parallel", L"1",
+                         L"big.txt"});
+    auto r1 = p1.run();
+    EXPECT_EQ(r1.exit_code, 0);
+
+    Pipeline p2;
+    p2.set_cwd(tmp.wpath());
+    p2.add(L"sort.exe", {flag, L"-t", L",", L"-k", L"1", L"--parallel", L"4",
+                         L"big.txt"});
+    auto r2 = p2.run();
+    EXPECT_EQ(r2.exit_code, 0);
+    EXPECT_EQ_TEXT(r2.stdout_text, r1.stdout_text);
+  }
+}
+
+TEST(sort, sort_radix_paths_on_large_inputs) {
+  TempDir tmp;
+  // Shared prefixes for the byte-wise path; the second field is numeric
+  std::vector<std::pair<std::string, int>> rows;
+  std::string input;
+  for (int i = 0; i < 3000; ++i) {
+    std::string path = "/srv/logs/" + std::to_string((i * 37) % 500);
+    int size = (i * 7919) % 2000 - 1000;
+    rows.emplace_back(path, size);
+    input += path + " " + std::to_string(size) + "\n";
+  }
+  tmp.write("big.txt", input);
+
+  std::vector<std::string> lines;
+  for (const auto& [path, size] : rows) {
+    lines.push_back(path + " " + std::to_string(size));
+  }
+
+  std::vector<std::string> descending = lines;
+  std::sort(descending.begin(), descending.end(), std::greater<>());
+  std::string expected_bytes;
+  for (const auto& line : descending) expected_bytes += line + "\n";
+
+  Pipeline p1;
+  p1.set_cwd(tmp.wpath());
+  p1.add(L"sort.exe", {L"-r", L"big.txt"});
+  auto r1 = p1.run();
+  EXPECT_EQ(r1.exit_code, 0);
+  EXPECT_EQ_TEXT(r1.stdout_text, expected_bytes);
+
+  std::vector<size_t> order(rows.size());
+  std::iota(order.begin(), order.end(), size_t{0});
+  std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    if (rows[a].second != rows[b].second) {
+      return rows[a].second < rows[b].second;
+    }
+    return lines[a] < lines[b];
+  });
+  std::string expected_numeric;
+  for (size_t i : order) expected_numeric += lines[i] + "\n";
+
+  Pipeline p2;
+  p2.set_cwd(tmp.wpath());
+  p2.add(L"sort.exe", {L"-n", L"-k", L"2", L"big.txt"});
+  auto r2 = p2.run();
+  EXPECT_EQ(r2.exit_code, 0);
+  EXPECT_EQ_TEXT(r2.stdout_text, expected_numeric);
+}
@@ -19,4 +19,25 @@ TEST(sum, sum_basic) {
   TEST_LOG("sum output", r.stdout_text);
 
   EXPECT_EQ(r.exit_code, 0);
-}
\ No newline at end of file
+}
+
+TEST(sum, sum_bsd_and_sysv) {
+  TempDir tmp;
+  tmp.write("test.txt", "hello");
+
+  Pipeline p;
+  p.set_cwd(tmp.wpath());
+  p.add(L"sum.exe", {L"test.txt"});
+  auto r = p.run();
+
+  EXPECT_EQ(r.exit_code, 0);
+  EXPECT_EQ_TEXT(r.stdout_text, "08403     1 test.txt\n");
+
+  Pipeline p2;
+  p2.set_stdin("hello");
+  p2.add(L"sum.exe", {L"-s"});
+  auto r2 = p2.run();
+
+  EXPECT_EQ(r2.exit_code, 0);
+  EXPECT_EQ_TEXT(r2.stdout_text, "532 1\n");
+}
@@ -65,4 +65,49 @@ TEST(tac, tac_single_line) {
 
   EXPECT_EQ(r.exit_code, 0);
   EXPECT_EQ_TEXT(r.stdout_text, "only one line\n");
-}
\ No newline at end of file
+}
+
+TEST(tac, tac_files_reversed_one_at_a_time) {
+  TempDir tmp;
+  tmp.write("a.txt", "a1\na2\n");
+  tmp.write("b.txt", "b1\nb2\n");
+
+  Pipeline p;
+  p.set_cwd(tmp.wpath());
+  p.add(L"tac.exe", {L"a.txt", L"b.txt"});
+
+  auto r = p.run();
+
+  EXPECT_EQ(r.exit_code, 0);
+  EXPECT_EQ_TEXT(r.stdout_text, "a2\na1\nb2\nb1\n");
+}
+
+TEST(tac, tac_separator_before_and_regex) {
+  TempDir tmp;
+  tmp.write("list.txt", "a,b,c,");
+  tmp.write("story.txt", "One. Two! Three? ");
+
+  Pipeline p1;
+  p1.set_cwd(tmp.wpath());
+  p1.add(L"tac.exe", {L"-s", L",", L"list.txt"});
+  auto r1 = p1.run();
+
+  EXPECT_EQ(r1.exit_code, 0);
+  EXPECT_EQ_TEXT(r1.stdout_text, "c,b,a,");
+
+  Pipeline p2;
+  p2.set_cwd(tmp.wpath());
+  p2.add(L"tac.exe", {L"-b", L"-s", L",", L"list.txt"});
+  auto r2 = p2.run();
+
+  EXPECT_EQ(r2.exit_code, 0);
+  EXPECT_EQ_TEXT(r2.stdout_text, ",,c,ba");
+
+  Pipeline p3;
+  p3.set_cwd(tmp.wpath());
+  p3.add(L"tac.exe", {L"-r", L"-s", L"[.!?] ", L"story.txt"});
+  auto r3 = p3.run();
+
+  EXPECT_EQ(r3.exit_code, 0);
+  EXPECT_EQ_TEXT(r3.stdout_text, "Three? Two! One. ");
+}
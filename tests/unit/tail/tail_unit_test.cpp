@@ -59,6 +59,27 @@ TEST(tail, tail_plus_lines_and_bytes) {
   EXPECT_EQ_TEXT(r2.stdout_text, "pha\nbeta\ngamma\n");
 }
 
+TEST(tail, tail_unterminated_last_line) {
+  TempDir tmp;
+  tmp.write("a.txt", "one\ntwo\n\nthree");
+
+  Pipeline p1;
+  p1.set_cwd(tmp.wpath());
+  p1.add(L"tail.exe", {L"-n", L"2", L"a.txt"});
+  auto r1 = p1.run();
+
+  EXPECT_EQ(r1.exit_code, 0);
+  EXPECT_EQ_TEXT(r1.stdout_text, "\nthree");
+
+  Pipeline p2;
+  p2.set_cwd(tmp.wpath());
+  p2.add(L"tail.exe", {L"-c", L"4", L"a.txt"});
+  auto r2 = p2.run();
+
+  EXPECT_EQ(r2.exit_code, 0);
+  EXPECT_EQ_TEXT(r2.stdout_text, "hree");
+}
+
 TEST(tail, tail_follow_option_recognized) {
   // Verify that -f flag is recognized and doesn't error out
   // (actual follow mode is a long-running operation tested manually)
@@ -96,3 +117,255 @@ TEST(tail, tail_wildcard) {
   EXPECT_TRUE(r.stdout_text.find("line6") != std::string::npos);
   EXPECT_TRUE(r.stdout_text.find("log3") == std::string::npos);
 }
+
+TEST(tail, tail_large_input_file_and_pipe) {
+  std::string data;
+  for (int i = 0; i < 200000; ++i) {
+    data += "line " + std::to_string(i) + "\n";
+  }
+  TempDir tmp;
+  tmp.write("big.txt", data);
+
+  Pipeline p1;
+  p1.set_cwd(tmp.wpath());
+  p1.add(L"tail.exe", {L"-n", L"3", L"big.txt"});
+  auto r1 = p1.run();
+
+  EXPECT_EQ(r1.exit_code, 0);
+  EXPECT_EQ_TEXT(r1.stdout_text, "line 199997\nline 199998\nline 199999\n");
+
+  Pipeline p2;
+  p2.set_stdin(data);
+  p2.add(L"tail.exe", {L"-n", L"2"});
+  auto r2 = p2.run();
+
+  EXPECT_EQ(r2.exit_code, 0);
+  EXPECT_EQ_TEXT(r2.stdout_text, "line 199998\nline 199999\n");
+
+  Pipeline p3;
+  p3.set_stdin(data);
+  p3.add(L"tail.exe", {L"-c", L"7"});
+  auto r3 = p3.run();
+
+  EXPECT_EQ(r3.exit_code, 0);
+  EXPECT_EQ_TEXT(r3.stdout_text, "199999\n");
+}
+
+TEST(tail, tail_follow_ends_with_pid) {
+  TempDir tmp;
+  tmp.write("a.txt", "line1\nline2\nline3\n");
+
+  // No process has this ID, so following stops after one check.
+  Pipeline p1;
+  p1.set_cwd(tmp.wpath());
+  p1.add(L"tail.exe", {L"-n", L"2", L"--follow=name", L"--pid=2147483644",
+                       L"a.txt"});
+  auto r1 = p1.run();
+
+  EXPECT_EQ(r1.exit_code, 0);
+  EXPECT_EQ_TEXT(r1.stdout_text, "line2\nline3\n");
+
+  Pipeline p2;
+  p2.set_cwd(tmp.wpath());
+  p2.add(L"tail.exe", {L"--follow=sometimes", L"a.txt"});
+  auto r2 = p2.run();
+
+  EXPECT_NE(r2.exit_code, 0);
+}
+
+// A tail.exe that follows files in a TempDir, and the writer.bat process
+// whose pid (--pid) bounds the follow. The writer waits for a "go" file,
+// runs its commands against the followed files and then waits for a "done"
+// file before exiting, so each test decides when the file changes and when
+// tail stops. Standard output and error of tail are read back together as
+// they arrive.
+class FollowRun {
+ public:
+  FollowRun(const TempDir& tmp, std::string_view writer_commands,
+            std::vector<std::wstring> args) {
+    const std::string poll = " ( ping -n 1 -w 10 127.0.0.1 >nul & goto ";
+    std::string script = "@echo off\r\n:go\r\nif not exist go" + poll +
+                         "go )\r\n";
+    script += writer_commands;
+    script += ":done\r\nif not exist done" + poll + "done )\r\n";
+    tmp.write("writer.bat", script);
+    dir_ = tmp.wpath();
+    if (!start(L"cmd.exe /d /c writer.bat", nullptr, writer_)) return;
+
+    SECURITY_ATTRIBUTES sa{sizeof(sa), nullptr, TRUE};
+    HANDLE write = nullptr;
+    if (!CreatePipe(&output_, &write, &sa, 0)) return;
+    SetHandleInformation(output_, HANDLE_FLAG_INHERIT, 0);
+
+    std::wstring tail_cmd =
+        L"\"" + ProjectPaths::exe(L"tail.exe").wstring() + L"\" --pid=" +
+        std::to_wstring(writer_.dwProcessId);
+    for (const auto& arg : args) tail_cmd += L" " + arg;
+    start(tail_cmd, write, tail_);
+    CloseHandle(write);
+  }
+
+  ~FollowRun() {
+    for (auto* pi : {&tail_, &writer_}) {
+      if (!pi->hProcess) continue;
+      TerminateProcess(pi->hProcess, 1);
+      WaitForSingleObject(pi->hProcess, INFINITE);
+      CloseHandle(pi->hProcess);
+    }
+    if (output_) CloseHandle(output_);
+  }
+
+  bool started() const { return writer_.hProcess && tail_.hProcess; }
+
+  /// Let the writer run its commands
+  void go() const { touch(L"go"); }
+
+  /// Let the writer exit, which ends the follow
+  void done() const { touch(L"done"); }
+
+  /// Read tail's output until TEXT shows up (false after 10 s)
+  bool wait_for(std::string_view text) {
+    const auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (output_text_.find(text) == std::string::npos) {
+      DWORD available = 0;
+      if (!PeekNamedPipe(output_, nullptr, 0, nullptr, &available, nullptr)) {
+        return false;
+      }
+      if (available == 0) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        continue;
+      }
+      std::string chunk(available, '\0');
+      DWORD got = 0;
+      if (!ReadFile(output_, chunk.data(), available, &got, nullptr)) {
+        return false;
+      }
+      output_text_.append(chunk, 0, got);
+    }
+    return true;
+  }
+
+  /// Wait up to 10 s for tail to exit, then read the rest of its output.
+  /// @return tail's exit code, or -1 when it is still following
+  int finish() {
+    if (!tail_.hProcess ||
+        WaitForSingleObject(tail_.hProcess, 10000) != WAIT_OBJECT_0) {
+      return -1;
+    }
+    char buffer[4096];
+    DWORD got = 0;
+    while (ReadFile(output_, buffer, sizeof(buffer), &got, nullptr) &&
+           got > 0) {
+      output_text_.append(buffer, got);
+    }
+    DWORD code = 0;
+    GetExitCodeProcess(tail_.hProcess, &code);
+    return static_cast<int>(code);
+  }
+
+  const std::string& output() const { return output_text_; }
+
+ private:
+  std::wstring dir_;
+  PROCESS_INFORMATION writer_{};
+  PROCESS_INFORMATION tail_{};
+  HANDLE output_ = nullptr;
+  std::string output_text_;
+
+  bool start(std::wstring cmd, HANDLE output, PROCESS_INFORMATION& pi) {
+    STARTUPINFOW si{};
+    si.cb = sizeof(si);
+    if (output) {
+      si.dwFlags = STARTF_USESTDHANDLES;
+      si.hStdInput = GetStdHandle(STD_INPUT_HANDLE);
+      si.hStdOutput = output;
+      si.hStdError = output;
+    }
+    if (!CreateProcessW(nullptr, cmd.data(), nullptr, nullptr,
+                        output != nullptr, CREATE_NO_WINDOW, nullptr,
+                        dir_.c_str(), &si, &pi)) {
+      pi = {};
+      return false;
+    }
+    CloseHandle(pi.hThread);
+    pi.hThread = nullptr;
+    return true;
+  }
+
+  void touch(const wchar_t* name) const {
+    std::ofstream(std::filesystem::path(dir_) / name).put('\n');
+  }
+};
+
+TEST(tail, tail_follow_prints_appended_bytes) {
+  TempDir tmp;
+  tmp.write("a.txt", "one\n");
+
+  FollowRun run(tmp, ">>a.txt echo two\r\n", {L"-f", L"a.txt"});
+  EXPECT_TRUE(run.started());
+  EXPECT_TRUE(run.wait_for("one\n"));
+  run.go();
+  EXPECT_TRUE(run.wait_for("two"));
+  run.done();
+
+  EXPECT_EQ(run.finish(), 0);
+  EXPECT_EQ_TEXT(run.output(), "one\ntwo\n");
+}
+
+TEST(tail, tail_follow_name_reopens_rotated_file) {
+  TempDir tmp;
+  tmp.write("app.log", "first generation\n");
+
+  // Between the rename and the new file tail may see no file at all, so
+  // --retry keeps the name and either message leads to the new file.
+  FollowRun run(tmp,
+                "ren app.log app.log.1\r\n"
+                ">app.log echo second generation\r\n",
+                {L"--follow=name", L"--retry", L"app.log"});
+  EXPECT_TRUE(run.started());
+  EXPECT_TRUE(run.wait_for("first generation\n"));
+  run.go();
+  EXPECT_TRUE(run.wait_for("following new file"));
+  EXPECT_TRUE(run.wait_for("second generation"));
+  run.done();
+
+  // The new file is printed from its start and the old one is not repeated
+  EXPECT_EQ(run.finish(), 0);
+  const auto& out = run.output();
+  EXPECT_LT(out.find("following new file"), out.find("second generation"));
+  EXPECT_EQ(out.find("first generation"), out.rfind("first generation"));
+}
+
+TEST(tail, tail_follow_reports_truncation) {
+  TempDir tmp;
+  tmp.write("a.txt", "a longer first line\n");
+
+  FollowRun run(tmp, ">a.txt echo short\r\n", {L"-f", L"a.txt"});
+  EXPECT_TRUE(run.started());
+  EXPECT_TRUE(run.wait_for("a longer first line\n"));
+  run.go();
+  EXPECT_TRUE(run.wait_for("tail: a.txt: file truncated"));
+  EXPECT_TRUE(run.wait_for("short"));
+  run.done();
+
+  EXPECT_EQ(run.finish(), 0);
+  EXPECT_LT(run.output().find("file truncated"), run.output().find("short"));
+}
+
+TEST(tail, tail_follow_retry_waits_for_missing_file) {
+  TempDir tmp;
+
+  FollowRun run(tmp, ">late.txt echo arrived\r\n",
+                {L"--follow=name", L"--retry", L"late.txt"});
+  EXPECT_TRUE(run.started());
+  EXPECT_TRUE(run.wait_for("tail: cannot open 'late.txt'"));
+  run.go();
+  EXPECT_TRUE(run.wait_for("'late.txt' has appeared;  following new file"));
+  EXPECT_TRUE(run.wait_for("arrived"));
+  run.done();
+
+  // The file was missing at startup, which still sets the exit status.
+  EXPECT_EQ(run.finish(), 1);
+}
@@ -96,3 +96,43 @@ TEST(uniq, uniq_all_repeated) {
   EXPECT_EQ(r.exit_code, 0);
   EXPECT_EQ_TEXT(r.stdout_text, "a\na\nc\nc\n");
 }
+
+TEST(uniq, uniq_unsorted_groups_non_adjacent_lines) {
+  TempDir tmp;
+  tmp.write("a.txt", "GET /a\nPOST /b\nget /a\nGET /c\nPOST /b\n");
+
+  Pipeline p1;
+  p1.set_cwd(tmp.wpath());
+  p1.add(L"uniq.exe", {L"--unsorted", L"-c", L"-i", L"a.txt"});
+  auto r1 = p1.run();
+  EXPECT_EQ(r1.exit_code, 0);
+  EXPECT_EQ_TEXT(r1.stdout_text,
+                 "      2 GET /a\n      2 POST /b\n      1 GET /c\n");
+
+  // -D prints each repeated group together, in first-seen order
+  Pipeline p2;
+  p2.set_cwd(tmp.wpath());
+  p2.add(L"uniq.exe", {L"--unsorted", L"-D", L"-f", L"1", L"a.txt"});
+  auto r2 = p2.run();
+  EXPECT_EQ(r2.exit_code, 0);
+  EXPECT_EQ_TEXT(r2.stdout_text, "GET /a\nget /a\nPOST /b\nPOST /b\n");
+}
+
+TEST(uniq, uniq_utf16le_input) {
+  TempDir tmp;
+  const std::string text = "a\na\nb\n";
+  std::vector<char> data{'\xFF', '\xFE'};
+  for (char c : text) {
+    data.push_back(c);
+    data.push_back('\0');
+  }
+  tmp.write_bytes("a.txt", data);
+
+  Pipeline p;
+  p.set_cwd(tmp.wpath());
+  p.add(L"uniq.exe", {L"-c", L"a.txt"});
+  auto r = p.run();
+
+  EXPECT_EQ(r.exit_code, 0);
+  EXPECT_EQ_TEXT(r.stdout_text, "      2 a\n      1 b\n");
+}
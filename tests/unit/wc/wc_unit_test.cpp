@@ -142,3 +142,34 @@ TEST(wc, wc_wildcard) {
   EXPECT_TRUE(r.stdout_text.find("file2.txt") != std::string::npos);
   EXPECT_TRUE(r.stdout_text.find("other.log") == std::string::npos);
 }
+
+TEST(wc, wc_utf8_chars_and_file_order) {
+  TempDir tmp;
+  // "héllo wörld\n": 12 code points in 14 bytes
+  tmp.write("utf8.txt", "h\xC3\xA9llo w\xC3\xB6rld\n");
+  std::string big;
+  for (int i = 0; i < 50000; ++i) big += "word another\tthird\n";
+  tmp.write("big.txt", big);
+
+  Pipeline p;
+  p.set_cwd(tmp.wpath());
+  p.add(L"wc.exe",
+        {L"-l", L"-w", L"-m", L"-c", L"utf8.txt", L"big.txt", L"missing.txt"});
+
+  TEST_LOG_CMD_LIST("wc.exe", L"-l", L"-w", L"-m", L"-c", L"utf8.txt",
+                    L"big.txt", L"missing.txt");
+
+  auto r = p.run();
+
+  TEST_LOG_EXIT_CODE(r);
+  TEST_LOG("wc output", r.stdout_text);
+
+  // Counted in parallel, printed in argument order; the missing file is
+  // reported and the others still counted
+  EXPECT_EQ(r.exit_code, 1);
+  EXPECT_EQ_TEXT(r.stdout_text,
+                 "1 2 12 14 utf8.txt\n"
+                 "50000 150000 950000 950000 big.txt\n"
+                 "50001 150002 950012 950014 total\n");
+  EXPECT_TRUE(r.stderr_text.find("missing.txt") != std::string::npos);
+}
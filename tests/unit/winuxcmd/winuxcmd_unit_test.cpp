@@ -44,3 +44,334 @@ TEST(winuxcmd, winuxcmd_help_command_topic_shows_command_help) {
   EXPECT_TRUE(r.stdout_text.find("Usage: sort [OPTION]... [FILE]...") !=
               std::string::npos);
 }
+
+// A `winuxcmd --serve --trace` process on a pipe private to this test run.
+// Its standard output, which carries the gate trace, is read back so tests
+// can wait for a request to reach a given step instead of sleeping.
+class TestServer {
+ public:
+  TestServer()
+      : pipe_(L"\\\\.\\pipe\\winuxcmd-test-" +
+              std::to_wstring(GetCurrentProcessId())) {
+    SECURITY_ATTRIBUTES sa{sizeof(sa), nullptr, TRUE};
+    HANDLE write = nullptr;
+    if (!CreatePipe(&trace_, &write, &sa, 0)) return;
+    SetHandleInformation(trace_, HANDLE_FLAG_INHERIT, 0);
+
+    std::wstring cmd = L"\"" + ProjectPaths::exe(L"winuxcmd.exe").wstring() +
+                       L"\" --serve " + pipe_ + L" --trace";
+    STARTUPINFOW si{};
+    si.cb = sizeof(si);
+    si.dwFlags = STARTF_USESTDHANDLES;
+    si.hStdOutput = write;
+    si.hStdError = write;
+    if (CreateProcessW(nullptr, cmd.data(), nullptr, nullptr, TRUE,
+                       CREATE_NO_WINDOW, nullptr, nullptr, &si, &pi_)) {
+      CloseHandle(pi_.hThread);
+    }
+    CloseHandle(write);
+    started_ = pi_.hProcess != nullptr && wait_for("serving on");
+  }
+
+  ~TestServer() {
+    if (pi_.hProcess) {
+      TerminateProcess(pi_.hProcess, 0);
+      WaitForSingleObject(pi_.hProcess, INFINITE);
+      CloseHandle(pi_.hProcess);
+    }
+    if (trace_) CloseHandle(trace_);
+  }
+
+  bool started() const { return started_; }
+  const std::wstring &pipe() const { return pipe_; }
+
+  /// Everything the server has printed so far
+  const std::string &log() const { return log_; }
+
+  /// Read the server's output until TEXT shows up (false after 10 s)
+  bool wait_for(std::string_view text) {
+    const auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (log_.find(text) == std::string::npos) {
+      DWORD available = 0;
+      if (!PeekNamedPipe(trace_, nullptr, 0, nullptr, &available, nullptr)) {
+        return false;
+      }
+      if (available == 0) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        continue;
+      }
+      std::string chunk(available, '\0');
+      DWORD got = 0;
+      if (!ReadFile(trace_, chunk.data(), available, &got, nullptr)) {
+        return false;
+      }
+      log_.append(chunk, 0, got);
+    }
+    return true;
+  }
+
+ private:
+  std::wstring pipe_;
+  PROCESS_INFORMATION pi_{};
+  HANDLE trace_ = nullptr;
+  std::string log_;
+  bool started_ = false;
+};
+
+// An anonymous pipe whose read end a client inherits as standard input, so
+// the test decides when that client's input ends.
+struct InputPipe {
+  HANDLE read = nullptr;
+  HANDLE write = nullptr;
+
+  InputPipe() {
+    SECURITY_ATTRIBUTES sa{sizeof(sa), nullptr, TRUE};
+    CreatePipe(&read, &write, &sa, 0);
+    SetHandleInformation(write, HANDLE_FLAG_INHERIT, 0);
+  }
+
+  ~InputPipe() {
+    close_write();
+    if (read) CloseHandle(read);
+  }
+
+  void close_write() {
+    if (write) CloseHandle(write);
+    write = nullptr;
+  }
+};
+
+// A client started directly rather than through Pipeline, so the test owns
+// its lifetime. Standard output and error go to OUTPUT.
+class ServerClient {
+ public:
+  ServerClient(const TestServer &server, const std::wstring &exe,
+               const std::wstring &cwd, HANDLE input,
+               const std::filesystem::path &output)
+      : output_(output) {
+    SECURITY_ATTRIBUTES sa{sizeof(sa), nullptr, TRUE};
+    HANDLE out = CreateFileW(output.c_str(), GENERIC_WRITE, FILE_SHARE_READ,
+                             &sa, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL,
+                             nullptr);
+
+    // This process's environment plus WINUXCMD_SERVER
+    std::wstring env;
+    if (wchar_t *block = GetEnvironmentStringsW()) {
+      for (const wchar_t *p = block; *p; p += wcslen(p) + 1) {
+        if (_wcsnicmp(p, L"WINUXCMD_SERVER=", 16) == 0) continue;
+        env.append(p);
+        env.push_back(L'\0');
+      }
+      FreeEnvironmentStringsW(block);
+    }
+    env += L"WINUXCMD_SERVER=" + server.pipe();
+    env.push_back(L'\0');
+    env.push_back(L'\0');
+
+    std::wstring cmd = L"\"" + ProjectPaths::exe(exe).wstring() + L"\"";
+    STARTUPINFOW si{};
+    si.cb = sizeof(si);
+    si.dwFlags = STARTF_USESTDHANDLES;
+    si.hStdInput = input;
+    si.hStdOutput = out;
+    si.hStdError = out;
+    if (CreateProcessW(nullptr, cmd.data(), nullptr, nullptr, TRUE,
+                       CREATE_NO_WINDOW | CREATE_UNICODE_ENVIRONMENT,
+                       env.data(), cwd.c_str(), &si, &pi_)) {
+      CloseHandle(pi_.hThread);
+    }
+    if (out != INVALID_HANDLE_VALUE) CloseHandle(out);
+  }
+
+  ~ServerClient() {
+    if (pi_.hProcess) {
+      kill();
+      CloseHandle(pi_.hProcess);
+    }
+  }
+
+  /// Whether the client exited within 10 s
+  bool finished() {
+    return pi_.hProcess &&
+           WaitForSingleObject(pi_.hProcess, 10000) == WAIT_OBJECT_0;
+  }
+
+  void kill() {
+    TerminateProcess(pi_.hProcess, 1);
+    WaitForSingleObject(pi_.hProcess, INFINITE);
+  }
+
+  DWORD exit_code() const {
+    DWORD code = 1;
+    GetExitCodeProcess(pi_.hProcess, &code);
+    return code;
+  }
+
+  std::string output() const {
+    std::ifstream in(output_, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), {});
+  }
+
+ private:
+  std::filesystem::path output_;
+  PROCESS_INFORMATION pi_{};
+};
+
+TEST(winuxcmd, server_runs_os_handle_commands_locally) {
+  TestServer server;
+
+  // stdbuf starts a child on the real standard handles; run in the server,
+  // the child would write to the server's console instead of this pipeline.
+  Pipeline p;
+  p.set_env(L"WINUXCMD_SERVER", server.pipe());
+  p.add(L"stdbuf.exe",
+        {L"-oL", ProjectPaths::exe(L"echo.exe").wstring(), L"hi"});
+  auto r = p.run();
+
+  EXPECT_EQ(r.exit_code, 0);
+  EXPECT_EQ_TEXT(r.stdout_text, "hi\n");
+}
+
+TEST(winuxcmd, server_admits_requests_in_arrival_order) {
+  TestServer server;
+  EXPECT_TRUE(server.started());
+  TempDir dir_a;
+  TempDir dir_b;
+  TempDir out;
+  InputPipe a_input;
+  InputPipe no_input;
+
+  // A holds dir_a until its input ends. B needs dir_b and must wait for A.
+  // C matches A's state but arrives after B, so it must not overtake B.
+  // Each client is started only once the previous one holds its ticket.
+  ServerClient a(server, L"cat.exe", dir_a.wpath(), a_input.read,
+                 out.path / "a.txt");
+  EXPECT_TRUE(server.wait_for("ticket 0 admitted"));
+  ServerClient b(server, L"pwd.exe", dir_b.wpath(), no_input.read,
+                 out.path / "b.txt");
+  EXPECT_TRUE(server.wait_for("ticket 1 queued"));
+  ServerClient c(server, L"pwd.exe", dir_a.wpath(), no_input.read,
+                 out.path / "c.txt");
+  EXPECT_TRUE(server.wait_for("ticket 2 queued"));
+
+  a_input.close_write();
+  EXPECT_TRUE(a.finished());
+  EXPECT_TRUE(b.finished());
+  EXPECT_TRUE(c.finished());
+  EXPECT_TRUE(server.wait_for("ticket 2 admitted"));
+
+  EXPECT_EQ(a.exit_code(), 0u);
+  EXPECT_EQ(b.exit_code(), 0u);
+  EXPECT_EQ(c.exit_code(), 0u);
+  const std::string &log = server.log();
+  EXPECT_TRUE(log.find("ticket 0 released") <
+              log.find("ticket 1 admitted"));
+  EXPECT_TRUE(log.find("ticket 1 admitted") <
+              log.find("ticket 2 admitted"));
+  EXPECT_TRUE(b.output().find(dir_b.path.filename().string()) !=
+              std::string::npos);
+  EXPECT_TRUE(c.output().find(dir_a.path.filename().string()) !=
+              std::string::npos);
+}
+
+TEST(winuxcmd, server_releases_requests_of_disconnected_clients) {
+  TestServer server;
+  EXPECT_TRUE(server.started());
+  TempDir dir_a;
+  TempDir dir_b;
+  TempDir out;
+  InputPipe a_input;  // Never closed: cat would wait forever
+  InputPipe no_input;
+
+  ServerClient a(server, L"cat.exe", dir_a.wpath(), a_input.read,
+                 out.path / "a.txt");
+  EXPECT_TRUE(server.wait_for("ticket 0 admitted"));
+  a.kill();
+  EXPECT_TRUE(server.wait_for("ticket 0 released"));
+
+  // A different cwd needs the gate to itself
+  no_input.close_write();
+  ServerClient b(server, L"pwd.exe", dir_b.wpath(), no_input.read,
+                 out.path / "b.txt");
+  EXPECT_TRUE(b.finished());
+  EXPECT_EQ(b.exit_code(), 0u);
+  EXPECT_TRUE(b.output().find(dir_b.path.filename().string()) !=
+              std::string::npos);
+}
+
+// `winuxcmd --pipeline LINE` splits LINE like the REPL and runs it on
+// in-process stages, or exits with 2 where the REPL would use the shell.
+static CommandResult run_pipeline_line(const std::wstring &line,
+                                       const std::wstring &cwd = L"") {
+  Pipeline p;
+  if (!cwd.empty()) p.set_cwd(cwd);
+  p.add(L"winuxcmd.exe", {L"--pipeline", line});
+  return p.run();
+}
+
+TEST(winuxcmd, pipeline_split_respects_quotes) {
+  // A `|` inside quotes would leave a stage starting with `b"`, which is
+  // not a builtin, so a wrong split shows up as exit status 2.
+  auto r1 = run_pipeline_line(L"echo \"a | b\" | wc -l");
+  EXPECT_EQ(r1.exit_code, 0);
+  EXPECT_TRUE(r1.stdout_text.find('1') != std::string::npos);
+
+  auto r2 = run_pipeline_line(L"echo 'a || b' | wc -l");
+  EXPECT_EQ(r2.exit_code, 0);
+  EXPECT_TRUE(r2.stdout_text.find('1') != std::string::npos);
+
+  auto r3 = run_pipeline_line(L"echo a || echo b");
+  EXPECT_EQ(r3.exit_code, 2);
+  EXPECT_TRUE(r3.stdout_text.empty());
+}
+
+TEST(winuxcmd, pipeline_falls_back_for_other_lines) {
+  const wchar_t *lines[] = {
+      L"echo a",                   // No pipe at all
+      L"echo a | nosuchcommand",   // Not a builtin
+      L"echo a | xargs echo",      // Hands its handles to a child
+      L"echo a | less",            // Talks to the console
+      L"echo a | sort > out.txt",  // Redirection
+      L"echo a |",                 // Empty stage
+  };
+  for (const wchar_t *line : lines) {
+    auto r = run_pipeline_line(line);
+    EXPECT_EQ(r.exit_code, 2);
+    EXPECT_TRUE(r.stdout_text.empty());
+  }
+}
+
+TEST(winuxcmd, pipeline_exit_status_is_pipefail) {
+  TempDir tmp;
+  EXPECT_EQ(run_pipeline_line(L"true | true").exit_code, 0);
+  EXPECT_EQ(run_pipeline_line(L"false | true").exit_code, 1);
+  // grep exits 2 for a missing file: the rightmost failure wins
+  EXPECT_EQ(run_pipeline_line(L"grep x missing.txt | false", tmp.wpath())
+                .exit_code,
+            1);
+  EXPECT_EQ(run_pipeline_line(L"false | grep x missing.txt", tmp.wpath())
+                .exit_code,
+            2);
+  EXPECT_EQ(run_pipeline_line(L"grep x missing.txt | true", tmp.wpath())
+                .exit_code,
+            2);
+}
+
+TEST(winuxcmd, pipeline_stops_writers_when_reader_exits) {
+  auto r1 = run_pipeline_line(L"yes | head -n 1");
+  EXPECT_EQ(r1.exit_code, 0);
+  EXPECT_EQ_TEXT(r1.stdout_text, "y\n");
+
+  // Far more than one channel holds, so cat blocks unless head's exit
+  // releases it.
+  std::string data;
+  for (int i = 0; i < 400000; ++i) {
+    data += "line " + std::to_string(i) + "\n";
+  }
+  TempDir tmp;
+  tmp.write("big.txt", data);
+  auto r2 = run_pipeline_line(L"cat big.txt | head -n 1", tmp.wpath());
+  EXPECT_EQ_TEXT(r2.stdout_text, "line 0\n");
+}
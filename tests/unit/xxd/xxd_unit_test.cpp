@@ -17,4 +17,21 @@ TEST(xxd, xxd_from_stdin) {
 
   EXPECT_EQ(r.exit_code, 0);
   EXPECT_FALSE(r.stdout_text.empty());
-}
\ No newline at end of file
+}
+
+TEST(xxd, xxd_file_partial_last_line) {
+  TempDir tmp;
+  tmp.write("a.bin", "0123456789abcdefXY");
+
+  Pipeline p;
+  p.set_cwd(tmp.wpath());
+  p.add(L"xxd.exe", {L"a.bin"});
+
+  auto r = p.run();
+
+  EXPECT_EQ(r.exit_code, 0);
+  EXPECT_EQ_TEXT(r.stdout_text,
+                 "00000000: 3031 3233 3435 3637 3839 6162 6364 6566  "
+                 "0123456789abcdef\n"
+                 "00000010: 5859                                     XY\n");
+}